@@ -0,0 +1,100 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "batchconversions.h"
+#include "oscillator.h"
+#include "wifbbench.h"
+#include "wifbcodec.h"
+
+/* Encode and decode time per chunk of interleaved pcm, and the
+size of the payload against the pcm.  A tone with a little noise
+stands in for programme audio; white noise at full scale is the
+worst case, where lossless channels end up stored verbatim.  ADPCM
+payloads are the same size whatever the signal. */
+
+namespace Bench
+{
+
+/* Fills frames of interleaved pcm with a 1 kHz tone at half
+scale and noise around -60 dBFS, or with full-scale white noise */
+template <typename I>
+static std::vector<uint8_t> make_pcm(int_fast32_t numFrames, bool white)
+{
+    const int_fast32_t numSamples(numFrames * numChannels);
+    std::vector<float> values(numSamples);
+    Osc::OscillatorBase<float> osc;
+    osc.set_sample_rate(48000);
+    osc.set_frequency(1000);
+    osc.scale = 0.5f;
+
+    uint32_t seed(1);
+    for (int_fast32_t i(0); i < numSamples; i += numChannels)
+    {
+        float tone;
+        osc.get(&tone, 1);
+        for (int_fast8_t c(0); c < numChannels; ++c)
+        {
+            seed = (seed * 1664525) + 1013904223;
+            const float noise((static_cast<float>(seed >> 8) / 8388608.0f) - 1.0f);
+            values[i + c] = white ? noise : (tone + (noise * 0.001f));
+        }
+    }
+
+    std::vector<uint8_t> pcm(numSamples * sizeof(I));
+    float_to_int_batch<I>(reinterpret_cast<I*>(pcm.data()), values.data(), numSamples);
+    return pcm;
+}
+
+template <typename I>
+static void codec(
+        Runner& runner,
+        const char* codecName,
+        uint8_t encoding,
+        const char* signal,
+        int_fast32_t numFrames
+    )
+{
+    const std::string suffix(
+            std::string("/") + type_name<I>() + "/" + signal + "/" + std::to_string(numFrames)
+        );
+    const std::unique_ptr<WIFBCodec> coder(make_codec(encoding, sizeof(I) * 8, numChannels));
+    std::vector<uint8_t> pcm(make_pcm<I>(numFrames, signal[0] == 'w'));
+    std::vector<uint8_t> encoded(coder->max_encoded_size(pcm.size()));
+    std::vector<uint8_t> decoded(pcm.size());
+    uint8_t* regions[1] = {pcm.data()};
+    const int_fast32_t lengths[1] = {static_cast<int_fast32_t>(pcm.size())};
+    int_fast32_t encodedLength(coder->encode(encoded.data(), regions, lengths, 1));
+
+    const std::string encodeName(std::string("codec/") + codecName + "_encode" + suffix);
+    runner.run(encodeName, numFrames * numChannels, [&]() {
+            encodedLength = coder->encode(encoded.data(), regions, lengths, 1);
+            keep(encoded.data());
+        });
+    runner.annotate(
+            encodeName,
+            "compression_ratio",
+            static_cast<double>(encodedLength) / static_cast<double>(pcm.size())
+        );
+
+    runner.run(std::string("codec/") + codecName + "_decode" + suffix, numFrames * numChannels, [&]() {
+            keep(coder->decode(decoded.data(), decoded.size(), encoded.data(), encodedLength));
+            keep(decoded.data());
+        });
+}
+
+void codec(Runner& runner)
+{
+    for (const int_fast32_t numFrames: bufferLengths)
+    {
+        for (const char* signal: {"tone", "white"})
+        {
+            codec<int16_t>(runner, "lossless", WIFB_ENCODING_LOSSLESS, signal, numFrames);
+            codec<Int24>(runner, "lossless", WIFB_ENCODING_LOSSLESS, signal, numFrames);
+            codec<int16_t>(runner, "adpcm", WIFB_ENCODING_ADPCM, signal, numFrames);
+            codec<Int24>(runner, "adpcm", WIFB_ENCODING_ADPCM, signal, numFrames);
+        }
+    }
+}
+
+};
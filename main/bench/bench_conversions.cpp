@@ -0,0 +1,65 @@
+#include <string>
+#include <vector>
+
+#include "batchconversions.h"
+#include "intfloatconversions.h"
+#include "wifbbench.h"
+
+/* Per-sample converters against the block converters,
+over a full-scale ramp so every branch is taken */
+
+namespace Bench
+{
+
+template <typename I>
+static void conversions(Runner& runner, int_fast32_t length)
+{
+    const std::string suffix(
+            std::string("/") + type_name<I>() + "/" + std::to_string(length)
+        );
+    std::vector<float> values(length), floats(length);
+    std::vector<I> ints(length);
+    for (int_fast32_t i(0); i < length; ++i)
+    {
+        values[i] = -1.0f + ((2.0f * static_cast<float>(i)) / static_cast<float>(length));
+    }
+    float_to_int<float, I>(ints.data(), values.data(), length);
+    TPDFDither dither;
+
+    runner.run("conversions/float_to_int" + suffix, length, [&]() {
+            float_to_int<float, I>(ints.data(), values.data(), length);
+            keep(ints.data());
+        });
+
+    runner.run("conversions/int_to_float" + suffix, length, [&]() {
+            int_to_float<I, float>(floats.data(), ints.data(), length);
+            keep(floats.data());
+        });
+
+    runner.run("conversions/float_to_int_batch" + suffix, length, [&]() {
+            float_to_int_batch<I>(ints.data(), values.data(), length);
+            keep(ints.data());
+        });
+
+    runner.run("conversions/float_to_int_batch_dithered" + suffix, length, [&]() {
+            float_to_int_batch<I>(ints.data(), values.data(), length, &dither);
+            keep(ints.data());
+        });
+
+    runner.run("conversions/int_to_float_batch" + suffix, length, [&]() {
+            int_to_float_batch<I>(floats.data(), ints.data(), length);
+            keep(floats.data());
+        });
+}
+
+void conversions(Runner& runner)
+{
+    for (const int_fast32_t length: bufferLengths)
+    {
+        conversions<uint8_t>(runner, length);
+        conversions<int16_t>(runner, length);
+        conversions<int32_t>(runner, length);
+    }
+}
+
+};
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+#include "broadcastringbuffer.h"
+#include "wifbbench.h"
+#include "wifbframe.h"
+#include "wifbmetadata.h"
+#include "wifbnetwork.h"
+
+/* The transmitter's fan-out over loopback: a producer writes chunks
+into a broadcast ring, and one session thread per client reads its
+own cursor and sends each chunk as a frame over tcp, as
+client_sock_handler does.  Latency is measured with the producer
+writing at the audio rate, from a chunk's write to its frame
+arriving, and annotated as the mean over clients and the worst
+client's mean.  Throughput then runs the producer flat out, stalled
+by the slowest reader, so items are payload bytes summed over
+clients. */
+
+namespace Bench
+{
+
+static constexpr const int_fast32_t fanoutPayloadLength = 1024;
+static constexpr const int_fast32_t fanoutChunkSamples = fanoutPayloadLength / sizeof(int16_t);
+static constexpr const int_fast8_t fanoutRingLength = 8;
+/* Up to a client on every reader of the ring */
+static constexpr const int_fast8_t maxClients = RINGBUFF_MAX_READERS;
+
+/* Chunks written at 48 kHz for the latency of each case */
+static constexpr const int_fast32_t pacedChunks = 64;
+static constexpr const int64_t pacedChunkNs = (fanoutChunkSamples / numChannels) * 1000000000LL / 48000;
+
+static int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+}
+
+/* One receiver and the session that serves it */
+class Client
+{
+
+protected:
+
+    Buffer::BroadcastRingBuffer<int16_t>& _ring;
+    int _socks[2];
+    int_fast8_t _reader;
+    std::atomic_bool _running;
+    std::thread _session;
+    std::thread _receiver;
+
+    void _send()
+    {
+        uint8_t metadata[METADATA_SIZE] = {};
+        WIFBFrameEncoder encoder(WIFB_ENCODING_PCM, 16, numChannels);
+        struct iovec iov[4];
+        uint8_t* regions[2];
+        int_fast32_t lengths[2];
+        while (_running)
+        {
+            if (!_ring.wait_readable(_reader, fanoutChunkSamples, 50)) continue;
+            const int_fast8_t numRegions(_ring.get_read_byte_regions(
+                    _reader,
+                    fanoutPayloadLength,
+                    regions,
+                    lengths
+                ));
+            if (!numRegions) continue;
+
+            encoder.encode(fanoutPayloadLength, (METADATA_SIZE), fanoutChunkSamples / numChannels);
+            iov[0].iov_base = encoder.data;
+            iov[0].iov_len = (WIFB_FRAME_HEADER_SIZE);
+            for (int_fast8_t r(0); r < numRegions; ++r)
+            {
+                iov[r + 1].iov_base = regions[r];
+                iov[r + 1].iov_len = lengths[r];
+            }
+            iov[numRegions + 1].iov_base = metadata;
+            iov[numRegions + 1].iov_len = (METADATA_SIZE);
+            const int rc(send_iov(_socks[0], iov, numRegions + 2));
+            _ring.report_read_bytes(_reader, fanoutPayloadLength);
+            if (rc < 0) break;
+        }
+    }
+
+    /* Each chunk starts with the time it was written */
+    void _receive()
+    {
+        constexpr int_fast32_t frameLength = (WIFB_FRAME_HEADER_SIZE) + fanoutPayloadLength + (METADATA_SIZE);
+        uint8_t frame[frameLength];
+        WIFBFrameHeader header;
+        while (recv(_socks[1], frame, frameLength, MSG_WAITALL) == frameLength)
+        {
+            if (!decode_frame_header(frame, &header)) break;
+            int64_t written;
+            std::memcpy(&written, &(frame[WIFB_FRAME_HEADER_SIZE]), sizeof(written));
+            if (written < since) continue;
+            const int64_t latency(now_ns() - written);
+            latencySumNs += latency;
+            ++latencyFrames;
+        }
+    }
+
+public:
+
+    /* Latency of chunks written from since on */
+    std::atomic<int64_t> since;
+    std::atomic<int64_t> latencySumNs;
+    std::atomic<int64_t> latencyFrames;
+
+    Client(Buffer::BroadcastRingBuffer<int16_t>& ring) :
+    _ring(ring),
+    _socks{-1, -1},
+    _reader(-1),
+    _running(true),
+    since(INT64_MAX),
+    latencySumNs(0),
+    latencyFrames(0)
+    {
+        if (!loopback_pair(SOCK_STREAM, _socks)) return;
+        _reader = _ring.add_reader();
+        if (_reader < 0) return;
+        _session = std::thread(&Client::_send, this);
+        _receiver = std::thread(&Client::_receive, this);
+    }
+
+    ~Client()
+    {
+        /* The receiver drains until the session has stopped sending */
+        _running = false;
+        if (_session.joinable()) _session.join();
+        if (_socks[0] >= 0) shutdown(_socks[0], SHUT_RDWR);
+        if (_receiver.joinable()) _receiver.join();
+        if (_reader >= 0) _ring.remove_reader(_reader);
+        if (_socks[0] >= 0) close(_socks[0]);
+        if (_socks[1] >= 0) close(_socks[1]);
+    }
+
+    bool connected() const
+    {
+        return (_reader >= 0);
+    }
+
+    void start_latency(int64_t from)
+    {
+        latencySumNs = 0;
+        latencyFrames = 0;
+        since = from;
+    }
+
+};
+
+static void write_chunk(Buffer::BroadcastRingBuffer<int16_t>& ring, int16_t* chunk)
+{
+    const int64_t written(now_ns());
+    std::memcpy(chunk, &written, sizeof(written));
+    ring.write_samples(chunk, fanoutChunkSamples);
+}
+
+static void fan_out(Runner& runner, int_fast8_t numClients)
+{
+    const std::string name("fanout/tcp/" + std::to_string(numClients) + "_clients");
+    if (!runner.selected(name)) return;
+
+    /* The producer is held to the slowest client, so
+    its rate is the rate every client is served at */
+    Buffer::BroadcastRingBuffer<int16_t> ring(
+            fanoutChunkSamples,
+            fanoutRingLength,
+            Buffer::BLOCK_ON_SLOWEST_READER
+        );
+    std::vector<int16_t> chunk(fanoutChunkSamples, 0x1234);
+    std::vector<std::unique_ptr<Client>> clients;
+    for (int_fast8_t c(0); c < numClients; ++c)
+    {
+        clients.emplace_back(new Client(ring));
+        if (!clients.back()->connected())
+        {
+            std::cerr << "Unable to connect client " << +c << " over loopback\n";
+            return;
+        }
+    }
+
+    /* Latency is measured first, as the backlog a flat out run
+    leaves in the streams releases frames in bursts for a while */
+    const int64_t from(now_ns());
+    for (std::unique_ptr<Client>& client: clients) client->start_latency(from);
+    auto next(std::chrono::steady_clock::now());
+    for (int_fast32_t i(0); i < pacedChunks; ++i)
+    {
+        next += std::chrono::nanoseconds(pacedChunkNs);
+        std::this_thread::sleep_until(next);
+        if (ring.wait_writable(fanoutChunkSamples, 1000)) write_chunk(ring, chunk.data());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    double meanSumNs(0), worstMeanNs(0);
+    for (std::unique_ptr<Client>& client: clients)
+    {
+        const int64_t frames(client->latencyFrames);
+        const double meanNs(frames ? (static_cast<double>(client->latencySumNs) / frames) : 0);
+        meanSumNs += meanNs;
+        worstMeanNs = std::max(worstMeanNs, meanNs);
+    }
+
+    runner.run(name, fanoutPayloadLength * numClients, [&]() {
+            if (ring.wait_writable(fanoutChunkSamples, 1000)) write_chunk(ring, chunk.data());
+        });
+    runner.annotate(name, "latency_mean_ns", meanSumNs / numClients);
+    runner.annotate(name, "latency_worst_client_ns", worstMeanNs);
+}
+
+void fanout(Runner& runner)
+{
+    for (int_fast8_t numClients(1); numClients <= maxClients; ++numClients) fan_out(runner, numClients);
+}
+
+};
@@ -0,0 +1,74 @@
+#include <string>
+#include <vector>
+
+#include "wifbbench.h"
+#include "wifbframe.h"
+#include "wifbmetadata.h"
+
+/* Framing overhead on either side of the socket: serializing and
+deserializing a header, and taking a stream of frames apart with
+WIFBFrameParser, its payloads copied out into two regions as
+from a stream buffer.  Items are frames for the headers and
+bytes of the stream for the parser. */
+
+namespace Bench
+{
+
+static constexpr const int_fast32_t framePayloadLengths[] = {256, 1024, 4096};
+
+/* Frames in each parsed stream */
+static constexpr const int_fast32_t streamFrames = 16;
+
+static void parse(Runner& runner, int_fast32_t payloadLength)
+{
+    WIFBFrameEncoder encoder(WIFB_ENCODING_PCM, 16, numChannels);
+    std::vector<uint8_t> stream;
+    for (int_fast32_t f(0); f < streamFrames; ++f)
+    {
+        encoder.encode(payloadLength, (METADATA_SIZE), payloadLength / (sizeof(int16_t) * numChannels));
+        stream.insert(stream.end(), encoder.data, encoder.data + (WIFB_FRAME_HEADER_SIZE));
+        stream.resize(stream.size() + payloadLength + (METADATA_SIZE), 0x5A);
+    }
+
+    std::vector<uint8_t> payload(payloadLength);
+    uint8_t metadata[METADATA_SIZE];
+    WIFBFrameParser parser(payloadLength, metadata, (METADATA_SIZE));
+    uint8_t* const regions[2] = {payload.data() + (payloadLength / 2), payload.data()};
+    const int_fast32_t lengths[2] = {payloadLength / 2, payloadLength / 2};
+
+    runner.run("frame/parse/" + std::to_string(payloadLength), stream.size(), [&]() {
+            int_fast32_t consumed(0);
+            while (consumed < static_cast<int_fast32_t>(stream.size()))
+            {
+                consumed += parser.parse(stream.data() + consumed, stream.size() - consumed);
+                if (parser.state() == FRAME_HEADER_COMPLETE)
+                {
+                    parser.set_payload_regions(regions, lengths, 2);
+                }
+                else if (parser.state() == FRAME_COMPLETE)
+                {
+                    parser.next_frame();
+                }
+            }
+            keep(payload[0]);
+        });
+}
+
+void frame(Runner& runner)
+{
+    WIFBFrameEncoder encoder(WIFB_ENCODING_PCM, 16, numChannels);
+    runner.run("frame/encode_header", 1, [&]() {
+            encoder.encode(1024, (METADATA_SIZE), 256);
+            keep(encoder.data);
+        });
+
+    WIFBFrameHeader header;
+    runner.run("frame/decode_header", 1, [&]() {
+            keep(decode_frame_header(encoder.data, &header));
+            keep(header);
+        });
+
+    for (const int_fast32_t payloadLength: framePayloadLengths) parse(runner, payloadLength);
+}
+
+};
@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+
+#include "multibuffer.h"
+#include "wifbbench.h"
+
+/* Each case reads one buffer from every channel per iteration,
+after the channels' writes have only been reported */
+
+namespace Bench
+{
+
+template <typename T>
+static void multibuffer(Runner& runner, int_fast32_t length)
+{
+    const std::string suffix(
+            std::string("/") + type_name<T>() + "/" + std::to_string(length)
+        );
+    const int_fast32_t frameLength(length * numChannels);
+    Buffer::AtomicMultiRingBuffer<T> multi(length, ringLength, numChannels);
+    std::vector<T> read(frameLength);
+
+    auto report_written = [&]() {
+            for (auto& buffer: multi.buffers) buffer.report_written_samples(length);
+            multi.update();
+        };
+
+    runner.run("multiringbuffer/read_samples_interleaved" + suffix, frameLength, [&]() {
+            report_written();
+            multi.read_samples_interleaved(read.data(), frameLength);
+            keep(read.data());
+        });
+
+    multi.reset();
+    runner.run("multiringbuffer/read_samples_concatenated" + suffix, frameLength, [&]() {
+            report_written();
+            multi.read_samples_concatenated(read.data(), frameLength);
+            keep(read.data());
+        });
+
+    /* Each call takes an equal share of one buffer from every channel */
+    multi.reset();
+    runner.run("multiringbuffer/read_concatenated" + suffix, frameLength, [&]() {
+            report_written();
+            for (int_fast8_t c(0); c < numChannels; ++c) multi.read_concatenated(&read);
+            keep(read.data());
+        });
+}
+
+void multibuffer(Runner& runner)
+{
+    for (const int_fast32_t length: bufferLengths)
+    {
+        multibuffer<uint8_t>(runner, length);
+        multibuffer<int16_t>(runner, length);
+        multibuffer<int32_t>(runner, length);
+        multibuffer<float>(runner, length);
+    }
+}
+
+};
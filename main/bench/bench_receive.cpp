@@ -0,0 +1,272 @@
+#include <cerrno>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+#include "staticringbuffer.h"
+#include "wifbbench.h"
+#include "wifbframe.h"
+#include "wifbmetadata.h"
+#include "wifbnetwork.h"
+
+/* Cost of receiving frames from loopback into a static ring the
+way the receiver does: over tcp the parser hands recvmsg the ring's
+write regions, so audio lands in ring memory, and over udp each
+datagram is received whole and its payload copied into the ring.
+A sender thread keeps the socket full and a playback thread empties
+the ring whenever it wakes.  Per frame received, cpu_per_packet_ns
+is the receiving thread's own cpu, lost_per_packet counts frames
+that never arrived, which over udp is how far the unthrottled sender
+outruns the receiver, and refused_per_packet counts frames dropped
+because playback had not yet made room in the ring. */
+
+namespace Bench
+{
+
+static constexpr const int_fast32_t receiveRingLength = 4;
+
+/* Sends frames with a payload of length bytes from a thread of its
+own, as fast as the socket takes them, until destroyed */
+class FrameSource
+{
+
+protected:
+
+    int _sock;
+    int_fast32_t _length;
+    std::atomic_bool _running;
+    std::thread _thread;
+
+    void _send()
+    {
+        std::vector<uint8_t> payload(_length, 0x5A);
+        uint8_t metadata[METADATA_SIZE] = {};
+        WIFBFrameEncoder encoder(WIFB_ENCODING_PCM, 16, numChannels);
+        struct iovec iov[3];
+        while (_running)
+        {
+            encoder.encode(_length, (METADATA_SIZE), _length / (sizeof(int16_t) * numChannels));
+            iov[0].iov_base = encoder.data;
+            iov[0].iov_len = (WIFB_FRAME_HEADER_SIZE);
+            iov[1].iov_base = payload.data();
+            iov[1].iov_len = _length;
+            iov[2].iov_base = metadata;
+            iov[2].iov_len = (METADATA_SIZE);
+
+            /* A full socket buffer only drops datagrams */
+            if ((send_iov(_sock, iov, 3) < 0) && (errno != ENOBUFS) && (errno != ECONNREFUSED)) break;
+        }
+    }
+
+public:
+
+    FrameSource(int sock, int_fast32_t length) :
+    _sock(sock),
+    _length(length),
+    _running(true)
+    {
+        _thread = std::thread(&FrameSource::_send, this);
+    }
+
+    ~FrameSource()
+    {
+        /* Shutting down wakes a send blocked on a full stream */
+        _running = false;
+        shutdown(_sock, SHUT_RDWR);
+        _thread.join();
+    }
+
+};
+
+struct Drops
+{
+    int64_t lost{0};
+    int64_t refused{0};
+};
+
+/* Runs a case that receives one frame per iteration, and adds the
+receiving thread's cpu and the drops for each frame to its result */
+template <typename F>
+static void run_frames(Runner& runner, const std::string& name, int64_t frameLength, Drops* drops, F&& body)
+{
+    int64_t frames(0);
+    *drops = Drops();
+    const int64_t cpuStart(thread_cpu_ns());
+    runner.run(name, frameLength, [&]() {
+            frames += body();
+        });
+    if (!frames) return;
+    const int64_t cpuNs(thread_cpu_ns() - cpuStart);
+    runner.annotate(name, "cpu_per_packet_ns", static_cast<double>(cpuNs) / static_cast<double>(frames));
+    runner.annotate(name, "lost_per_packet", static_cast<double>(drops->lost) / static_cast<double>(frames));
+    runner.annotate(name, "refused_per_packet", static_cast<double>(drops->refused) / static_cast<double>(frames));
+}
+
+template <int_fast32_t PayloadLength>
+static void receive_tcp(Runner& runner, int socks[2])
+{
+    constexpr int_fast32_t bufferLength = PayloadLength / sizeof(int16_t);
+    Buffer::StaticRingBuffer<int16_t, bufferLength, receiveRingLength> ring;
+    std::atomic_bool playing(true);
+    std::thread playback([&]() {
+            while (playing)
+            {
+                if (ring.wait_readable(bufferLength, 50)) ring.report_read_samples(ring.buffered());
+            }
+        });
+
+    uint8_t metadata[METADATA_SIZE];
+    uint8_t drained[PayloadLength];
+    WIFBFrameParser parser(PayloadLength, metadata, (METADATA_SIZE));
+    struct iovec iov[3];
+    uint8_t* regions[3];
+    int_fast32_t lengths[3];
+    int_fast32_t payloadBytes(0);
+    Drops drops;
+
+    {
+        FrameSource source(socks[0], PayloadLength);
+        const int64_t frameLength((WIFB_FRAME_HEADER_SIZE) + PayloadLength + (METADATA_SIZE));
+        run_frames(runner, "receive/tcp/" + std::to_string(PayloadLength), frameLength, &drops, [&]() {
+                while (true)
+                {
+                    const int_fast8_t numRegions(parser.next_regions(regions, lengths));
+                    if (numRegions)
+                    {
+                        for (int_fast8_t i(0); i < numRegions; ++i)
+                        {
+                            iov[i].iov_base = regions[i];
+                            iov[i].iov_len = lengths[i];
+                        }
+                        const int rc(recv_iov(socks[1], iov, numRegions));
+                        if (rc <= 0) return 0;
+                        parser.advance(rc);
+                    }
+                    else if (parser.state() == FRAME_HEADER_COMPLETE)
+                    {
+                        const int_fast32_t length(parser.header().payloadLength);
+                        int_fast8_t numPayloadRegions(ring.get_write_byte_regions(length, regions, lengths));
+                        payloadBytes = (numPayloadRegions ? length : 0);
+                        if (!numPayloadRegions)
+                        {
+                            regions[0] = drained;
+                            lengths[0] = length;
+                            numPayloadRegions = 1;
+                            ++drops.refused;
+                        }
+                        parser.set_payload_regions(regions, lengths, numPayloadRegions);
+                    }
+                    else
+                    {
+                        if (payloadBytes) ring.report_written_bytes(payloadBytes);
+                        drops.lost += parser.lost();
+                        parser.next_frame();
+                        return 1;
+                    }
+                }
+            });
+    }
+
+    playing = false;
+    playback.join();
+}
+
+template <int_fast32_t PayloadLength>
+static void receive_udp(Runner& runner, int socks[2])
+{
+    constexpr int_fast32_t bufferLength = PayloadLength / sizeof(int16_t);
+    Buffer::StaticRingBuffer<int16_t, bufferLength, receiveRingLength> ring;
+    std::atomic_bool playing(true);
+    std::thread playback([&]() {
+            while (playing)
+            {
+                if (ring.wait_readable(bufferLength, 50)) ring.report_read_samples(ring.buffered());
+            }
+        });
+
+    /* A sender that stops leaves recv waiting only briefly */
+    timeval timeout{1, 0};
+    setsockopt(socks[1], SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    uint8_t datagram[UDP_MAX_DATAGRAM_SIZE];
+    WIFBFrameHeader header;
+    bool started(false);
+    uint32_t sequence(0);
+    Drops drops;
+
+    {
+        FrameSource source(socks[0], PayloadLength);
+        const int64_t frameLength((WIFB_FRAME_HEADER_SIZE) + PayloadLength + (METADATA_SIZE));
+        run_frames(runner, "receive/udp/" + std::to_string(PayloadLength), frameLength, &drops, [&]() {
+                const ssize_t rc(recv(socks[1], datagram, sizeof(datagram), 0));
+                if (
+                        (rc != frameLength)
+                        || !decode_frame_header(datagram, &header)
+                        || (header.payloadLength != PayloadLength)
+                    )
+                {
+                    return 0;
+                }
+
+                /* Datagrams the socket had no room for leave gaps */
+                if (started) drops.lost += static_cast<uint32_t>(header.sequence - sequence - 1);
+                started = true;
+                sequence = header.sequence;
+
+                if (ring.bytes_available() >= PayloadLength)
+                {
+                    ring.write_bytes(&(datagram[WIFB_FRAME_HEADER_SIZE]), PayloadLength);
+                }
+                else
+                {
+                    ++drops.refused;
+                }
+                return 1;
+            });
+    }
+
+    playing = false;
+    playback.join();
+}
+
+/* Each case gets a fresh pair of sockets,
+as its sender shuts its end down */
+template <int_fast32_t PayloadLength>
+static void receive_frames(Runner& runner)
+{
+    int socks[2];
+    if (loopback_pair(SOCK_STREAM, socks))
+    {
+        receive_tcp<PayloadLength>(runner, socks);
+        close(socks[0]);
+        close(socks[1]);
+    }
+    else
+    {
+        std::cerr << "Unable to connect tcp over loopback\n";
+    }
+
+    if ((WIFB_FRAME_HEADER_SIZE) + PayloadLength + (METADATA_SIZE) > (UDP_MAX_DATAGRAM_SIZE)) return;
+    if (loopback_pair(SOCK_DGRAM, socks))
+    {
+        receive_udp<PayloadLength>(runner, socks);
+        close(socks[0]);
+        close(socks[1]);
+    }
+    else
+    {
+        std::cerr << "Unable to connect udp over loopback\n";
+    }
+}
+
+void receive(Runner& runner)
+{
+    receive_frames<256>(runner);
+    receive_frames<1024>(runner);
+    receive_frames<4096>(runner);
+}
+
+};
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ringbuffer.h"
+#include "wifbbench.h"
+
+/* Each case moves one buffer through the ring per iteration.
+The end not being measured only reports, so the ring stays in
+step without its copies adding to the time. */
+
+namespace Bench
+{
+
+template <typename T>
+static void ringbuffer(Runner& runner, int_fast32_t length)
+{
+    const std::string suffix(
+            std::string("/") + type_name<T>() + "/" + std::to_string(length)
+        );
+    Buffer::AtomicRingBuffer<T> ring(length, ringLength);
+    std::vector<T> samples(length), read(length);
+    for (int_fast32_t i(0); i < length; ++i) samples[i] = static_cast<T>(i);
+
+    runner.run("ringbuffer/write_samples" + suffix, length, [&]() {
+            keep(ring.write_samples(samples.data(), length));
+            ring.report_read_samples(length);
+        });
+
+    ring.reset();
+    runner.run("ringbuffer/write_vector" + suffix, length, [&]() {
+            keep(ring.write(samples));
+            ring.report_read_samples(length);
+        });
+
+    ring.reset();
+    runner.run("ringbuffer/write_sample" + suffix, length, [&]() {
+            for (int_fast32_t i(0); i < length; ++i) ring.write(samples[i]);
+            ring.report_read_samples(length);
+        });
+
+    ring.reset();
+    runner.run("ringbuffer/read_samples" + suffix, length, [&]() {
+            ring.report_written_samples(length);
+            ring.read_samples(read.data(), length);
+            keep(read.data());
+        });
+
+    ring.reset();
+    runner.run("ringbuffer/report_samples" + suffix, 1, [&]() {
+            ring.report_written_samples(length);
+            ring.report_read_samples(length);
+        });
+
+    ring.reset();
+    runner.run("ringbuffer/rotate_buffers" + suffix, 1, [&]() {
+            ring.rotate_write_buffer();
+            ring.rotate_read_buffer();
+        });
+}
+
+/* Samples in each chunk committed one at a time, the 64 bytes of
+int16_t the transmitter reads per frame */
+static constexpr const int_fast32_t commitChunkLength = 32;
+
+/* Reserves length samples, fills them and commits once */
+template <typename T>
+static bool write_batched(Buffer::AtomicRingBuffer<T>& ring, int_fast32_t length, T value)
+{
+    T* regions[2];
+    int_fast32_t lengths[2];
+    const int_fast8_t numRegions(ring.get_write_regions(length, regions, lengths));
+    if (!numRegions) return false;
+    for (int_fast8_t r(0); r < numRegions; ++r) std::fill_n(regions[r], lengths[r], value);
+    ring.commit_written_samples(length);
+    return true;
+}
+
+/* Reserves, fills and commits each chunk of length samples in turn */
+template <typename T>
+static bool write_per_chunk(Buffer::AtomicRingBuffer<T>& ring, int_fast32_t length, T value)
+{
+    if (ring.available() < length) return false;
+    for (int_fast32_t i(0); i < length; i += commitChunkLength)
+    {
+        keep(write_batched(ring, std::min(commitChunkLength, length - i), value));
+    }
+    return true;
+}
+
+/* Takes length samples in regions, a chunk at a time
+or all at once, committing each read as it goes */
+template <typename T>
+static bool read_committing(Buffer::AtomicRingBuffer<T>& ring, int_fast32_t length, int_fast32_t chunkLength)
+{
+    if (ring.buffered() < length) return false;
+    T* regions[2];
+    int_fast32_t lengths[2];
+    for (int_fast32_t i(0); i < length; i += chunkLength)
+    {
+        const int_fast32_t readLength(std::min(chunkLength, length - i));
+        const int_fast8_t numRegions(ring.get_read_regions(readLength, regions, lengths));
+        for (int_fast8_t r(0); r < numRegions; ++r) keep(regions[r][lengths[r] - 1]);
+        ring.commit_read_samples(readLength);
+    }
+    return true;
+}
+
+/* A producer and a consumer thread move a buffer per iteration
+through the ring, committing every chunk or once per buffer.
+The per-chunk case publishes a counter, and wakes the other side,
+that many more times per buffer; on a multi-core host the cache
+lines bouncing between the threads show in the time. */
+template <typename T>
+static void ringbuffer_threads(Runner& runner, int_fast32_t length)
+{
+    for (const bool batched: {true, false})
+    {
+        const std::string name(
+                std::string("ringbuffer/threads/") + (batched ? "commit_batched/" : "commit_per_chunk/")
+                + type_name<T>() + "/" + std::to_string(length)
+            );
+        if (!runner.selected(name)) continue;
+
+        Buffer::AtomicRingBuffer<T> ring(length, ringLength);
+        const int_fast32_t chunkLength(batched ? length : commitChunkLength);
+        std::atomic_bool running(true);
+        std::thread consumer([&]() {
+                while (running)
+                {
+                    if (!read_committing(ring, length, chunkLength)) ring.wait_readable(length, 50);
+                }
+            });
+
+        T value(0);
+        runner.run(name, length, [&]() {
+                ++value;
+                while (!(batched ? write_batched(ring, length, value) : write_per_chunk(ring, length, value)))
+                {
+                    ring.wait_writable(length, 50);
+                }
+            });
+
+        running = false;
+        consumer.join();
+    }
+}
+
+void ringbuffer(Runner& runner)
+{
+    for (const int_fast32_t length: bufferLengths)
+    {
+        ringbuffer<uint8_t>(runner, length);
+        ringbuffer<int16_t>(runner, length);
+        ringbuffer<int32_t>(runner, length);
+        ringbuffer<float>(runner, length);
+    }
+
+    for (const int_fast32_t length: {256, 1024, 4096}) ringbuffer_threads<int16_t>(runner, length);
+}
+
+};
@@ -0,0 +1,58 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "ringbuffer.h"
+#include "wifbbench.h"
+
+/* Cost of sleeping on a ring instead of polling it: how long
+a waiting thread takes to wake once a buffer is published, and
+how much cpu a thread waiting on an empty ring burns */
+
+namespace Bench
+{
+
+static constexpr const int_fast32_t notifyLength = 64;
+
+void ringnotifier(Runner& runner)
+{
+    /* Two threads hand a buffer back and forth through a pair
+    of rings, each asleep in wait_readable until the other
+    publishes, so every iteration is two wakes */
+    Buffer::AtomicRingBuffer<int16_t> ping(notifyLength, ringLength);
+    Buffer::AtomicRingBuffer<int16_t> pong(notifyLength, ringLength);
+    std::atomic_bool running(true);
+    std::thread echo([&]() {
+            while (running)
+            {
+                if (!ping.wait_readable(notifyLength, 100)) continue;
+                ping.report_read_samples(notifyLength);
+                pong.report_written_samples(notifyLength);
+            }
+        });
+
+    runner.run("ringnotifier/wake_round_trip", 2, [&]() {
+            ping.report_written_samples(notifyLength);
+            pong.wait_readable(notifyLength);
+            pong.report_read_samples(notifyLength);
+        });
+
+    running = false;
+    echo.join();
+
+    /* cpu_time against real_time is the share of a
+    core the idle waiter uses while nothing arrives */
+    Buffer::AtomicRingBuffer<int16_t> empty(notifyLength, ringLength);
+    std::thread waiter([&]() {
+            empty.wait_readable(notifyLength);
+        });
+
+    runner.run("ringnotifier/idle_wait", 1, [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+
+    empty.report_written_samples(notifyLength);
+    waiter.join();
+}
+
+};
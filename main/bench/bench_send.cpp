@@ -0,0 +1,158 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+#include "broadcastringbuffer.h"
+#include "wifbbench.h"
+#include "wifbframe.h"
+#include "wifbmetadata.h"
+#include "wifbnetwork.h"
+
+/* Cost of sending frames over loopback the way the transmitter
+does, gathering header, audio straight from ring memory and
+metadata with sendmsg, against copying them into one buffer and
+sending that.  Items are bytes on the wire, so items_per_second
+is throughput; cpu_per_packet_ns is the sending thread's own cpu,
+leaving out the thread draining the other end. */
+
+namespace Bench
+{
+
+static constexpr const int_fast32_t payloadLengths[] = {256, 1024, 4096};
+
+/* Ring regions of one payload, across the end of the ring if wrapped */
+static int_fast8_t payload_regions(
+        Buffer::BroadcastRingBuffer<int16_t>& ring,
+        bool wrapped,
+        uint8_t* regions[2],
+        int_fast32_t lengths[2]
+    )
+{
+    const int_fast32_t bufferLength(ring.buffer_length());
+    const int_fast32_t half(bufferLength / 2);
+    const int_fast8_t reader(ring.add_reader());
+    std::vector<int16_t> samples(bufferLength, 0x1234);
+
+    /* Leave the reader half a buffer short of the end of the ring */
+    if (wrapped)
+    {
+        for (int_fast32_t i(0); i < ((ring.ring_length() * 2) - 1); ++i)
+        {
+            ring.write_samples(samples.data(), half);
+            ring.read_samples(reader, samples.data(), half);
+        }
+    }
+    ring.write_samples(samples.data(), half);
+    ring.write_samples(samples.data(), half);
+    return ring.get_read_byte_regions(reader, bufferLength * sizeof(int16_t), regions, lengths);
+}
+
+static int send_all(int sock, const uint8_t* data, int_fast32_t length)
+{
+    int_fast32_t sent(0);
+    while (sent < length)
+    {
+        const ssize_t rc(::send(sock, data + sent, length - sent, (WIFB_SEND_FLAGS)));
+        if (rc < 0) return -1;
+        sent += rc;
+    }
+    return sent;
+}
+
+/* Runs a case that sends one frame per iteration, and adds
+the sending thread's cpu for each frame to its result */
+template <typename F>
+static void run_frames(Runner& runner, const std::string& name, int64_t frameLength, F&& body)
+{
+    int64_t frames(0);
+    const int64_t cpuStart(thread_cpu_ns());
+    runner.run(name, frameLength, [&]() {
+            keep(body());
+            ++frames;
+        });
+    if (!frames) return;
+    runner.annotate(
+            name,
+            "cpu_per_packet_ns",
+            static_cast<double>(thread_cpu_ns() - cpuStart) / static_cast<double>(frames)
+        );
+}
+
+static void send_frames(Runner& runner, const std::string& transport, int sock, int_fast32_t payloadLength)
+{
+    const int_fast32_t frameLength((WIFB_FRAME_HEADER_SIZE) + payloadLength + (METADATA_SIZE));
+    std::vector<uint8_t> staging(frameLength);
+    uint8_t metadata[METADATA_SIZE] = {};
+    WIFBFrameEncoder encoder(WIFB_ENCODING_PCM, 16, numChannels);
+
+    for (const bool wrapped: {false, true})
+    {
+        Buffer::BroadcastRingBuffer<int16_t> ring(payloadLength / sizeof(int16_t), ringLength);
+        uint8_t* regions[2];
+        int_fast32_t lengths[2];
+        const int_fast8_t numRegions(payload_regions(ring, wrapped, regions, lengths));
+        const std::string suffix(std::string(wrapped ? "_wrapped/" : "/") + std::to_string(payloadLength));
+
+        run_frames(runner, "send/" + transport + "/copy" + suffix, frameLength, [&]() {
+                encoder.encode(payloadLength, (METADATA_SIZE), payloadLength / (sizeof(int16_t) * numChannels));
+                uint8_t* out(staging.data());
+                std::memcpy(out, encoder.data, (WIFB_FRAME_HEADER_SIZE));
+                out += (WIFB_FRAME_HEADER_SIZE);
+                for (int_fast8_t r(0); r < numRegions; ++r)
+                {
+                    std::memcpy(out, regions[r], lengths[r]);
+                    out += lengths[r];
+                }
+                std::memcpy(out, metadata, (METADATA_SIZE));
+                return send_all(sock, staging.data(), frameLength);
+            });
+
+        run_frames(runner, "send/" + transport + "/iov" + suffix, frameLength, [&]() {
+                encoder.encode(payloadLength, (METADATA_SIZE), payloadLength / (sizeof(int16_t) * numChannels));
+                struct iovec iov[4];
+                iov[0].iov_base = encoder.data;
+                iov[0].iov_len = (WIFB_FRAME_HEADER_SIZE);
+                for (int_fast8_t r(0); r < numRegions; ++r)
+                {
+                    iov[r + 1].iov_base = regions[r];
+                    iov[r + 1].iov_len = lengths[r];
+                }
+                iov[numRegions + 1].iov_base = metadata;
+                iov[numRegions + 1].iov_len = (METADATA_SIZE);
+                return send_iov(sock, iov, numRegions + 2);
+            });
+    }
+}
+
+void send(Runner& runner)
+{
+    for (const int type: {SOCK_STREAM, SOCK_DGRAM})
+    {
+        const std::string transport((type == SOCK_STREAM) ? "tcp" : "udp");
+        int socks[2];
+        if (!loopback_pair(type, socks))
+        {
+            std::cerr << "Unable to connect " << transport << " over loopback\n";
+            continue;
+        }
+
+        {
+            Sink sink(socks[1]);
+            for (const int_fast32_t payloadLength: payloadLengths)
+            {
+                /* Datagrams are kept from fragmenting */
+                const int_fast32_t frameLength((WIFB_FRAME_HEADER_SIZE) + payloadLength + (METADATA_SIZE));
+                if ((type == SOCK_DGRAM) && (frameLength > (UDP_MAX_DATAGRAM_SIZE))) continue;
+                send_frames(runner, transport, socks[0], payloadLength);
+            }
+        }
+        close(socks[0]);
+        close(socks[1]);
+    }
+}
+
+};
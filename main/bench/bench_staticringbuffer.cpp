@@ -0,0 +1,87 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ringbuffer.h"
+#include "staticringbuffer.h"
+#include "wifbbench.h"
+
+/* Per-sample cost of the compile-time ring, to compare with the
+same cases of the ring with virtual counters: writes one sample
+at a time against ringbuffer/write_sample, and counters polled
+once per sample against virtualringbuffer/poll_counters, which
+calls them through the base class as the rest of the tree does */
+
+namespace Bench
+{
+
+template <typename T, int_fast32_t BufferLength>
+static void staticringbuffer(Runner& runner)
+{
+    const std::string suffix(
+            std::string("/") + type_name<T>() + "/" + std::to_string(BufferLength)
+        );
+    auto ring(std::make_unique<Buffer::StaticRingBuffer<T, BufferLength, ringLength>>());
+    Buffer::AtomicRingBuffer<T> virtualRing(BufferLength, ringLength);
+    Buffer::Base<T, std::atomic_int_fast8_t>& base(virtualRing);
+    std::vector<T> samples(BufferLength), read(BufferLength);
+    for (int_fast32_t i(0); i < BufferLength; ++i) samples[i] = static_cast<T>(i);
+
+    runner.run("staticringbuffer/write_sample" + suffix, BufferLength, [&]() {
+            for (int_fast32_t i(0); i < BufferLength; ++i)
+            {
+                ring->write_samples(samples.data() + i, 1);
+            }
+            ring->report_read_samples(BufferLength);
+        });
+
+    runner.run("staticringbuffer/poll_counters" + suffix, BufferLength, [&]() {
+            for (int_fast32_t i(0); i < BufferLength; ++i)
+            {
+                keep(ring->buffered());
+                keep(ring->available());
+            }
+        });
+
+    runner.run("virtualringbuffer/poll_counters" + suffix, BufferLength, [&]() {
+            for (int_fast32_t i(0); i < BufferLength; ++i)
+            {
+                keep(base.buffered());
+                keep(base.available());
+            }
+        });
+
+    ring->reset();
+    runner.run("staticringbuffer/write_samples" + suffix, BufferLength, [&]() {
+            keep(ring->write_samples(samples.data(), BufferLength));
+            ring->report_read_samples(BufferLength);
+        });
+
+    ring->reset();
+    runner.run("staticringbuffer/read_samples" + suffix, BufferLength, [&]() {
+            ring->report_written_samples(BufferLength);
+            keep(ring->read_samples(read.data(), BufferLength));
+            keep(read.data());
+        });
+}
+
+/* Lengths match bufferLengths, as template arguments */
+template <typename T>
+static void staticringbuffer(Runner& runner)
+{
+    staticringbuffer<T, 32>(runner);
+    staticringbuffer<T, 64>(runner);
+    staticringbuffer<T, 256>(runner);
+    staticringbuffer<T, 1024>(runner);
+    staticringbuffer<T, 4096>(runner);
+}
+
+void staticringbuffer(Runner& runner)
+{
+    staticringbuffer<uint8_t>(runner);
+    staticringbuffer<int16_t>(runner);
+    staticringbuffer<int32_t>(runner);
+    staticringbuffer<float>(runner);
+}
+
+};
@@ -0,0 +1,270 @@
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+
+#include "wifbbench.h"
+
+namespace Bench
+{
+
+Runner::Runner(const std::string& filter, double minTimeS, int repetitions) :
+_filter(filter),
+_minTimeS(minTimeS),
+_repetitions(repetitions)
+{
+}
+
+bool Runner::selected(const std::string& name) const
+{
+    return (name.find(_filter) != std::string::npos);
+}
+
+void Runner::_record(
+        const std::string& name,
+        int64_t iterations,
+        double realTimeS,
+        double cpuTimeS,
+        int64_t items
+    )
+{
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.realTimeNs = (realTimeS * 1e9) / static_cast<double>(iterations);
+    result.cpuTimeNs = (cpuTimeS * 1e9) / static_cast<double>(iterations);
+    result.itemsPerIteration = items;
+    _results.push_back(result);
+
+    std::cerr << name << ": " << result.realTimeNs << " ns, ";
+    std::cerr << (result.realTimeNs / static_cast<double>(items)) << " ns/item\n";
+}
+
+void Runner::annotate(const std::string& name, const std::string& counter, double value)
+{
+    for (Result& result: _results)
+    {
+        if (result.name != name) continue;
+        result.counters.emplace_back(counter, value);
+        std::cerr << name << ": " << counter << ' ' << value << '\n';
+    }
+}
+
+/* Binds sock to an ephemeral loopback port and fills in its address */
+static bool bind_loopback(int sock, sockaddr_in* address)
+{
+    std::memset(address, 0, sizeof(*address));
+    address->sin_family = AF_INET;
+    address->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength(sizeof(*address));
+    return (
+            (sock >= 0)
+            && !bind(sock, reinterpret_cast<sockaddr*>(address), sizeof(*address))
+            && !getsockname(sock, reinterpret_cast<sockaddr*>(address), &addressLength)
+        );
+}
+
+bool loopback_pair(int type, int socks[2])
+{
+    sockaddr_in address, peer;
+    socks[0] = socket(AF_INET, type, 0);
+    socks[1] = -1;
+    if (type == SOCK_STREAM)
+    {
+        const int listener(socket(AF_INET, SOCK_STREAM, 0));
+        if (
+                bind_loopback(listener, &address)
+                && !listen(listener, 1)
+                && !connect(socks[0], reinterpret_cast<sockaddr*>(&address), sizeof(address))
+            )
+        {
+            socks[1] = accept(listener, nullptr, nullptr);
+        }
+        if (listener >= 0) close(listener);
+    }
+    else
+    {
+        socks[1] = socket(AF_INET, type, 0);
+        if (
+                !bind_loopback(socks[0], &address)
+                || !bind_loopback(socks[1], &peer)
+                || connect(socks[0], reinterpret_cast<sockaddr*>(&peer), sizeof(peer))
+                || connect(socks[1], reinterpret_cast<sockaddr*>(&address), sizeof(address))
+            )
+        {
+            close(socks[1]);
+            socks[1] = -1;
+        }
+    }
+
+    if ((socks[0] >= 0) && (socks[1] >= 0)) return true;
+    if (socks[0] >= 0) close(socks[0]);
+    if (socks[1] >= 0) close(socks[1]);
+    socks[0] = socks[1] = -1;
+    return false;
+}
+
+int64_t thread_cpu_ns()
+{
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (static_cast<int64_t>(now.tv_sec) * 1000000000) + now.tv_nsec;
+}
+
+Sink::Sink(int sock) :
+_sock(sock),
+_running(true),
+_bytes(0)
+{
+    /* Wake now and then to notice being stopped */
+    timeval timeout{0, 50000};
+    setsockopt(_sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    _thread = std::thread(&Sink::_drain, this);
+}
+
+Sink::~Sink()
+{
+    _running = false;
+    _thread.join();
+}
+
+void Sink::_drain()
+{
+    static thread_local uint8_t discarded[1 << 16];
+    while (_running)
+    {
+        const ssize_t rc(recv(_sock, discarded, sizeof(discarded), 0));
+        if (rc > 0) _bytes += rc;
+        else if (!rc) break;
+        else if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) break;
+    }
+}
+
+int64_t Sink::bytes() const
+{
+    return _bytes;
+}
+
+void Runner::write_json(std::ostream& out, const char* executable) const
+{
+    const std::time_t now(std::time(nullptr));
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"executable\": \"" << executable << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    #ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\",\n";
+    #else
+    out << "    \"library_build_type\": \"debug\",\n";
+    #endif
+    out << "    \"wifb_debug\": " << (_DEBUG ? "true" : "false") << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i(0); i < _results.size(); ++i)
+    {
+        const Result& result(_results[i]);
+        out << (i ? ",\n" : "\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << result.name << "\",\n";
+        out << "      \"run_name\": \"" << result.name << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"repetitions\": " << _repetitions << ",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"real_time\": " << result.realTimeNs << ",\n";
+        out << "      \"cpu_time\": " << result.cpuTimeNs << ",\n";
+        out << "      \"time_unit\": \"ns\",\n";
+        for (const std::pair<std::string, double>& counter: result.counters)
+        {
+            out << "      \"" << counter.first << "\": " << counter.second << ",\n";
+        }
+        out << "      \"items_per_second\": ";
+        out << ((static_cast<double>(result.itemsPerIteration) * 1e9) / result.realTimeNs);
+        out << "\n    }";
+    }
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+};
+
+int main(int argc, char** argv)
+{
+    const char* usage = (
+            "Usage: wifb_bench [-f filter] [-t seconds] [-r repetitions] [-o output]\n"
+            "\t-f  run only cases whose name contains filter\n"
+            "\t-t  least time each timed batch runs for\n"
+            "\t-r  timed batches per case, the fastest of which is kept\n"
+            "\t-o  JSON output file instead of stdout\n"
+        );
+
+    std::string filter;
+    double minTimeS(0.02);
+    int repetitions(5);
+    const char* output(nullptr);
+    int option;
+    while ((option = getopt(argc, argv, "f:t:r:o:")) != -1)
+    {
+        switch (option)
+        {
+            case 'f':
+                filter = optarg;
+                break;
+            case 't':
+                minTimeS = std::atof(optarg);
+                break;
+            case 'r':
+                repetitions = std::atoi(optarg);
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            default:
+                std::cerr << usage;
+                return 1;
+        }
+    }
+    if ((minTimeS <= 0) || (repetitions < 1))
+    {
+        std::cerr << usage;
+        return 1;
+    }
+
+    Bench::Runner runner(filter, minTimeS, repetitions);
+    Bench::ringbuffer(runner);
+    Bench::staticringbuffer(runner);
+    Bench::ringnotifier(runner);
+    Bench::multibuffer(runner);
+    Bench::conversions(runner);
+    Bench::codec(runner);
+    Bench::frame(runner);
+    Bench::send(runner);
+    Bench::receive(runner);
+    Bench::fanout(runner);
+
+    if (output)
+    {
+        std::ofstream file(output);
+        runner.write_json(file, argv[0]);
+        if (!file)
+        {
+            std::cerr << "Unable to write " << output << '\n';
+            return 1;
+        }
+    }
+    else
+    {
+        runner.write_json(std::cout, argv[0]);
+    }
+    return 0;
+}
@@ -0,0 +1,186 @@
+#ifndef WIFBBENCH_H
+#define WIFBBENCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "int24.h"
+
+/* Minimal timing harness for the host benchmarks.  Each case
+runs batches of iterations, doubling a batch until it lasts the
+minimum time, then keeps the fastest of several such batches.
+Results are written as JSON in the layout of Google Benchmark,
+so its tools can compare runs. */
+
+namespace Bench
+{
+
+struct Result
+{
+    std::string name;
+    int64_t iterations;
+
+    /* Times per iteration of the fastest batch */
+    double realTimeNs;
+    double cpuTimeNs;
+
+    /* Samples, or buffers for the counter cases,
+    moved by each iteration */
+    int64_t itemsPerIteration;
+
+    /* Further measurements, written as user counters */
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+class Runner
+{
+
+protected:
+
+    std::string _filter;
+    double _minTimeS;
+    int _repetitions;
+    std::vector<Result> _results;
+
+    void _record(
+            const std::string& name,
+            int64_t iterations,
+            double realTimeS,
+            double cpuTimeS,
+            int64_t items
+        );
+
+public:
+
+    Runner(const std::string& filter, double minTimeS, int repetitions);
+
+    /* Whether a case with this name is to run */
+    bool selected(const std::string& name) const;
+
+    /* Times body, one call per iteration, if the case is selected */
+    template <typename F>
+    void run(const std::string& name, int64_t items, F&& body);
+
+    /* Adds a counter to the result of a case that has run */
+    void annotate(const std::string& name, const std::string& counter, double value);
+
+    void write_json(std::ostream& out, const char* executable) const;
+
+};
+
+template <typename F>
+void Runner::run(const std::string& name, int64_t items, F&& body)
+{
+    if (!selected(name)) return;
+
+    /* Warm caches and find a batch that lasts the minimum time */
+    int64_t iterations(1);
+    double realTimeS(0), cpuTimeS(0);
+    for (int repetition(0); repetition < _repetitions;)
+    {
+        const std::clock_t cpuStart(std::clock());
+        const auto start(std::chrono::steady_clock::now());
+        for (int64_t i(0); i < iterations; ++i) body();
+        const double elapsedS(std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start
+            ).count());
+        const double cpuS(
+                static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC
+            );
+
+        if (elapsedS < _minTimeS)
+        {
+            iterations *= 2;
+            continue;
+        }
+        if (!repetition || (elapsedS < realTimeS))
+        {
+            realTimeS = elapsedS;
+            cpuTimeS = cpuS;
+        }
+        ++repetition;
+    }
+    _record(name, iterations, realTimeS, cpuTimeS, items);
+}
+
+/* Keeps the compiler from discarding a result or the stores
+behind it as unused */
+template <typename T>
+inline void keep(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename T>
+constexpr const char* type_name();
+
+template <> constexpr const char* type_name<uint8_t>() { return "uint8_t"; }
+template <> constexpr const char* type_name<int16_t>() { return "int16_t"; }
+template <> constexpr const char* type_name<int32_t>() { return "int32_t"; }
+template <> constexpr const char* type_name<float>() { return "float"; }
+template <> constexpr const char* type_name<Int24>() { return "Int24"; }
+
+/* Buffer lengths in samples every suite is run at */
+static const int_fast32_t bufferLengths[] = {32, 64, 256, 1024, 4096};
+
+/* Buffers in each benchmarked ring */
+static constexpr const int_fast8_t ringLength = 4;
+
+/* Channels in each benchmarked multi ring */
+static constexpr const int_fast8_t numChannels = 2;
+
+/* Connects a pair of sockets of type, SOCK_STREAM or SOCK_DGRAM,
+over loopback, sending from socks[0] to socks[1].  Returns
+whether both are connected. */
+bool loopback_pair(int type, int socks[2]);
+
+/* Cpu time used by the calling thread, in nanoseconds, for
+cases whose work is split between threads */
+int64_t thread_cpu_ns();
+
+/* Reads and discards whatever arrives on a socket, on a thread
+of its own, until destroyed.  The socket is left open. */
+class Sink
+{
+
+protected:
+
+    int _sock;
+    std::atomic_bool _running;
+    std::atomic<int64_t> _bytes;
+    std::thread _thread;
+
+    void _drain();
+
+public:
+
+    Sink(int sock);
+    ~Sink();
+
+    /* Bytes received so far */
+    int64_t bytes() const;
+
+};
+
+/* Suites, each in a file of its own */
+void ringbuffer(Runner& runner);
+void staticringbuffer(Runner& runner);
+void ringnotifier(Runner& runner);
+void multibuffer(Runner& runner);
+void conversions(Runner& runner);
+void codec(Runner& runner);
+void frame(Runner& runner);
+void send(Runner& runner);
+void receive(Runner& runner);
+void fanout(Runner& runner);
+
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef BATCHCONVERSIONS_H
+#define BATCHCONVERSIONS_H
+
+#include <cstdint>
+
+#include "int24.h"
+
+/* Block float <-> int sample converters.
+Full scale is 2 ^ (Bits - 1): floats are scaled, optionally
+dithered, saturated to the integer range and rounded to nearest
+with ties to even, so -1.0 maps to the minimum and anything at
+or beyond +1.0 clips to the maximum.  Unsigned samples are
+offset by half their range.  24 bit samples are either right
+justified and sign extended in 32 bit containers or packed as
+Int24.  Blocks of eight samples are vectorized with AVX2, SSE2
+or NEON when the target has them, and otherwise run a branch-free
+scalar path suited to the Xtensa fpu.  Every path produces
+identical output. */
+
+/* Builds only the scalar path, e.g. to compare it with the vector paths */
+#ifndef BATCHCONV_SCALAR
+#define BATCHCONV_SCALAR                    (0)
+#endif
+
+/* Independent dither generators; sample i of
+every batch draws from generator i % TPDF_DITHER_LANES */
+#define TPDF_DITHER_LANES                   (8)
+
+/* Triangular dither of up to +-1 LSB, from xorshift32
+generators whose 16 bit halves are differenced */
+struct TPDFDither
+{
+    uint32_t state[TPDF_DITHER_LANES];
+
+    TPDFDither(uint32_t value = 0x9E3779B9);
+
+    /* Restarts every generator from value, which must not be zero */
+    void seed(uint32_t value);
+};
+
+/* Converts length floats to Bits bit integers,
+adding dither before rounding if one is given */
+template <typename I, int_fast8_t Bits = (sizeof(I) * 8)>
+void float_to_int_batch(
+        I* converted,
+        const float* values,
+        int_fast32_t length,
+        TPDFDither* dither = nullptr
+    );
+
+/* Packed 24 bit samples convert through 32 bit blocks */
+template <>
+void float_to_int_batch<Int24, 24>(
+        Int24* converted,
+        const float* values,
+        int_fast32_t length,
+        TPDFDither* dither
+    );
+
+/* Converts length Bits bit integers to floats */
+template <typename I, int_fast8_t Bits = (sizeof(I) * 8)>
+void int_to_float_batch(
+        float* converted,
+        const I* values,
+        int_fast32_t length
+    );
+
+template <>
+void int_to_float_batch<Int24, 24>(
+        float* converted,
+        const Int24* values,
+        int_fast32_t length
+    );
+
+#endif
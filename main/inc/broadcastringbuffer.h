@@ -0,0 +1,329 @@
+#ifndef BROADCASTRINGBUFFER_H
+#define BROADCASTRINGBUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+#include "ringbuffer.h"
+
+/* Maximum number of independent readers per ring */
+#ifndef RINGBUFF_MAX_READERS
+#define RINGBUFF_MAX_READERS                (10)
+#endif
+
+namespace Buffer
+{
+
+enum broadcast_policy
+{
+    /* Writer stalls when the slowest reader is a full ring behind */
+    BLOCK_ON_SLOWEST_READER = 0,
+
+    /* Writer never stalls; lagging readers skip ahead */
+    OVERWRITE_SLOWEST_READER = 1,
+};
+
+/* Single writer, multiple reader ring buffer.
+Each registered reader has its own cursor, so readers consume
+at their own pace and never affect each other.  The writer only
+consults reader cursors under BLOCK_ON_SLOWEST_READER, and then
+only when its cached view of the slowest reader runs out of room.
+Under OVERWRITE_SLOWEST_READER, readers that fall too far behind
+are snapped forward by whole buffers and the number of samples
+skipped is recorded for that reader. */
+template <typename T>
+class BroadcastRingBuffer
+{
+
+protected:
+
+    enum reader_state
+    {
+        READER_FREE = 0,
+        READER_CLAIMED = 1,
+        READER_ACTIVE = 2,
+    };
+
+    struct alignas(RINGBUFF_CACHE_LINE_SIZE) ReaderCursor
+    {
+        /* Reader owned; position of the next sample to be read */
+        std::atomic_int_fast32_t position{0};
+
+        /* Samples the cursor skipped since last queried */
+        std::atomic_int_fast32_t skipped{0};
+
+        /* Samples read, but possibly overwritten while
+        being read, since last queried */
+        std::atomic_int_fast32_t overrun{0};
+
+        std::atomic_int_fast8_t state{READER_FREE};
+    };
+
+    /* Contiguous storage for every buffer in the ring */
+    T* _ring;
+
+    /* Source of ring storage; the heap if null */
+    Arena* _arena;
+
+    int_fast8_t _ringLength;
+
+    int_fast32_t
+        _bufferLength,
+        _bytesPerBuffer,
+        _totalRingSampleLength,
+        _maxLag,
+        _positionModulus;
+
+    std::atomic_int_fast8_t _policy{BLOCK_ON_SLOWEST_READER};
+
+    /* Writer owned; position of the next sample to be written.
+    Positions wrap at a large multiple of the ring length
+    so that lagging readers can be measured. */
+    alignas(RINGBUFF_CACHE_LINE_SIZE) std::atomic_int_fast32_t _writePosition{0};
+
+    /* Writer's last observed position of the slowest reader */
+    mutable int_fast32_t _cachedSlowestPosition{0};
+    mutable bool _cachedHasReaders{false};
+
+    ReaderCursor _readers[RINGBUFF_MAX_READERS];
+
+    /* Wake readers after writes and the writer after reads */
+    alignas(RINGBUFF_CACHE_LINE_SIZE) Notifier
+        _readable,
+        _writable;
+
+    /* Size in bytes of ring storage */
+    size_t _storage_size() const;
+
+    /* Allocates aligned ring storage */
+    virtual void _allocate();
+
+    /* Releases ring storage */
+    virtual void _deallocate();
+
+    /* Wraps a position to the position modulus */
+    int_fast32_t _wrap(int_fast32_t position) const;
+
+    /* Returns sample index in ring storage for a position */
+    int_fast32_t _index(int_fast32_t position) const;
+
+    /* Returns number of samples between two positions */
+    int_fast32_t _distance(int_fast32_t from, int_fast32_t to) const;
+
+    /* Scans active readers and caches the slowest position */
+    void _update_slowest_reader() const;
+
+    /* Snaps a lagging reader forward by whole buffers
+    and returns the reader's position */
+    int_fast32_t _catch_up(int_fast8_t reader);
+
+public:
+
+    static constexpr const int_fast32_t bytesPerSample = sizeof(T);
+
+    BroadcastRingBuffer();
+    BroadcastRingBuffer(
+            int_fast32_t bufferSize,
+            int_fast8_t ringSize,
+            broadcast_policy policy = BLOCK_ON_SLOWEST_READER
+        );
+    BroadcastRingBuffer(const BroadcastRingBuffer& obj) = delete;
+
+    virtual ~BroadcastRingBuffer();
+
+    /* Indicator as to whether ring storage has been allocated */
+    bool size_is_set() const;
+
+    /* Sets ring and buffer size and allocates storage.
+    Not safe to call while writer or readers are running. */
+    virtual void set_size(int_fast32_t bufferSize, int_fast8_t ringSize);
+
+    /* Draws ring storage from arena instead of the heap, moving
+    existing storage if size is set.  Not safe to call while writer
+    or readers are running. */
+    void set_arena(Arena* arena);
+
+    /* Sets behavior of the writer with respect to lagging readers */
+    void set_policy(broadcast_policy policy);
+    broadcast_policy policy() const;
+
+    /* Total number of samples that can fit in the ring */
+    int_fast32_t size() const;
+
+    /* Total number of bytes that can fit in the ring */
+    int_fast32_t total_size() const;
+
+    /* Number of buffers in the ring */
+    int_fast8_t ring_length() const;
+
+    /* Length in samples of each buffer in the ring */
+    int_fast32_t buffer_length() const;
+
+    /* Number of bytes per sample */
+    int_fast32_t bytes_per_sample() const;
+
+    /* Size in bytes of each buffer in the ring */
+    int_fast32_t bytes_per_buffer() const;
+
+    /* Fill the entire ring with value.
+    Not safe to call while writer or readers are running. */
+    void fill(T value = 0);
+
+    /* Reset writer and all reader positions.
+    Not safe to call while writer or readers are running. */
+    void reset();
+
+/*                              Readers                             */
+
+    /* Registers a new reader starting at the current write position
+    and returns its index, or READER_LIMIT_REACHED */
+    int_fast8_t add_reader();
+
+    /* Unregisters a reader so that it no longer holds back the writer */
+    void remove_reader(int_fast8_t reader);
+
+    /* Number of registered readers */
+    int_fast8_t num_readers() const;
+
+    /* Returns and clears the number of samples a reader's
+    cursor has skipped, unread, since last queried */
+    int_fast32_t skipped(int_fast8_t reader);
+
+    /* Returns and clears the number of samples a reader read
+    that the writer may have overwritten while they were read */
+    int_fast32_t overrun(int_fast8_t reader);
+
+/*                               Read                               */
+
+    /* Total number of unread samples for reader */
+    int_fast32_t buffered(int_fast8_t reader);
+
+    /* Total number of unread bytes for reader */
+    int_fast32_t bytes_buffered(int_fast8_t reader);
+
+    /* Number of samples reader can read contiguously
+    from its current read buffer */
+    int_fast32_t unread(int_fast8_t reader);
+
+    /* Number of bytes reader can read contiguously
+    from its current read buffer */
+    int_fast32_t bytes_unread(int_fast8_t reader);
+
+    /* Total number of whole unread buffers for reader */
+    int_fast32_t buffers_buffered(int_fast8_t reader);
+
+    /* Returns pointer to reader's next unread sample */
+    T* get_read_sample(int_fast8_t reader);
+
+    /* Returns pointer to reader's next unread byte */
+    uint8_t* get_read_byte(int_fast8_t reader);
+
+    /* Sets up to two contiguous regions that together hold
+    the next length unread samples for reader, which may wrap
+    around the end of the ring.  Returns number of regions set,
+    or zero if fewer than length samples are buffered. */
+    int_fast8_t get_read_regions(
+            int_fast8_t reader,
+            int_fast32_t length,
+            T* regions[2],
+            int_fast32_t lengths[2]
+        );
+
+    /* Sets up to two contiguous regions that together hold
+    the next numBytes unread bytes for reader */
+    int_fast8_t get_read_byte_regions(
+            int_fast8_t reader,
+            int_fast32_t numBytes,
+            uint8_t* regions[2],
+            int_fast32_t lengths[2]
+        );
+
+    /* Copies samples for reader to data pointer
+    and returns number of samples read */
+    int_fast32_t read_samples(int_fast8_t reader, T* data, int_fast32_t length);
+
+    /* Copies bytes for reader to data pointer
+    and returns number of bytes read */
+    int_fast32_t read_bytes(
+            int_fast8_t reader,
+            uint8_t* data,
+            int_fast32_t numBytes
+        );
+
+    /* Advances reader's cursor by number of samples read externally.
+    If the writer overran the samples while they were being read,
+    they are added to the reader's overrun count. */
+    void report_read_samples(int_fast8_t reader, int_fast32_t length);
+
+    /* Advances reader's cursor by number of bytes read externally */
+    void report_read_bytes(int_fast8_t reader, int_fast32_t numBytes);
+
+    /* Sleeps until reader has at least length unread samples
+    or timeoutMs elapses, and returns whether it has */
+    bool wait_readable(
+            int_fast8_t reader,
+            int_fast32_t length,
+            int_fast32_t timeoutMs = RINGBUFF_WAIT_FOREVER
+        );
+
+/*                               Write                              */
+
+    /* Total number of samples that can be written */
+    int_fast32_t available() const;
+
+    /* Total number of bytes that can be written */
+    int_fast32_t bytes_available() const;
+
+    /* Number of samples that can be written contiguously
+    to the current write buffer */
+    int_fast32_t unwritten() const;
+
+    /* Number of bytes that can be written contiguously
+    to the current write buffer */
+    int_fast32_t bytes_unwritten() const;
+
+    /* Returns pointer to first sample
+    of current write buffer */
+    T* get_write_buffer_sample();
+
+    /* Returns pointer to first byte
+    of current write buffer */
+    uint8_t* get_write_buffer_byte();
+
+    /* Returns pointer to next writable sample */
+    T* get_write_sample();
+
+    /* Returns pointer to next writable byte */
+    uint8_t* get_write_byte();
+
+    /* Copies samples from data pointer to the ring
+    and returns number of samples written */
+    int_fast32_t write_samples(const T* data, int_fast32_t length);
+
+    /* Copies bytes from data pointer to the ring
+    and returns number of bytes written */
+    int_fast32_t write_bytes(const uint8_t* data, int_fast32_t numBytes);
+
+    /* Publishes number of samples written externally */
+    void report_written_samples(int_fast32_t length);
+
+    /* Publishes number of bytes written externally */
+    void report_written_bytes(int_fast32_t numBytes);
+
+    /* Sleeps until at least length samples can be written
+    or timeoutMs elapses, and returns whether they can */
+    bool wait_writable(
+            int_fast32_t length,
+            int_fast32_t timeoutMs = RINGBUFF_WAIT_FOREVER
+        );
+
+};
+
+};
+
+#endif
@@ -4,8 +4,20 @@
 #include <cstdint>
 #include <iostream>
 #include <vector>
+
+#include "int24.h"
+
+#ifdef ESP_PLATFORM
 #include <driver/i2s_std.h>
 #include <driver/gpio.h>
+#else
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include "batchconversions.h"
+#include "oscillator.h"
+#endif
 
 namespace I2S
 {
@@ -31,12 +43,60 @@ protected:
         _numBytesWritten,
         _numBytesRead,
         _numTicksToWait;
+
+    #ifdef ESP_PLATFORM
+
     i2s_chan_handle_t
         _txHandle,
         _rxHandle;
     i2s_chan_config_t _channelConfig;
     i2s_std_config_t _stdConfig;
 
+    /* 32 bit slots that packed 24 bit samples are staged in */
+    std::vector<int32_t> _slots;
+
+    #else
+
+    /* Simulated bus for host builds.  Transfers are paced by a clock
+    running at the configured sample rate, input comes from a file or
+    a generated tone, and output goes to a file or is discarded. */
+    uint32_t _sampleRate;
+    uint16_t
+        _bitsPerSample,
+        _channels;
+    bool
+        _realtime,
+        _toneEnabled;
+    std::FILE
+        *_source,
+        *_sink;
+    Osc::OscillatorBase<float> _tone;
+    std::vector<float> _toneBuffer;
+    std::vector<uint8_t> _toneSamples;
+
+    /* Sample clock period relative to nominal */
+    double _clockScale;
+
+    /* Each direction counts frames moved since its clock started */
+    std::chrono::steady_clock::time_point
+        _readStart,
+        _writeStart;
+    int64_t
+        _framesRead,
+        _framesWritten;
+
+    /* Wait until the sample clock reaches the end of a transfer */
+    void _pace(
+            std::chrono::steady_clock::time_point* start,
+            int64_t* frames,
+            int_fast32_t numBytes
+        );
+
+    /* Fill with interleaved tone samples at the bus bit depth */
+    void _generate_tone(uint8_t* data, int_fast32_t numBytes);
+
+    #endif
+
     virtual void _initialize();
     virtual void _disable();
     virtual void _enable();
@@ -63,6 +123,25 @@ public:
     virtual void set_invert_bit_clock(bool invert = false);
     virtual void set_invert_word_select(bool invert = false);
     virtual void set_auto_clear(bool clear);
+
+    #ifndef ESP_PLATFORM
+
+    /* Read raw interleaved input from a file, looping at its end */
+    virtual void set_source_file(const char* path);
+
+    /* Generate a sine tone as input */
+    virtual void set_source_tone(float frequency, float scale = 0.5f);
+
+    /* Write raw interleaved output to a file */
+    virtual void set_sink_file(const char* path);
+
+    /* Whether transfers wait for the simulated sample clock */
+    virtual void set_realtime(bool realtime);
+
+    /* Run the sample clock fast or slow by parts per million */
+    virtual void set_clock_error_ppm(double ppm);
+
+    #endif
     
     virtual void start();
     virtual void stop();
@@ -76,6 +155,11 @@ public:
     template <typename T>
     void read(std::vector<T>* data, int_fast32_t length);
 
+    /* Packed 24 bit samples, which the i2s peripheral
+    carries in the upper bytes of 32 bit slots */
+    virtual void write_samples(const Int24* data, int_fast32_t length);
+    virtual void read_samples(Int24* data, int_fast32_t length);
+
 };
 
 };
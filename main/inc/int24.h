@@ -0,0 +1,78 @@
+#ifndef INT24_H
+#define INT24_H
+
+#include <cstdint>
+#include <limits>
+
+/* Packed 24 bit signed sample of three little endian bytes.
+There is no padding, so an array of samples is the wire and
+file format as is, and rings of them hold 3 bytes per sample.
+Arithmetic happens on int32_t, which samples convert to and
+from implicitly; values outside 24 bits wrap when stored. */
+class Int24
+{
+
+protected:
+
+    uint8_t _bytes[3];
+
+public:
+
+    static constexpr const int32_t minimum = -0x800000;
+    static constexpr const int32_t maximum = 0x7FFFFF;
+
+    /* Uninitialized, like the built in integers */
+    Int24() = default;
+
+    constexpr Int24(int32_t value) :
+    _bytes{
+            static_cast<uint8_t>(value),
+            static_cast<uint8_t>(value >> 8),
+            static_cast<uint8_t>(value >> 16)
+        }
+    {
+    }
+
+    constexpr operator int32_t() const
+    {
+        /* Assemble in the upper bytes and shift down to sign extend */
+        return static_cast<int32_t>(
+                (static_cast<uint32_t>(this->_bytes[2]) << 24)
+                | (static_cast<uint32_t>(this->_bytes[1]) << 16)
+                | (static_cast<uint32_t>(this->_bytes[0]) << 8)
+            ) >> 8;
+    }
+
+};
+
+static_assert(sizeof(Int24) == 3, "Int24 must be packed");
+
+namespace std
+{
+
+template <>
+struct numeric_limits<Int24> : public numeric_limits<int32_t>
+{
+    static constexpr const int digits = 23;
+    static constexpr const int digits10 = 6;
+
+    static constexpr Int24 min() noexcept { return Int24(Int24::minimum); }
+    static constexpr Int24 lowest() noexcept { return Int24(Int24::minimum); }
+    static constexpr Int24 max() noexcept { return Int24(Int24::maximum); }
+};
+
+};
+
+/* Packs length right justified, sign extended 32 bit samples */
+void pack_int24(Int24* packed, const int32_t* values, int_fast32_t length);
+
+/* Unpacks length samples to right justified, sign extended 32 bit samples */
+void unpack_int24(int32_t* values, const Int24* packed, int_fast32_t length);
+
+/* Packs length samples from the upper bytes of 32 bit i2s slots */
+void pack_int24_slots(Int24* packed, const int32_t* slots, int_fast32_t length);
+
+/* Unpacks length samples into the upper bytes of 32 bit i2s slots */
+void unpack_int24_slots(int32_t* slots, const Int24* packed, int_fast32_t length);
+
+#endif
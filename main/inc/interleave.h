@@ -0,0 +1,300 @@
+#ifndef INTERLEAVE_H
+#define INTERLEAVE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Buffer
+{
+
+/* Block interleave and deinterleave kernels.
+Channel counts of 2, 4 and 8 are unrolled at compile time; on hosts
+with SSE2 each block of one register per channel is transposed
+in registers with log2(channels) rounds of unpacks.  Other counts
+fall back to strided copies.  Samples are moved as raw bits, so
+any trivially copyable type of 1, 2, 4 or 8 bytes is accelerated. */
+
+namespace Kernel
+{
+
+#if defined(__SSE2__)
+
+template <size_t Width>
+struct Unpack;
+
+template <>
+struct Unpack<1>
+{
+    static inline __m128i lo(__m128i a, __m128i b) { return _mm_unpacklo_epi8(a, b); }
+    static inline __m128i hi(__m128i a, __m128i b) { return _mm_unpackhi_epi8(a, b); }
+};
+
+template <>
+struct Unpack<2>
+{
+    static inline __m128i lo(__m128i a, __m128i b) { return _mm_unpacklo_epi16(a, b); }
+    static inline __m128i hi(__m128i a, __m128i b) { return _mm_unpackhi_epi16(a, b); }
+};
+
+template <>
+struct Unpack<4>
+{
+    static inline __m128i lo(__m128i a, __m128i b) { return _mm_unpacklo_epi32(a, b); }
+    static inline __m128i hi(__m128i a, __m128i b) { return _mm_unpackhi_epi32(a, b); }
+};
+
+template <>
+struct Unpack<8>
+{
+    static inline __m128i lo(__m128i a, __m128i b) { return _mm_unpacklo_epi64(a, b); }
+    static inline __m128i hi(__m128i a, __m128i b) { return _mm_unpackhi_epi64(a, b); }
+};
+
+/* Whether T moves through the sse2 path */
+template <typename T>
+constexpr bool vectorizable()
+{
+    return (
+            std::is_trivially_copyable<T>::value
+            && ((sizeof(T) == 1) || (sizeof(T) == 2)
+                || (sizeof(T) == 4) || (sizeof(T) == 8))
+        );
+}
+
+/* One round of the transpose network: pairs register j with
+register j + C / 2 and interleaves their elements */
+template <size_t Width, int_fast8_t C>
+inline void shuffle_round(__m128i r[C])
+{
+    __m128i out[C];
+    #pragma GCC unroll 8
+    for (int_fast8_t j(0); j < (C / 2); ++j)
+    {
+        out[2 * j] = Unpack<Width>::lo(r[j], r[j + (C / 2)]);
+        out[(2 * j) + 1] = Unpack<Width>::hi(r[j], r[j + (C / 2)]);
+    }
+    #pragma GCC unroll 8
+    for (int_fast8_t j(0); j < C; ++j) r[j] = out[j];
+}
+
+/* Inverse of shuffle_round.  Splitting the even and odd elements
+of a register pair is the perfect shuffle applied one time fewer
+than its order, log2 of the elements in the pair. */
+template <size_t Width, int_fast8_t C>
+inline void unshuffle_round(__m128i r[C])
+{
+    constexpr int_fast8_t lanes(16 / Width);
+    constexpr int_fast8_t passes(
+            (lanes == 16) ? 4 : (lanes == 8) ? 3 : (lanes == 4) ? 2 : 1
+        );
+    __m128i out[C];
+    #pragma GCC unroll 8
+    for (int_fast8_t j(0); j < (C / 2); ++j)
+    {
+        __m128i a(r[2 * j]), b(r[(2 * j) + 1]);
+        #pragma GCC unroll 8
+        for (int_fast8_t p(0); p < passes; ++p)
+        {
+            const __m128i lo(Unpack<Width>::lo(a, b));
+            b = Unpack<Width>::hi(a, b);
+            a = lo;
+        }
+        out[j] = a;
+        out[j + (C / 2)] = b;
+    }
+    #pragma GCC unroll 8
+    for (int_fast8_t j(0); j < C; ++j) r[j] = out[j];
+}
+
+#endif
+
+template <typename T, int_fast8_t C>
+inline void interleave(T* output, const T* const* inputs, int_fast32_t length)
+{
+    int_fast32_t i(0);
+
+    #if defined(__SSE2__)
+    if constexpr (vectorizable<T>())
+    {
+        constexpr int_fast32_t lanes(16 / sizeof(T));
+        constexpr int_fast8_t rounds((C == 2) ? 1 : (C == 4) ? 2 : 3);
+        __m128i r[C];
+        for (; (i + lanes) <= length; i += lanes)
+        {
+            #pragma GCC unroll 8
+            for (int_fast8_t c(0); c < C; ++c)
+            {
+                r[c] = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(inputs[c] + i)
+                    );
+            }
+            #pragma GCC unroll 8
+            for (int_fast8_t k(0); k < rounds; ++k)
+            {
+                shuffle_round<sizeof(T), C>(r);
+            }
+            #pragma GCC unroll 8
+            for (int_fast8_t c(0); c < C; ++c)
+            {
+                _mm_storeu_si128(
+                        reinterpret_cast<__m128i*>(output + (i * C) + (c * lanes)),
+                        r[c]
+                    );
+            }
+        }
+    }
+    #endif
+
+    /* Remaining frames short of a whole register */
+    for (; i < length; ++i)
+    {
+        #pragma GCC unroll 8
+        for (int_fast8_t c(0); c < C; ++c) output[(i * C) + c] = inputs[c][i];
+    }
+}
+
+template <typename T, int_fast8_t C>
+inline void deinterleave(T* const* outputs, const T* input, int_fast32_t length)
+{
+    int_fast32_t i(0);
+
+    #if defined(__SSE2__)
+    if constexpr (vectorizable<T>())
+    {
+        constexpr int_fast32_t lanes(16 / sizeof(T));
+        constexpr int_fast8_t rounds((C == 2) ? 1 : (C == 4) ? 2 : 3);
+        __m128i r[C];
+        for (; (i + lanes) <= length; i += lanes)
+        {
+            #pragma GCC unroll 8
+            for (int_fast8_t c(0); c < C; ++c)
+            {
+                r[c] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                        input + (i * C) + (c * lanes)
+                    ));
+            }
+            #pragma GCC unroll 8
+            for (int_fast8_t k(0); k < rounds; ++k)
+            {
+                unshuffle_round<sizeof(T), C>(r);
+            }
+            #pragma GCC unroll 8
+            for (int_fast8_t c(0); c < C; ++c)
+            {
+                _mm_storeu_si128(
+                        reinterpret_cast<__m128i*>(outputs[c] + i),
+                        r[c]
+                    );
+            }
+        }
+    }
+    #endif
+
+    /* Remaining frames short of a whole register */
+    for (; i < length; ++i)
+    {
+        #pragma GCC unroll 8
+        for (int_fast8_t c(0); c < C; ++c) outputs[c][i] = input[(i * C) + c];
+    }
+}
+
+};
+
+/* Copies length frames from a single channel
+to every numChannels-th sample of output */
+template <typename T>
+inline void interleave_channel(
+        T* output,
+        const T* input,
+        int_fast8_t numChannels,
+        int_fast32_t length
+    )
+{
+    for (int_fast32_t i(0); i < length; ++i) output[i * numChannels] = input[i];
+}
+
+/* Copies every numChannels-th sample of
+input to length frames of a single channel */
+template <typename T>
+inline void deinterleave_channel(
+        T* output,
+        const T* input,
+        int_fast8_t numChannels,
+        int_fast32_t length
+    )
+{
+    for (int_fast32_t i(0); i < length; ++i) output[i] = input[i * numChannels];
+}
+
+/* Interleaves length frames from numChannels separate
+channel inputs into numChannels * length samples of output */
+template <typename T>
+void interleave(
+        T* output,
+        const T* const* inputs,
+        int_fast8_t numChannels,
+        int_fast32_t length
+    )
+{
+    switch (numChannels)
+    {
+        case 1:
+            std::copy_n(inputs[0], length, output);
+            break;
+        case 2:
+            Kernel::interleave<T, 2>(output, inputs, length);
+            break;
+        case 4:
+            Kernel::interleave<T, 4>(output, inputs, length);
+            break;
+        case 8:
+            Kernel::interleave<T, 8>(output, inputs, length);
+            break;
+        default:
+            for (int_fast8_t c(0); c < numChannels; ++c)
+            {
+                interleave_channel<T>(output + c, inputs[c], numChannels, length);
+            }
+    }
+}
+
+/* Splits numChannels * length interleaved samples
+of input into length frames of each channel output */
+template <typename T>
+void deinterleave(
+        T* const* outputs,
+        const T* input,
+        int_fast8_t numChannels,
+        int_fast32_t length
+    )
+{
+    switch (numChannels)
+    {
+        case 1:
+            std::copy_n(input, length, outputs[0]);
+            break;
+        case 2:
+            Kernel::deinterleave<T, 2>(outputs, input, length);
+            break;
+        case 4:
+            Kernel::deinterleave<T, 4>(outputs, input, length);
+            break;
+        case 8:
+            Kernel::deinterleave<T, 8>(outputs, input, length);
+            break;
+        default:
+            for (int_fast8_t c(0); c < numChannels; ++c)
+            {
+                deinterleave_channel<T>(outputs[c], input + c, numChannels, length);
+            }
+    }
+}
+
+};
+
+#endif
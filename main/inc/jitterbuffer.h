@@ -0,0 +1,156 @@
+#ifndef JITTERBUFFER_H
+#define JITTERBUFFER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "intfloatconversions.h"
+#include "ringbuffer.h"
+
+namespace Buffer
+{
+
+enum jitter_concealment
+{
+    /* Missing frames are played as silence, the midpoint
+    of unsigned sample types and zero otherwise */
+    CONCEAL_SILENCE = 0,
+
+    /* Missing frames repeat the last played frame,
+    falling back to silence after a few repeats */
+    CONCEAL_REPEAT_LAST = 1,
+};
+
+struct JitterStats
+{
+    /* Frames currently held */
+    int_fast32_t depth;
+
+    /* Current playout delay */
+    int_fast32_t targetDepthUs;
+
+    /* Interarrival jitter estimate */
+    int_fast32_t jitterUs;
+
+    uint_fast32_t
+        received,
+        played,
+        late,
+        lost,
+        concealed,
+        duplicated,
+        resynced;
+};
+
+/* Reorders frames by sequence number and releases them on a
+playout schedule derived from their sequence, delayed by a target
+depth that adapts to the measured interarrival jitter (RFC 3550).
+Frames missing at their playout time are concealed; frames that
+arrive after it are counted late and dropped.  Time is always
+supplied by the caller in microseconds, so behavior depends only
+on the sequence of calls and can be replayed exactly. */
+template <typename T>
+class JitterBuffer
+{
+
+protected:
+
+    struct Slot
+    {
+        uint32_t sequence;
+        bool filled;
+    };
+
+    std::vector<T> _samples, _lastFrame, _silence;
+    std::vector<Slot> _slots;
+
+    int_fast32_t
+        _frameLength,
+        _numSlots,
+        _sampleRate,
+        _samplesPerFrame;
+
+    jitter_concealment _concealment;
+    int_fast8_t _maxRepeats, _repeats;
+    bool _adaptive;
+
+    int_fast32_t
+        _minDepthUs,
+        _maxDepthUs,
+        _configuredDepthUs,
+        _targetDepthUs;
+
+    bool _started;
+    uint32_t _baseSequence, _nextSequence;
+    int64_t _baseArrivalUs;
+
+    /* RFC 3550 state; jitter is kept scaled by 16 */
+    bool _haveTransit;
+    uint32_t _previousTimestamp;
+    int64_t _previousArrivalUs, _jitter16;
+
+    JitterStats _stats;
+
+    /* Nominal arrival time of a frame on the sequence timeline */
+    int64_t _nominal_arrival(uint32_t sequence) const;
+
+    /* Update jitter estimate and target depth from an arrival */
+    void _update_jitter(uint32_t timestamp, int64_t nowUs);
+
+    /* Restart the schedule from a frame */
+    void _start(uint32_t sequence, int64_t nowUs);
+
+public:
+
+    JitterBuffer(
+            int_fast32_t frameLength,
+            int_fast32_t numSlots,
+            int_fast32_t sampleRate,
+            int_fast8_t channels = 1
+        );
+
+    ~JitterBuffer();
+
+    /* Set initial playout delay; also the fixed delay if not adaptive */
+    void set_target_depth_ms(int_fast32_t targetMs);
+
+    /* Set bounds for the adaptive playout delay */
+    void set_depth_limits_ms(int_fast32_t minMs, int_fast32_t maxMs);
+
+    /* Enable or disable adapting the delay to measured jitter */
+    void set_adaptive(bool adaptive);
+
+    /* Set how missing frames are concealed */
+    void set_concealment(jitter_concealment concealment, int_fast8_t maxRepeats = 2);
+
+    /* Number of samples in every frame */
+    int_fast32_t frame_length() const;
+
+    /* Store a frame that arrived at nowUs and return whether it was kept */
+    bool insert(
+            uint32_t sequence,
+            uint32_t timestamp,
+            const T* data,
+            int_fast32_t length,
+            int64_t nowUs
+        );
+
+    /* Returns the next frame if its playout time has come,
+    concealing it if it is missing, or nullptr if no frame is due.
+    The returned samples are valid until the next insert. */
+    const T* pull(int64_t nowUs);
+
+    /* Current statistics */
+    JitterStats stats() const;
+
+    /* Discard all frames and restart at the next insert */
+    void reset();
+
+};
+
+};
+
+#endif
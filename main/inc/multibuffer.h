@@ -1,44 +1,72 @@
 #ifndef MULTIBUFFER_H
 #define MULTIBUFFER_H
 
+#include "interleave.h"
 #include "ringbuffer.h"
 
 namespace Buffer
 {
 
-template <typename T, typename I>
+template <typename T, typename I, typename A>
 class MultiRingBuffer :
 public Buffer::Base<T, I>
 {
 
+public:
+
+    typedef A allocator_type;
+
 protected:
 
+    typedef typename std::allocator_traits<A>::template rebind_alloc<
+            RingBuffer<T, I, A>
+        > _buffers_allocator_type;
+
     int_fast8_t _numBuffers;
 
 public:
 
-    std::vector<RingBuffer<T, I>> buffers;
+    std::vector<RingBuffer<T, I, A>, _buffers_allocator_type> buffers;
 
 public:
 
     MultiRingBuffer();
+    explicit MultiRingBuffer(const A& allocator);
     MultiRingBuffer(
             int_fast32_t bufferSize,
             int_fast8_t ringSize,
-            int_fast8_t numBuffers
+            int_fast8_t numBuffers,
+            const A& allocator = A()
         );
     MultiRingBuffer(const MultiRingBuffer& obj);
+    MultiRingBuffer(MultiRingBuffer&& obj) noexcept;
 
     virtual ~MultiRingBuffer();
 
+    /* Copies into existing sub buffers, allocating
+    only where they are smaller than those of obj */
+    MultiRingBuffer& operator=(const MultiRingBuffer& obj);
+    MultiRingBuffer& operator=(MultiRingBuffer&& obj) noexcept;
+
     bool size_is_set() const override;
 
+    /* Sets sizes of all sub buffers, reusing their
+    allocated storage where it fits */
     virtual void set_size(
             int_fast32_t bufferSize,
             int_fast8_t ringSize,
             int_fast8_t numBuffers
         );
 
+    /* Reserves room for numBuffers sub buffers and storage
+    in each existing one without changing the current size,
+    so that later calls to set_size within it do not allocate */
+    virtual void reserve(
+            int_fast32_t bufferSize,
+            int_fast8_t ringSize,
+            int_fast8_t numBuffers
+        );
+
     int_fast32_t size() const override;
     int_fast32_t total_size() const override;
     int_fast8_t num_buffers() const;
@@ -87,7 +115,8 @@ public:
     virtual void read_interleaved(std::vector<T>* data);
 
     /* Copies specified number of samples divided among buffers
-    and interleaved to data pointer */
+    and interleaved to data pointer.  Whole frames move in blocks
+    bounded by sub buffer boundaries. */
     virtual void read_samples_interleaved(T* data, int_fast32_t length);
 
     /* Copies specified number of bytes divided among buffers
@@ -146,6 +175,24 @@ public:
             bool force = false
         );
 
+    /* Splits interleaved samples among buffers, one channel
+    per buffer, and returns total number of samples written.
+    Only whole frames are written. If forced, unread data
+    will be overwritten. */
+    int_fast32_t write_samples_interleaved(
+            const T* data,
+            int_fast32_t length,
+            bool force = false
+        );
+
+    /* Splits interleaved bytes among buffers and
+    returns total number of bytes written */
+    int_fast32_t write_bytes_interleaved(
+            const uint8_t* data,
+            int_fast32_t numBytes,
+            bool force = false
+        );
+
 };
 
 template <typename T>
@@ -161,9 +208,13 @@ public:
             int_fast8_t numBuffers
         );
     NonAtomicMultiRingBuffer(const NonAtomicMultiRingBuffer& obj);
+    NonAtomicMultiRingBuffer(NonAtomicMultiRingBuffer&& obj) noexcept;
 
     virtual ~NonAtomicMultiRingBuffer();
 
+    NonAtomicMultiRingBuffer& operator=(const NonAtomicMultiRingBuffer& obj);
+    NonAtomicMultiRingBuffer& operator=(NonAtomicMultiRingBuffer&& obj) noexcept;
+
 };
 
 template <typename T>
@@ -179,9 +230,13 @@ public:
             int_fast8_t numBuffers
         );
     AtomicMultiRingBuffer(const AtomicMultiRingBuffer& obj);
+    AtomicMultiRingBuffer(AtomicMultiRingBuffer&& obj) noexcept;
 
     virtual ~AtomicMultiRingBuffer();
 
+    AtomicMultiRingBuffer& operator=(const AtomicMultiRingBuffer& obj);
+    AtomicMultiRingBuffer& operator=(AtomicMultiRingBuffer&& obj) noexcept;
+
 };
 
 };
@@ -0,0 +1,129 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "int24.h"
+#include "intfloatconversions.h"
+
+namespace Resample
+{
+
+enum resampler_err
+{
+    RESAMPLE_OUTPUT_TOO_SHORT = -801,
+    RESAMPLE_RATIO_OUT_OF_RANGE = -802,
+};
+
+/* Streaming fractional resampler using 4-point Catmull-Rom
+interpolation over interleaved frames.  The read position is kept
+in 32.32 fixed point so long runs accumulate no rounding drift.
+History carries across calls, adding one frame of latency. */
+template <typename T>
+class CubicResampler
+{
+
+protected:
+
+    int_fast8_t _channels;
+
+    /* Input frames advanced per output frame, 32.32 fixed point */
+    int64_t _step;
+
+    /* Position between the middle two history frames */
+    int64_t _phase;
+
+    /* Last four input frames, oldest first, interleaved;
+    silence before the first input */
+    std::vector<float> _history;
+
+    /* Convert and saturate an interpolated value */
+    static T _to_sample(float value);
+
+public:
+
+    CubicResampler(int_fast8_t channels = 1);
+
+    ~CubicResampler();
+
+    /* Set ratio of output rate to input rate, near 1.0 */
+    void set_ratio(double ratio);
+
+    /* Ratio of output rate to input rate */
+    double ratio() const;
+
+    /* Most output frames process can write for inFrames input frames */
+    int_fast32_t max_output_frames(int_fast32_t inFrames) const;
+
+    /* Consume inFrames interleaved input frames and write
+    resampled frames to out, returning number of frames written.
+    out must hold max_output_frames(inFrames) frames. */
+    int_fast32_t process(
+            const T* in,
+            int_fast32_t inFrames,
+            T* out,
+            int_fast32_t maxOutFrames
+        );
+
+    /* Clear history to silence and phase */
+    void reset();
+
+};
+
+/* Estimates clock drift between sender and receiver from the fill
+level of the receive ring, and returns the resampling ratio that
+holds the fill at its target.  A PI controller acts on the smoothed,
+normalized fill error; the integral settles at the clock offset
+while the proportional term absorbs jitter in the fill level. */
+class DriftEstimator
+{
+
+protected:
+
+    double
+        _targetFill,
+        _smoothedFill,
+        _smoothing,
+        _proportionalGain,
+        _integralGain,
+        _integral,
+        _maxDeviation,
+        _ratio;
+
+    bool _primed;
+
+public:
+
+    DriftEstimator(int_fast32_t targetFill = 0, double maxPpm = 500);
+
+    ~DriftEstimator();
+
+    /* Set fill level in samples to hold */
+    void set_target_fill(int_fast32_t targetFill);
+
+    /* Set controller gains per update and fill smoothing factor */
+    void set_gains(double proportional, double integral, double smoothing = (1.0 / 64));
+
+    /* Update with the current fill level in samples
+    and return the new ratio of output rate to input rate */
+    double update(int_fast32_t fill);
+
+    /* Ratio of output rate to input rate */
+    double ratio() const;
+
+    /* Estimated drift in parts per million */
+    double ppm() const;
+
+    /* Forget history */
+    void reset();
+
+};
+
+};
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef RINGALLOCATOR_H
+#define RINGALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+#endif
+
+/* Alignment in bytes of every arena allocation */
+#ifndef RINGBUFF_CACHE_LINE_SIZE
+#define RINGBUFF_CACHE_LINE_SIZE            (64)
+#endif
+
+/* Memory capabilities arenas request by default */
+#ifndef RINGBUFF_ARENA_CAPS
+#ifdef ESP_PLATFORM
+#define RINGBUFF_ARENA_CAPS                 (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#else
+#define RINGBUFF_ARENA_CAPS                 (0)
+#endif
+#endif
+
+namespace Buffer
+{
+
+/* Fixed region that ring storage is carved from.
+The region is claimed once, typically at startup, from heap
+memory with the requested capabilities (e.g. MALLOC_CAP_DMA)
+or from a caller supplied static array.  Allocations bump an
+offset and are never individually returned, except that freeing
+the most recent allocation rewinds over it so a vector growing
+at the top of the arena does not leak its old storage. */
+class Arena
+{
+
+protected:
+
+    uint8_t* _region;
+    size_t _size;
+    uint32_t _caps;
+
+    /* Whether the region was claimed by this arena */
+    bool _owned;
+
+    std::atomic_size_t _offset{0};
+
+public:
+
+    /* Claims size bytes with capabilities caps */
+    Arena(size_t size, uint32_t caps = RINGBUFF_ARENA_CAPS);
+
+    /* Carves from an existing region that outlives the arena */
+    Arena(void* region, size_t size);
+
+    Arena(const Arena& obj) = delete;
+
+    ~Arena();
+
+    /* Returns aligned storage for numBytes,
+    or nullptr if the arena is exhausted */
+    void* allocate(size_t numBytes, size_t alignment = RINGBUFF_CACHE_LINE_SIZE);
+
+    /* Rewinds if data was the most recent allocation */
+    void deallocate(void* data, size_t numBytes);
+
+    /* Releases every allocation at once.  Nothing
+    carved from the arena may be in use. */
+    void reset();
+
+    /* Whether the region was claimed successfully */
+    bool valid() const;
+
+    /* Size in bytes of the region */
+    size_t size() const;
+
+    /* Bytes allocated, including alignment padding */
+    size_t used() const;
+
+    /* Bytes left to allocate */
+    size_t available() const;
+
+    /* Capabilities the region was claimed with */
+    uint32_t caps() const;
+
+};
+
+/* Standard allocator drawing from an Arena, for use as
+the allocator parameter of RingBuffer and MultiRingBuffer.
+A default constructed allocator has no arena and fails every
+allocation, so rings must be constructed with one. */
+template <typename T>
+class ArenaAllocator
+{
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+protected:
+
+    Arena* _arena;
+
+public:
+
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type is_always_equal;
+
+    ArenaAllocator() noexcept :
+    _arena(nullptr)
+    {
+    }
+
+    ArenaAllocator(Arena& arena) noexcept :
+    _arena(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& obj) noexcept :
+    _arena(obj._arena)
+    {
+    }
+
+    T* allocate(size_t length)
+    {
+        void* data(
+                this->_arena
+                ? this->_arena->allocate(length * sizeof(T))
+                : nullptr
+            );
+        if (data == nullptr) throw std::bad_alloc();
+        return static_cast<T*>(data);
+    }
+
+    void deallocate(T* data, size_t length) noexcept
+    {
+        if (this->_arena) this->_arena->deallocate(data, length * sizeof(T));
+    }
+
+    Arena* arena() const
+    {
+        return this->_arena;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& obj) const noexcept
+    {
+        return (this->_arena == obj._arena);
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& obj) const noexcept
+    {
+        return (this->_arena != obj._arena);
+    }
+
+};
+
+};
+
+#endif
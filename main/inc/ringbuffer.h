@@ -11,13 +11,29 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <span>
 #include <stdexcept>
 #include <type_traits>
 
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#endif
+
+#include "int24.h"
+#include "ringallocator.h"
+#include "ringnotifier.h"
+
 #ifndef RINGBUFF_AUTO_FIRST_ROTATE
 #define RINGBUFF_AUTO_FIRST_ROTATE  0
 #endif
 
+/* Alignment in bytes of ring storage and of
+producer and consumer owned counters */
+#ifndef RINGBUFF_CACHE_LINE_SIZE
+#define RINGBUFF_CACHE_LINE_SIZE            (64)
+#endif
+
 namespace Buffer
 {
 
@@ -39,12 +55,50 @@ enum ringbuffer_err
     NON_MULTIPLE_BYTE_COUNT = -81,
     BUFFER_COUNT_TOO_SHORT = -90,
     SIZE_NOT_SET = -91,
+    READER_LIMIT_REACHED = -92,
+    READER_NOT_REGISTERED = -93,
 };
 
+enum overrun_policy
+{
+    /* Writer stalls when the ring is full */
+    BLOCK_ON_OVERRUN = 0,
+
+    /* Writer never stalls; the reader drops
+    the oldest buffers to catch up */
+    OVERWRITE_OLDEST = 1,
+};
+
+/* Bits reporting fill level crossings */
+enum watermark_event
+{
+    WATERMARK_NONE = 0,
+
+    /* Buffered samples fell to or below the low watermark */
+    WATERMARK_LOW = 1,
+
+    /* Buffered samples rose to or above the high watermark */
+    WATERMARK_HIGH = 2,
+
+    /* Buffered samples rose past the low watermark plus hysteresis */
+    WATERMARK_LOW_CLEARED = 4,
+
+    /* Buffered samples fell past the high watermark minus hysteresis */
+    WATERMARK_HIGH_CLEARED = 8,
+};
+
+/* Called with the watermark events raised and the number of
+samples buffered, on whichever task caused the crossing */
+typedef void (*watermark_callback)(
+        int_fast8_t events,
+        int_fast32_t buffered,
+        void* context
+    );
+
 template <typename T, typename I>
 class Base;
 
-template <typename T, typename I>
+template <typename T, typename I, typename A = std::allocator<T>>
 class RingBuffer;
 
 template <typename T>
@@ -53,7 +107,7 @@ class NonAtomicRingBuffer;
 template <typename T>
 class AtomicRingBuffer;
 
-template <typename T, typename I>
+template <typename T, typename I, typename A = std::allocator<T>>
 class MultiRingBuffer;
 
 template <typename T>
@@ -66,8 +120,10 @@ template <typename T, typename I>
 class Base
 {
 
-    friend class RingBuffer<T, I>;
-    friend class MultiRingBuffer<T, I>;
+    template <typename, typename, typename>
+    friend class RingBuffer;
+    template <typename, typename, typename>
+    friend class MultiRingBuffer;
 
 protected:
 
@@ -77,30 +133,102 @@ protected:
     int_fast8_t _ringLength;
 
     int_fast32_t
-        _buffered,
-        _samplesWritten,
-        _samplesUnwritten,
-        _samplesProcessed,
-        _samplesUnread,
         _bufferLength,
         _bytesPerBuffer,
         _totalWritableLength,
         _totalRingSampleLength;
 
+    std::atomic_int_fast8_t _policy{BLOCK_ON_OVERRUN};
+
+    /* Fill levels in samples; negative disables */
+    int_fast32_t
+        _lowWatermark{-1},
+        _highWatermark{-1},
+        _watermarkHysteresis{0};
+
+    watermark_callback _watermarkCallback{nullptr};
+    void* _watermarkContext{nullptr};
+
+    #ifdef ESP_PLATFORM
+    EventGroupHandle_t _watermarkEventGroup{nullptr};
+    #endif
+
+    /* Watermarks currently crossed, and events
+    raised since last queried; changed only on crossings */
+    std::atomic_int_fast8_t
+        _watermarkState{WATERMARK_NONE},
+        _watermarkEvents{WATERMARK_NONE};
+
 public:
 
     static constexpr const int_fast32_t bytesPerSample = sizeof(T);
 
-    I
+    /* Producer and consumer state sit on separate cache lines.
+    Neither side writes the other's counters; buffered samples are
+    the difference of two running totals, each advanced with one
+    release store when a buffer rotates. */
+
+    alignas(RINGBUFF_CACHE_LINE_SIZE) I writeIndex{0};
+
+protected:
+
+    int_fast32_t
+        _samplesWritten,
+        _samplesUnwritten;
+
+    /* Running total of samples in completed write buffers */
+    std::atomic_uint_fast32_t _samplesCommitted{0};
+
+public:
+
+    alignas(RINGBUFF_CACHE_LINE_SIZE) I
         readIndex{0},
-        writeIndex{0},
         processingIndex{0};
 
+protected:
+
+    int_fast32_t
+        _samplesUnread,
+        _samplesProcessed;
+
+    /* Running total of samples in rotated read buffers */
+    std::atomic_uint_fast32_t _samplesReleased{0};
+
+    /* Running totals lost to OVERWRITE_OLDEST */
+    std::atomic_uint_fast32_t
+        _samplesDropped{0},
+        _buffersDropped{0};
+
+    /* Wake the consumer after commits
+    and the producer after releases */
+    alignas(RINGBUFF_CACHE_LINE_SIZE) Notifier
+        _readable,
+        _writable;
+
+    /* Publishes completed write buffers to the consumer */
+    void _commit(int_fast32_t length);
+
+    /* Returns rotated read buffers to the producer */
+    void _release(int_fast32_t length);
+
+    /* Raises events for any watermark the fill level has crossed */
+    void _check_watermarks();
+
+    /* Copies sizes, indices, counters and configuration */
+    void _copy_state(const Base& obj);
+
+    /* Returns to the unsized state of a default constructed ring */
+    void _clear_state();
+
 public:
 
     Base();
     Base(int_fast32_t bufferSize, int_fast8_t ringSize);
     Base(const Base& obj);
+    Base(Base&& obj) noexcept;
+
+    Base& operator=(const Base& obj);
+    Base& operator=(Base&& obj) noexcept;
 
     virtual ~Base();
 
@@ -135,6 +263,53 @@ public:
     /* Reset all counters and indices */
     virtual void reset();
 
+    /* Sets whether a full ring stalls the writer
+    or overwrites the oldest unread buffers */
+    virtual void set_policy(overrun_policy policy);
+    virtual overrun_policy policy() const;
+
+    /* Under OVERWRITE_OLDEST, snaps the reader forward by whole
+    buffers past any the writer has overwritten.  Called by the
+    read methods; consumers reading through pointers call it
+    before reading.  Returns number of unread samples dropped. */
+    virtual int_fast32_t catch_up();
+
+    /* Total number of unread samples dropped since reset */
+    virtual uint_fast32_t samples_dropped() const;
+
+    /* Total number of buffers skipped since reset */
+    virtual uint_fast32_t buffers_dropped() const;
+
+/*                            Watermarks                            */
+
+    /* Sets fill levels in samples at which watermark events are
+    raised.  A crossed watermark clears only once the level moves
+    hysteresis samples back past it.  A negative level disables
+    that watermark.  Not safe to call while the ring is in use. */
+    virtual void set_watermarks(
+            int_fast32_t low,
+            int_fast32_t high,
+            int_fast32_t hysteresis = 0
+        );
+
+    /* Sets a function called on every watermark event.
+    It runs on the producer or consumer task inline,
+    so it must be short and must not block. */
+    virtual void set_watermark_callback(
+            watermark_callback callback,
+            void* context = nullptr
+        );
+
+    #ifdef ESP_PLATFORM
+    /* Sets an event group that receives watermark event bits,
+    so tasks can block on them */
+    virtual void set_watermark_event_group(EventGroupHandle_t group);
+    #endif
+
+    /* Returns and clears the watermark events
+    raised since last queried */
+    virtual int_fast8_t watermark_events();
+
 /*                          Sample Counters                         */
 
     /* Total number of unread samples buffered,
@@ -198,6 +373,22 @@ public:
     this counter may be inaccurate */
     virtual int_fast32_t buffers_processed() const;
 
+/*                               Wait                               */
+
+    /* Sleeps until at least length samples can be read
+    or timeoutMs elapses, and returns whether they can */
+    virtual bool wait_readable(
+            int_fast32_t length,
+            int_fast32_t timeoutMs = RINGBUFF_WAIT_FOREVER
+        );
+
+    /* Sleeps until at least length samples can be written
+    or timeoutMs elapses, and returns whether they can */
+    virtual bool wait_writable(
+            int_fast32_t length,
+            int_fast32_t timeoutMs = RINGBUFF_WAIT_FOREVER
+        );
+
 /*                               Read                               */
 
     /* Rotate read index
@@ -217,6 +408,11 @@ public:
     /* Update counters with number of bytes read externally */
     virtual void report_read_bytes(int_fast32_t numBytes);
 
+    /* Update counters with a read spanning any number
+    of buffers, such as both regions of a reservation,
+    and release them to the producer at once */
+    virtual void commit_read_samples(int_fast32_t length);
+
 /*                               Write                              */
 
     /* Rotate write index
@@ -240,6 +436,11 @@ public:
     /* Update counters with number of bytes written externally */
     virtual void report_written_bytes(int_fast32_t numBytes);
 
+    /* Update counters with a write spanning any number
+    of buffers, such as both regions of a reservation,
+    and publish them to the consumer at once */
+    virtual void commit_written_samples(int_fast32_t length);
+
 /*                             Transform                            */
 
     /* Rotate processing index
@@ -262,29 +463,65 @@ public:
 
 };
 
-template <typename T, typename I>
+template <typename T, typename I, typename A>
 class RingBuffer :
 public Base<T, I>
 {
 
 public:
 
-    std::vector<std::vector<T>> ring;
+    typedef A allocator_type;
+    typedef std::vector<T, A> buffer_type;
+
+protected:
+
+    typedef typename std::allocator_traits<A>::template rebind_alloc<
+            buffer_type
+        > _ring_allocator_type;
+
+    /* Buffers released by shrinking the ring, kept
+    with their storage for the ring to grow into */
+    std::vector<buffer_type, _ring_allocator_type> _spare;
+
+    /* Grows or shrinks the ring to ringSize buffers,
+    moving buffers to and from spares before allocating */
+    void _reshape(int_fast8_t ringSize);
+
+public:
+
+    std::vector<buffer_type, _ring_allocator_type> ring;
 
     RingBuffer();
-    RingBuffer(int_fast32_t bufferSize, int_fast8_t ringSize);
+    explicit RingBuffer(const A& allocator);
+    RingBuffer(
+            int_fast32_t bufferSize,
+            int_fast8_t ringSize,
+            const A& allocator = A()
+        );
     RingBuffer(const RingBuffer& obj);
+    RingBuffer(RingBuffer&& obj) noexcept;
 
     virtual ~RingBuffer();
 
-    /* Sets ring and buffer size and allocates vectors */
+    /* Copies into existing buffers, allocating
+    only if this ring is smaller than obj */
+    RingBuffer& operator=(const RingBuffer& obj);
+    RingBuffer& operator=(RingBuffer&& obj) noexcept;
+
+    /* Sets ring and buffer size, reusing allocated buffers
+    where they fit and allocating only to grow past them */
     virtual void set_size(int_fast32_t bufferSize, int_fast8_t ringSize);
 
+    /* Allocates storage for a ring of up to ringSize buffers
+    of up to bufferSize samples without changing the current size,
+    so that later calls to set_size within it do not allocate */
+    virtual void reserve(int_fast32_t bufferSize, int_fast8_t ringSize);
+
     /* Fill all the buffers with value */
     virtual void fill(T value = 0);
 
     /* Returns ring index for buffer at pointer */
-    virtual int_fast8_t get_ring_index(std::vector<T>* bufferPtr);
+    virtual int_fast8_t get_ring_index(buffer_type* bufferPtr);
 
     /* Returns ring index for buffer beginning at pointer */
     virtual int_fast8_t get_ring_index(uint8_t* bufferPtr);
@@ -294,12 +531,12 @@ public:
 protected:
 
     /* Returns current read buffer */
-    virtual std::vector<T> _read();
+    virtual buffer_type _read();
 
 public:
 
     /* Returns current read buffer and rotates */
-    virtual std::vector<T> read();
+    virtual buffer_type read();
 
     /* Copies samples from read buffer to data pointer */
     virtual void read_samples(T* data, int_fast32_t length);
@@ -307,8 +544,31 @@ public:
     /* Copies bytes from read buffer to data pointer */
     virtual void read_bytes(uint8_t* data, int_fast32_t numBytes);
 
+    /* Copies buffered samples into data along the ring
+    without allocating and returns number of samples read */
+    virtual int_fast32_t read(std::span<T> data);
+
+    /* Sets up to two contiguous regions that together hold
+    the next length buffered samples: the rest of the current
+    read buffer and the start of the next.  Returns number of
+    regions set, or zero if fewer than length samples are
+    buffered.  Commit both regions with commit_read_samples. */
+    virtual int_fast8_t get_read_regions(
+            int_fast32_t length,
+            T* regions[2],
+            int_fast32_t lengths[2]
+        );
+
+    /* Sets up to two contiguous regions that together hold
+    the next numBytes buffered bytes */
+    virtual int_fast8_t get_read_byte_regions(
+            int_fast32_t numBytes,
+            uint8_t* regions[2],
+            int_fast32_t lengths[2]
+        );
+
     /* Returns pointer to current read buffer */
-    virtual std::vector<T>* get_read_buffer();
+    virtual buffer_type* get_read_buffer();
 
     /* Returns pointer to first sample
     of current read buffer */
@@ -336,12 +596,17 @@ public:
 
     /* Writes along ring and returns total number of samples written.
     If forced, unread data will be overwritten. */
-    virtual int_fast32_t write(std::vector<T> data, bool force = false);
+    virtual int_fast32_t write(const std::vector<T>& data, bool force = false);
+
+    /* Copies samples along ring without allocating and returns
+    total number of samples written.  Each buffer takes one copy.
+    If forced, unread data will be overwritten. */
+    virtual int_fast32_t write(std::span<const T> data, bool force = false);
 
     /* Writes specified number of samples.
     If forced, unread data will be overwritten. */
     virtual int_fast32_t write_samples(
-            T* data,
+            const T* data,
             int_fast32_t length,
             bool force = false
         );
@@ -349,13 +614,32 @@ public:
     /* Returns number of bytes written.
     If forced, unread data will be overwritten. */
     virtual int_fast32_t write_bytes(
-            uint8_t* data,
+            const uint8_t* data,
             int_fast32_t numBytes,
             bool force = false
         );
 
+    /* Sets up to two contiguous regions that together hold
+    room for the next length samples: the rest of the current
+    write buffer and the start of the next.  Returns number of
+    regions set, or zero if fewer than length samples fit.
+    Commit both regions with commit_written_samples. */
+    virtual int_fast8_t get_write_regions(
+            int_fast32_t length,
+            T* regions[2],
+            int_fast32_t lengths[2]
+        );
+
+    /* Sets up to two contiguous regions that together hold
+    room for the next numBytes bytes */
+    virtual int_fast8_t get_write_byte_regions(
+            int_fast32_t numBytes,
+            uint8_t* regions[2],
+            int_fast32_t lengths[2]
+        );
+
     /* Returns pointer to current write buffer */
-    virtual std::vector<T>* get_write_buffer();
+    virtual buffer_type* get_write_buffer();
 
     /* Returns pointer to first sample
     of current write buffer */
@@ -376,7 +660,7 @@ public:
 /*                             Transform                            */
 
     /* Returns pointer to current processing buffer */
-    virtual std::vector<T>* get_processing_buffer();
+    virtual buffer_type* get_processing_buffer();
 
     /* Returns pointer to first sample
     of current processing buffer */
@@ -405,9 +689,13 @@ public:
     NonAtomicRingBuffer();
     NonAtomicRingBuffer(int_fast32_t bufferSize, int_fast8_t ringSize);
     NonAtomicRingBuffer(const NonAtomicRingBuffer& obj);
+    NonAtomicRingBuffer(NonAtomicRingBuffer&& obj) noexcept;
 
     virtual ~NonAtomicRingBuffer();
 
+    NonAtomicRingBuffer& operator=(const NonAtomicRingBuffer& obj);
+    NonAtomicRingBuffer& operator=(NonAtomicRingBuffer&& obj) noexcept;
+
 };
 
 template <typename T>
@@ -419,9 +707,13 @@ public:
     AtomicRingBuffer();
     AtomicRingBuffer(int_fast32_t bufferSize, int_fast8_t ringSize);
     AtomicRingBuffer(const AtomicRingBuffer& obj);
+    AtomicRingBuffer(AtomicRingBuffer&& obj) noexcept;
     
     virtual ~AtomicRingBuffer();
 
+    AtomicRingBuffer& operator=(const AtomicRingBuffer& obj);
+    AtomicRingBuffer& operator=(AtomicRingBuffer&& obj) noexcept;
+
 };
 
 
@@ -446,6 +738,7 @@ public:
     AtomicMultiReadRingBuffer();
     AtomicMultiReadRingBuffer(int_fast32_t bufferSize, int_fast8_t ringSize);
     AtomicMultiReadRingBuffer(const AtomicMultiReadRingBuffer& obj);
+    AtomicMultiReadRingBuffer(AtomicMultiReadRingBuffer&& obj) noexcept;
 
     virtual ~AtomicMultiReadRingBuffer();
 
@@ -456,6 +749,8 @@ public:
 
 public:
 
+    using AtomicRingBuffer<T>::read;
+
     /* Returns current read buffer and reports read */
     virtual std::vector<T> read() override;
 
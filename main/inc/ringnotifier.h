@@ -0,0 +1,110 @@
+#ifndef RINGNOTIFIER_H
+#define RINGNOTIFIER_H
+
+#include <atomic>
+#include <cstdint>
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#else
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#endif
+
+/* Timeout for ring buffer waits that never expire */
+#ifndef RINGBUFF_WAIT_FOREVER
+#define RINGBUFF_WAIT_FOREVER               (-1)
+#endif
+
+#ifdef ESP_PLATFORM
+/* Task notification index ring waits sleep on.  Index 0 is left
+to stream and message buffers and to libraries, whose notifications
+would otherwise wake waiters early or be swallowed by them. */
+#ifndef RINGBUFF_NOTIFY_INDEX
+#define RINGBUFF_NOTIFY_INDEX               (1)
+#endif
+
+static_assert(
+        (RINGBUFF_NOTIFY_INDEX) < configTASK_NOTIFICATION_ARRAY_ENTRIES,
+        "Raise CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES"
+        " past RINGBUFF_NOTIFY_INDEX"
+    );
+#endif
+
+/* Number of tasks that may wait on one notifier at once.
+Tasks beyond this poll once per tick instead of sleeping. */
+#ifndef RINGBUFF_MAX_WAITERS
+#define RINGBUFF_MAX_WAITERS                (12)
+#endif
+
+namespace Buffer
+{
+
+/* Puts tasks to sleep until a ring buffer condition holds.
+Waiters sleep on a task notification on target and on a condition
+variable on host.  The side that changes the ring calls notify()
+after publishing; with nobody waiting that costs one fence and
+one load, so it is cheap enough for every publish. */
+class Notifier
+{
+
+protected:
+
+    std::atomic_int_fast8_t _numWaiters{0};
+
+    #ifdef ESP_PLATFORM
+    portMUX_TYPE _lock;
+    TaskHandle_t _waiters[RINGBUFF_MAX_WAITERS];
+    #else
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    #endif
+
+    /* Sleeps until ready(context) or timeout */
+    bool _wait(
+            bool (*ready)(const void*),
+            const void* context,
+            int_fast32_t timeoutMs
+        );
+
+public:
+
+    Notifier();
+
+    /* Waiters are not copied */
+    Notifier(const Notifier& obj);
+
+    ~Notifier();
+
+    /* Sleeps until ready() returns true or timeoutMs elapses
+    and returns the last result of ready().  A negative timeout
+    waits forever and a timeout of zero only checks once. */
+    template <typename Predicate>
+    bool wait(Predicate ready, int_fast32_t timeoutMs);
+
+    /* Wakes every waiting task to recheck its condition */
+    void notify();
+
+};
+
+template <typename Predicate>
+bool Notifier::wait(Predicate ready, int_fast32_t timeoutMs)
+{
+    if (ready()) return true;
+    else if (!timeoutMs) return false;
+
+    return _wait(
+            [](const void* context)
+            {
+                return (*static_cast<const Predicate*>(context))();
+            },
+            &ready,
+            timeoutMs
+        );
+}
+
+};
+
+#endif
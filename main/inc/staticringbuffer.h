@@ -0,0 +1,778 @@
+#ifndef STATICRINGBUFFER_H
+#define STATICRINGBUFFER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "ringbuffer.h"
+
+namespace Buffer
+{
+
+/* Lock-free single producer, single consumer ring buffer
+with its sizes fixed at compile time.  The producer owns the
+write position and the consumer owns the read position; each is
+published with a release store and observed with an acquire load,
+so samples are visible to the consumer before the counter is.
+Nothing is virtual, storage is held inline, and when the ring
+length is a power of two positions wrap with a mask instead
+of a compare. */
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+class StaticRingBuffer
+{
+
+public:
+
+    static constexpr const int_fast32_t bytesPerSample = sizeof(T);
+
+    static constexpr const int_fast32_t totalRingSampleLength = (
+            BufferLength * RingLength
+        );
+
+    static_assert(RingLength >= 2, "There must be multiple buffers to rotate");
+    static_assert(!(BufferLength % 2), "Buffer length must be an even number");
+    static_assert(
+            BufferLength <= (
+                std::numeric_limits<int_fast32_t>::max()
+                / 2
+                / RingLength
+                / bytesPerSample
+            ),
+            "Twice the total ring size in bytes must fit in int_fast32_t"
+        );
+
+protected:
+
+    static constexpr const bool _powerOfTwo = !(
+            totalRingSampleLength & (totalRingSampleLength - 1)
+        );
+
+    /* Positions run from 0 to twice the ring length so that
+    a full ring can be distinguished from an empty one */
+    static constexpr const int_fast32_t _positionModulus = (
+            totalRingSampleLength * 2
+        );
+
+    /* Contiguous storage for every buffer in the ring */
+    alignas(RINGBUFF_CACHE_LINE_SIZE) std::array<T, totalRingSampleLength> _ring;
+
+    /* Producer owned; position of the next sample to be written */
+    alignas(RINGBUFF_CACHE_LINE_SIZE) std::atomic_int_fast32_t _writePosition{0};
+
+    /* Producer's last observed read position */
+    mutable int_fast32_t _cachedReadPosition{0};
+
+    /* Consumer owned; position of the next sample to be read */
+    alignas(RINGBUFF_CACHE_LINE_SIZE) std::atomic_int_fast32_t _readPosition{0};
+
+    /* Consumer's last observed write position */
+    mutable int_fast32_t _cachedWritePosition{0};
+
+    /* Wake the consumer after writes and the producer after reads */
+    alignas(RINGBUFF_CACHE_LINE_SIZE) Notifier
+        _readable,
+        _writable;
+
+    /* Wraps a position to the position modulus */
+    static constexpr int_fast32_t _wrap(int_fast32_t position);
+
+    /* Returns sample index in ring storage for a position */
+    static constexpr int_fast32_t _index(int_fast32_t position);
+
+    /* Returns number of samples between two positions */
+    static constexpr int_fast32_t _distance(int_fast32_t from, int_fast32_t to);
+
+public:
+
+    StaticRingBuffer();
+    StaticRingBuffer(const StaticRingBuffer& obj) = delete;
+
+    /* Always true; storage is part of the object */
+    constexpr bool size_is_set() const;
+
+    /* Total number of samples that can fit in the ring */
+    constexpr int_fast32_t size() const;
+
+    /* Total number of bytes that can fit in the ring */
+    constexpr int_fast32_t total_size() const;
+
+    /* Number of buffers in the ring */
+    constexpr int_fast8_t ring_length() const;
+
+    /* Length in samples of each buffer in the ring */
+    constexpr int_fast32_t buffer_length() const;
+
+    /* Number of bytes per sample */
+    constexpr int_fast32_t bytes_per_sample() const;
+
+    /* Size in bytes of each buffer in the ring */
+    constexpr int_fast32_t bytes_per_buffer() const;
+
+    /* Fill the entire ring with value.
+    Not safe to call while producer or consumer is running. */
+    void fill(T value = 0);
+
+    /* Reset read and write positions.
+    Not safe to call while producer or consumer is running. */
+    void reset();
+
+/*                          Sample Counters                         */
+
+    /* Total number of unread samples in the ring.
+    Called from the consumer. */
+    int_fast32_t buffered() const;
+
+    /* Total number of unread bytes in the ring.
+    Called from the consumer. */
+    int_fast32_t bytes_buffered() const;
+
+    /* Total number of samples that can be written.
+    Called from the producer. */
+    int_fast32_t available() const;
+
+    /* Total number of bytes that can be written.
+    Called from the producer. */
+    int_fast32_t bytes_available() const;
+
+    /* Number of samples that can be read contiguously
+    from the current read buffer */
+    int_fast32_t unread() const;
+
+    /* Number of bytes that can be read contiguously
+    from the current read buffer */
+    int_fast32_t bytes_unread() const;
+
+    /* Number of samples that can be written contiguously
+    to the current write buffer */
+    int_fast32_t unwritten() const;
+
+    /* Number of bytes that can be written contiguously
+    to the current write buffer */
+    int_fast32_t bytes_unwritten() const;
+
+/*                          Buffer Counters                         */
+
+    /* Total number of whole unread buffers */
+    int_fast32_t buffers_buffered() const;
+
+    /* Total number of whole writable buffers */
+    int_fast32_t buffers_available() const;
+
+/*                               Read                               */
+
+    /* Returns pointer to first sample
+    of current read buffer */
+    T* get_read_buffer_sample();
+
+    /* Returns pointer to first byte
+    of current read buffer */
+    uint8_t* get_read_buffer_byte();
+
+    /* Returns pointer to next unread sample */
+    T* get_read_sample();
+
+    /* Returns pointer to next unread byte */
+    uint8_t* get_read_byte();
+
+    /* Copies samples from the ring to data pointer
+    and returns number of samples read */
+    int_fast32_t read_samples(T* data, int_fast32_t length);
+
+    /* Copies bytes from the ring to data pointer
+    and returns number of bytes read */
+    int_fast32_t read_bytes(uint8_t* data, int_fast32_t numBytes);
+
+    /* Publishes number of samples read externally */
+    void report_read_samples(int_fast32_t length);
+
+    /* Publishes number of bytes read externally */
+    void report_read_bytes(int_fast32_t numBytes);
+
+    /* Sleeps until at least length samples can be read
+    or timeoutMs elapses, and returns whether they can */
+    bool wait_readable(
+            int_fast32_t length,
+            int_fast32_t timeoutMs = RINGBUFF_WAIT_FOREVER
+        );
+
+/*                               Write                              */
+
+    /* Returns pointer to first sample
+    of current write buffer */
+    T* get_write_buffer_sample();
+
+    /* Returns pointer to first byte
+    of current write buffer */
+    uint8_t* get_write_buffer_byte();
+
+    /* Returns pointer to next writable sample */
+    T* get_write_sample();
+
+    /* Returns pointer to next writable byte */
+    uint8_t* get_write_byte();
+
+    /* Sets up to two contiguous regions that together hold
+    room for the next length samples, which may wrap around
+    the end of the ring.  Returns number of regions set,
+    or zero if fewer than length samples can be written. */
+    int_fast8_t get_write_regions(
+            int_fast32_t length,
+            T* regions[2],
+            int_fast32_t lengths[2]
+        );
+
+    /* Sets up to two contiguous regions that together hold
+    room for the next numBytes bytes */
+    int_fast8_t get_write_byte_regions(
+            int_fast32_t numBytes,
+            uint8_t* regions[2],
+            int_fast32_t lengths[2]
+        );
+
+    /* Copies samples from data pointer to the ring
+    and returns number of samples written */
+    int_fast32_t write_samples(const T* data, int_fast32_t length);
+
+    /* Copies bytes from data pointer to the ring
+    and returns number of bytes written */
+    int_fast32_t write_bytes(const uint8_t* data, int_fast32_t numBytes);
+
+    /* Publishes number of samples written externally */
+    void report_written_samples(int_fast32_t length);
+
+    /* Publishes number of bytes written externally */
+    void report_written_bytes(int_fast32_t numBytes);
+
+    /* Sleeps until at least length samples can be written
+    or timeoutMs elapses, and returns whether they can */
+    bool wait_writable(
+            int_fast32_t length,
+            int_fast32_t timeoutMs = RINGBUFF_WAIT_FOREVER
+        );
+
+};
+
+/*                            Definitions                           */
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+StaticRingBuffer<T, BufferLength, RingLength>::StaticRingBuffer()
+{
+    this->_ring.fill(T(0));
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::_wrap(
+        int_fast32_t position
+    )
+{
+    if constexpr (_powerOfTwo)
+    {
+        return position & (_positionModulus - 1);
+    }
+    else
+    {
+        return (
+                (position >= _positionModulus)
+                ? (position - _positionModulus)
+                : position
+            );
+    }
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::_index(
+        int_fast32_t position
+    )
+{
+    if constexpr (_powerOfTwo)
+    {
+        return position & (totalRingSampleLength - 1);
+    }
+    else
+    {
+        return (
+                (position >= totalRingSampleLength)
+                ? (position - totalRingSampleLength)
+                : position
+            );
+    }
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::_distance(
+        int_fast32_t from,
+        int_fast32_t to
+    )
+{
+    if constexpr (_powerOfTwo)
+    {
+        return (to - from) & (_positionModulus - 1);
+    }
+    else
+    {
+        return ((to >= from) ? (to - from) : (to + _positionModulus - from));
+    }
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr bool StaticRingBuffer<T, BufferLength, RingLength>::size_is_set() const
+{
+    return true;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::size() const
+{
+    return totalRingSampleLength;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::total_size() const
+{
+    return totalRingSampleLength * bytesPerSample;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr int_fast8_t StaticRingBuffer<T, BufferLength, RingLength>::ring_length() const
+{
+    return RingLength;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::buffer_length() const
+{
+    return BufferLength;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::bytes_per_sample() const
+{
+    return bytesPerSample;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+constexpr int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::bytes_per_buffer() const
+{
+    return BufferLength * bytesPerSample;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+void StaticRingBuffer<T, BufferLength, RingLength>::fill(T value)
+{
+    this->_ring.fill(value);
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+void StaticRingBuffer<T, BufferLength, RingLength>::reset()
+{
+    this->_writePosition.store(0, std::memory_order_relaxed);
+    this->_readPosition.store(0, std::memory_order_relaxed);
+    this->_cachedReadPosition = 0;
+    this->_cachedWritePosition = 0;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::buffered() const
+{
+    this->_cachedWritePosition = (
+            this->_writePosition.load(std::memory_order_acquire)
+        );
+    return _distance(
+            this->_readPosition.load(std::memory_order_relaxed),
+            this->_cachedWritePosition
+        );
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::bytes_buffered() const
+{
+    return buffered() * bytesPerSample;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::available() const
+{
+    this->_cachedReadPosition = (
+            this->_readPosition.load(std::memory_order_acquire)
+        );
+    return totalRingSampleLength - _distance(
+            this->_cachedReadPosition,
+            this->_writePosition.load(std::memory_order_relaxed)
+        );
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::bytes_available() const
+{
+    return available() * bytesPerSample;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::unread() const
+{
+    const int_fast32_t readPosition(
+            this->_readPosition.load(std::memory_order_relaxed)
+        );
+    const int_fast32_t contiguous(
+            BufferLength - (_index(readPosition) % BufferLength)
+        );
+
+    /* Only touch the producer's cache line
+    if the last observed position is insufficient */
+    int_fast32_t unreadSamples(
+            _distance(readPosition, this->_cachedWritePosition)
+        );
+    if (unreadSamples < contiguous) unreadSamples = buffered();
+
+    return std::min(unreadSamples, contiguous);
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::bytes_unread() const
+{
+    return unread() * bytesPerSample;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::unwritten() const
+{
+    const int_fast32_t writePosition(
+            this->_writePosition.load(std::memory_order_relaxed)
+        );
+    const int_fast32_t contiguous(
+            BufferLength - (_index(writePosition) % BufferLength)
+        );
+
+    /* Only touch the consumer's cache line
+    if the last observed position is insufficient */
+    int_fast32_t unwrittenSamples(
+            totalRingSampleLength
+            - _distance(this->_cachedReadPosition, writePosition)
+        );
+    if (unwrittenSamples < contiguous) unwrittenSamples = available();
+
+    return std::min(unwrittenSamples, contiguous);
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::bytes_unwritten() const
+{
+    return unwritten() * bytesPerSample;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::buffers_buffered() const
+{
+    return (buffered() / BufferLength);
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::buffers_available() const
+{
+    return (available() / BufferLength);
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline T* StaticRingBuffer<T, BufferLength, RingLength>::get_read_buffer_sample()
+{
+    const int_fast32_t index(
+            _index(this->_readPosition.load(std::memory_order_relaxed))
+        );
+    return this->_ring.data() + (index - (index % BufferLength));
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline uint8_t* StaticRingBuffer<T, BufferLength, RingLength>::get_read_buffer_byte()
+{
+    return reinterpret_cast<uint8_t*>(get_read_buffer_sample());
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline T* StaticRingBuffer<T, BufferLength, RingLength>::get_read_sample()
+{
+    return this->_ring.data() + _index(
+            this->_readPosition.load(std::memory_order_relaxed)
+        );
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline uint8_t* StaticRingBuffer<T, BufferLength, RingLength>::get_read_byte()
+{
+    return reinterpret_cast<uint8_t*>(get_read_sample());
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::read_samples(
+        T* data,
+        int_fast32_t length
+    )
+{
+    length = std::min(length, buffered());
+    if (length <= 0) return 0;
+
+    /* At most two copies; before and after the end of storage */
+    const int_fast32_t
+        index(_index(this->_readPosition.load(std::memory_order_relaxed))),
+        first(std::min(length, totalRingSampleLength - index));
+    std::memcpy(data, this->_ring.data() + index, first * sizeof(T));
+    if (first < length)
+    {
+        std::memcpy(data + first, this->_ring.data(), (length - first) * sizeof(T));
+    }
+
+    report_read_samples(length);
+    return length;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::read_bytes(
+        uint8_t* data,
+        int_fast32_t numBytes
+    )
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    return read_samples(
+            reinterpret_cast<T*>(data),
+            numBytes / bytesPerSample
+        ) * bytesPerSample;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline void StaticRingBuffer<T, BufferLength, RingLength>::report_read_samples(
+        int_fast32_t length
+    )
+{
+    const int_fast32_t readPosition(
+            this->_readPosition.load(std::memory_order_relaxed)
+        );
+
+    #if _DEBUG
+    if ((length <= 0) || (length > _distance(
+            readPosition,
+            this->_writePosition.load(std::memory_order_acquire)
+        )))
+    {
+        throw std::out_of_range("Length must be > 0 and <= samples buffered");
+    }
+    #endif
+
+    this->_readPosition.store(
+            _wrap(readPosition + length),
+            std::memory_order_release
+        );
+    this->_writable.notify();
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline void StaticRingBuffer<T, BufferLength, RingLength>::report_read_bytes(
+        int_fast32_t numBytes
+    )
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    report_read_samples(numBytes / bytesPerSample);
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+bool StaticRingBuffer<T, BufferLength, RingLength>::wait_readable(
+        int_fast32_t length,
+        int_fast32_t timeoutMs
+    )
+{
+    return this->_readable.wait(
+            [this, length]() { return (buffered() >= length); },
+            timeoutMs
+        );
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline T* StaticRingBuffer<T, BufferLength, RingLength>::get_write_buffer_sample()
+{
+    const int_fast32_t index(
+            _index(this->_writePosition.load(std::memory_order_relaxed))
+        );
+    return this->_ring.data() + (index - (index % BufferLength));
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline uint8_t* StaticRingBuffer<T, BufferLength, RingLength>::get_write_buffer_byte()
+{
+    return reinterpret_cast<uint8_t*>(get_write_buffer_sample());
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline T* StaticRingBuffer<T, BufferLength, RingLength>::get_write_sample()
+{
+    return this->_ring.data() + _index(
+            this->_writePosition.load(std::memory_order_relaxed)
+        );
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline uint8_t* StaticRingBuffer<T, BufferLength, RingLength>::get_write_byte()
+{
+    return reinterpret_cast<uint8_t*>(get_write_sample());
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+int_fast8_t StaticRingBuffer<T, BufferLength, RingLength>::get_write_regions(
+        int_fast32_t length,
+        T* regions[2],
+        int_fast32_t lengths[2]
+    )
+{
+    const int_fast32_t writePosition(
+            this->_writePosition.load(std::memory_order_relaxed)
+        );
+
+    /* Only touch the consumer's cache line
+    if the last observed position is insufficient */
+    if ((length <= 0) || ((
+            (totalRingSampleLength
+            - _distance(this->_cachedReadPosition, writePosition)) < length)
+            && (available() < length)
+        ))
+    {
+        return 0;
+    }
+
+    const int_fast32_t index(_index(writePosition));
+    regions[0] = this->_ring.data() + index;
+    lengths[0] = std::min(length, totalRingSampleLength - index);
+    if (lengths[0] == length) return 1;
+
+    regions[1] = this->_ring.data();
+    lengths[1] = length - lengths[0];
+    return 2;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+int_fast8_t StaticRingBuffer<T, BufferLength, RingLength>::get_write_byte_regions(
+        int_fast32_t numBytes,
+        uint8_t* regions[2],
+        int_fast32_t lengths[2]
+    )
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    T* sampleRegions[2];
+    const int_fast8_t numRegions(get_write_regions(
+            numBytes / bytesPerSample,
+            sampleRegions,
+            lengths
+        ));
+    for (int_fast8_t i(0); i < numRegions; ++i)
+    {
+        regions[i] = reinterpret_cast<uint8_t*>(sampleRegions[i]);
+        lengths[i] *= bytesPerSample;
+    }
+    return numRegions;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::write_samples(
+        const T* data,
+        int_fast32_t length
+    )
+{
+    length = std::min(length, available());
+    if (length <= 0) return 0;
+
+    /* At most two copies; before and after the end of storage */
+    const int_fast32_t
+        index(_index(this->_writePosition.load(std::memory_order_relaxed))),
+        first(std::min(length, totalRingSampleLength - index));
+    std::memcpy(this->_ring.data() + index, data, first * sizeof(T));
+    if (first < length)
+    {
+        std::memcpy(this->_ring.data(), data + first, (length - first) * sizeof(T));
+    }
+
+    report_written_samples(length);
+    return length;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+int_fast32_t StaticRingBuffer<T, BufferLength, RingLength>::write_bytes(
+        const uint8_t* data,
+        int_fast32_t numBytes
+    )
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    return write_samples(
+            reinterpret_cast<const T*>(data),
+            numBytes / bytesPerSample
+        ) * bytesPerSample;
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline void StaticRingBuffer<T, BufferLength, RingLength>::report_written_samples(
+        int_fast32_t length
+    )
+{
+    const int_fast32_t writePosition(
+            this->_writePosition.load(std::memory_order_relaxed)
+        );
+
+    #if _DEBUG
+    if ((length <= 0) || (length > (
+            totalRingSampleLength
+            - _distance(
+                    this->_readPosition.load(std::memory_order_acquire),
+                    writePosition
+                )
+        )))
+    {
+        throw std::out_of_range("Length must be > 0 and <= samples available");
+    }
+    #endif
+
+    this->_writePosition.store(
+            _wrap(writePosition + length),
+            std::memory_order_release
+        );
+    this->_readable.notify();
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+inline void StaticRingBuffer<T, BufferLength, RingLength>::report_written_bytes(
+        int_fast32_t numBytes
+    )
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    report_written_samples(numBytes / bytesPerSample);
+}
+
+template <typename T, int_fast32_t BufferLength, int_fast8_t RingLength>
+bool StaticRingBuffer<T, BufferLength, RingLength>::wait_writable(
+        int_fast32_t length,
+        int_fast32_t timeoutMs
+    )
+{
+    return this->_writable.wait(
+            [this, length]() { return (available() >= length); },
+            timeoutMs
+        );
+}
+
+};
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef WIFB_CODEC_H
+#define WIFB_CODEC_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "wifbframe.h"
+
+enum wifb_codec_err
+{
+    CODEC_UNSUPPORTED_FORMAT = -901,
+    CODEC_MALFORMED_PAYLOAD = -902,
+    CODEC_OUTPUT_TOO_SHORT = -903,
+};
+
+/* Largest payload growth over pcm of any codec,
+for sizing encoded buffers and datagrams */
+#define WIFB_CODEC_OVERHEAD(channels)       (2 + (4 * (channels)))
+
+/* Highest fixed predictor order of the lossless codec */
+#define WIFB_LOSSLESS_MAX_ORDER             (4)
+
+/* Codec stage between the ring and the socket.
+Encoders take one chunk of interleaved pcm, as up to two
+ring regions, and produce one frame payload; decoders turn
+the payload back into interleaved pcm.  8 bit pcm is unsigned
+and wider pcm signed little endian, as in the ring. */
+class WIFBCodec
+{
+
+protected:
+
+    uint8_t
+        _bitsPerSample,
+        _channels;
+
+public:
+
+    WIFBCodec(uint8_t bitsPerSample, uint8_t channels);
+
+    virtual ~WIFBCodec();
+
+    /* Payload encoding written to frame headers */
+    virtual uint8_t encoding() const = 0;
+
+    /* Largest payload that numBytes of pcm encodes to */
+    virtual int_fast32_t max_encoded_size(int_fast32_t numBytes) const = 0;
+
+    /* Encodes the pcm in regions to encoded, which must hold
+    max_encoded_size of the total, and returns its length */
+    virtual int_fast32_t encode(
+            uint8_t* encoded,
+            uint8_t* const regions[],
+            const int_fast32_t lengths[],
+            int_fast8_t numRegions
+        ) = 0;
+
+    /* Decodes a payload to at most capacity bytes of pcm and
+    returns the number of bytes, or a negative wifb_codec_err */
+    virtual int_fast32_t decode(
+            uint8_t* pcm,
+            int_fast32_t capacity,
+            const uint8_t* encoded,
+            int_fast32_t length
+        ) = 0;
+
+};
+
+/* Lossless codec in the style of FLAC's fixed subframes.
+Each channel of a chunk is predicted by the fixed polynomial
+of order 0 to 4 with the smallest residual, and residuals are
+Rice coded with one parameter per channel.  A channel that
+would not shrink is stored verbatim, so payloads never exceed
+the pcm by more than WIFB_CODEC_OVERHEAD.  Work per chunk is a
+fixed number of passes over its samples whatever the audio.
+
+Payload layout
+
+    0-1     frames in the chunk, little endian
+    then for each channel
+    0       predictor order, or 0x80 when verbatim
+            verbatim: every sample, little endian
+            otherwise: order warmup samples, little endian,
+            the Rice parameter, then the residual bit stream
+            padded to a whole byte
+*/
+class WIFBLosslessCodec : public WIFBCodec
+{
+
+protected:
+
+    /* Samples of each channel of a chunk, one run after another */
+    std::vector<int32_t> _samples;
+
+    template <typename R>
+    int_fast32_t _encode_channel(
+            uint8_t* encoded,
+            const int32_t* samples,
+            int_fast32_t numFrames
+        );
+
+    template <typename R>
+    int_fast32_t _decode_channel(
+            int32_t* samples,
+            int_fast32_t numFrames,
+            const uint8_t* encoded,
+            int_fast32_t length
+        );
+
+public:
+
+    WIFBLosslessCodec(uint8_t bitsPerSample, uint8_t channels);
+
+    ~WIFBLosslessCodec();
+
+    uint8_t encoding() const override;
+
+    int_fast32_t max_encoded_size(int_fast32_t numBytes) const override;
+
+    int_fast32_t encode(
+            uint8_t* encoded,
+            uint8_t* const regions[],
+            const int_fast32_t lengths[],
+            int_fast8_t numRegions
+        ) override;
+
+    int_fast32_t decode(
+            uint8_t* pcm,
+            int_fast32_t capacity,
+            const uint8_t* encoded,
+            int_fast32_t length
+        ) override;
+
+};
+
+/* IMA ADPCM, 4 bits per sample, for speech and monitoring feeds.
+Samples are reduced to 16 bits and each channel of a chunk is
+coded independently, so a lost chunk costs nothing more and
+there is no delay beyond the chunk itself.  Steps come from the
+standard IMA tables and quantization is done with masks rather
+than branches.  A chunk of 16 bit pcm shrinks close to 4 times,
+24 bit close to 6 times.
+
+Payload layout
+
+    0-1     frames in the chunk, little endian
+    then for each channel
+    0-1     first sample, 16 bit little endian
+    2       step index of the second sample
+    3       reserved, zero
+    then for each channel
+            a nibble per remaining frame, low nibble first,
+            padded to a whole byte
+*/
+class WIFBADPCMCodec : public WIFBCodec
+{
+
+protected:
+
+    /* Samples of each channel of a chunk, one run after another */
+    std::vector<int16_t> _samples;
+
+    /* Step index each channel's encoder ended the last chunk on,
+    so adaptation carries across chunks */
+    std::vector<uint8_t> _indices;
+
+public:
+
+    WIFBADPCMCodec(uint8_t bitsPerSample, uint8_t channels);
+
+    ~WIFBADPCMCodec();
+
+    uint8_t encoding() const override;
+
+    int_fast32_t max_encoded_size(int_fast32_t numBytes) const override;
+
+    int_fast32_t encode(
+            uint8_t* encoded,
+            uint8_t* const regions[],
+            const int_fast32_t lengths[],
+            int_fast8_t numRegions
+        ) override;
+
+    int_fast32_t decode(
+            uint8_t* pcm,
+            int_fast32_t capacity,
+            const uint8_t* encoded,
+            int_fast32_t length
+        ) override;
+
+};
+
+/* Codec for an encoding, or nullptr for pcm and unknown encodings */
+std::unique_ptr<WIFBCodec> make_codec(
+        uint8_t encoding,
+        uint8_t bitsPerSample,
+        uint8_t channels
+    );
+
+#endif
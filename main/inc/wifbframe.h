@@ -0,0 +1,214 @@
+#ifndef WIFB_FRAME_H
+#define WIFB_FRAME_H
+
+#include "debugmacros.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+enum wifb_frame_err
+{
+    FRAME_NOT_AWAITING_PAYLOAD = -701,
+    FRAME_PAYLOAD_LENGTH_MISMATCH = -702,
+};
+
+/* Size in bytes of the header preceding every frame */
+#define WIFB_FRAME_HEADER_SIZE              (16)
+
+/* High nibble of the first header byte; low nibble is the version */
+#define WIFB_FRAME_MAGIC                    (0xA0)
+#define WIFB_FRAME_MAGIC_MASK               (0xF0)
+
+/* Current frame format version */
+#define WIFB_FRAME_VERSION                  (1)
+
+/* Encoding of the frame payload */
+enum wifb_encoding
+{
+    WIFB_ENCODING_PCM = 0,
+
+    /* Fixed prediction and Rice coding, see WIFBLosslessCodec */
+    WIFB_ENCODING_LOSSLESS = 1,
+
+    /* 4 bit IMA ADPCM, see WIFBADPCMCodec */
+    WIFB_ENCODING_ADPCM = 2,
+};
+
+/* Little endian header layout
+
+    0       magic (high nibble) and version (low nibble)
+    1       payload encoding
+    2       bits per sample on the wire
+    3       number of channels
+    4-5     payload length in bytes
+    6-7     metadata length in bytes
+    8-11    sequence number
+    12-15   sample clock of the first sample in the payload
+*/
+struct WIFBFrameHeader
+{
+    uint8_t version;
+    uint8_t encoding;
+    uint8_t bitsPerSample;
+    uint8_t channels;
+    uint16_t payloadLength;
+    uint16_t metadataLength;
+    uint32_t sequence;
+    uint32_t timestamp;
+};
+
+/* Serialize header to WIFB_FRAME_HEADER_SIZE bytes */
+void encode_frame_header(const WIFBFrameHeader& header, uint8_t* outgoing);
+
+/* Deserialize header and return whether
+magic and version are valid */
+bool decode_frame_header(const uint8_t* incoming, WIFBFrameHeader* header);
+
+/* Produces consecutive headers for one stream */
+class WIFBFrameEncoder
+{
+
+protected:
+
+    WIFBFrameHeader _header;
+
+public:
+
+    /* Serialized header of the most recently encoded frame */
+    uint8_t data[WIFB_FRAME_HEADER_SIZE];
+
+public:
+
+    WIFBFrameEncoder();
+    WIFBFrameEncoder(uint8_t encoding, uint8_t bitsPerSample, uint8_t channels);
+
+    ~WIFBFrameEncoder();
+
+    /* Set format descriptor for subsequent frames */
+    void set_format(uint8_t encoding, uint8_t bitsPerSample, uint8_t channels);
+
+    /* Serialize the next header to data, then advance the
+    sequence by one and the sample clock by numSamples */
+    void encode(
+            uint16_t payloadLength,
+            uint16_t metadataLength,
+            uint32_t numSamples
+        );
+
+    /* Advance the sample clock past samples that were never sent,
+    and the sequence past the frames they would have filled, so
+    receivers scheduling by sequence conceal them instead of
+    playing everything after them late */
+    void skip_samples(uint32_t numSamples, uint32_t numFrames = 0);
+
+    /* Header of the most recently encoded frame */
+    const WIFBFrameHeader& header(void) const;
+
+};
+
+enum wifb_frame_state
+{
+    /* Waiting for header bytes */
+    FRAME_HEADER = 0,
+
+    /* Header is valid; caller must set payload regions */
+    FRAME_HEADER_COMPLETE = 1,
+
+    /* Waiting for payload and metadata bytes */
+    FRAME_BODY = 2,
+
+    /* Entire frame has been received */
+    FRAME_COMPLETE = 3,
+};
+
+/* Incremental, allocation-free stream parser.
+The parser never owns payload memory: it hands out the regions
+that the next bytes belong in, which may be written directly by
+recv/recvmsg, or filled from a stream buffer with parse().
+Headers with a bad magic, version or length are discarded
+one byte at a time until the stream is back on a frame boundary. */
+class WIFBFrameParser
+{
+
+protected:
+
+    wifb_frame_state _state;
+
+    uint8_t _headerData[WIFB_FRAME_HEADER_SIZE];
+    int_fast32_t _headerFilled;
+
+    WIFBFrameHeader _header;
+
+    int_fast32_t _maxPayloadLength, _maxMetadataLength;
+    uint8_t* _metadataDestination;
+
+    /* Up to two payload regions followed by metadata */
+    uint8_t* _regions[3];
+    int_fast32_t _lengths[3];
+    int_fast8_t _numRegions, _currentRegion;
+    int_fast32_t _regionFilled;
+
+    uint32_t _nextSequence;
+    bool _sequenceKnown;
+
+    uint_fast32_t _discardedBytes, _lostFrames;
+
+    /* Decode and validate a complete header */
+    bool _accept_header(void);
+
+    /* Shift header bytes to the next candidate magic byte */
+    void _resync(void);
+
+public:
+
+    WIFBFrameParser(
+            int_fast32_t maxPayloadLength,
+            uint8_t* metadataDestination,
+            int_fast32_t maxMetadataLength
+        );
+
+    ~WIFBFrameParser();
+
+    /* Current parser state */
+    wifb_frame_state state(void) const;
+
+    /* Header of the current frame; valid from FRAME_HEADER_COMPLETE */
+    const WIFBFrameHeader& header(void) const;
+
+    /* Sets up to three regions for the remaining bytes of the
+    current header or body and returns number of regions set.
+    Returns zero in FRAME_HEADER_COMPLETE and FRAME_COMPLETE. */
+    int_fast8_t next_regions(uint8_t* regions[3], int_fast32_t lengths[3]);
+
+    /* Report number of bytes written to regions from next_regions */
+    wifb_frame_state advance(int_fast32_t numBytes);
+
+    /* Set destination for the payload of the current frame.
+    Region lengths must total the header's payload length. */
+    void set_payload_regions(
+            uint8_t* const regions[],
+            const int_fast32_t lengths[],
+            int_fast8_t numRegions
+        );
+
+    /* Copy bytes from a stream buffer into the current regions
+    and return number of bytes consumed.  Stops early at
+    FRAME_HEADER_COMPLETE and FRAME_COMPLETE. */
+    int_fast32_t parse(const uint8_t* data, int_fast32_t length);
+
+    /* Begin waiting for the next header */
+    void next_frame(void);
+
+    /* Return and clear number of bytes discarded while resyncing */
+    uint_fast32_t discarded(void);
+
+    /* Return and clear number of frames missing from the sequence */
+    uint_fast32_t lost(void);
+
+    /* Discard any partial frame and forget sequence history */
+    void reset(void);
+
+};
+
+#endif
@@ -50,6 +50,10 @@ public:
     /* Copy data from external address */
     void set_data(const uint8_t* incoming);
 
+    /* Parse timecode after data
+    has been written in place */
+    void parse_data(void);
+
     /* Copy data to external address */
     void get_data(uint8_t* outgoing) const;
 
@@ -9,7 +9,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <future>
+#include <cerrno>
 
+#ifdef ESP_PLATFORM
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
@@ -23,19 +25,58 @@
 #include <lwip/err.h>
 #include <lwip/sys.h>
 #include <lwip/sockets.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 #include "espdelay.h"
 #include "private.h"
 
 /*                              Macros                              */
 
+#ifdef ESP_PLATFORM
 #define WIFI_CONNECTED_BIT                  BIT0
 #define WIFI_FAIL_BIT                       BIT1
+#endif
 
 #ifndef MAX_RETRY_COUNT
 #define MAX_RETRY_COUNT                     8
 #endif
 
+/* Largest UDP payload that avoids IP fragmentation on a 1500 byte MTU */
+#ifndef UDP_MAX_DATAGRAM_SIZE
+#define UDP_MAX_DATAGRAM_SIZE               (1472)
+#endif
+
+/* Flags for every send, so a send to a peer that has closed
+fails with EPIPE instead of raising SIGPIPE and ending the process */
+#ifdef MSG_NOSIGNAL
+#define WIFB_SEND_FLAGS                     (MSG_NOSIGNAL)
+#else
+#define WIFB_SEND_FLAGS                     (0)
+#endif
+
+/* Control handshake sent by receivers over tcp: mac address,
+udp audio port in network byte order, then the payload encoding
+the receiver asks for.  The transmitter falls back to its own
+default for an encoding it has no codec for, and every frame
+header names the encoding actually sent. */
+#define WIFB_HELLO_SIZE                     (9)
+
+/* Hello encoding asking for the transmitter's default */
+#define WIFB_HELLO_ANY_ENCODING             (0xFF)
+
+/* Control reply sent by transmitters over tcp after the hello when
+audio goes over udp: ipv4 group address and udp port in network
+byte order that every receiver's audio is sent to, or all zeros
+when audio is sent to the receiver's own port */
+#define WIFB_GROUP_SIZE                     (6)
+
 /*                           Declarations                           */
 
 struct WIFBDevice
@@ -43,6 +84,8 @@ struct WIFBDevice
     uint8_t mac[6];
     uint8_t ip[4];
     int sock{0};
+    uint16_t udpPort{0};
+    uint8_t encoding{WIFB_HELLO_ANY_ENCODING};
     std::atomic_bool
         networkConnected{false},
         socketConnected{false};
@@ -51,7 +94,54 @@ struct WIFBDevice
 std::string mac_addr_string(uint8_t addr[6]);
 std::string ip_addr_string(uint8_t addr[4]);
 std::string ip_addr_string(int addr);
+#ifdef ESP_PLATFORM
 std::string ip_addr_string(esp_ip4_addr_t addr);
+#endif
 bool match_mac_addr(const uint8_t addr1[6], const uint8_t addr2[6]);
 
+/* Advances an iovec array past a number of bytes
+and returns the index of the first incomplete iovec */
+int advance_iov(struct iovec* iov, int iovcnt, size_t numBytes);
+
+/* Sends every byte described by an iovec array without copying,
+resuming after partial sends.  Returns bytes sent or -1 on error. */
+int send_iov(int sock, struct iovec* iov, int iovcnt);
+
+/* Receives until every byte described by an iovec array is filled,
+reassembling frames split across short reads.  Returns bytes
+received, 0 if the peer closed the connection, or -1 on error. */
+int recv_iov(int sock, struct iovec* iov, int iovcnt);
+
+/* Creates a udp socket bound to port on any address,
+or to an ephemeral port if port is 0, and sets port
+to the bound port.  Returns the socket or -1 on error. */
+int open_udp_socket(uint16_t* port);
+
+/* Returns whether the peer of a connected
+stream socket has closed it, without blocking */
+bool peer_closed(int sock);
+
+/* Whether an ipv4 address is a multicast group */
+bool is_multicast_addr(const uint8_t addr[4]);
+
+/* Creates a udp socket connected to a multicast group or broadcast
+address and port, sending from the interface with address
+interfaceAddr, or the default interface if it is all zeros.
+Returns the socket or -1 on error. */
+int open_group_sender(
+        const uint8_t group[4],
+        uint16_t port,
+        const uint8_t interfaceAddr[4]
+    );
+
+/* Creates a udp socket bound to port on any address, shared with
+other receivers on the same host, and joins group on the interface
+with address interfaceAddr if group is a multicast address.
+Returns the socket or -1 on error. */
+int open_group_receiver(
+        const uint8_t group[4],
+        uint16_t port,
+        const uint8_t interfaceAddr[4]
+    );
+
 #endif
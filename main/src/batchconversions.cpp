@@ -0,0 +1,596 @@
+#include "batchconversions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#if !BATCHCONV_SCALAR && defined(__AVX2__)
+#include <immintrin.h>
+#define BATCHCONV_AVX2                      (1)
+#elif !BATCHCONV_SCALAR && defined(__SSE2__)
+#include <emmintrin.h>
+#define BATCHCONV_SSE2                      (1)
+#elif !BATCHCONV_SCALAR && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define BATCHCONV_NEON                      (1)
+#endif
+
+/* Samples per vector block, one dither generator each */
+#define BATCHCONV_BLOCK                     (TPDF_DITHER_LANES)
+
+/* Samples per pass through the 32 bit
+staging buffer when converting packed samples */
+#define BATCHCONV_STAGING                   (32 * (BATCHCONV_BLOCK))
+
+TPDFDither::TPDFDither(uint32_t value)
+{
+    seed(value);
+}
+
+void TPDFDither::seed(uint32_t value)
+{
+    /* Spread the generators apart with a Weyl sequence,
+    skipping any that would land on the zero state */
+    for (int_fast8_t i(0); i < TPDF_DITHER_LANES; ++i)
+    {
+        value += 0x9E3779B9;
+        this->state[i] = value ? value : 1;
+    }
+}
+
+/* Scaling and saturation constants of a sample format */
+template <typename I, int_fast8_t Bits>
+struct SampleFormat
+{
+    static_assert(
+            (Bits <= 32) && (Bits <= static_cast<int_fast8_t>(sizeof(I) * 8)),
+            "Samples must fit in 32 bit containers"
+        );
+
+    /* Float value of full scale */
+    static constexpr float scale = static_cast<float>(1ULL << (Bits - 1));
+
+    /* Whether saturation is exact in float; wider samples
+    are saturated after conversion instead */
+    static constexpr bool floatSaturation = (Bits <= 24);
+
+    static constexpr float minimum = -scale;
+    static constexpr float maximum = scale - 1.0f;
+
+    /* Added to signed results to give unsigned samples */
+    static constexpr int32_t offset = (
+            std::is_unsigned<I>::value ? static_cast<int32_t>(1ULL << (Bits - 1)) : 0
+        );
+};
+
+static inline float next_dither(uint32_t* state)
+{
+    uint32_t x(*state);
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return static_cast<float>(
+            static_cast<int32_t>(x & 0xFFFF) - static_cast<int32_t>(x >> 16)
+        ) * (1.0f / 65536.0f);
+}
+
+/* Scalar conversion, matching the vector paths bit for bit.
+Comparisons are ordered like the sse min and max instructions,
+so NaN saturates to the minimum, and rounding adds and removes
+2 ^ 23 rather than calling into libm, which is slow on Xtensa. */
+template <typename I, int_fast8_t Bits>
+static inline I to_int(float value, float dither)
+{
+    typedef SampleFormat<I, Bits> F;
+    float scaled((value * F::scale) + dither);
+
+    if constexpr (F::floatSaturation)
+    {
+        scaled = (scaled > F::minimum) ? scaled : F::minimum;
+        scaled = (scaled < F::maximum) ? scaled : F::maximum;
+    }
+    else
+    {
+        scaled = (scaled > F::minimum) ? scaled : F::minimum;
+        if (scaled >= F::scale) return std::numeric_limits<I>::max();
+        if (std::fabs(scaled) >= 8388608.0f)
+        {
+            /* Already integral */
+            return static_cast<I>(static_cast<int32_t>(scaled));
+        }
+    }
+
+    const float magic(std::copysign(8388608.0f, scaled));
+    scaled = (scaled + magic) - magic;
+    return static_cast<I>(static_cast<int32_t>(scaled) + F::offset);
+}
+
+template <typename I, int_fast8_t Bits>
+static inline float to_float(I value)
+{
+    typedef SampleFormat<I, Bits> F;
+    return (
+            static_cast<float>(static_cast<int32_t>(value) - F::offset)
+            * (1.0f / F::scale)
+        );
+}
+
+#if BATCHCONV_AVX2 || BATCHCONV_SSE2
+
+/* Narrows eight 32 bit results, already in range, into samples */
+template <typename I>
+static inline void store_block(I* converted, __m128i lo, __m128i hi)
+{
+    if constexpr (sizeof(I) == 4)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(converted), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(converted + 4), hi);
+    }
+    else if constexpr (sizeof(I) == 2)
+    {
+        _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(converted),
+                _mm_packs_epi32(lo, hi)
+            );
+    }
+    else
+    {
+        const __m128i packed(_mm_packs_epi32(lo, hi));
+        _mm_storel_epi64(
+                reinterpret_cast<__m128i*>(converted),
+                _mm_packus_epi16(packed, packed)
+            );
+    }
+}
+
+#endif
+
+#if BATCHCONV_AVX2
+
+struct DitherLanes
+{
+    __m256i state;
+
+    DitherLanes(const uint32_t* values) :
+    state(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)))
+    {
+    }
+
+    void save(uint32_t* values) const
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values), this->state);
+    }
+
+    inline __m256i next()
+    {
+        __m256i x(this->state);
+        x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+        x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+        this->state = x;
+        return x;
+    }
+};
+
+static inline __m256 dither_values(__m256i x)
+{
+    const __m256i difference(_mm256_sub_epi32(
+            _mm256_and_si256(x, _mm256_set1_epi32(0xFFFF)),
+            _mm256_srli_epi32(x, 16)
+        ));
+    return _mm256_mul_ps(
+            _mm256_cvtepi32_ps(difference),
+            _mm256_set1_ps(1.0f / 65536.0f)
+        );
+}
+
+template <typename I, int_fast8_t Bits, bool Dithered>
+static inline void to_int_block(I* converted, const float* values, DitherLanes* dither)
+{
+    typedef SampleFormat<I, Bits> F;
+    __m256 scaled(_mm256_mul_ps(_mm256_loadu_ps(values), _mm256_set1_ps(F::scale)));
+    if constexpr (Dithered)
+    {
+        scaled = _mm256_add_ps(scaled, dither_values(dither->next()));
+    }
+    scaled = _mm256_max_ps(scaled, _mm256_set1_ps(F::minimum));
+
+    __m256i result;
+    if constexpr (F::floatSaturation)
+    {
+        scaled = _mm256_min_ps(scaled, _mm256_set1_ps(F::maximum));
+        result = _mm256_cvtps_epi32(scaled);
+    }
+    else
+    {
+        /* Out of range lanes convert to INT32_MIN; flip the positive ones */
+        result = _mm256_xor_si256(
+                _mm256_cvtps_epi32(scaled),
+                _mm256_castps_si256(_mm256_cmp_ps(
+                        scaled,
+                        _mm256_set1_ps(F::scale),
+                        _CMP_GE_OQ
+                    ))
+            );
+    }
+    if constexpr (F::offset != 0)
+    {
+        result = _mm256_add_epi32(result, _mm256_set1_epi32(F::offset));
+    }
+
+    store_block<I>(
+            converted,
+            _mm256_castsi256_si128(result),
+            _mm256_extracti128_si256(result, 1)
+        );
+}
+
+template <typename I, int_fast8_t Bits>
+static inline void to_float_block(float* converted, const I* values)
+{
+    typedef SampleFormat<I, Bits> F;
+    __m256i widened;
+    if constexpr (sizeof(I) == 4)
+    {
+        widened = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+    }
+    else if constexpr (sizeof(I) == 2)
+    {
+        widened = _mm256_cvtepi16_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(values))
+            );
+    }
+    else
+    {
+        widened = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(values))
+            );
+    }
+    if constexpr (F::offset != 0)
+    {
+        widened = _mm256_sub_epi32(widened, _mm256_set1_epi32(F::offset));
+    }
+    _mm256_storeu_ps(converted, _mm256_mul_ps(
+            _mm256_cvtepi32_ps(widened),
+            _mm256_set1_ps(1.0f / F::scale)
+        ));
+}
+
+#elif BATCHCONV_SSE2
+
+struct DitherLanes
+{
+    __m128i state[2];
+
+    DitherLanes(const uint32_t* values) :
+    state{
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(values)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + 4))
+        }
+    {
+    }
+
+    void save(uint32_t* values) const
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values), this->state[0]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + 4), this->state[1]);
+    }
+
+    inline __m128 next(int_fast8_t half)
+    {
+        __m128i x(this->state[half]);
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+        this->state[half] = x;
+
+        const __m128i difference(_mm_sub_epi32(
+                _mm_and_si128(x, _mm_set1_epi32(0xFFFF)),
+                _mm_srli_epi32(x, 16)
+            ));
+        return _mm_mul_ps(_mm_cvtepi32_ps(difference), _mm_set1_ps(1.0f / 65536.0f));
+    }
+};
+
+template <typename I, int_fast8_t Bits, bool Dithered>
+static inline __m128i to_int_lanes(const float* values, DitherLanes* dither, int_fast8_t half)
+{
+    typedef SampleFormat<I, Bits> F;
+    __m128 scaled(_mm_mul_ps(_mm_loadu_ps(values), _mm_set1_ps(F::scale)));
+    if constexpr (Dithered) scaled = _mm_add_ps(scaled, dither->next(half));
+    scaled = _mm_max_ps(scaled, _mm_set1_ps(F::minimum));
+
+    __m128i result;
+    if constexpr (F::floatSaturation)
+    {
+        scaled = _mm_min_ps(scaled, _mm_set1_ps(F::maximum));
+        result = _mm_cvtps_epi32(scaled);
+    }
+    else
+    {
+        /* Out of range lanes convert to INT32_MIN; flip the positive ones */
+        result = _mm_xor_si128(
+                _mm_cvtps_epi32(scaled),
+                _mm_castps_si128(_mm_cmpge_ps(scaled, _mm_set1_ps(F::scale)))
+            );
+    }
+    if constexpr (F::offset != 0)
+    {
+        result = _mm_add_epi32(result, _mm_set1_epi32(F::offset));
+    }
+    return result;
+}
+
+template <typename I, int_fast8_t Bits, bool Dithered>
+static inline void to_int_block(I* converted, const float* values, DitherLanes* dither)
+{
+    const __m128i lo(to_int_lanes<I, Bits, Dithered>(values, dither, 0));
+    const __m128i hi(to_int_lanes<I, Bits, Dithered>(values + 4, dither, 1));
+    store_block<I>(converted, lo, hi);
+}
+
+template <typename I, int_fast8_t Bits>
+static inline void to_float_block(float* converted, const I* values)
+{
+    typedef SampleFormat<I, Bits> F;
+    __m128i lo, hi;
+    if constexpr (sizeof(I) == 4)
+    {
+        lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+        hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + 4));
+    }
+    else if constexpr (sizeof(I) == 2)
+    {
+        /* Sign extend by shifting each sample down from the upper half */
+        const __m128i samples(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values)));
+        lo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        hi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+    }
+    else
+    {
+        const __m128i zero(_mm_setzero_si128());
+        const __m128i samples(_mm_unpacklo_epi8(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(values)),
+                zero
+            ));
+        lo = _mm_unpacklo_epi16(samples, zero);
+        hi = _mm_unpackhi_epi16(samples, zero);
+    }
+    if constexpr (F::offset != 0)
+    {
+        lo = _mm_sub_epi32(lo, _mm_set1_epi32(F::offset));
+        hi = _mm_sub_epi32(hi, _mm_set1_epi32(F::offset));
+    }
+    const __m128 reciprocal(_mm_set1_ps(1.0f / F::scale));
+    _mm_storeu_ps(converted, _mm_mul_ps(_mm_cvtepi32_ps(lo), reciprocal));
+    _mm_storeu_ps(converted + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), reciprocal));
+}
+
+#elif BATCHCONV_NEON
+
+struct DitherLanes
+{
+    uint32x4_t state[2];
+
+    DitherLanes(const uint32_t* values) :
+    state{vld1q_u32(values), vld1q_u32(values + 4)}
+    {
+    }
+
+    void save(uint32_t* values) const
+    {
+        vst1q_u32(values, this->state[0]);
+        vst1q_u32(values + 4, this->state[1]);
+    }
+
+    inline float32x4_t next(int_fast8_t half)
+    {
+        uint32x4_t x(this->state[half]);
+        x = veorq_u32(x, vshlq_n_u32(x, 13));
+        x = veorq_u32(x, vshrq_n_u32(x, 17));
+        x = veorq_u32(x, vshlq_n_u32(x, 5));
+        this->state[half] = x;
+
+        const int32x4_t difference(vsubq_s32(
+                vreinterpretq_s32_u32(vandq_u32(x, vdupq_n_u32(0xFFFF))),
+                vreinterpretq_s32_u32(vshrq_n_u32(x, 16))
+            ));
+        return vmulq_n_f32(vcvtq_f32_s32(difference), 1.0f / 65536.0f);
+    }
+};
+
+template <typename I, int_fast8_t Bits, bool Dithered>
+static inline int32x4_t to_int_lanes(const float* values, DitherLanes* dither, int_fast8_t half)
+{
+    typedef SampleFormat<I, Bits> F;
+    float32x4_t scaled(vmulq_n_f32(vld1q_f32(values), F::scale));
+    if constexpr (Dithered) scaled = vaddq_f32(scaled, dither->next(half));
+
+    /* Selects rather than vmaxq so NaN saturates to the minimum as on sse */
+    const float32x4_t minimum(vdupq_n_f32(F::minimum));
+    scaled = vbslq_f32(vcgtq_f32(scaled, minimum), scaled, minimum);
+    if constexpr (F::floatSaturation)
+    {
+        const float32x4_t maximum(vdupq_n_f32(F::maximum));
+        scaled = vbslq_f32(vcltq_f32(scaled, maximum), scaled, maximum);
+    }
+
+    /* Converting saturates the 32 bit range by itself */
+    int32x4_t result(vcvtnq_s32_f32(scaled));
+    if constexpr (F::offset != 0) result = vaddq_s32(result, vdupq_n_s32(F::offset));
+    return result;
+}
+
+template <typename I, int_fast8_t Bits, bool Dithered>
+static inline void to_int_block(I* converted, const float* values, DitherLanes* dither)
+{
+    const int32x4_t lo(to_int_lanes<I, Bits, Dithered>(values, dither, 0));
+    const int32x4_t hi(to_int_lanes<I, Bits, Dithered>(values + 4, dither, 1));
+    if constexpr (sizeof(I) == 4)
+    {
+        vst1q_s32(reinterpret_cast<int32_t*>(converted), lo);
+        vst1q_s32(reinterpret_cast<int32_t*>(converted) + 4, hi);
+    }
+    else if constexpr (sizeof(I) == 2)
+    {
+        vst1q_s16(
+                reinterpret_cast<int16_t*>(converted),
+                vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))
+            );
+    }
+    else
+    {
+        vst1_u8(
+                reinterpret_cast<uint8_t*>(converted),
+                vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)))
+            );
+    }
+}
+
+template <typename I, int_fast8_t Bits>
+static inline void to_float_block(float* converted, const I* values)
+{
+    typedef SampleFormat<I, Bits> F;
+    int32x4_t lo, hi;
+    if constexpr (sizeof(I) == 4)
+    {
+        lo = vld1q_s32(reinterpret_cast<const int32_t*>(values));
+        hi = vld1q_s32(reinterpret_cast<const int32_t*>(values) + 4);
+    }
+    else if constexpr (sizeof(I) == 2)
+    {
+        const int16x8_t samples(vld1q_s16(reinterpret_cast<const int16_t*>(values)));
+        lo = vmovl_s16(vget_low_s16(samples));
+        hi = vmovl_high_s16(samples);
+    }
+    else
+    {
+        const uint16x8_t samples(vmovl_u8(vld1_u8(reinterpret_cast<const uint8_t*>(values))));
+        lo = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(samples)));
+        hi = vreinterpretq_s32_u32(vmovl_high_u16(samples));
+    }
+    if constexpr (F::offset != 0)
+    {
+        lo = vsubq_s32(lo, vdupq_n_s32(F::offset));
+        hi = vsubq_s32(hi, vdupq_n_s32(F::offset));
+    }
+    vst1q_f32(converted, vmulq_n_f32(vcvtq_f32_s32(lo), 1.0f / F::scale));
+    vst1q_f32(converted + 4, vmulq_n_f32(vcvtq_f32_s32(hi), 1.0f / F::scale));
+}
+
+#endif
+
+template <typename I, int_fast8_t Bits>
+void float_to_int_batch(
+        I* converted,
+        const float* values,
+        int_fast32_t length,
+        TPDFDither* dither
+    )
+{
+    int_fast32_t i(0);
+
+    #if BATCHCONV_AVX2 || BATCHCONV_SSE2 || BATCHCONV_NEON
+    if (dither)
+    {
+        DitherLanes lanes(dither->state);
+        for (; (i + BATCHCONV_BLOCK) <= length; i += BATCHCONV_BLOCK)
+        {
+            to_int_block<I, Bits, true>(converted + i, values + i, &lanes);
+        }
+        lanes.save(dither->state);
+    }
+    else
+    {
+        for (; (i + BATCHCONV_BLOCK) <= length; i += BATCHCONV_BLOCK)
+        {
+            to_int_block<I, Bits, false>(converted + i, values + i, nullptr);
+        }
+    }
+    #endif
+
+    /* Whole blocks end on a multiple of the generator
+    count, so i % TPDF_DITHER_LANES picks the same
+    generator here as the vector lanes would have */
+    if (dither)
+    {
+        for (; i < length; ++i)
+        {
+            converted[i] = to_int<I, Bits>(
+                    values[i],
+                    next_dither(&dither->state[i % TPDF_DITHER_LANES])
+                );
+        }
+    }
+    else
+    {
+        for (; i < length; ++i) converted[i] = to_int<I, Bits>(values[i], 0.0f);
+    }
+}
+
+template <typename I, int_fast8_t Bits>
+void int_to_float_batch(
+        float* converted,
+        const I* values,
+        int_fast32_t length
+    )
+{
+    int_fast32_t i(0);
+
+    #if BATCHCONV_AVX2 || BATCHCONV_SSE2 || BATCHCONV_NEON
+    for (; (i + BATCHCONV_BLOCK) <= length; i += BATCHCONV_BLOCK)
+    {
+        to_float_block<I, Bits>(converted + i, values + i);
+    }
+    #endif
+
+    for (; i < length; ++i) converted[i] = to_float<I, Bits>(values[i]);
+}
+
+template <>
+void float_to_int_batch<Int24, 24>(
+        Int24* converted,
+        const float* values,
+        int_fast32_t length,
+        TPDFDither* dither
+    )
+{
+    /* Passes are whole blocks, so dither generators line up as in one call */
+    int32_t staging[BATCHCONV_STAGING];
+    for (int_fast32_t i(0); i < length; i += BATCHCONV_STAGING)
+    {
+        const int_fast32_t count(std::min<int_fast32_t>(BATCHCONV_STAGING, length - i));
+        float_to_int_batch<int32_t, 24>(staging, values + i, count, dither);
+        pack_int24(converted + i, staging, count);
+    }
+}
+
+template <>
+void int_to_float_batch<Int24, 24>(
+        float* converted,
+        const Int24* values,
+        int_fast32_t length
+    )
+{
+    int32_t staging[BATCHCONV_STAGING];
+    for (int_fast32_t i(0); i < length; i += BATCHCONV_STAGING)
+    {
+        const int_fast32_t count(std::min<int_fast32_t>(BATCHCONV_STAGING, length - i));
+        unpack_int24(staging, values + i, count);
+        int_to_float_batch<int32_t, 24>(converted + i, staging, count);
+    }
+}
+
+/* 8 bit samples are unsigned and wider samples signed, as on the i2s bus */
+
+template void float_to_int_batch<uint8_t, 8>(uint8_t*, const float*, int_fast32_t, TPDFDither*);
+template void float_to_int_batch<int16_t, 16>(int16_t*, const float*, int_fast32_t, TPDFDither*);
+template void float_to_int_batch<int32_t, 24>(int32_t*, const float*, int_fast32_t, TPDFDither*);
+template void float_to_int_batch<int32_t, 32>(int32_t*, const float*, int_fast32_t, TPDFDither*);
+
+template void int_to_float_batch<uint8_t, 8>(float*, const uint8_t*, int_fast32_t);
+template void int_to_float_batch<int16_t, 16>(float*, const int16_t*, int_fast32_t);
+template void int_to_float_batch<int32_t, 24>(float*, const int32_t*, int_fast32_t);
+template void int_to_float_batch<int32_t, 32>(float*, const int32_t*, int_fast32_t);
@@ -0,0 +1,777 @@
+#include "broadcastringbuffer.h"
+
+using namespace Buffer;
+
+template <typename T>
+BroadcastRingBuffer<T>::BroadcastRingBuffer() :
+_ring(nullptr),
+_arena(nullptr),
+_ringLength(0),
+_bufferLength(0),
+_bytesPerBuffer(0),
+_totalRingSampleLength(0),
+_maxLag(0),
+_positionModulus(0)
+{
+}
+
+template <typename T>
+BroadcastRingBuffer<T>::BroadcastRingBuffer(
+        int_fast32_t bufferSize,
+        int_fast8_t ringSize,
+        broadcast_policy policy
+    ) :
+BroadcastRingBuffer()
+{
+    set_policy(policy);
+    set_size(bufferSize, ringSize);
+}
+
+template <typename T>
+BroadcastRingBuffer<T>::~BroadcastRingBuffer()
+{
+    _deallocate();
+}
+
+template <typename T>
+inline size_t BroadcastRingBuffer<T>::_storage_size() const
+{
+    /* Round allocation up to a whole number of cache lines */
+    return (
+            (static_cast<size_t>(this->_totalRingSampleLength) * sizeof(T))
+            + (RINGBUFF_CACHE_LINE_SIZE - 1)
+        ) & ~static_cast<size_t>(RINGBUFF_CACHE_LINE_SIZE - 1);
+}
+
+template <typename T>
+void BroadcastRingBuffer<T>::_allocate()
+{
+    const size_t numBytes(_storage_size());
+    if (this->_arena)
+    {
+        this->_ring = static_cast<T*>(this->_arena->allocate(numBytes));
+        if (this->_ring == nullptr) throw std::bad_alloc();
+    }
+    else
+    {
+        this->_ring = static_cast<T*>(::operator new(
+                numBytes,
+                std::align_val_t(RINGBUFF_CACHE_LINE_SIZE)
+            ));
+    }
+    std::fill(this->_ring, this->_ring + this->_totalRingSampleLength, T(0));
+}
+
+template <typename T>
+void BroadcastRingBuffer<T>::_deallocate()
+{
+    if (this->_ring == nullptr) return;
+    if (this->_arena)
+    {
+        this->_arena->deallocate(this->_ring, _storage_size());
+    }
+    else
+    {
+        ::operator delete(
+                this->_ring,
+                std::align_val_t(RINGBUFF_CACHE_LINE_SIZE)
+            );
+    }
+    this->_ring = nullptr;
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::_wrap(int_fast32_t position) const
+{
+    return (
+            (position >= this->_positionModulus)
+            ? (position - this->_positionModulus)
+            : position
+        );
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::_index(int_fast32_t position) const
+{
+    return (position % this->_totalRingSampleLength);
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::_distance(
+        int_fast32_t from,
+        int_fast32_t to
+    ) const
+{
+    return ((to >= from) ? (to - from) : (to + this->_positionModulus - from));
+}
+
+template <typename T>
+void BroadcastRingBuffer<T>::_update_slowest_reader() const
+{
+    const int_fast32_t writePosition(
+            this->_writePosition.load(std::memory_order_relaxed)
+        );
+    int_fast32_t greatestLag(-1);
+
+    for (const ReaderCursor& cursor: this->_readers)
+    {
+        if (cursor.state.load(std::memory_order_acquire) != READER_ACTIVE)
+        {
+            continue;
+        }
+        const int_fast32_t position(
+                cursor.position.load(std::memory_order_acquire)
+            );
+        const int_fast32_t lag(_distance(position, writePosition));
+        if (lag > greatestLag)
+        {
+            greatestLag = lag;
+            this->_cachedSlowestPosition = position;
+        }
+    }
+
+    this->_cachedHasReaders = (greatestLag >= 0);
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::_catch_up(int_fast8_t reader)
+{
+    ReaderCursor& cursor = this->_readers[reader];
+    const int_fast32_t position(
+            cursor.position.load(std::memory_order_relaxed)
+        );
+
+    if (policy() != OVERWRITE_SLOWEST_READER) return position;
+
+    const int_fast32_t lag(_distance(
+            position,
+            this->_writePosition.load(std::memory_order_acquire)
+        ));
+    if (lag <= this->_maxLag) return position;
+
+    /* Skip whole buffers to preserve chunk alignment */
+    const int_fast32_t skip(
+            (
+                (lag - this->_maxLag + this->_bufferLength - 1)
+                / this->_bufferLength
+            ) * this->_bufferLength
+        );
+    cursor.skipped.fetch_add(skip, std::memory_order_relaxed);
+    const int_fast32_t snapped(_wrap(position + skip));
+    cursor.position.store(snapped, std::memory_order_release);
+    return snapped;
+}
+
+template <typename T>
+bool BroadcastRingBuffer<T>::size_is_set() const
+{
+    return (this->_ring != nullptr);
+}
+
+template <typename T>
+void BroadcastRingBuffer<T>::set_size(
+        int_fast32_t bufferSize,
+        int_fast8_t ringSize
+    )
+{
+    #if _DEBUG
+    /* There must be multiple buffers to rotate */
+    if (ringSize < 2) throw RING_SIZE_TOO_SHORT;
+
+    /* Assert that total ring size in bytes
+    leaves room for reader lag measurement */
+    if (bufferSize > (
+            std::numeric_limits<int32_t>::max()
+            / 4
+            / static_cast<int_fast32_t>(ringSize)
+            / bytesPerSample
+        ))
+    {
+        throw BUFFER_LENGTH_TOO_LONG;
+    }
+
+    /* Buffer length must be an even number */
+    if (bufferSize % 2) throw UNEVEN_BUFFER_LENGTH;
+    #endif
+
+    _deallocate();
+    this->_ringLength = ringSize;
+    this->_bufferLength = bufferSize;
+    this->_bytesPerBuffer = this->_bufferLength * bytesPerSample;
+    this->_totalRingSampleLength = this->_ringLength * this->_bufferLength;
+    this->_maxLag = this->_totalRingSampleLength - this->_bufferLength;
+    this->_positionModulus = (
+            (std::numeric_limits<int32_t>::max() / 2)
+            / this->_totalRingSampleLength
+            * this->_totalRingSampleLength
+        );
+    _allocate();
+    reset();
+}
+
+template <typename T>
+void BroadcastRingBuffer<T>::set_arena(Arena* arena)
+{
+    if (arena == this->_arena) return;
+    _deallocate();
+    this->_arena = arena;
+    if (this->_totalRingSampleLength > 0)
+    {
+        _allocate();
+        reset();
+    }
+}
+
+template <typename T>
+void BroadcastRingBuffer<T>::set_policy(broadcast_policy policy)
+{
+    this->_policy.store(policy, std::memory_order_relaxed);
+}
+
+template <typename T>
+inline broadcast_policy BroadcastRingBuffer<T>::policy() const
+{
+    return static_cast<broadcast_policy>(
+            this->_policy.load(std::memory_order_relaxed)
+        );
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::size() const
+{
+    return this->_totalRingSampleLength;
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::total_size() const
+{
+    return this->_totalRingSampleLength * bytesPerSample;
+}
+
+template <typename T>
+int_fast8_t BroadcastRingBuffer<T>::ring_length() const
+{
+    return this->_ringLength;
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::buffer_length() const
+{
+    return this->_bufferLength;
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::bytes_per_sample() const
+{
+    return bytesPerSample;
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::bytes_per_buffer() const
+{
+    return this->_bytesPerBuffer;
+}
+
+template <typename T>
+void BroadcastRingBuffer<T>::fill(T value)
+{
+    std::fill(this->_ring, this->_ring + this->_totalRingSampleLength, value);
+}
+
+template <typename T>
+void BroadcastRingBuffer<T>::reset()
+{
+    this->_writePosition.store(0, std::memory_order_relaxed);
+    for (ReaderCursor& cursor: this->_readers)
+    {
+        cursor.position.store(0, std::memory_order_relaxed);
+        cursor.skipped.store(0, std::memory_order_relaxed);
+        cursor.overrun.store(0, std::memory_order_relaxed);
+    }
+    this->_cachedSlowestPosition = 0;
+    this->_cachedHasReaders = false;
+}
+
+template <typename T>
+int_fast8_t BroadcastRingBuffer<T>::add_reader()
+{
+    for (int_fast8_t i(0); i < RINGBUFF_MAX_READERS; ++i)
+    {
+        ReaderCursor& cursor = this->_readers[i];
+        int_fast8_t expected(READER_FREE);
+        if (!cursor.state.compare_exchange_strong(
+                expected,
+                READER_CLAIMED,
+                std::memory_order_acq_rel
+            ))
+        {
+            continue;
+        }
+
+        /* New readers start at the live edge */
+        cursor.position.store(
+                this->_writePosition.load(std::memory_order_acquire),
+                std::memory_order_relaxed
+            );
+        cursor.skipped.store(0, std::memory_order_relaxed);
+        cursor.overrun.store(0, std::memory_order_relaxed);
+        cursor.state.store(READER_ACTIVE, std::memory_order_release);
+        return i;
+    }
+    return READER_LIMIT_REACHED;
+}
+
+template <typename T>
+void BroadcastRingBuffer<T>::remove_reader(int_fast8_t reader)
+{
+    #if _DEBUG
+    if ((reader < 0) || (reader >= RINGBUFF_MAX_READERS))
+    {
+        throw READER_NOT_REGISTERED;
+    }
+    #endif
+
+    this->_readers[reader].state.store(READER_FREE, std::memory_order_release);
+    this->_writable.notify();
+}
+
+template <typename T>
+int_fast8_t BroadcastRingBuffer<T>::num_readers() const
+{
+    int_fast8_t count(0);
+    for (const ReaderCursor& cursor: this->_readers)
+    {
+        count += (
+                cursor.state.load(std::memory_order_relaxed)
+                == READER_ACTIVE
+            );
+    }
+    return count;
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::skipped(int_fast8_t reader)
+{
+    return this->_readers[reader].skipped.exchange(
+            0,
+            std::memory_order_relaxed
+        );
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::overrun(int_fast8_t reader)
+{
+    return this->_readers[reader].overrun.exchange(
+            0,
+            std::memory_order_relaxed
+        );
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::buffered(int_fast8_t reader)
+{
+    #if _DEBUG
+    if (
+            this->_readers[reader].state.load(std::memory_order_relaxed)
+            != READER_ACTIVE
+        )
+    {
+        throw READER_NOT_REGISTERED;
+    }
+    #endif
+
+    const int_fast32_t position(_catch_up(reader));
+    return _distance(
+            position,
+            this->_writePosition.load(std::memory_order_acquire)
+        );
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::bytes_buffered(int_fast8_t reader)
+{
+    return buffered(reader) * bytesPerSample;
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::unread(int_fast8_t reader)
+{
+    const int_fast32_t unreadSamples(buffered(reader));
+    const int_fast32_t contiguous(
+            this->_bufferLength
+            - (_index(
+                    this->_readers[reader].position.load(
+                            std::memory_order_relaxed
+                        )
+                ) % this->_bufferLength)
+        );
+    return std::min(unreadSamples, contiguous);
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::bytes_unread(int_fast8_t reader)
+{
+    return unread(reader) * bytesPerSample;
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::buffers_buffered(int_fast8_t reader)
+{
+    return (buffered(reader) / this->_bufferLength);
+}
+
+template <typename T>
+inline T* BroadcastRingBuffer<T>::get_read_sample(int_fast8_t reader)
+{
+    return this->_ring + _index(
+            this->_readers[reader].position.load(std::memory_order_relaxed)
+        );
+}
+
+template <typename T>
+inline uint8_t* BroadcastRingBuffer<T>::get_read_byte(int_fast8_t reader)
+{
+    return reinterpret_cast<uint8_t*>(get_read_sample(reader));
+}
+
+template <typename T>
+int_fast8_t BroadcastRingBuffer<T>::get_read_regions(
+        int_fast8_t reader,
+        int_fast32_t length,
+        T* regions[2],
+        int_fast32_t lengths[2]
+    )
+{
+    if ((length <= 0) || (buffered(reader) < length)) return 0;
+
+    const int_fast32_t index(_index(
+            this->_readers[reader].position.load(std::memory_order_relaxed)
+        ));
+    regions[0] = this->_ring + index;
+    lengths[0] = std::min(length, this->_totalRingSampleLength - index);
+    if (lengths[0] == length) return 1;
+
+    regions[1] = this->_ring;
+    lengths[1] = length - lengths[0];
+    return 2;
+}
+
+template <typename T>
+int_fast8_t BroadcastRingBuffer<T>::get_read_byte_regions(
+        int_fast8_t reader,
+        int_fast32_t numBytes,
+        uint8_t* regions[2],
+        int_fast32_t lengths[2]
+    )
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    T* sampleRegions[2];
+    const int_fast8_t numRegions(get_read_regions(
+            reader,
+            numBytes / bytesPerSample,
+            sampleRegions,
+            lengths
+        ));
+    for (int_fast8_t i(0); i < numRegions; ++i)
+    {
+        regions[i] = reinterpret_cast<uint8_t*>(sampleRegions[i]);
+        lengths[i] *= bytesPerSample;
+    }
+    return numRegions;
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::read_samples(
+        int_fast8_t reader,
+        T* data,
+        int_fast32_t length
+    )
+{
+    #if _DEBUG
+    if (!size_is_set()) throw BUFFER_NOT_INITIALIZED;
+    #endif
+
+    length = std::min(length, buffered(reader));
+    if (length <= 0) return 0;
+
+    /* At most two copies; before and after the end of storage */
+    const int_fast32_t
+        index(_index(this->_readers[reader].position.load(
+                std::memory_order_relaxed
+            ))),
+        first(std::min(length, this->_totalRingSampleLength - index));
+    std::memcpy(data, this->_ring + index, first * sizeof(T));
+    if (first < length)
+    {
+        std::memcpy(data + first, this->_ring, (length - first) * sizeof(T));
+    }
+
+    report_read_samples(reader, length);
+    return length;
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::read_bytes(
+        int_fast8_t reader,
+        uint8_t* data,
+        int_fast32_t numBytes
+    )
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    return read_samples(
+            reader,
+            reinterpret_cast<T*>(data),
+            numBytes / bytesPerSample
+        ) * bytesPerSample;
+}
+
+template <typename T>
+inline void BroadcastRingBuffer<T>::report_read_samples(
+        int_fast8_t reader,
+        int_fast32_t length
+    )
+{
+    ReaderCursor& cursor = this->_readers[reader];
+    const int_fast32_t
+        position(cursor.position.load(std::memory_order_relaxed)),
+        lag(_distance(
+                position,
+                this->_writePosition.load(std::memory_order_acquire)
+            ));
+
+    #if _DEBUG
+    if ((length <= 0) || (length > lag))
+    {
+        throw std::out_of_range("Length must be > 0 and <= samples buffered");
+    }
+    #endif
+
+    /* The writer may have reached the samples while they were read */
+    if (
+            (policy() == OVERWRITE_SLOWEST_READER)
+            && ((lag + this->_bufferLength) > this->_totalRingSampleLength)
+        )
+    {
+        cursor.overrun.fetch_add(length, std::memory_order_relaxed);
+    }
+
+    cursor.position.store(
+            _wrap(position + length),
+            std::memory_order_release
+        );
+    this->_writable.notify();
+}
+
+template <typename T>
+bool BroadcastRingBuffer<T>::wait_readable(
+        int_fast8_t reader,
+        int_fast32_t length,
+        int_fast32_t timeoutMs
+    )
+{
+    return this->_readable.wait(
+            [this, reader, length]() { return (buffered(reader) >= length); },
+            timeoutMs
+        );
+}
+
+template <typename T>
+inline void BroadcastRingBuffer<T>::report_read_bytes(
+        int_fast8_t reader,
+        int_fast32_t numBytes
+    )
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    report_read_samples(reader, numBytes / bytesPerSample);
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::available() const
+{
+    if (policy() == OVERWRITE_SLOWEST_READER)
+    {
+        return this->_totalRingSampleLength;
+    }
+
+    _update_slowest_reader();
+    if (!this->_cachedHasReaders) return this->_totalRingSampleLength;
+
+    return this->_totalRingSampleLength - _distance(
+            this->_cachedSlowestPosition,
+            this->_writePosition.load(std::memory_order_relaxed)
+        );
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::bytes_available() const
+{
+    return available() * bytesPerSample;
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::unwritten() const
+{
+    const int_fast32_t writePosition(
+            this->_writePosition.load(std::memory_order_relaxed)
+        );
+    const int_fast32_t contiguous(
+            this->_bufferLength
+            - (_index(writePosition) % this->_bufferLength)
+        );
+
+    if (policy() == OVERWRITE_SLOWEST_READER) return contiguous;
+
+    /* Only scan reader cursors if the last
+    observed slowest position is insufficient */
+    int_fast32_t unwrittenSamples(
+            this->_cachedHasReaders
+            ? (
+                this->_totalRingSampleLength
+                - _distance(this->_cachedSlowestPosition, writePosition)
+            )
+            : 0
+        );
+    if (unwrittenSamples < contiguous) unwrittenSamples = available();
+
+    return std::min(unwrittenSamples, contiguous);
+}
+
+template <typename T>
+inline int_fast32_t BroadcastRingBuffer<T>::bytes_unwritten() const
+{
+    return unwritten() * bytesPerSample;
+}
+
+template <typename T>
+inline T* BroadcastRingBuffer<T>::get_write_buffer_sample()
+{
+    const int_fast32_t index(
+            _index(this->_writePosition.load(std::memory_order_relaxed))
+        );
+    return this->_ring + (index - (index % this->_bufferLength));
+}
+
+template <typename T>
+inline uint8_t* BroadcastRingBuffer<T>::get_write_buffer_byte()
+{
+    return reinterpret_cast<uint8_t*>(get_write_buffer_sample());
+}
+
+template <typename T>
+inline T* BroadcastRingBuffer<T>::get_write_sample()
+{
+    return this->_ring + _index(
+            this->_writePosition.load(std::memory_order_relaxed)
+        );
+}
+
+template <typename T>
+inline uint8_t* BroadcastRingBuffer<T>::get_write_byte()
+{
+    return reinterpret_cast<uint8_t*>(get_write_sample());
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::write_samples(
+        const T* data,
+        int_fast32_t length
+    )
+{
+    #if _DEBUG
+    if (!size_is_set()) throw BUFFER_NOT_INITIALIZED;
+    #endif
+
+    int_fast32_t written(0);
+    while (written < length)
+    {
+        const int_fast32_t contiguous(
+                std::min(length - written, unwritten())
+            );
+        if (contiguous <= 0) break;
+        std::memcpy(get_write_sample(), data + written, contiguous * sizeof(T));
+        report_written_samples(contiguous);
+        written += contiguous;
+    }
+    return written;
+}
+
+template <typename T>
+int_fast32_t BroadcastRingBuffer<T>::write_bytes(
+        const uint8_t* data,
+        int_fast32_t numBytes
+    )
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    return write_samples(
+            reinterpret_cast<const T*>(data),
+            numBytes / bytesPerSample
+        ) * bytesPerSample;
+}
+
+template <typename T>
+inline void BroadcastRingBuffer<T>::report_written_samples(int_fast32_t length)
+{
+    #if _DEBUG
+    if ((length <= 0) || (length > available()))
+    {
+        throw std::out_of_range("Length must be > 0 and <= samples available");
+    }
+    #endif
+
+    this->_writePosition.store(
+            _wrap(this->_writePosition.load(std::memory_order_relaxed) + length),
+            std::memory_order_release
+        );
+    this->_readable.notify();
+}
+
+template <typename T>
+bool BroadcastRingBuffer<T>::wait_writable(
+        int_fast32_t length,
+        int_fast32_t timeoutMs
+    )
+{
+    return this->_writable.wait(
+            [this, length]() { return (available() >= length); },
+            timeoutMs
+        );
+}
+
+template <typename T>
+inline void BroadcastRingBuffer<T>::report_written_bytes(int_fast32_t numBytes)
+{
+    #if _DEBUG
+    if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    report_written_samples(numBytes / bytesPerSample);
+}
+
+/*                      Template Instantiations                     */
+
+// template class Buffer::BroadcastRingBuffer<int8_t>;
+template class Buffer::BroadcastRingBuffer<uint8_t>;
+template class Buffer::BroadcastRingBuffer<int16_t>;
+// template class Buffer::BroadcastRingBuffer<uint16_t>;
+template class Buffer::BroadcastRingBuffer<int32_t>;
+// template class Buffer::BroadcastRingBuffer<uint32_t>;
+// template class Buffer::BroadcastRingBuffer<int64_t>;
+// template class Buffer::BroadcastRingBuffer<uint64_t>;
+
+template class Buffer::BroadcastRingBuffer<Int24>;
+
+template class Buffer::BroadcastRingBuffer<float>;
+template class Buffer::BroadcastRingBuffer<double>;
+// template class Buffer::BroadcastRingBuffer<long double>;
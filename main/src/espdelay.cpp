@@ -1,36 +1,47 @@
-#include "espdelay.h"
-
-void delay_ticks(int numTicks)
-{
-    #ifdef ESP_PLATFORM
-    /* Delay for ticks */
-    vTaskDelay(numTicks);
-    #else
-    /* Delay for nanoseconds */
-    std::this_thread::sleep_for(std::chrono::nanoseconds(numTicks));
-    #endif
-}
-
-void delay_ms(int ms)
-{
-    /* Delay for milliseconds */
-    #ifdef ESP_PLATFORM
-    vTaskDelay(ms / portTICK_PERIOD_MS);
-    #else
-    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
-    #endif
-}
-
-void delay_ticks_at_count(int* counter, int threshold, int numTicks)
-{
-    /* Delay after a specified number of external iterations */
-    if (++(*counter) %= threshold) return;
-    delay_ticks(numTicks);
-}
-
-void delay_ms_at_count(int* counter, int threshold, int ms)
-{
-    /* Delay after a specified number of external iterations */
-    if (++(*counter) %= threshold) return;
-    delay_ms(ms);
-}
+#include "espdelay.h"
+
+void delay_ticks(int numTicks)
+{
+    #ifdef ESP_PLATFORM
+    /* Delay for ticks */
+    vTaskDelay(numTicks);
+    #else
+    /* Delay for nanoseconds */
+    std::this_thread::sleep_for(std::chrono::nanoseconds(numTicks));
+    #endif
+}
+
+void delay_ms(int ms)
+{
+    /* Delay for milliseconds */
+    #ifdef ESP_PLATFORM
+    vTaskDelay(ms / portTICK_PERIOD_MS);
+    #else
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    #endif
+}
+
+void delay_ticks_at_count(int* counter, int threshold, int numTicks)
+{
+    /* Delay after a specified number of external iterations */
+    if (++(*counter) %= threshold) return;
+    delay_ticks(numTicks);
+}
+
+void delay_ms_at_count(int* counter, int threshold, int ms)
+{
+    /* Delay after a specified number of external iterations */
+    if (++(*counter) %= threshold) return;
+    delay_ms(ms);
+}
+
+int64_t time_us(void)
+{
+    #ifdef ESP_PLATFORM
+    return esp_timer_get_time();
+    #else
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    #endif
+}
@@ -2,6 +2,8 @@
 
 using namespace I2S;
 
+#ifdef ESP_PLATFORM
+
 Bus::Bus() :
 _initialized(false),
 _started(false),
@@ -63,13 +65,6 @@ void Bus::_enable()
 void Bus::set_buffer_length(int length, int count)
 {
     /* Sets DMA buffer length */
-    #if _DEBUG
-    if (
-            (this->_stdConfig.slot_cfg.data_bit_width == I2S_DATA_BIT_WIDTH_24BIT)
-            && (length % 3)
-        ) throw NON_MULTIPLE_BYTE_COUNT;
-    #endif
-
     this->_channelConfig.dma_frame_num = length;
     this->_channelConfig.dma_desc_num = count;
 }
@@ -91,9 +86,11 @@ void Bus::set_bit_depth(uint16_t bitsPerSample)
     }
     else if (bitsPerSample == 24)
     {
-        this->_stdConfig.slot_cfg.data_bit_width = I2S_DATA_BIT_WIDTH_24BIT;
-        this->_stdConfig.slot_cfg.slot_bit_width = I2S_SLOT_BIT_WIDTH_24BIT;
-        this->_stdConfig.clk_cfg.mclk_multiple = I2S_MCLK_MULTIPLE_384;
+        /* Sent msb first in 32 bit slots, which every peripheral
+        supports, and packed or unpacked by read_samples/write_samples */
+        this->_stdConfig.slot_cfg.data_bit_width = I2S_DATA_BIT_WIDTH_32BIT;
+        this->_stdConfig.slot_cfg.slot_bit_width = I2S_SLOT_BIT_WIDTH_32BIT;
+        this->_stdConfig.clk_cfg.mclk_multiple = I2S_MCLK_MULTIPLE_256;
     }
     else if (bitsPerSample == 32)
     {
@@ -249,13 +246,6 @@ void Bus::write_bytes(const void* data, int_fast32_t numBytes)
     #endif
 }
 
-template <typename T>
-inline void Bus::write(std::vector<T>* data, int_fast32_t length)
-{
-    constexpr int_fast32_t typeSize(sizeof(T));
-    write_bytes(reinterpret_cast<const void*>(&((*data)[0])), length * typeSize);
-}
-
 void Bus::read_bytes(void* data, int_fast32_t numBytes)
 {
     i2s_channel_read(
@@ -274,6 +264,376 @@ void Bus::read_bytes(void* data, int_fast32_t numBytes)
     #endif
 }
 
+void Bus::write_samples(const Int24* data, int_fast32_t length)
+{
+    this->_slots.resize(length);
+    unpack_int24_slots(this->_slots.data(), data, length);
+    write_bytes(this->_slots.data(), length * sizeof(int32_t));
+}
+
+void Bus::read_samples(Int24* data, int_fast32_t length)
+{
+    this->_slots.resize(length);
+    read_bytes(this->_slots.data(), length * sizeof(int32_t));
+    pack_int24_slots(data, this->_slots.data(), length);
+}
+
+#else
+
+Bus::Bus() :
+_initialized(false),
+_started(false),
+_numBytesWritten(0),
+_numBytesRead(0),
+_numTicksToWait(100),
+_sampleRate(48000),
+_bitsPerSample(32),
+_channels(1),
+_realtime(true),
+_toneEnabled(false),
+_source(nullptr),
+_sink(nullptr),
+_clockScale(1.0),
+_framesRead(0),
+_framesWritten(0)
+{
+    this->_tone.set_sample_rate(this->_sampleRate);
+}
+
+Bus::Bus(const Bus& obj) :
+_initialized(obj._initialized),
+_started(obj._started),
+_numBytesWritten(obj._numBytesWritten),
+_numBytesRead(obj._numBytesRead),
+_numTicksToWait(obj._numTicksToWait),
+_sampleRate(obj._sampleRate),
+_bitsPerSample(obj._bitsPerSample),
+_channels(obj._channels),
+_realtime(obj._realtime),
+_toneEnabled(false),
+_source(nullptr),
+_sink(nullptr),
+_clockScale(obj._clockScale),
+_framesRead(0),
+_framesWritten(0)
+{
+    /* Sources and sinks stay with the original bus */
+    this->_tone.set_sample_rate(this->_sampleRate);
+}
+
+Bus::~Bus()
+{
+    close();
+}
+
+void Bus::_initialize()
+{
+    this->_initialized = true;
+}
+
+void Bus::_disable()
+{
+}
+
+void Bus::_enable()
+{
+    /* Sample clocks start over whenever the bus is enabled */
+    this->_readStart = std::chrono::steady_clock::now();
+    this->_writeStart = this->_readStart;
+    this->_framesRead = 0;
+    this->_framesWritten = 0;
+}
+
+void Bus::_pace(
+        std::chrono::steady_clock::time_point* start,
+        int64_t* frames,
+        int_fast32_t numBytes
+    )
+{
+    if (!this->_realtime) return;
+
+    const int_fast32_t frameSize(((this->_bitsPerSample + 7) / 8) * this->_channels);
+    *frames += numBytes / frameSize;
+
+    const std::chrono::steady_clock::time_point due(
+            *start + std::chrono::nanoseconds(static_cast<int64_t>(
+                (static_cast<double>(*frames) * 1e9 * this->_clockScale)
+                / this->_sampleRate
+            ))
+        );
+    const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+
+    /* Start over after a stall instead of racing to catch up,
+    as a real bus drops samples that nobody was there to move */
+    if ((now - due) > std::chrono::milliseconds(100))
+    {
+        *start = now;
+        *frames = 0;
+        return;
+    }
+    std::this_thread::sleep_until(due);
+}
+
+void Bus::_generate_tone(uint8_t* data, int_fast32_t numBytes)
+{
+    const int_fast32_t width((this->_bitsPerSample + 7) / 8);
+    const int_fast32_t numFrames(numBytes / (width * this->_channels));
+    const int_fast32_t containerWidth((width == 3) ? 4 : width);
+    this->_toneBuffer.resize(numFrames);
+    this->_toneSamples.resize(numFrames * containerWidth);
+    this->_tone.get(this->_toneBuffer.data(), numFrames);
+
+    uint8_t* samples(this->_toneSamples.data());
+    if (width == 1)
+    {
+        float_to_int_batch<uint8_t>(samples, this->_toneBuffer.data(), numFrames);
+    }
+    else if (width == 2)
+    {
+        float_to_int_batch<int16_t>(
+                reinterpret_cast<int16_t*>(samples),
+                this->_toneBuffer.data(),
+                numFrames
+            );
+    }
+    else if (width == 3)
+    {
+        /* 24 bit samples are the lower bytes of a sign extended 32 bit sample */
+        float_to_int_batch<int32_t, 24>(
+                reinterpret_cast<int32_t*>(samples),
+                this->_toneBuffer.data(),
+                numFrames
+            );
+    }
+    else
+    {
+        float_to_int_batch<int32_t>(
+                reinterpret_cast<int32_t*>(samples),
+                this->_toneBuffer.data(),
+                numFrames
+            );
+    }
+
+    for (int_fast32_t i(0); i < numFrames; ++i)
+    {
+        for (uint16_t c(0); c < this->_channels; ++c)
+        {
+            std::memcpy(data, samples, width);
+            data += width;
+        }
+        samples += containerWidth;
+    }
+}
+
+void Bus::set_buffer_length(int length, int count)
+{
+    /* There is no DMA to size on the simulated bus */
+}
+
+void Bus::set_bit_depth(uint16_t bitsPerSample)
+{
+    this->_bitsPerSample = bitsPerSample;
+}
+
+void Bus::set_sample_rate(uint32_t samplerate)
+{
+    this->_sampleRate = samplerate;
+    this->_tone.set_sample_rate(samplerate);
+}
+
+void Bus::set_channels(uint16_t channels)
+{
+    #if _DEBUG
+    if ((channels < 1) || (channels > 2))
+    {
+        throw std::out_of_range("Channels must be 1 <= channels <= 2");
+    }
+    #endif
+    this->_channels = channels;
+}
+
+void Bus::set_i2s_bus_num(int num)
+{
+    #if _DEBUG
+    if ((num < 0) || (num > 1))
+    {
+        throw std::out_of_range("I2S bus number must be 0 or 1");
+    }
+    #endif
+}
+
+void Bus::set_master()
+{
+}
+
+void Bus::set_slave()
+{
+}
+
+void Bus::set_pin_master_clock(int pin)
+{
+}
+
+void Bus::set_pin_bit_clock(int pin)
+{
+}
+
+void Bus::set_pin_word_select(int pin)
+{
+}
+
+void Bus::set_pin_data_out(int pin)
+{
+}
+
+void Bus::set_pin_data_in(int pin)
+{
+}
+
+void Bus::set_invert_master_clock(bool invert)
+{
+}
+
+void Bus::set_invert_bit_clock(bool invert)
+{
+}
+
+void Bus::set_invert_word_select(bool invert)
+{
+}
+
+void Bus::set_auto_clear(bool clear)
+{
+}
+
+void Bus::set_source_file(const char* path)
+{
+    if (this->_source) std::fclose(this->_source);
+    this->_source = std::fopen(path, "rb");
+    if (!this->_source)
+    {
+        std::cerr << "Error: unable to open i2s source " << path << '\n';
+    }
+}
+
+void Bus::set_source_tone(float frequency, float scale)
+{
+    this->_tone.set_frequency(frequency);
+    this->_tone.scale = scale;
+    this->_toneEnabled = true;
+}
+
+void Bus::set_sink_file(const char* path)
+{
+    if (this->_sink) std::fclose(this->_sink);
+    this->_sink = std::fopen(path, "wb");
+    if (!this->_sink)
+    {
+        std::cerr << "Error: unable to open i2s sink " << path << '\n';
+    }
+}
+
+void Bus::set_realtime(bool realtime)
+{
+    this->_realtime = realtime;
+}
+
+void Bus::set_clock_error_ppm(double ppm)
+{
+    /* A fast clock moves each sample sooner */
+    this->_clockScale = 1.0 / (1.0 + (ppm * 1e-6));
+}
+
+void Bus::start()
+{
+    _initialize();
+    _enable();
+    this->_started = true;
+}
+
+void Bus::stop()
+{
+    _disable();
+    this->_started = false;
+}
+
+void Bus::close()
+{
+    stop();
+    if (this->_source) std::fclose(this->_source);
+    if (this->_sink) std::fclose(this->_sink);
+    this->_source = nullptr;
+    this->_sink = nullptr;
+}
+
+void Bus::write_bytes(const void* data, int_fast32_t numBytes)
+{
+    this->_numBytesWritten = (
+            this->_sink
+            ? std::fwrite(data, 1, numBytes, this->_sink)
+            : numBytes
+        );
+    #if _DEBUG
+    if (numBytes != static_cast<int_fast32_t>(this->_numBytesWritten))
+    {
+        std::cerr << "Error: " << this->_numBytesWritten;
+        std::cerr << " of " << numBytes << " written\n";
+    }
+    #endif
+    _pace(&(this->_writeStart), &(this->_framesWritten), numBytes);
+}
+
+void Bus::read_bytes(void* data, int_fast32_t numBytes)
+{
+    uint8_t* incoming(static_cast<uint8_t*>(data));
+    int_fast32_t numRead(0);
+
+    if (this->_source)
+    {
+        /* Loop the file so a short clip can feed a long run */
+        while (numRead < numBytes)
+        {
+            size_t rc = std::fread(&(incoming[numRead]), 1, numBytes - numRead, this->_source);
+            if (!rc)
+            {
+                std::rewind(this->_source);
+                rc = std::fread(&(incoming[numRead]), 1, numBytes - numRead, this->_source);
+                if (!rc) break;
+            }
+            numRead += rc;
+        }
+    }
+    else if (this->_toneEnabled)
+    {
+        _generate_tone(incoming, numBytes);
+        numRead = numBytes;
+    }
+    std::memset(&(incoming[numRead]), 0, numBytes - numRead);
+
+    this->_numBytesRead = numBytes;
+    _pace(&(this->_readStart), &(this->_framesRead), numBytes);
+}
+
+void Bus::write_samples(const Int24* data, int_fast32_t length)
+{
+    /* Files and tones are already packed */
+    write_bytes(data, length * sizeof(Int24));
+}
+
+void Bus::read_samples(Int24* data, int_fast32_t length)
+{
+    read_bytes(data, length * sizeof(Int24));
+}
+
+#endif
+
+template <typename T>
+inline void Bus::write(std::vector<T>* data, int_fast32_t length)
+{
+    constexpr int_fast32_t typeSize(sizeof(T));
+    write_bytes(reinterpret_cast<const void*>(&((*data)[0])), length * typeSize);
+}
+
 template <typename T>
 void Bus::read(std::vector<T>* data, int_fast32_t length)
 {
@@ -292,8 +652,12 @@ template void Bus::write<int16_t>(std::vector<int16_t>*, int_fast32_t);
 template void Bus::write<int32_t>(std::vector<int32_t>*, int_fast32_t);
 // template void Bus::write<uint32_t>(std::vector<uint32_t>*, int_fast32_t);
 
+#if (INT_FAST8_MAX != INT8_MAX)
 template void Bus::write<int_fast8_t>(std::vector<int_fast8_t>*, int_fast32_t);
+#endif
+#if (UINT_FAST8_MAX != UINT8_MAX)
 template void Bus::write<uint_fast8_t>(std::vector<uint_fast8_t>*, int_fast32_t);
+#endif
 
 // template void Bus::read<int8_t>(std::vector<int8_t>*, int_fast32_t);
 template void Bus::read<uint8_t>(std::vector<uint8_t>*, int_fast32_t);
@@ -302,5 +666,9 @@ template void Bus::read<int16_t>(std::vector<int16_t>*, int_fast32_t);
 template void Bus::read<int32_t>(std::vector<int32_t>*, int_fast32_t);
 // template void Bus::read<uint32_t>(std::vector<uint32_t>*, int_fast32_t);
 
+#if (INT_FAST8_MAX != INT8_MAX)
 template void Bus::read<int_fast8_t>(std::vector<int_fast8_t>*, int_fast32_t);
+#endif
+#if (UINT_FAST8_MAX != UINT8_MAX)
 template void Bus::read<uint_fast8_t>(std::vector<uint_fast8_t>*, int_fast32_t);
+#endif
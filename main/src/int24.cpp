@@ -0,0 +1,101 @@
+#include "int24.h"
+
+#include <cstring>
+
+/* Four samples fill exactly three 32 bit words, so on little
+endian targets groups of four are moved with whole word loads
+and stores instead of byte by byte.  Slots hold a sample in
+their upper three bytes and are converted by shifting. */
+
+template <bool Slots>
+static inline uint32_t to_word(int32_t value)
+{
+    return Slots ? (static_cast<uint32_t>(value) >> 8) : static_cast<uint32_t>(value);
+}
+
+template <bool Slots>
+static inline void pack(Int24* packed, const int32_t* values, int_fast32_t length)
+{
+    int_fast32_t i(0);
+
+    #if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    uint8_t* output(reinterpret_cast<uint8_t*>(packed));
+    for (; (i + 4) <= length; i += 4)
+    {
+        const uint32_t
+            a(to_word<Slots>(values[i])),
+            b(to_word<Slots>(values[i + 1])),
+            c(to_word<Slots>(values[i + 2])),
+            d(to_word<Slots>(values[i + 3]));
+        const uint32_t
+            first((a & 0xFFFFFF) | (b << 24)),
+            second(((b >> 8) & 0xFFFF) | (c << 16)),
+            third(((c >> 16) & 0xFF) | (d << 8));
+        std::memcpy(output + (i * 3), &first, 4);
+        std::memcpy(output + (i * 3) + 4, &second, 4);
+        std::memcpy(output + (i * 3) + 8, &third, 4);
+    }
+    #endif
+
+    for (; i < length; ++i)
+    {
+        packed[i] = Slots ? (values[i] >> 8) : values[i];
+    }
+}
+
+template <bool Slots>
+static inline void unpack(int32_t* values, const Int24* packed, int_fast32_t length)
+{
+    int_fast32_t i(0);
+
+    #if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    const uint8_t* input(reinterpret_cast<const uint8_t*>(packed));
+    for (; (i + 4) <= length; i += 4)
+    {
+        uint32_t words[3];
+        std::memcpy(words, input + (i * 3), sizeof(words));
+
+        /* Each sample is first placed in the upper bytes of a slot */
+        const uint32_t slots[4] = {
+                words[0] << 8,
+                ((words[0] >> 16) | (words[1] << 16)) & 0xFFFFFF00,
+                ((words[1] >> 8) | (words[2] << 24)) & 0xFFFFFF00,
+                words[2] & 0xFFFFFF00
+            };
+        for (int_fast8_t j(0); j < 4; ++j)
+        {
+            values[i + j] = (
+                    Slots
+                    ? static_cast<int32_t>(slots[j])
+                    : (static_cast<int32_t>(slots[j]) >> 8)
+                );
+        }
+    }
+    #endif
+
+    for (; i < length; ++i)
+    {
+        const int32_t value(packed[i]);
+        values[i] = Slots ? static_cast<int32_t>(static_cast<uint32_t>(value) << 8) : value;
+    }
+}
+
+void pack_int24(Int24* packed, const int32_t* values, int_fast32_t length)
+{
+    pack<false>(packed, values, length);
+}
+
+void unpack_int24(int32_t* values, const Int24* packed, int_fast32_t length)
+{
+    unpack<false>(values, packed, length);
+}
+
+void pack_int24_slots(Int24* packed, const int32_t* slots, int_fast32_t length)
+{
+    pack<true>(packed, slots, length);
+}
+
+void unpack_int24_slots(int32_t* slots, const Int24* packed, int_fast32_t length)
+{
+    unpack<true>(slots, packed, length);
+}
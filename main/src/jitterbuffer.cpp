@@ -0,0 +1,323 @@
+#include "jitterbuffer.h"
+
+using namespace Buffer;
+
+template <typename T>
+JitterBuffer<T>::JitterBuffer(
+        int_fast32_t frameLength,
+        int_fast32_t numSlots,
+        int_fast32_t sampleRate,
+        int_fast8_t channels
+    ) :
+_frameLength(frameLength),
+_numSlots(numSlots),
+_sampleRate(sampleRate),
+_samplesPerFrame(frameLength / channels),
+_concealment(CONCEAL_SILENCE),
+_maxRepeats(2),
+_repeats(0),
+_adaptive(true)
+{
+    #if _DEBUG
+    if (!frameLength || !numSlots || !sampleRate || !channels)
+    {
+        throw VALUE_MUST_BE_NONZERO;
+    }
+    #endif
+
+    this->_samples.resize(this->_frameLength * this->_numSlots, get_zero<T>());
+    this->_lastFrame.resize(this->_frameLength, get_zero<T>());
+    this->_silence.resize(this->_frameLength, get_zero<T>());
+    this->_slots.resize(this->_numSlots);
+
+    /* Never wait less than one frame, nor longer than the slots hold */
+    const int_fast32_t framePeriodUs(
+            static_cast<int64_t>(this->_samplesPerFrame) * 1000000
+            / this->_sampleRate
+        );
+    this->_minDepthUs = framePeriodUs;
+    this->_maxDepthUs = framePeriodUs * (this->_numSlots - 1);
+    this->_configuredDepthUs = this->_minDepthUs;
+
+    reset();
+}
+
+template <typename T>
+JitterBuffer<T>::~JitterBuffer()
+{
+}
+
+template <typename T>
+inline int64_t JitterBuffer<T>::_nominal_arrival(uint32_t sequence) const
+{
+    return this->_baseArrivalUs + (
+            static_cast<int64_t>(static_cast<int32_t>(sequence - this->_baseSequence))
+            * this->_samplesPerFrame * 1000000 / this->_sampleRate
+        );
+}
+
+template <typename T>
+void JitterBuffer<T>::_update_jitter(uint32_t timestamp, int64_t nowUs)
+{
+    if (this->_haveTransit)
+    {
+        /* Difference in transit time between consecutive arrivals */
+        const int64_t difference(
+                (nowUs - this->_previousArrivalUs)
+                - (
+                    static_cast<int64_t>(
+                        static_cast<int32_t>(timestamp - this->_previousTimestamp)
+                    ) * 1000000 / this->_sampleRate
+                )
+            );
+        this->_jitter16 += std::llabs(difference) - ((this->_jitter16 + 8) >> 4);
+    }
+    this->_previousTimestamp = timestamp;
+    this->_previousArrivalUs = nowUs;
+    this->_haveTransit = true;
+
+    if (!this->_adaptive) return;
+
+    /* Grow at once to stop concealment, shrink gradually */
+    const int_fast32_t wanted(std::clamp(
+            static_cast<int_fast32_t>(this->_minDepthUs + (this->_jitter16 >> 2)),
+            this->_minDepthUs,
+            this->_maxDepthUs
+        ));
+    if (wanted > this->_targetDepthUs)
+    {
+        this->_targetDepthUs = wanted;
+    }
+    else
+    {
+        this->_targetDepthUs -= (this->_targetDepthUs - wanted) >> 6;
+    }
+}
+
+template <typename T>
+void JitterBuffer<T>::_start(uint32_t sequence, int64_t nowUs)
+{
+    for (Slot& slot: this->_slots) slot.filled = false;
+    this->_baseSequence = sequence;
+    this->_nextSequence = sequence;
+    this->_baseArrivalUs = nowUs;
+    this->_repeats = 0;
+    this->_stats.depth = 0;
+    this->_started = true;
+}
+
+template <typename T>
+void JitterBuffer<T>::set_target_depth_ms(int_fast32_t targetMs)
+{
+    this->_configuredDepthUs = std::clamp(
+            static_cast<int_fast32_t>(targetMs * 1000),
+            this->_minDepthUs,
+            this->_maxDepthUs
+        );
+    this->_targetDepthUs = this->_configuredDepthUs;
+}
+
+template <typename T>
+void JitterBuffer<T>::set_depth_limits_ms(int_fast32_t minMs, int_fast32_t maxMs)
+{
+    const int_fast32_t framePeriodUs(
+            static_cast<int64_t>(this->_samplesPerFrame) * 1000000
+            / this->_sampleRate
+        );
+    this->_maxDepthUs = std::min(
+            static_cast<int_fast32_t>(maxMs * 1000),
+            framePeriodUs * (this->_numSlots - 1)
+        );
+    this->_minDepthUs = std::clamp(
+            static_cast<int_fast32_t>(minMs * 1000),
+            framePeriodUs,
+            this->_maxDepthUs
+        );
+    this->_configuredDepthUs = std::clamp(
+            this->_configuredDepthUs,
+            this->_minDepthUs,
+            this->_maxDepthUs
+        );
+    this->_targetDepthUs = std::clamp(
+            this->_targetDepthUs,
+            this->_minDepthUs,
+            this->_maxDepthUs
+        );
+}
+
+template <typename T>
+void JitterBuffer<T>::set_adaptive(bool adaptive)
+{
+    this->_adaptive = adaptive;
+    if (!adaptive) this->_targetDepthUs = this->_configuredDepthUs;
+}
+
+template <typename T>
+void JitterBuffer<T>::set_concealment(
+        jitter_concealment concealment,
+        int_fast8_t maxRepeats
+    )
+{
+    this->_concealment = concealment;
+    this->_maxRepeats = maxRepeats;
+}
+
+template <typename T>
+int_fast32_t JitterBuffer<T>::frame_length() const
+{
+    return this->_frameLength;
+}
+
+template <typename T>
+bool JitterBuffer<T>::insert(
+        uint32_t sequence,
+        uint32_t timestamp,
+        const T* data,
+        int_fast32_t length,
+        int64_t nowUs
+    )
+{
+    if (length != this->_frameLength) return false;
+
+    if (!this->_started) _start(sequence, nowUs);
+
+    const int32_t ahead(static_cast<int32_t>(sequence - this->_nextSequence));
+    if ((ahead < 0) && (-ahead <= this->_numSlots))
+    {
+        ++this->_stats.late;
+        return false;
+    }
+    else if ((ahead < 0) || (ahead >= this->_numSlots))
+    {
+        /* Sender restarted or the stream jumped beyond the slots */
+        ++this->_stats.resynced;
+        _start(sequence, nowUs);
+    }
+
+    const int_fast32_t index(sequence % this->_numSlots);
+    Slot& slot = this->_slots[index];
+    if (slot.filled && (slot.sequence == sequence))
+    {
+        ++this->_stats.duplicated;
+        return false;
+    }
+
+    std::memcpy(
+            &(this->_samples[index * this->_frameLength]),
+            data,
+            this->_frameLength * sizeof(T)
+        );
+    slot.sequence = sequence;
+    slot.filled = true;
+    ++this->_stats.depth;
+    ++this->_stats.received;
+
+    /* Follow the earliest arrivals immediately and
+    later ones slowly, so the schedule tracks clock drift */
+    const int64_t early(_nominal_arrival(sequence) - nowUs);
+    if (early > 0) this->_baseArrivalUs -= early;
+    else this->_baseArrivalUs += (-early) >> 10;
+
+    _update_jitter(timestamp, nowUs);
+
+    return true;
+}
+
+template <typename T>
+const T* JitterBuffer<T>::pull(int64_t nowUs)
+{
+    if (
+            !this->_started
+            || (nowUs < (_nominal_arrival(this->_nextSequence) + this->_targetDepthUs))
+        )
+    {
+        return nullptr;
+    }
+
+    const int_fast32_t index(this->_nextSequence % this->_numSlots);
+    Slot& slot = this->_slots[index];
+    const T* frame;
+
+    if (slot.filled && (slot.sequence == this->_nextSequence))
+    {
+        frame = &(this->_samples[index * this->_frameLength]);
+        slot.filled = false;
+        --this->_stats.depth;
+        ++this->_stats.played;
+        this->_repeats = 0;
+        if (this->_concealment == CONCEAL_REPEAT_LAST)
+        {
+            std::copy(frame, frame + this->_frameLength, this->_lastFrame.begin());
+        }
+    }
+    else
+    {
+        ++this->_stats.concealed;
+        if (
+                (this->_concealment == CONCEAL_REPEAT_LAST)
+                && (this->_repeats < this->_maxRepeats)
+            )
+        {
+            ++this->_repeats;
+            frame = this->_lastFrame.data();
+        }
+        else
+        {
+            frame = this->_silence.data();
+        }
+    }
+
+    ++this->_nextSequence;
+    return frame;
+}
+
+template <typename T>
+JitterStats JitterBuffer<T>::stats() const
+{
+    JitterStats current(this->_stats);
+    current.targetDepthUs = this->_targetDepthUs;
+    current.jitterUs = static_cast<int_fast32_t>(this->_jitter16 >> 4);
+
+    /* Every late arrival was concealed at its playout time */
+    current.lost = (
+            (current.concealed > current.late)
+            ? (current.concealed - current.late)
+            : 0
+        );
+    return current;
+}
+
+template <typename T>
+void JitterBuffer<T>::reset()
+{
+    for (Slot& slot: this->_slots) slot.filled = false;
+    std::fill(this->_lastFrame.begin(), this->_lastFrame.end(), get_zero<T>());
+    std::memset(&(this->_stats), 0, sizeof(this->_stats));
+    this->_started = false;
+    this->_baseSequence = 0;
+    this->_nextSequence = 0;
+    this->_baseArrivalUs = 0;
+    this->_repeats = 0;
+    this->_haveTransit = false;
+    this->_previousTimestamp = 0;
+    this->_previousArrivalUs = 0;
+    this->_jitter16 = 0;
+    this->_targetDepthUs = this->_configuredDepthUs;
+}
+
+/*                      Template Instantiations                     */
+
+// template class Buffer::JitterBuffer<int8_t>;
+template class Buffer::JitterBuffer<uint8_t>;
+template class Buffer::JitterBuffer<int16_t>;
+// template class Buffer::JitterBuffer<uint16_t>;
+template class Buffer::JitterBuffer<int32_t>;
+// template class Buffer::JitterBuffer<uint32_t>;
+// template class Buffer::JitterBuffer<int64_t>;
+// template class Buffer::JitterBuffer<uint64_t>;
+
+template class Buffer::JitterBuffer<Int24>;
+
+template class Buffer::JitterBuffer<float>;
+template class Buffer::JitterBuffer<double>;
+// template class Buffer::JitterBuffer<long double>;
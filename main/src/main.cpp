@@ -3,38 +3,55 @@
  * Copyright 2024 K Hughes Production LLC
  */
 
+#include <algorithm>
+#include <csignal>
 #include <iostream>
+#include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <thread>
+
+#ifdef ESP_PLATFORM
+#include "esp_pthread.h"
+#endif
 
 #include "debugmacros.h"
 #include "private.h"
 
 #include "ringbuffer.h"
+#include "staticringbuffer.h"
+#include "broadcastringbuffer.h"
+#include "jitterbuffer.h"
+#include "resampler.h"
 #include "espdelay.h"
 #include "esp32button.h"
 #include "espi2s.h"
+#include "intfloatconversions.h"
 #include "wifbnetwork.h"
 #include "wifbmetadata.h"
+#include "wifbframe.h"
+#include "wifbcodec.h"
+#include "ringallocator.h"
 
 /*                              Macros                              */
 
 /* I2S master clock */
-#define I2S_MCK                             (GPIO_NUM_0)
+#define I2S_MCK                             (0)
 
 /* I2S word select */
-#define I2S_WS                              (GPIO_NUM_26)
+#define I2S_WS                              (26)
 
 /* I2S bit clock */
-#define I2S_BCK                             (GPIO_NUM_14)
+#define I2S_BCK                             (14)
 
 /* I2S data */
-#define I2S_DI                              (GPIO_NUM_35)
+#define I2S_DI                              (35)
 
 /* I2S output data */
-#define I2S_DO                              (GPIO_NUM_25)
+#define I2S_DO                              (25)
 
 /* Shutdown signal output */
-#define I2S_SHUTDOWN                        (GPIO_NUM_21)
+#define I2S_SHUTDOWN                        (21)
 
 /* Whether to enable i2s or simulate I/O */
 #ifndef I2S_ENABLED
@@ -42,7 +59,7 @@
 #endif
 
 /* Momentary switch */
-#define BUTTON_PIN                          (GPIO_NUM_35)
+#define BUTTON_PIN                          (35)
 
 /* Audio sample rate */
 #ifndef SAMPLE_RATE
@@ -68,9 +85,9 @@
 #elif ((BITS_PER_SAMPLE) == 16)
 #define AUDIO_DATATYPE                      int16_t
 #elif ((BITS_PER_SAMPLE) == 24)
-#define AUDIO_DATATYPE                      int_fast32_t
+#define AUDIO_DATATYPE                      Int24
 #elif ((BITS_PER_SAMPLE) == 32)
-#define AUDIO_DATATYPE                      int_fast32_t
+#define AUDIO_DATATYPE                      int32_t
 #endif
 
 /* Length in samples of each buffer in ring */
@@ -101,9 +118,156 @@
 #endif
 #endif
 
+/* Payload encoding of transmitted chunks for receivers that do
+not ask for one; receivers decode whatever each frame carries */
+#ifndef AUDIO_ENCODING
+#define AUDIO_ENCODING                      (WIFB_ENCODING_LOSSLESS)
+#endif
+
+/* Payload encoding receivers ask the transmitter for,
+e.g. WIFB_ENCODING_ADPCM to save airtime on speech feeds */
+#ifndef RECEIVE_ENCODING
+#define RECEIVE_ENCODING                    (WIFB_HELLO_ANY_ENCODING)
+#endif
+
+/* Largest payload of a chunk once encoded */
+#define TRANSMIT_PAYLOAD_SIZE               ( \
+        (TRANSMIT_DATA_CHUNKSIZE) + WIFB_CODEC_OVERHEAD(NUM_CHANNELS) \
+    )
+
 #ifndef TRANSMISSION_SIZE
 #define TRANSMISSION_SIZE                   ( \
-        (TRANSMIT_DATA_CHUNKSIZE) + (METADATA_SIZE) \
+        (WIFB_FRAME_HEADER_SIZE) \
+        + (TRANSMIT_PAYLOAD_SIZE) \
+        + (METADATA_SIZE) \
+    )
+#endif
+
+/* Number of samples per channel in each transmitted chunk */
+#define TRANSMIT_FRAME_SAMPLES              ( \
+        (TRANSMIT_DATA_CHUNKSIZE) / (SAMPLE_WIDTH) / (NUM_CHANNELS) \
+    )
+
+/* Send audio as udp datagrams and keep tcp as the control channel */
+#ifndef UDP_AUDIO_TRANSPORT
+#define UDP_AUDIO_TRANSPORT                 (true)
+#endif
+
+/* Send udp audio once to this multicast group, or a subnet
+broadcast address such as 192.168.4.255 on the soft AP,
+rather than once to each receiver; nullptr sends unicast */
+#ifndef MULTICAST_GROUP_ADDR
+#define MULTICAST_GROUP_ADDR                (nullptr)
+#endif
+
+/* Address of the interface group audio leaves from;
+nullptr for the default interface */
+#ifndef MULTICAST_INTERFACE_ADDR
+#define MULTICAST_INTERFACE_ADDR            (nullptr)
+#endif
+
+/* Udp port group audio is sent to */
+#ifndef MULTICAST_PORT
+#define MULTICAST_PORT                      ((CONFIG_PORT) + 1)
+#endif
+
+/* Number of frames the receiver's jitter buffer can hold */
+#ifndef JITTER_BUFFER_SLOTS
+#define JITTER_BUFFER_SLOTS                 (64)
+#endif
+
+/* Initial playout delay added by the jitter buffer */
+#ifndef JITTER_TARGET_DEPTH_MS
+#define JITTER_TARGET_DEPTH_MS              (10)
+#endif
+
+/* Bounds for the adaptive playout delay */
+#ifndef JITTER_MIN_DEPTH_MS
+#define JITTER_MIN_DEPTH_MS                 (2)
+#endif
+
+#ifndef JITTER_MAX_DEPTH_MS
+#define JITTER_MAX_DEPTH_MS                 (60)
+#endif
+
+/* Concealment for frames missing at their playout time */
+#ifndef JITTER_CONCEALMENT
+#define JITTER_CONCEALMENT                  (Buffer::CONCEAL_REPEAT_LAST)
+#endif
+
+/* Resample received audio to hold receive ring fill steady
+against the difference between sender and receiver clocks */
+#ifndef DRIFT_COMPENSATION
+#define DRIFT_COMPENSATION                  (true)
+#endif
+
+/* Largest clock difference the resampler corrects */
+#ifndef DRIFT_MAX_PPM
+#define DRIFT_MAX_PPM                       (500)
+#endif
+
+/* Longest wait for a datagram before releasing due frames */
+#ifndef JITTER_POLL_US
+#define JITTER_POLL_US                      (1000)
+#endif
+
+/* Receiver checks the control channel after this long without audio */
+#ifndef UDP_RECEIVE_TIMEOUT_MS
+#define UDP_RECEIVE_TIMEOUT_MS              (1000)
+#endif
+
+/* Number of frames sent between checks of the control channel */
+#ifndef CONTROL_POLL_FRAMES
+#define CONTROL_POLL_FRAMES                 (64)
+#endif
+
+/* Longest a transmitter waits for a new client's hello */
+#ifndef HELLO_TIMEOUT_MS
+#define HELLO_TIMEOUT_MS                    (2000)
+#endif
+
+/* Pause before a receiver reconnects after losing its transmitter */
+#ifndef RECONNECT_DELAY_MS
+#define RECONNECT_DELAY_MS                  (1000)
+#endif
+
+/* Longest a task sleeps waiting on a ring buffer
+before rechecking its connection */
+#ifndef RING_WAIT_TIMEOUT_MS
+#define RING_WAIT_TIMEOUT_MS                (100)
+#endif
+
+static_assert(
+        sizeof(AUDIO_DATATYPE) == (SAMPLE_WIDTH),
+        "Ring samples must be stored as they are sent"
+    );
+
+static_assert(
+        !((TRANSMIT_DATA_CHUNKSIZE) % ((SAMPLE_WIDTH) * (NUM_CHANNELS))),
+        "Each chunk must hold whole frames"
+    );
+
+#if UDP_AUDIO_TRANSPORT
+static_assert(
+        (TRANSMISSION_SIZE) <= (UDP_MAX_DATAGRAM_SIZE),
+        "Each frame must fit in a single unfragmented datagram"
+    );
+#endif
+
+/* Stack size in bytes of each client session task */
+#ifndef CLIENT_TASK_STACK_SIZE
+#define CLIENT_TASK_STACK_SIZE              (6144)
+#endif
+
+/* Size in bytes of the region the transmit ring and the encoded
+payload of every client session are carved from at boot, with
+a cache line of alignment padding for each */
+#ifndef AUDIO_ARENA_SIZE
+#define AUDIO_ARENA_SIZE                    ( \
+        ((RING_BUFFER_LENGTH) * (RING_LENGTH) * sizeof(AUDIO_DATATYPE)) \
+        + ((RINGBUFF_MAX_READERS) * ((TRANSMIT_DATA_CHUNKSIZE) \
+            + WIFB_CODEC_OVERHEAD(NUM_CHANNELS))) \
+        + (((RINGBUFF_MAX_READERS) + 1) * (RINGBUFF_CACHE_LINE_SIZE)) \
     )
 #endif
 
@@ -114,7 +278,11 @@
 
 /* Transmitter ipv4 address */
 #ifndef TRANSMITTER_IPV4_ADDR
+#ifdef ESP_PLATFORM
 #define TRANSMITTER_IPV4_ADDR               ("192.168.4.1")
+#else
+#define TRANSMITTER_IPV4_ADDR               ("127.0.0.1")
+#endif
 #endif
 
 /*                             Variables                            */
@@ -122,12 +290,39 @@
 /* Transmit or receive */
 static bool txMode(DEFUALT_MODE_TRANSMIT);
 
+/* Address receivers connect to */
+static const char* transmitterAddress(TRANSMITTER_IPV4_ADDR);
+
+/* Encoding receivers ask for in their hello */
+static uint8_t requestedEncoding(RECEIVE_ENCODING);
+
+#if UDP_AUDIO_TRANSPORT
+/* Group audio is sent to, if any, and the interface it leaves from */
+static const char* multicastGroup(MULTICAST_GROUP_ADDR);
+static const char* multicastInterface(MULTICAST_INTERFACE_ADDR);
+
+/* Clients listening to group audio */
+static std::atomic_int groupListeners(0);
+#endif
+
+/* Audio storage claimed once at boot */
+static Buffer::Arena audioArena(AUDIO_ARENA_SIZE);
+
 /* Audio I/O */
-static Buffer::AtomicMultiReadRingBuffer<AUDIO_DATATYPE> ringBuffer(
+static Buffer::BroadcastRingBuffer<AUDIO_DATATYPE> ringBuffer(
         RING_BUFFER_LENGTH,
-        RING_LENGTH
+        RING_LENGTH,
+        Buffer::OVERWRITE_SLOWEST_READER
     );
+/* Receive ring sizes are fixed at compile time */
+static Buffer::StaticRingBuffer<
+        AUDIO_DATATYPE,
+        (RING_BUFFER_LENGTH),
+        (RING_LENGTH)
+    > receiveRingBuffer;
 static I2S::Bus i2s;
+/* Keeps the audio loop of the current mode running */
+static std::atomic_bool audioRunning(false);
 
 /* Hardware button */
 static Esp32Button::DualActionButton button(BUTTON_PIN);
@@ -135,13 +330,31 @@ static Esp32Button::DualActionButton button(BUTTON_PIN);
 static WIFBDevice self;
 static WIFBMetadata metadata;
 static std::vector<std::shared_ptr<WIFBDevice>> connectedClients;
+static std::mutex clientsMutex;
+
+/* Scratch of the session on each ring reader, set up at boot
+so that sessions coming and going allocate nothing */
+struct SessionScratch
+{
+    /* Encoded payload, carved from audioArena */
+    uint8_t* encoded;
+
+    /* Codec for each encoding, or nullptr for pcm.  Every frame
+    decodes on its own, so a codec passes from one session on
+    the reader to the next. */
+    std::unique_ptr<WIFBCodec> codecs[(WIFB_ENCODING_ADPCM) + 1];
+};
+static SessionScratch sessionScratch[RINGBUFF_MAX_READERS];
+#ifdef ESP_PLATFORM
 static int retryNum = 0;
 static EventGroupHandle_t staEventGroup;
+#endif
 
 /*                           Declarations                           */
 
 /* Audio */
 
+bool allocate_audio_storage(void);
 void i2s_to_ring_buffer(void);
 void i2s_to_buffer_loop(void);
 void ring_buffer_to_i2s(void);
@@ -157,37 +370,105 @@ std::shared_ptr<WIFBDevice> get_client_from_mac(const uint8_t addr[6]);
 
 /* Transmitter */
 
+#ifdef ESP_PLATFORM
 void ap_event_handler(
         void* arg,
         esp_event_base_t eventBase,
         int32_t eventId,
         void* data
     );
+#endif
 int config_ap(void);
 void purge_disconnected_clients(void);
 void socket_server_tcp(void);
-void socket_server_udp(void);
+void client_session(int clientSock, struct sockaddr_in clientAddress);
+WIFBCodec* session_codec(int_fast8_t reader, uint8_t encoding);
+int_fast8_t send_frame(
+        int dataSock,
+        int_fast8_t reader,
+        WIFBFrameEncoder* encoder,
+        WIFBCodec* codec,
+        uint8_t* encoded
+    );
 void client_sock_handler(std::shared_ptr<WIFBDevice> client);
+#if UDP_AUDIO_TRANSPORT
+void client_control_handler(std::shared_ptr<WIFBDevice> client);
+void group_sock_handler(void);
+#endif
 
 /* Receiver */
 
+#ifdef ESP_PLATFORM
 void sta_event_handler(
         void* arg,
         esp_event_base_t eventBase,
         int32_t eventId,
         void* data
     );
+#endif
 int config_sta(void);
-void socket_client(void);
+int_fast32_t decode_payload(
+        std::unique_ptr<WIFBCodec>* codec,
+        uint8_t encoding,
+        uint8_t* pcm,
+        const uint8_t* payload,
+        int_fast32_t length
+    );
+void receive_tcp_audio(void);
+void receive_udp_audio(int udpSock);
+void socket_client_tcp(void);
 
 /* Main */
 
 extern "C" void app_main(void);
 
+#ifndef ESP_PLATFORM
+void host_mac_addr(uint8_t addr[6]);
+int main(int argc, char** argv);
+#endif
+
 /*                            Definitions                           */
 
 /* Audio */
 
+bool allocate_audio_storage(void)
+{
+    /* The transmit ring moves before either end of it runs;
+    the receive ring is static storage already */
+    if (!audioArena.valid()) return false;
+    if (audioArena.available() < static_cast<size_t>(ringBuffer.total_size())) return false;
+    ringBuffer.set_arena(&audioArena);
+
+    /* Encoding a chunk of silence sizes each codec's own scratch */
+    std::vector<uint8_t> silence(TRANSMIT_DATA_CHUNKSIZE, 0);
+    uint8_t* const regions[1] = {silence.data()};
+    const int_fast32_t lengths[1] = {(TRANSMIT_DATA_CHUNKSIZE)};
+    for (SessionScratch& scratch: sessionScratch)
+    {
+        int_fast32_t encodedSize(TRANSMIT_DATA_CHUNKSIZE);
+        for (uint8_t encoding(0); encoding <= (WIFB_ENCODING_ADPCM); ++encoding)
+        {
+            scratch.codecs[encoding] = make_codec(encoding, ((SAMPLE_WIDTH) * 8), (NUM_CHANNELS));
+            if (!scratch.codecs[encoding]) continue;
+            encodedSize = std::max(
+                    encodedSize,
+                    scratch.codecs[encoding]->max_encoded_size(TRANSMIT_DATA_CHUNKSIZE)
+                );
+        }
+
+        scratch.encoded = static_cast<uint8_t*>(audioArena.allocate(encodedSize));
+        if (scratch.encoded == nullptr) return false;
+        for (std::unique_ptr<WIFBCodec>& codec: scratch.codecs)
+        {
+            if (codec) codec->encode(scratch.encoded, regions, lengths, 1);
+        }
+    }
+
+    DEBUG_OUT("Audio storage uses " << audioArena.used() << " of ");
+    DEBUG_OUT(audioArena.size() << " bytes\n");
+    return true;
+}
+
 void i2s_to_ring_buffer(void)
 {
     /* Read from i2s input to ring buffer */
@@ -199,10 +480,12 @@ void i2s_to_ring_buffer(void)
     {
         DEBUG_OUT("Reading from i2s...\n");
 
-        #if I2S_ENABLED
-        i2s.read(ringBuffer.get_write_buffer(), unwritten);
+        #if (I2S_ENABLED && ((BITS_PER_SAMPLE) == 24))
+        i2s.read_samples(ringBuffer.get_write_sample(), unwritten);
+        #elif I2S_ENABLED
+        i2s.read_bytes(ringBuffer.get_write_byte(), unwritten * SAMPLE_WIDTH);
         #else
-        std::memset(ringBuffer.get_write_byte(), 0, (unwritten / SAMPLE_WIDTH));
+        std::memset(ringBuffer.get_write_byte(), 0, unwritten * SAMPLE_WIDTH);
         #endif
 
         DEBUG_OUT("Read from i2s\n");
@@ -222,20 +505,25 @@ void i2s_to_ring_buffer(void)
 void i2s_to_buffer_loop(void)
 {
     DEBUG_OUT("Running i2s_to_buffer_loop...\n");
-    DELAY_COUNTER_INT(0);
-    while (true)
+    while (audioRunning)
     {
-        i2s_to_ring_buffer();
-        DELAY_TICKS_AT_COUNT(125);
+        /* Sleep rather than spin while readers hold the ring full */
+        if (ringBuffer.wait_writable(
+                ringBuffer.buffer_length(),
+                (RING_WAIT_TIMEOUT_MS)
+            ))
+        {
+            i2s_to_ring_buffer();
+        }
     }
-    DEBUG_ERR("i2s_to_buffer_loop exited unexpectedly\n");
+    DEBUG_OUT("i2s_to_buffer_loop stopped\n");
 }
 
 void ring_buffer_to_i2s(void)
 {
     /* Write from ring buffer to i2s output */
-    if (!ringBuffer.buffers_buffered()) return;
-    const int unread(ringBuffer.unread());
+    if (!receiveRingBuffer.buffers_buffered()) return;
+    const int unread(receiveRingBuffer.unread());
     
     #if _DEBUG
     if (!unread)
@@ -245,26 +533,32 @@ void ring_buffer_to_i2s(void)
     }
     #endif
     
-    #if I2S_ENABLED
-    i2s.write(ringBuffer.get_read_buffer(), unread);
+    #if (I2S_ENABLED && ((BITS_PER_SAMPLE) == 24))
+    i2s.write_samples(receiveRingBuffer.get_read_sample(), unread);
+    #elif I2S_ENABLED
+    i2s.write_bytes(receiveRingBuffer.get_read_byte(), unread * SAMPLE_WIDTH);
     #endif
 
     DEBUG_OUT("Reporting " << unread);
     DEBUG_OUT(" read samples to ring buffer\n");
 
-    ringBuffer.report_read_samples(unread);
+    receiveRingBuffer.report_read_samples(unread);
 }
 
 void buffer_to_i2s_loop(void)
 {
     DEBUG_OUT("Running buffer_to_i2s_loop...\n");
-    DELAY_COUNTER_INT(0);
-    while (true)
+    while (audioRunning)
     {
-        ring_buffer_to_i2s();
-        DELAY_TICKS_AT_COUNT(125);
+        if (receiveRingBuffer.wait_readable(
+                receiveRingBuffer.buffer_length(),
+                (RING_WAIT_TIMEOUT_MS)
+            ))
+        {
+            ring_buffer_to_i2s();
+        }
     }
-    DEBUG_ERR("buffer_to_i2s_loop exited unexpectedly\n");
+    DEBUG_OUT("buffer_to_i2s_loop stopped\n");
 }
 
 // void osc_to_ring_buffer(void)
@@ -295,6 +589,7 @@ void buffer_to_i2s_loop(void)
 
 std::shared_ptr<WIFBDevice> get_client_from_mac(const uint8_t addr[6])
 {
+    /* Caller must hold clientsMutex */
     DEBUG_OUT("Retrieving client from mac addr...\n");
 
     for (std::shared_ptr<WIFBDevice> c: connectedClients)
@@ -310,6 +605,8 @@ std::shared_ptr<WIFBDevice> get_client_from_mac(const uint8_t addr[6])
 
 /* Transmitter */
 
+#ifdef ESP_PLATFORM
+
 void ap_event_handler(
         void* arg,
         esp_event_base_t eventBase,
@@ -333,12 +630,13 @@ void ap_event_handler(
                 reinterpret_cast<wifi_event_ap_stadisconnected_t*>(data)
             );
         
+        std::lock_guard<std::mutex> lock(clientsMutex);
         std::shared_ptr<WIFBDevice> client = get_client_from_mac(event->mac);
         if (client != nullptr)
         {
+            /* The client's session closes its own socket */
             client->socketConnected = false;
             client->networkConnected = false;
-            client->sock = 0;
 
             DEBUG_OUT("Disconnected client:\n");
             DEBUG_OUT("\t  ip: " << ip_addr_string(client->ip) << '\n');
@@ -397,52 +695,39 @@ int config_ap(void)
     return ((rc != ESP_OK) ? rc : 0);
 }
 
+#else
+
+int config_ap(void)
+{
+    /* Host transmitter serves receivers over its own interfaces */
+    host_mac_addr(self.mac);
+    return 0;
+}
+
+#endif
+
 void purge_disconnected_clients()
 {
+    /* Caller must hold clientsMutex */
     #if _DEBUG
     int lengthBeforePurge(static_cast<int>(connectedClients.size()));
-    DEBUG_OUT("Purging ");
     #endif
 
-    std::vector<std::vector<std::shared_ptr<WIFBDevice>>::iterator> purgeList;
-    int length(0);
-    for (
-            auto it = std::begin(connectedClients);
-            it != std::end(connectedClients);
-            ++it
-        )
-    {
-        std::shared_ptr<WIFBDevice> c = *it;
-        if (c == nullptr) continue;
-        else if (!c->socketConnected)
-        {
-            purgeList.push_back(it);
-            ++length;
-        }
-    }
-
-    DEBUG_OUT(length << " disconnected clients\n");
-    
-    for (int i(0); i < length; ++i)
-    {
-        connectedClients.erase(purgeList[i]);
-    }
+    connectedClients.erase(
+            std::remove_if(
+                connectedClients.begin(),
+                connectedClients.end(),
+                [](const std::shared_ptr<WIFBDevice>& c)
+                {
+                    return ((c == nullptr) || !c->socketConnected);
+                }
+            ),
+            connectedClients.end()
+        );
 
     #if _DEBUG
-    int numPurged(
-            lengthBeforePurge
-            - static_cast<int>(connectedClients.size())
-        );
-    if (numPurged == length)
-    {
-        DEBUG_OUT("Sucessfully purged ");
-        DEBUG_OUT(length << " disconnected clients\n");
-    }
-    else
-    {
-        DEBUG_ERR("Error: purged " << numPurged);
-        DEBUG_ERR(" of " << length << " disconnected clients\n");
-    }
+    DEBUG_OUT("Purged " << (lengthBeforePurge - static_cast<int>(connectedClients.size())));
+    DEBUG_OUT(" disconnected clients\n");
     #endif
 }
 
@@ -475,7 +760,8 @@ void socket_server_tcp(void)
         );
     if (rc < 0)
     {
-        DEBUG_OUT("bind: " << rc << errno << '\n');
+        DEBUG_ERR("bind: " << rc << " " << errno << '\n');
+        close(sock);
         return;
     }
 
@@ -485,15 +771,38 @@ void socket_server_tcp(void)
     rc = listen(sock, 5);
     if (rc < 0)
     {
-        DEBUG_OUT("listen: " << rc << errno << '\n');
+        DEBUG_ERR("listen: " << rc << " " << errno << '\n');
+        close(sock);
         return;
     }
 
-    DELAY_COUNTER_INT(0);
-    uint8_t incomingMacAddr[6];
+    #ifdef ESP_PLATFORM
+    /* Size the tasks that back each client's std::thread */
+    esp_pthread_cfg_t threadConfig = esp_pthread_get_default_config();
+    threadConfig.stack_size = (CLIENT_TASK_STACK_SIZE);
+    threadConfig.thread_name = "wifb_client";
+    esp_pthread_set_cfg(&threadConfig);
+    #endif
+
+    #if UDP_AUDIO_TRANSPORT
+    /* Group audio is read and sent by one task for every client */
+    if (multicastGroup)
+    {
+        try
+        {
+            std::thread(group_sock_handler).detach();
+        }
+        catch (...)
+        {
+            DEBUG_ERR("Unable to launch group sender\n");
+            close(sock);
+            return;
+        }
+    }
+    #endif
+
     socklen_t clientAddressLength;
     int clientSock;
-    std::shared_ptr<WIFBDevice> client;
 
     while (true)
     {
@@ -507,309 +816,458 @@ void socket_server_tcp(void)
                 &clientAddressLength
             );
 
-
         if (clientSock < 0)
         {
-            DEBUG_OUT("accept: " << clientSock << " " << errno << '\n');
-            return;
+            DEBUG_ERR("accept: " << clientSock << " " << errno << '\n');
+            break;
         }
 
         DEBUG_OUT("Accepted connection from client\n");
 
-        // Index client mac address
-        recv(clientSock, incomingMacAddr, 6, 0);
-        
+        // Handshake and stream on a thread of its own,
+        // so no client can hold up the next accept
+        try
+        {
+            std::thread(client_session, clientSock, clientAddress).detach();
+            DEBUG_OUT("Client session launched\n");
+        }
+        catch (...)
+        {
+            DEBUG_ERR("Unable to launch client session\n");
+            close(clientSock);
+        }
+    }
+    close(sock);
+    DEBUG_ERR("Exiting socket_server_tcp\n");
+}
+
+void client_session(int clientSock, struct sockaddr_in clientAddress)
+{
+    // A client that connects but never sends its hello
+    // gives up its session after a while
+    struct timeval timeout;
+    timeout.tv_sec = (HELLO_TIMEOUT_MS) / 1000;
+    timeout.tv_usec = ((HELLO_TIMEOUT_MS) % 1000) * 1000;
+    setsockopt(clientSock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // Receive client mac address and udp audio port
+    uint8_t hello[WIFB_HELLO_SIZE];
+    struct iovec helloIov;
+    helloIov.iov_base = hello;
+    helloIov.iov_len = (WIFB_HELLO_SIZE);
+    if (recv_iov(clientSock, &helloIov, 1) != (WIFB_HELLO_SIZE))
+    {
+        DEBUG_ERR("Client did not complete handshake\n");
+        close(clientSock);
+        return;
+    }
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 0;
+    setsockopt(clientSock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // Each connection gets its own device record, so a session
+    // still winding down for a reconnecting client keeps its own
+    // socket and only sees itself marked disconnected
+    std::shared_ptr<WIFBDevice> client = std::make_shared<WIFBDevice>();
+    std::memcpy(client->mac, hello, 6);
+    std::memcpy(
+            client->ip,
+            reinterpret_cast<uint8_t*>(&clientAddress.sin_addr.s_addr),
+            4
+        );
+    client->networkConnected = true;
+    client->socketConnected = true;
+    client->sock = clientSock;
+    client->udpPort = static_cast<uint16_t>((hello[6] << 8) | hello[7]);
+    client->encoding = hello[8];
+
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+
         // Check if client is reconnecting or new
-        client = get_client_from_mac(incomingMacAddr);
-        if (client == nullptr)
+        std::shared_ptr<WIFBDevice> previous = get_client_from_mac(hello);
+        if (previous != nullptr)
+        {
+            DEBUG_OUT("Existing client found:\n");
+            previous->socketConnected = false;
+            std::replace(
+                    connectedClients.begin(),
+                    connectedClients.end(),
+                    previous,
+                    client
+                );
+        }
+        else
         {
-            // Create new client
             DEBUG_OUT("New client found:\n");
-
-            client = std::make_shared<WIFBDevice>();
             connectedClients.push_back(client);
-            
+
             // Purge inactive receivers from client list
             if (connectedClients.size() > CONFIG_MAX_STA_CONNECTIONS)
             {
                 purge_disconnected_clients();
             }
-
-            std::memcpy(client->mac, incomingMacAddr, 6);
-            std::memcpy(
-                    client->ip,
-                    reinterpret_cast<uint8_t*>(&clientAddress.sin_addr.s_addr),
-                    4
-                );
-            DEBUG_OUT("New client created\n");
-        }
-        else
-        {
-            DEBUG_OUT("Existing client found:\n");
         }
+    }
 
-        // Update client status in index
-        client->networkConnected = true;
-        client->socketConnected = true;
-        client->sock = clientSock;
+    DEBUG_OUT("\t  ip: " << ip_addr_string(client->ip) << '\n');
+    DEBUG_OUT("\t mac: " << mac_addr_string(client->mac) << '\n');
+    DEBUG_OUT("\tsock: " << client->sock << '\n');
+    DEBUG_OUT("\t udp: " << client->udpPort << '\n');
+    DEBUG_OUT("\t enc: " << +(client->encoding) << '\n');
 
-        DEBUG_OUT("\t  ip: " << ip_addr_string(client->ip) << '\n');
-        DEBUG_OUT("\t mac: " << mac_addr_string(client->mac) << '\n');
-        DEBUG_OUT("\tsock: " << client->sock << '\n');
+    #if UDP_AUDIO_TRANSPORT
+    // Tell the client where its audio will arrive
+    uint8_t group[WIFB_GROUP_SIZE] = {0, 0, 0, 0, 0, 0};
+    if (multicastGroup)
+    {
+        inet_pton(AF_INET, multicastGroup, group);
+        group[4] = static_cast<uint8_t>((MULTICAST_PORT) >> 8);
+        group[5] = static_cast<uint8_t>(MULTICAST_PORT);
+    }
+    if (send(clientSock, group, (WIFB_GROUP_SIZE), (WIFB_SEND_FLAGS)) != (WIFB_GROUP_SIZE))
+    {
+        DEBUG_ERR("Unable to send group to client\n");
+        client->socketConnected = false;
+    }
 
-        // Launch handler for individual client
-        client_sock_handler(client);
-        // std::thread t(client_sock_handler, client);
+    if (multicastGroup) client_control_handler(client);
+    else client_sock_handler(client);
+    #else
+    client_sock_handler(client);
+    #endif
 
-        DEBUG_OUT("Client handler launched\n");
-        
-        DELAY_TICKS_AT_COUNT(125);
-    }
-    DEBUG_ERR("Exiting socket_server_tcp\n");
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    connectedClients.erase(
+            std::remove(connectedClients.begin(), connectedClients.end(), client),
+            connectedClients.end()
+        );
 }
 
-void socket_server_udp(void)
+int_fast8_t send_frame(
+        int dataSock,
+        int_fast8_t reader,
+        WIFBFrameEncoder* encoder,
+        WIFBCodec* codec,
+        uint8_t* encoded
+    )
 {
-    DEBUG_OUT("Starting udp socket server\n");
+    /* Each frame is a header, audio sent straight from ring memory,
+    then metadata; a chunk that wraps the end of the ring
+    takes two iovecs.  With a codec the chunk is encoded
+    from ring memory and sent from encoded instead.  Returns
+    the number of ring regions sent, zero if no chunk was
+    ready, or -1 if the send failed. */
+    int rc(0);
+    int_fast8_t numPayloadRegions;
+    int_fast32_t payloadLength;
+    struct iovec iov[4];
+    uint8_t* regions[2];
+    int_fast32_t lengths[2];
+
+    DEBUG_OUT(ringBuffer.buffered(reader) << " samples buffered");
+    DEBUG_OUT(" of total ring sample length of ");
+    DEBUG_OUT(ringBuffer.size() << '\n');
+    DEBUG_OUT("Transmission size is " << (TRANSMISSION_SIZE) << "; ");
+    DEBUG_OUT("Transmission data chunk size is " << (TRANSMIT_DATA_CHUNKSIZE) << '\n');
+
+    /* Update metadata with current timecode using metadata.set_timecode() */
+
+    /* Sleep until a chunk is ready, waking periodically
+    so callers can notice departed clients */
+    ringBuffer.wait_readable(
+            reader,
+            (TRANSMIT_DATA_CHUNKSIZE) / (SAMPLE_WIDTH),
+            (RING_WAIT_TIMEOUT_MS)
+        );
 
-    int rc;
-    DELAY_COUNTER_INT(0);
-    uint8_t rx_buffer[128];
-    const char* tx_buffer = "hello from socket_server_udp";
-    struct sockaddr_in serverAddress;
+    /* Keep the sample clock continuous across skipped audio */
+    const int_fast32_t skippedSamples(ringBuffer.skipped(reader));
+    if (skippedSamples)
+    {
+        encoder->skip_samples(
+                skippedSamples / (NUM_CHANNELS),
+                skippedSamples / ((TRANSMIT_DATA_CHUNKSIZE) / (SAMPLE_WIDTH))
+            );
+        DEBUG_ERR("Reader lagging; skipped " << skippedSamples);
+        DEBUG_ERR(" samples\n");
+    }
 
-    while (true)
+    const int_fast8_t numRegions(ringBuffer.get_read_byte_regions(
+            reader,
+            (TRANSMIT_DATA_CHUNKSIZE),
+            regions,
+            lengths
+        ));
+
+    if (numRegions)
     {
-        DEBUG_OUT("Creating socket...\n");
-        self.sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
-        if (self.sock < 0)
+        DEBUG_OUT("Sending data from ");
+        DEBUG_OUT(+numRegions << " ring region(s)\n");
+        DEBUG_OUT("Sending timecode: " << std::setfill('0'));
+        for (int i(0); i < 4; ++i)
         {
-            DEBUG_ERR("Error creating socket\n");
-            break;
+            DEBUG_OUT(std::setw(2) << +(metadata.timecode[i]) << ((i == 3) ? '\n' : ':'));
         }
-        else
+
+        numPayloadRegions = numRegions;
+        payloadLength = (TRANSMIT_DATA_CHUNKSIZE);
+        if (codec)
         {
-            DEBUG_OUT("Socket created\n");
+            payloadLength = codec->encode(encoded, regions, lengths, numRegions);
+            regions[0] = encoded;
+            lengths[0] = payloadLength;
+            numPayloadRegions = 1;
         }
 
-        int enable = 1;
-        lwip_setsockopt(
-                self.sock,
-                IPPROTO_IP,
-                IP_PKTINFO,
-                &enable,
-                sizeof(enable)
-            );
-
-        struct timeval timeout;
-        timeout.tv_sec = 10;
-        timeout.tv_usec = 0;
-        setsockopt(
-                self.sock,
-                SOL_SOCKET,
-                SO_RCVTIMEO,
-                &timeout,
-                sizeof(timeout)
+        encoder->encode(
+                payloadLength,
+                (METADATA_SIZE),
+                (TRANSMIT_FRAME_SAMPLES)
             );
 
-        DEBUG_OUT("Binding socket to port...\n");
-        serverAddress.sin_family = AF_INET;
-        serverAddress.sin_addr.s_addr = htonl(INADDR_ANY);
-        serverAddress.sin_port = htons(CONFIG_PORT);
-        rc = bind(
-                self.sock,
-                reinterpret_cast<sockaddr*>(&serverAddress),
-                sizeof(serverAddress)
-            );
-        if (rc < 0)
+        iov[0].iov_base = encoder->data;
+        iov[0].iov_len = (WIFB_FRAME_HEADER_SIZE);
+        for (int_fast8_t i(0); i < numPayloadRegions; ++i)
         {
-            DEBUG_ERR("bind err; rc: " << rc << '\n');
-            return;
+            iov[i + 1].iov_base = regions[i];
+            iov[i + 1].iov_len = lengths[i];
         }
+        iov[numPayloadRegions + 1].iov_base = metadata.data;
+        iov[numPayloadRegions + 1].iov_len = (METADATA_SIZE);
 
-        struct sockaddr_storage source_addr;
-        socklen_t socklen = sizeof(source_addr);
+        DEBUG_OUT("Sending frame " << encoder->header().sequence << " of ");
+        DEBUG_OUT(((WIFB_FRAME_HEADER_SIZE) + payloadLength + (METADATA_SIZE)));
+        DEBUG_OUT(" bytes to socket\n");
 
-        struct iovec iov;
-        struct msghdr msg;
-        uint8_t cmsg_buf[CMSG_SPACE(sizeof(struct in_pktinfo))];
+        /* Send header, audio and metadata in one call */
+        rc = send_iov(dataSock, iov, numPayloadRegions + 2);
 
-        iov.iov_base = rx_buffer;
-        iov.iov_len = sizeof(rx_buffer);
-        msg.msg_control = cmsg_buf;
-        msg.msg_controllen = sizeof(cmsg_buf);
-        msg.msg_flags = 0;
-        msg.msg_iov = &iov;
-        msg.msg_iovlen = 1;
-        msg.msg_name = reinterpret_cast<sockaddr*>(&source_addr);
-        msg.msg_namelen = socklen;
-
-        while (true)
+        if (rc < 0)
         {
-            DEBUG_OUT("Waiting for data...\n");
-            int length = recvmsg(self.sock, &msg, 0);
+            DEBUG_ERR("Error sending data\n");
+        }
 
-            if (length < 0)
-            {
-                DEBUG_ERR("Error receiving data\n");
-                break;
-            }
+        DEBUG_OUT("Sent timecode " << std::setfill('0'));
+        #if _DEBUG
+        for (int i(0); i < 4; ++i)
+        {
+            DEBUG_OUT(std::setw(2) << (+metadata.timecode[i]));
+            DEBUG_OUT(((i == 3) ? '\n' : ':'));
+        }
+        #endif
 
-            rx_buffer[length] = 0;
-            DEBUG_OUT("Data received of length " << length);
-            DEBUG_OUT("\n\t" << rx_buffer << '\n');
-
-            rc = sendto(
-                    self.sock,
-                    tx_buffer,
-                    strlen(tx_buffer),
-                    0,
-                    reinterpret_cast<sockaddr*>(&source_addr),
-                    sizeof(source_addr)
-                );
-            if (rc < 0)
-            {
-                DEBUG_ERR("Error occurred during sending\n");
-                break;
-            }
-            DEBUG_OUT("Data sent\n");
+        DEBUG_OUT("Reporting " << (TRANSMIT_DATA_CHUNKSIZE) << " read bytes to buffer\n");
 
-            DELAY_TICKS_AT_COUNT(125);
-        }
+        /* Ring memory is released only after the send completes */
+        ringBuffer.report_read_bytes(reader, TRANSMIT_DATA_CHUNKSIZE);
 
-        if (self.sock != -1)
+        /* A chunk the writer overran while it was sent still went
+        out as a frame, so unlike skipped audio it leaves the
+        sequence alone */
+        if (ringBuffer.overrun(reader))
         {
-            DEBUG_ERR("Shutting down socket and restarting...\n");
-            shutdown(self.sock, 0);
-            close(self.sock);
+            DEBUG_ERR("Reader overrun while sending frame ");
+            DEBUG_ERR(encoder->header().sequence << '\n');
         }
     }
+    #if _DEBUG
+    else
+    {
+        DEBUG_OUT("ringBuffer.buffered() == " << ringBuffer.buffered(reader));
+        DEBUG_OUT("\t(TRANSMIT_DATA_CHUNKSIZE) == " << (TRANSMIT_DATA_CHUNKSIZE) << '\n');
+    }
+    #endif
 
-    DEBUG_ERR("Exiting socket_server_udp\n");
+    return ((rc < 0) ? -1 : numRegions);
 }
 
-void client_sock_handler(std::shared_ptr<WIFBDevice> client)
+WIFBCodec* session_codec(int_fast8_t reader, uint8_t encoding)
 {
-    DELAY_COUNTER_INT(0);
-    int rc;
+    if (encoding > (WIFB_ENCODING_ADPCM)) return nullptr;
+    return sessionScratch[reader].codecs[encoding].get();
+}
 
-    int_fast8_t numReaders = ringBuffer.num_readers();
+void client_sock_handler(std::shared_ptr<WIFBDevice> client)
+{
+    /* Each client reads from its own cursor,
+    so a stalled client cannot hold back the others */
+    const int_fast8_t reader(ringBuffer.add_reader());
+    if (reader < 0)
+    {
+        DEBUG_ERR("No ring buffer reader available for client\n");
+        client->socketConnected = false;
+        close(client->sock);
+        return;
+    }
 
-    DEBUG_OUT("Current num readers: " << +numReaders);
-    DEBUG_OUT("\nSetting new num readers to: ");
-    DEBUG_OUT(+((numReaders > 1) ? (numReaders + 1) : numReaders));
-    DEBUG_OUT('\n');
+    DEBUG_OUT("Registered ring buffer reader " << +reader);
+    DEBUG_OUT(" of " << +ringBuffer.num_readers() << '\n');
+
+    #if UDP_AUDIO_TRANSPORT
+    /* Audio goes to the client's udp port as one datagram per frame;
+    the tcp socket stays open only as the control channel */
+    const int dataSock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    struct sockaddr_in clientAddress;
+    std::memset(&clientAddress, 0, sizeof(clientAddress));
+    clientAddress.sin_family = AF_INET;
+    std::memcpy(&clientAddress.sin_addr.s_addr, client->ip, 4);
+    clientAddress.sin_port = htons(client->udpPort);
+    if (
+            (dataSock < 0)
+            || (connect(
+                    dataSock,
+                    reinterpret_cast<sockaddr*>(&clientAddress),
+                    sizeof(clientAddress)
+                ) < 0)
+        )
+    {
+        DEBUG_ERR("Unable to open udp socket to client\n");
+        client->socketConnected = false;
+    }
+    int framesSincePoll(0);
+    #else
+    const int dataSock = client->sock;
+    #endif
 
-    /* Set the number of connected clients.
-    The first client is already accounted for
-    in the ring buffer read counter. */
-    ringBuffer.set_num_readers(
-            (numReaders > 1)
-            ? (numReaders + 1)
-            : numReaders
+    /* The client gets the encoding it asked for when there
+    is a codec for it, and otherwise the default */
+    WIFBCodec* codec(session_codec(reader, client->encoding));
+    if (!codec && (client->encoding != WIFB_ENCODING_PCM))
+    {
+        codec = session_codec(reader, (AUDIO_ENCODING));
+    }
+    uint8_t* const encoded(sessionScratch[reader].encoded);
+    WIFBFrameEncoder encoder(
+            (codec ? codec->encoding() : static_cast<uint8_t>(WIFB_ENCODING_PCM)),
+            ((SAMPLE_WIDTH) * 8),
+            (NUM_CHANNELS)
         );
 
-    DEBUG_OUT("Num readers set to " << +ringBuffer.num_readers() << '\n');
-
-    DEBUG_OUT("Zeroing sendBuff\n");
-    uint8_t sendBuff[TRANSMISSION_SIZE];
-    std::memset(sendBuff, 0, TRANSMISSION_SIZE);
-
     while (client->socketConnected)
     {
-        DEBUG_OUT(ringBuffer.buffered() << " samples buffered");
-        DEBUG_OUT(" of total ring sample length of ");
-        DEBUG_OUT(ringBuffer.size() << '\n');
-        DEBUG_OUT("Transmission size is " << (TRANSMISSION_SIZE) << "; ");
-        DEBUG_OUT("Transmission data chunk size is " << (TRANSMIT_DATA_CHUNKSIZE) << '\n');
-
-        /* Update metadata with current timecode using metadata.set_timecode() */
-
-        int unreadBytes(ringBuffer.bytes_unread());
-
-        if (unreadBytes >= (TRANSMIT_DATA_CHUNKSIZE))
+        #if UDP_AUDIO_TRANSPORT
+        const int_fast8_t numRegions(send_frame(
+                dataSock,
+                reader,
+                &encoder,
+                codec,
+                encoded
+            ));
+
+        /* Datagrams rarely fail on a departed receiver, so watch
+        the control channel for it to close, at once if one does */
+        if ((numRegions <= 0) || (++framesSincePoll >= (CONTROL_POLL_FRAMES)))
         {
-            DEBUG_OUT("Sending data to client\n");
-            DEBUG_OUT("Copying data from ringBuffer to sendBuff\n");
-
-            /* Copy audio data to send buffer */
-            std::memcpy(
-                    &(sendBuff[0]),
-                    ringBuffer.get_read_byte(),
-                    (TRANSMIT_DATA_CHUNKSIZE)
-                );
-
-            DEBUG_OUT("Copying data from metadata.data to sendBuff\n");
-            DEBUG_OUT("Sending timecode: " << std::setfill('0'));
-            for (int i(0); i < 4; ++i)
+            framesSincePoll = 0;
+            if (peer_closed(client->sock))
             {
-                DEBUG_OUT(std::setw(2) << +(metadata.timecode[i]) << ((i == 3) ? '\n' : ':'));
+                DEBUG_OUT("Client closed control channel\n");
+                client->socketConnected = false;
             }
+        }
+        #else
+        /* A failed send on the stream means the client is gone */
+        if (send_frame(dataSock, reader, &encoder, codec, encoded) < 0)
+        {
+            DEBUG_OUT("Client stopped receiving\n");
+            client->socketConnected = false;
+        }
+        #endif
 
-            /* Copy metadata to buffer */
-            metadata.get_data(&(sendBuff[(TRANSMIT_DATA_CHUNKSIZE)]));
+        DEBUG_OUT("Cycling...\n");
+    }
 
-            DEBUG_OUT("Sending " << +(TRANSMISSION_SIZE) << " bytes to socket\n");
+    DEBUG_OUT("Removing ring buffer reader for disconnected client\n");
 
-            /* Send buffered data to client */
-            rc = send(
-                    client->sock,
-                    sendBuff,
-                    (TRANSMISSION_SIZE),
-                    0
-                );
+    ringBuffer.remove_reader(reader);
 
-            if (rc < 0)
-            {
-                DEBUG_ERR("Error sending data\n");
-            }
+    DEBUG_OUT("Closing client socket\n");
 
-            DEBUG_OUT("Sent timecode " << std::setfill('0'));
-            #if _DEBUG
-            for (int i(0); i < 4; ++i)
-            {
-                DEBUG_OUT(std::setw(2) << (+metadata.timecode[i]));
-                DEBUG_OUT(((i == 3) ? '\n' : ':'));
-            }
-            #endif
+    #if UDP_AUDIO_TRANSPORT
+    if (dataSock >= 0) close(dataSock);
+    #endif
 
-            DEBUG_OUT("Reporting " << (TRANSMIT_DATA_CHUNKSIZE) << " read bytes to buffer\n");
-            
-            ringBuffer.report_read_bytes(TRANSMIT_DATA_CHUNKSIZE);
-        }
-        #if _DEBUG
-        else
+    close(client->sock);
+}
+
+#if UDP_AUDIO_TRANSPORT
+
+void client_control_handler(std::shared_ptr<WIFBDevice> client)
+{
+    /* Audio reaches the client from group_sock_handler,
+    so only the control channel is watched for it to close */
+    ++groupListeners;
+    while (client->socketConnected)
+    {
+        delay_ms(RING_WAIT_TIMEOUT_MS);
+        if (peer_closed(client->sock))
         {
-            DEBUG_OUT("ringBuffer.buffered() == " << ringBuffer.buffered());
-            DEBUG_OUT("\t(TRANSMIT_DATA_CHUNKSIZE) == " << (TRANSMIT_DATA_CHUNKSIZE) << '\n');
+            DEBUG_OUT("Client closed control channel\n");
+            client->socketConnected = false;
         }
-        #endif
-
-        DEBUG_OUT("Incrementing delay counter\n");
-        DELAY_TICKS_AT_COUNT(125);
-        DEBUG_OUT("Cycling...\n");
     }
+    --groupListeners;
 
-    DEBUG_OUT("Decrementing num readers for disconnected client\n");
+    DEBUG_OUT("Closing client socket\n");
 
-    // DEBUG_OUT("Dellocating sendBuff\n");
-    // delete sendBuff;
-    // DEBUG_OUT("Dellocated sendBuff\n");
+    close(client->sock);
+}
 
-    /* Do not decrement the read counter below one */
-    ringBuffer.set_num_readers(
-            (numReaders > 1)
-            ? (numReaders - 1)
-            : numReaders
+void group_sock_handler(void)
+{
+    /* Every client hears the same datagrams, so each chunk is read,
+    encoded and sent once however many clients there are.  The
+    group gets the default encoding, as clients cannot choose. */
+    const int_fast8_t reader(ringBuffer.add_reader());
+    uint8_t group[4], interface[4] = {0, 0, 0, 0};
+    int dataSock(-1);
+    if (
+            (reader >= 0)
+            && (inet_pton(AF_INET, multicastGroup, group) == 1)
+            && (!multicastInterface || (inet_pton(AF_INET, multicastInterface, interface) == 1))
+        )
+    {
+        dataSock = open_group_sender(group, (MULTICAST_PORT), interface);
+    }
+    if (dataSock < 0)
+    {
+        DEBUG_ERR("Unable to open group socket\n");
+        if (reader >= 0) ringBuffer.remove_reader(reader);
+        return;
+    }
+
+    DEBUG_OUT("Sending group audio to " << multicastGroup);
+    DEBUG_OUT(':' << (MULTICAST_PORT) << '\n');
+
+    WIFBCodec* const codec(session_codec(reader, (AUDIO_ENCODING)));
+    uint8_t* const encoded(sessionScratch[reader].encoded);
+    WIFBFrameEncoder encoder(
+            (codec ? codec->encoding() : static_cast<uint8_t>(WIFB_ENCODING_PCM)),
+            ((SAMPLE_WIDTH) * 8),
+            (NUM_CHANNELS)
         );
 
-    DEBUG_OUT("Closing client socket\n");
+    while (true)
+    {
+        /* Save airtime while nobody listens; the reader falls
+        behind and skips ahead once a client arrives */
+        if (!groupListeners)
+        {
+            delay_ms(RING_WAIT_TIMEOUT_MS);
+            continue;
+        }
 
-    close(client->sock);
+        send_frame(dataSock, reader, &encoder, codec, encoded);
+    }
 }
 
+#endif
+
 /* Receiver */
 
+#ifdef ESP_PLATFORM
+
 void sta_event_handler(
         void* arg,
         esp_event_base_t eventBase,
@@ -967,95 +1425,156 @@ int config_sta(void)
     return rc;
 }
 
-void socket_client_tcp(void)
-{
-    DEBUG_OUT("Starting socket_client_tcp...\n");
-    DEBUG_OUT("Creating socket...\n");
-
-    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    self.sock = sock;
-
-    DEBUG_OUT("socket rc: " << sock << '\n');
+#else
 
-    struct sockaddr_in serverAddress;
-    serverAddress.sin_family = AF_INET;
-    inet_pton(
-            AF_INET,
-            TRANSMITTER_IPV4_ADDR,
-            &serverAddress.sin_addr.s_addr
-        );
-    serverAddress.sin_port = htons(CONFIG_PORT);
+int config_sta(void)
+{
+    /* Host receiver reaches the transmitter over its own interfaces */
+    host_mac_addr(self.mac);
+    self.networkConnected = true;
+    self.socketConnected = false;
+    return 0;
+}
 
-    DEBUG_OUT("Connecting to server...\n");
-    int rc = connect(
-            self.sock,
-            (struct sockaddr*)&serverAddress,
-            sizeof(struct sockaddr_in)
-        );
-    DEBUG_OUT("connect rc: " << rc << '\n');
+#endif
 
-    if (self.socketConnected = (rc >= 0))
+int_fast32_t decode_payload(
+        std::unique_ptr<WIFBCodec>* codec,
+        uint8_t encoding,
+        uint8_t* pcm,
+        const uint8_t* payload,
+        int_fast32_t length
+    )
+{
+    /* The decoder is kept until the transmitter changes encoding */
+    if (!(*codec) || ((*codec)->encoding() != encoding))
     {
-        send(self.sock, self.mac, 6, 0);
-        DEBUG_OUT("Send self mac addr: " << mac_addr_string(self.mac) << '\n');
+        *codec = make_codec(encoding, ((SAMPLE_WIDTH) * 8), (NUM_CHANNELS));
+        if (!(*codec)) return CODEC_UNSUPPORTED_FORMAT;
     }
+    return (*codec)->decode(pcm, (TRANSMIT_DATA_CHUNKSIZE), payload, length);
+}
 
+void receive_tcp_audio(void)
+{
+    int rc;
     DELAY_COUNTER_INT(0);
-    DEBUG_OUT("Allocating recvBuff\n");
-    uint8_t recvBuff[TRANSMISSION_SIZE];
-    std::memset(recvBuff, 0, TRANSMISSION_SIZE);
-    DEBUG_OUT("Allocated recvBuff of size " << sizeof(recvBuff) << '\n');
+
+    /* The parser hands out the regions each part of a frame belongs
+    in: its own header buffer, then the ring's write region(s) and
+    the metadata slot, so audio is received straight into ring memory.
+    Encoded payloads are received into payloadBuff and decoded
+    into decodedBuff before being written to the ring.  When the
+    ring is full or the format does not match, the payload is
+    drained into payloadBuff so the stream stays aligned. */
+    WIFBFrameParser parser(
+            (TRANSMIT_PAYLOAD_SIZE),
+            metadata.data,
+            (METADATA_SIZE)
+        );
+    struct iovec iov[3];
+    uint8_t* regions[3];
+    int_fast32_t lengths[3];
+    uint8_t payloadBuff[TRANSMIT_PAYLOAD_SIZE];
+    alignas(AUDIO_DATATYPE) uint8_t decodedBuff[TRANSMIT_DATA_CHUNKSIZE];
+    std::unique_ptr<WIFBCodec> codec;
+    uint_fast32_t overflowedChunks(0);
+    int_fast32_t payloadBytes(0), encodedBytes(0), decodedBytes;
 
     while (self.socketConnected)
     {
+        const int_fast8_t numRegions(parser.next_regions(regions, lengths));
 
-        DEBUG_OUT("Attempting to receive from socket...\n");
+        if (numRegions)
+        {
+            for (int_fast8_t i(0); i < numRegions; ++i)
+            {
+                iov[i].iov_base = regions[i];
+                iov[i].iov_len = lengths[i];
+            }
 
-        rc = recv(
-                self.sock,
-                recvBuff,
-                (TRANSMISSION_SIZE),
-                0
-            );
-        
-        DEBUG_OUT("Socket receive attempted\n");
+            rc = recv_iov(self.sock, iov, numRegions);
 
-        if (rc < 0)
-        {
-            DEBUG_ERR("recv rc == " << rc << '\n');
-            self.socketConnected = false;
-            break;
-        }
+            if (rc <= 0)
+            {
+                DEBUG_ERR("recv rc == " << rc << '\n');
+                self.socketConnected = false;
+                break;
+            }
 
-        if (ringBuffer.available() >= (TRANSMIT_DATA_CHUNKSIZE))
+            parser.advance(rc);
+
+            #if _DEBUG
+            const uint_fast32_t discardedBytes(parser.discarded());
+            if (discardedBytes)
+            {
+                DEBUG_ERR("Discarded " << discardedBytes);
+                DEBUG_ERR(" bytes while resyncing to frame header\n");
+            }
+            #endif
+        }
+        else if (parser.state() == FRAME_HEADER_COMPLETE)
         {
+            const WIFBFrameHeader& header(parser.header());
 
-            DEBUG_OUT("Copying data to ringBuffer from recvBuff\n");
+            DEBUG_OUT("Receiving frame " << header.sequence);
+            DEBUG_OUT(" at sample " << header.timestamp << '\n');
 
-            std::memcpy(
-                    ringBuffer.get_write_byte(),
-                    recvBuff,
-                    (TRANSMIT_DATA_CHUNKSIZE)
+            int_fast8_t numPayloadRegions(0);
+            payloadBytes = 0;
+            encodedBytes = 0;
+            const bool formatMatches(
+                    (header.bitsPerSample == ((SAMPLE_WIDTH) * 8))
+                    && (header.channels == (NUM_CHANNELS))
                 );
+            if (
+                    formatMatches
+                    && (header.encoding == WIFB_ENCODING_PCM)
+                    && !(header.payloadLength % (SAMPLE_WIDTH))
+                    && (header.payloadLength <= (TRANSMIT_DATA_CHUNKSIZE))
+                )
+            {
+                numPayloadRegions = receiveRingBuffer.get_write_byte_regions(
+                        header.payloadLength,
+                        regions,
+                        lengths
+                    );
+                if (numPayloadRegions) payloadBytes = header.payloadLength;
+            }
+            else if (formatMatches && (header.encoding != WIFB_ENCODING_PCM))
+            {
+                /* Ring space is checked once the size of the audio is known */
+                regions[0] = payloadBuff;
+                lengths[0] = header.payloadLength;
+                numPayloadRegions = 1;
+                encodedBytes = header.payloadLength;
+            }
+            #if _DEBUG
+            else
+            {
+                DEBUG_ERR("Frame format does not match receiver\n");
+            }
+            #endif
 
-            DEBUG_OUT("Copied data to ringBuffer from recvBuff\n");
-            DEBUG_OUT("Extrapolating timecode from recvBuff\n");
-
-            // DEBUG_OUT("Printing recvBuff\n");
-            // for (int i(0); i < TRANSMISSION_SIZE; ++i)
-            // {
-            //     DEBUG_OUT(std::setw(2) << (+(i)) << ' ' << std::setfill('0'));
-            //     DEBUG_OUT(std::setw(2) << (+(recvBuff[i])) << '\n');
-            // }
-            // DEBUG_OUT('\n');
+            if (!numPayloadRegions && header.payloadLength)
+            {
+                regions[0] = payloadBuff;
+                lengths[0] = header.payloadLength;
+                numPayloadRegions = 1;
+                ++overflowedChunks;
+                DEBUG_ERR("Receive ring buffer full or format mismatch; ");
+                DEBUG_ERR("dropped chunk " << overflowedChunks << " total\n");
+            }
 
+            parser.set_payload_regions(regions, lengths, numPayloadRegions);
+        }
+        else if (parser.state() == FRAME_COMPLETE)
+        {
             DEBUG_OUT("Setting receiver metadata from data...\n");
 
             /* Extrapolate TC from metadata chunk */
-            metadata.set_data(&(recvBuff[(TRANSMIT_DATA_CHUNKSIZE)]));
+            metadata.parse_data();
 
-            DEBUG_OUT("Set receiver metadata from data\n");
-            DEBUG_OUT("Extrapolated timecode from recvBuff\n");
             DEBUG_OUT("Received timecode " << std::setfill('0'));
             #if _DEBUG
             for (int i(0); i < 4; ++i)
@@ -1063,132 +1582,356 @@ void socket_client_tcp(void)
                 DEBUG_OUT(std::setw(2) << (+metadata.timecode[i]));
                 DEBUG_OUT(((i == 3) ? '\n' : ':'));
             }
+
+            const uint_fast32_t lostFrames(parser.lost());
+            if (lostFrames)
+            {
+                DEBUG_ERR("Sequence gap of " << lostFrames << " frames\n");
+            }
             #endif
 
-            // rc = recv(
-            //         self.sock,
-            //         ringBuffer.get_write_byte(),
-            //         (TRANSMIT_DATA_CHUNKSIZE),
-            //         0
-            //     );
+            if (payloadBytes)
+            {
+                DEBUG_OUT("Reporting " << payloadBytes << " written bytes to buffer\n");
 
-            DEBUG_OUT("Reporting " << (TRANSMIT_DATA_CHUNKSIZE) << " written bytes to buffer\n");
+                receiveRingBuffer.report_written_bytes(payloadBytes);
+            }
+            else if (encodedBytes)
+            {
+                decodedBytes = decode_payload(
+                        &codec,
+                        parser.header().encoding,
+                        decodedBuff,
+                        payloadBuff,
+                        encodedBytes
+                    );
+                if (decodedBytes < 0)
+                {
+                    DEBUG_ERR("Unable to decode chunk; rc == " << decodedBytes << '\n');
+                }
+                else if (receiveRingBuffer.bytes_available() >= decodedBytes)
+                {
+                    receiveRingBuffer.write_samples(
+                            reinterpret_cast<const AUDIO_DATATYPE*>(decodedBuff),
+                            decodedBytes / (SAMPLE_WIDTH)
+                        );
+                }
+                else
+                {
+                    ++overflowedChunks;
+                    DEBUG_ERR("Receive ring buffer full; ");
+                    DEBUG_ERR("dropped chunk " << overflowedChunks << " total\n");
+                }
+            }
 
-            ringBuffer.report_written_bytes(TRANSMIT_DATA_CHUNKSIZE);
+            parser.next_frame();
+            DELAY_TICKS_AT_COUNT(125);
         }
-        DELAY_TICKS_AT_COUNT(125);
     }
-
-    DEBUG_OUT("Closing socket...\n");
-
-    rc = close(self.sock);
-
-    DEBUG_OUT("close rc: " << rc << '\n');
-    DEBUG_OUT("Socket closed\n");
-
-    // DEBUG_OUT("Deallocating recvBuff\n");
-    // delete recvBuff;
-    // DEBUG_OUT("Deallocated recvBuff\n");
-
-    DEBUG_OUT("Exiting socket_client_tcp\n");
 }
 
-void socket_client_udp(void)
+void receive_udp_audio(int udpSock)
 {
-    DEBUG_OUT("Starting socket_client_udp...\n");
+    DEBUG_OUT("Receiving audio over udp...\n");
+
+    /* Wake up regularly so due frames are released
+    even while no datagrams are arriving */
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = (JITTER_POLL_US);
+    setsockopt(
+            udpSock,
+            SOL_SOCKET,
+            SO_RCVTIMEO,
+            &timeout,
+            sizeof(timeout)
+        );
 
-    const char* tx_buffer = "hello from socket_client_udp";
-    DELAY_COUNTER_INT(0);
-    int rc;
+    /* Datagrams are reordered and scheduled by the jitter buffer,
+    which releases frames into the ring at their playout time */
+    Buffer::JitterBuffer<AUDIO_DATATYPE> jitterBuffer(
+            (TRANSMIT_DATA_CHUNKSIZE) / (SAMPLE_WIDTH),
+            (JITTER_BUFFER_SLOTS),
+            (SAMPLE_RATE),
+            (NUM_CHANNELS)
+        );
+    jitterBuffer.set_depth_limits_ms((JITTER_MIN_DEPTH_MS), (JITTER_MAX_DEPTH_MS));
+    jitterBuffer.set_target_depth_ms(JITTER_TARGET_DEPTH_MS);
+    jitterBuffer.set_concealment(JITTER_CONCEALMENT);
+
+    #if DRIFT_COMPENSATION
+    /* Ring fill is held at half the ring by stretching or
+    squeezing each frame by a fraction of a sample */
+    constexpr const int_fast32_t frameFrames(
+            (TRANSMIT_DATA_CHUNKSIZE) / (SAMPLE_WIDTH) / (NUM_CHANNELS)
+        );
+    constexpr const int_fast32_t maxResampledFrames(frameFrames + 4);
+    Resample::CubicResampler<AUDIO_DATATYPE> resampler(NUM_CHANNELS);
+    Resample::DriftEstimator driftEstimator(
+            receiveRingBuffer.size() / 2,
+            (DRIFT_MAX_PPM)
+        );
+    AUDIO_DATATYPE resampled[maxResampledFrames * (NUM_CHANNELS)];
+    int_fast32_t numResampled;
+    #endif
 
-    uint8_t rx_buffer[128];
+    alignas(AUDIO_DATATYPE) uint8_t datagram[UDP_MAX_DATAGRAM_SIZE];
+    alignas(AUDIO_DATATYPE) uint8_t decoded[TRANSMIT_DATA_CHUNKSIZE];
+    std::unique_ptr<WIFBCodec> codec;
+    WIFBFrameHeader header;
+    const uint8_t* payload;
+    int_fast32_t payloadLength;
+    const AUDIO_DATATYPE* frame;
+    int64_t now(time_us()), lastArrival(now);
+    uint_fast32_t invalidFrames(0);
 
-    while (true)
+    while (self.socketConnected)
     {
+        const int rc = recv(udpSock, datagram, sizeof(datagram), 0);
+        now = time_us();
 
-        struct sockaddr_in dest_addr;
-        dest_addr.sin_addr.s_addr = inet_addr(TRANSMITTER_IPV4_ADDR);
-        dest_addr.sin_family = AF_INET;
-        dest_addr.sin_port = htons(CONFIG_PORT);
-
-        DEBUG_OUT("Creating socket...\n");
-
-        self.sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+        if (rc < 0)
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+            {
+                DEBUG_ERR("udp recv rc == " << rc << '\n');
+                self.socketConnected = false;
+                break;
+            }
 
-        if (self.sock < 0)
+            /* No audio for a while; make sure the transmitter is still there */
+            if ((now - lastArrival) >= ((UDP_RECEIVE_TIMEOUT_MS) * 1000))
+            {
+                lastArrival = now;
+                if (peer_closed(self.sock))
+                {
+                    DEBUG_ERR("Transmitter closed control channel\n");
+                    self.socketConnected = false;
+                }
+            }
+        }
+        else if (
+                (rc < (WIFB_FRAME_HEADER_SIZE))
+                || !decode_frame_header(datagram, &header)
+                || (rc != (
+                        (WIFB_FRAME_HEADER_SIZE)
+                        + header.payloadLength
+                        + header.metadataLength
+                    ))
+                || (header.bitsPerSample != ((SAMPLE_WIDTH) * 8))
+                || (header.channels != (NUM_CHANNELS))
+                || (
+                        (header.encoding == WIFB_ENCODING_PCM)
+                        && (header.payloadLength % (SAMPLE_WIDTH))
+                    )
+                || (header.metadataLength > (METADATA_SIZE))
+            )
         {
-            DEBUG_ERR("Unable to create socket\n");
-            break;
+            ++invalidFrames;
+            DEBUG_ERR("Discarded invalid datagram; " << invalidFrames << " total\n");
         }
+        else
+        {
+            lastArrival = now;
 
-        struct timeval timeout;
-        timeout.tv_sec = 2;
-        timeout.tv_usec = 0;
-        setsockopt(
-                self.sock,
-                SOL_SOCKET,
-                SO_RCVTIMEO,
-                &timeout,
-                sizeof(timeout)
-            );
-
-        DEBUG_OUT("Socket created, sending to ");
-        DEBUG_OUT(TRANSMITTER_IPV4_ADDR << ":" << CONFIG_PORT << '\n');
+            DEBUG_OUT("Received frame " << header.sequence);
+            DEBUG_OUT(" at sample " << header.timestamp << '\n');
 
-        while (true)
-        {
-            rc = sendto(
-                    self.sock,
-                    tx_buffer,
-                    strlen(tx_buffer),
-                    0,
-                    reinterpret_cast<sockaddr*>(&dest_addr),
-                    sizeof(dest_addr)
+            /* Extrapolate TC from metadata chunk */
+            std::memcpy(
+                    metadata.data,
+                    &(datagram[(WIFB_FRAME_HEADER_SIZE) + header.payloadLength]),
+                    header.metadataLength
                 );
-                
-            if (rc < 0)
+            metadata.parse_data();
+
+            payload = &(datagram[(WIFB_FRAME_HEADER_SIZE)]);
+            payloadLength = header.payloadLength;
+            if (header.encoding != WIFB_ENCODING_PCM)
             {
-                DEBUG_ERR("Error occurred during sending\n");
-                break;
+                payloadLength = decode_payload(
+                        &codec,
+                        header.encoding,
+                        decoded,
+                        payload,
+                        payloadLength
+                    );
+                payload = decoded;
             }
-            DEBUG_OUT("Message sent\n");
-
-            struct sockaddr_storage source_addr;
-            socklen_t socklen = sizeof(source_addr);
-            int length = recvfrom(
-                    self.sock,
-                    rx_buffer,
-                    sizeof(rx_buffer) - 1,
-                    0,
-                    reinterpret_cast<sockaddr*>(&source_addr),
-                    &socklen
-                );
 
-            if (length < 0)
+            if (payloadLength < 0)
             {
-                DEBUG_ERR("recvfrom failed\n");
-                break;
+                ++invalidFrames;
+                DEBUG_ERR("Unable to decode datagram; rc == " << payloadLength << '\n');
             }
             else
             {
-                rx_buffer[length] = 0;
-                DEBUG_OUT("Data received of length " << length);
-                DEBUG_OUT(" from " << TRANSMITTER_IPV4_ADDR);
-                DEBUG_OUT("\n\t" << rx_buffer << '\n');
+                jitterBuffer.insert(
+                        header.sequence,
+                        header.timestamp,
+                        reinterpret_cast<const AUDIO_DATATYPE*>(payload),
+                        payloadLength / (SAMPLE_WIDTH),
+                        now
+                    );
             }
+        }
 
-            DELAY_TICKS_AT_COUNT(0);
+        /* Release every frame whose playout time has come */
+        #if DRIFT_COMPENSATION
+        while (
+                (receiveRingBuffer.available() >= (maxResampledFrames * (NUM_CHANNELS)))
+                && ((frame = jitterBuffer.pull(now)) != nullptr)
+            )
+        {
+            resampler.set_ratio(driftEstimator.update(
+                    receiveRingBuffer.size() - receiveRingBuffer.available()
+                ));
+            numResampled = resampler.process(
+                    frame,
+                    frameFrames,
+                    resampled,
+                    maxResampledFrames
+                );
+            receiveRingBuffer.write_samples(resampled, numResampled * (NUM_CHANNELS));
+        }
+        #else
+        while (
+                (receiveRingBuffer.available() >= jitterBuffer.frame_length())
+                && ((frame = jitterBuffer.pull(now)) != nullptr)
+            )
+        {
+            receiveRingBuffer.write_samples(frame, jitterBuffer.frame_length());
         }
+        #endif
 
-        if (self.sock != -1)
+        #if _DEBUG
+        const Buffer::JitterStats stats(jitterBuffer.stats());
+        if ((rc > 0) && !(stats.received % 1000))
         {
-            DEBUG_ERR("Shutting down socket and restarting...\n");
-            shutdown(self.sock, 0);
-            close(self.sock);
+            DEBUG_OUT("Jitter buffer depth " << stats.depth << " frames, ");
+            DEBUG_OUT("target " << stats.targetDepthUs << " us, ");
+            DEBUG_OUT("jitter " << stats.jitterUs << " us; ");
+            DEBUG_OUT(stats.late << " late, " << stats.lost << " lost, ");
+            DEBUG_OUT(stats.concealed << " concealed\n");
+            #if DRIFT_COMPENSATION
+            DEBUG_OUT("Clock drift " << driftEstimator.ppm() << " ppm\n");
+            #endif
         }
+        #endif
     }
+}
 
-    DEBUG_OUT("Exiting socket_client_udp\n");
+void socket_client_tcp(void)
+{
+    DEBUG_OUT("Starting socket_client_tcp...\n");
+    DEBUG_OUT("Creating socket...\n");
+
+    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    self.sock = sock;
+
+    DEBUG_OUT("socket rc: " << sock << '\n');
+
+    struct sockaddr_in serverAddress;
+    serverAddress.sin_family = AF_INET;
+    inet_pton(
+            AF_INET,
+            transmitterAddress,
+            &serverAddress.sin_addr.s_addr
+        );
+    serverAddress.sin_port = htons(CONFIG_PORT);
+
+    DEBUG_OUT("Connecting to server...\n");
+    int rc = connect(
+            self.sock,
+            (struct sockaddr*)&serverAddress,
+            sizeof(struct sockaddr_in)
+        );
+    DEBUG_OUT("connect rc: " << rc << '\n');
+
+    /* Audio arrives on a udp port of our own,
+    which is announced to the transmitter with our mac */
+    uint16_t udpPort(0);
+    #if UDP_AUDIO_TRANSPORT
+    int udpSock = open_udp_socket(&udpPort);
+    if (udpSock < 0)
+    {
+        DEBUG_ERR("Unable to open udp socket\n");
+        rc = -1;
+    }
+    #endif
+
+    if ((self.socketConnected = (rc >= 0)))
+    {
+        uint8_t hello[WIFB_HELLO_SIZE];
+        std::memcpy(hello, self.mac, 6);
+        hello[6] = static_cast<uint8_t>(udpPort >> 8);
+        hello[7] = static_cast<uint8_t>(udpPort);
+        hello[8] = requestedEncoding;
+        send(self.sock, hello, (WIFB_HELLO_SIZE), (WIFB_SEND_FLAGS));
+        DEBUG_OUT("Send self mac addr: " << mac_addr_string(self.mac) << '\n');
+        DEBUG_OUT("Send udp port: " << udpPort << '\n');
+        DEBUG_OUT("Send requested encoding: " << +requestedEncoding << '\n');
+    }
+
+    #if UDP_AUDIO_TRANSPORT
+    /* The transmitter answers with the group its audio is sent to,
+    if any, which is joined on the interface facing the transmitter */
+    uint8_t group[WIFB_GROUP_SIZE];
+    struct iovec groupIov;
+    groupIov.iov_base = group;
+    groupIov.iov_len = (WIFB_GROUP_SIZE);
+    if (self.socketConnected && (recv_iov(self.sock, &groupIov, 1) != (WIFB_GROUP_SIZE)))
+    {
+        DEBUG_ERR("Transmitter did not complete handshake\n");
+        self.socketConnected = false;
+    }
+    else if (self.socketConnected && (group[0] | group[1] | group[2] | group[3]))
+    {
+        const uint16_t groupPort(static_cast<uint16_t>((group[4] << 8) | group[5]));
+        struct sockaddr_in localAddress;
+        socklen_t localAddressLength = sizeof(localAddress);
+        getsockname(
+                self.sock,
+                reinterpret_cast<sockaddr*>(&localAddress),
+                &localAddressLength
+            );
+        const int groupSock = open_group_receiver(
+                group,
+                groupPort,
+                reinterpret_cast<uint8_t*>(&localAddress.sin_addr.s_addr)
+            );
+        if (groupSock < 0)
+        {
+            DEBUG_ERR("Unable to join group\n");
+            self.socketConnected = false;
+        }
+        else
+        {
+            close(udpSock);
+            udpSock = groupSock;
+            DEBUG_OUT("Joined group " << ip_addr_string(group) << ':' << groupPort << '\n');
+        }
+    }
+    #endif
+
+    #if UDP_AUDIO_TRANSPORT
+    if (udpSock >= 0)
+    {
+        receive_udp_audio(udpSock);
+        close(udpSock);
+    }
+    #else
+    receive_tcp_audio();
+    #endif
+
+    DEBUG_OUT("Closing socket...\n");
+
+    rc = close(self.sock);
+
+    DEBUG_OUT("close rc: " << rc << '\n');
+    DEBUG_OUT("Socket closed\n");
+
+    DEBUG_OUT("Exiting socket_client_tcp\n");
 }
 
 extern "C" void app_main(void)
@@ -1198,10 +1941,20 @@ extern "C" void app_main(void)
     /* Set timecode to dummy value */
     metadata.set_timecode(12, 0, 0, 0);
 
-    /* Set buffer to have one reader initially */
+    /* Claim audio storage, so that sessions need no heap */
+
+    DEBUG_OUT("Allocating audio storage...\n");
+    if (!allocate_audio_storage())
+    {
+        DEBUG_ERR("Unable to allocate audio storage\n");
+        #ifdef ESP_PLATFORM
+        DEBUG_ERR("Rebooting...\n");
+        esp_restart();
+        #else
+        return;
+        #endif
+    }
 
-    ringBuffer.set_num_readers(1);
-    
     DEBUG_OUT("Ring buffer audio datatype width is " << sizeof(AUDIO_DATATYPE));
     DEBUG_OUT(" samples\n");
 
@@ -1260,8 +2013,12 @@ extern "C" void app_main(void)
     {
         DEBUG_ERR("Errors encountered\n");
         DEBUG_ERR("WIFB initialization failed\n");
+        #ifdef ESP_PLATFORM
         DEBUG_ERR("Rebooting...\n");
         esp_restart();
+        #else
+        return;
+        #endif
     }
 
     DEBUG_OUT("Networking configured\n");
@@ -1270,24 +2027,151 @@ extern "C" void app_main(void)
     if (txMode)
     {
         DEBUG_OUT("Launching i2s_to_buffer_loop...\n");
+        audioRunning = true;
         std::thread loop(i2s_to_buffer_loop);
 
         socket_server_tcp();
-        // socket_server_udp();
+
+        /* The server only returns when it can no longer accept
+        clients, so stop the audio loop before giving up */
+        DEBUG_ERR("Transmitter stopped\n");
+        audioRunning = false;
+        loop.join();
+        #ifdef ESP_PLATFORM
+        DEBUG_ERR("Rebooting...\n");
+        esp_restart();
+        #endif
     }
     else
     {
-        DEBUG_OUT("Launching buffer_to_i2s_loop...\n");
-        std::thread loop(buffer_to_i2s_loop);
-
-        // socket_client_udp();
         while (true)
         {
+            DEBUG_OUT("Launching buffer_to_i2s_loop...\n");
+            audioRunning = true;
+            std::thread loop(buffer_to_i2s_loop);
+
             socket_client_tcp();
 
-            /* Flush buffer when socket closes */
+            /* Flush buffer when socket closes, once its consumer
+            has stopped, since the ring may only be reset or
+            filled while neither end runs */
             DEBUG_ERR("Disconnected; flushing buffer...\n");
-            ringBuffer.fill(0);
+            audioRunning = false;
+            loop.join();
+            receiveRingBuffer.reset();
+            receiveRingBuffer.fill(get_zero<AUDIO_DATATYPE>());
+
+            /* Give a transmitter that is down or restarting
+            time to come back rather than retrying at once */
+            delay_ms(RECONNECT_DELAY_MS);
+        }
+    }
+}
+
+#ifndef ESP_PLATFORM
+
+void host_mac_addr(uint8_t addr[6])
+{
+    /* Locally administered address unique to this process,
+    so several receivers can run on one host */
+    const uint32_t pid(static_cast<uint32_t>(getpid()));
+    addr[0] = 0x02;
+    addr[1] = 0x00;
+    for (int i(0); i < 4; ++i)
+    {
+        addr[i + 2] = static_cast<uint8_t>(pid >> (24 - (i * 8)));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    /* Host build: the simulated i2s bus stands in for the codec,
+    and transmitter and receivers connect over the host's sockets */
+    const char* usage = (
+            "Usage: wifb tx|rx [-a address] [-e encoding] [-m group] [-n interface]"
+            " [-i input] [-t hz] [-o output] [-d ppm] [-f]\n"
+            "\t-a  transmitter address for rx\n"
+            "\t-e  encoding rx asks for: pcm, lossless or adpcm\n"
+            "\t-m  multicast group or broadcast address tx sends audio to once\n"
+            "\t-n  address of the interface tx sends group audio from\n"
+            "\t-i  raw interleaved input file for tx, looped\n"
+            "\t-t  input tone frequency when no file is given\n"
+            "\t-o  raw interleaved output file for rx\n"
+            "\t-d  sample clock error in parts per million\n"
+            "\t-f  run free of the sample clock\n"
+        );
+
+    float toneFrequency(1000);
+    int option;
+    while ((option = getopt(argc, argv, "a:e:m:n:i:t:o:d:f")) != -1)
+    {
+        switch (option)
+        {
+            case 'a':
+                transmitterAddress = optarg;
+                break;
+            case 'e':
+                if (!std::strcmp(optarg, "pcm")) requestedEncoding = WIFB_ENCODING_PCM;
+                else if (!std::strcmp(optarg, "lossless")) requestedEncoding = WIFB_ENCODING_LOSSLESS;
+                else if (!std::strcmp(optarg, "adpcm")) requestedEncoding = WIFB_ENCODING_ADPCM;
+                else
+                {
+                    std::cerr << usage;
+                    return 1;
+                }
+                break;
+            #if UDP_AUDIO_TRANSPORT
+            case 'm':
+                multicastGroup = optarg;
+                break;
+            case 'n':
+                multicastInterface = optarg;
+                break;
+            #endif
+            case 'i':
+                i2s.set_source_file(optarg);
+                break;
+            case 't':
+                toneFrequency = std::atof(optarg);
+                break;
+            case 'o':
+                i2s.set_sink_file(optarg);
+                break;
+            case 'd':
+                i2s.set_clock_error_ppm(std::atof(optarg));
+                break;
+            case 'f':
+                i2s.set_realtime(false);
+                break;
+            default:
+                std::cerr << usage;
+                return 1;
         }
     }
+
+    if ((optind < argc) && !std::strcmp(argv[optind], "tx"))
+    {
+        txMode = true;
+    }
+    else if ((optind < argc) && !std::strcmp(argv[optind], "rx"))
+    {
+        txMode = false;
+    }
+    else
+    {
+        std::cerr << usage;
+        return 1;
+    }
+
+    if (toneFrequency > 0) i2s.set_source_tone(toneFrequency);
+
+    /* Departed peers are noticed from failed sends,
+    which without MSG_NOSIGNAL would raise SIGPIPE */
+    std::signal(SIGPIPE, SIG_IGN);
+
+    /* Returns only if initialization fails or the server stops */
+    app_main();
+    return 1;
 }
+
+#endif
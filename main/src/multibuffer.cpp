@@ -2,54 +2,101 @@
 
 using namespace Buffer;
 
-template <typename T, typename I>
-MultiRingBuffer<T, I>::MultiRingBuffer() :
-Base<T, I>()
+template <typename T, typename I, typename A>
+MultiRingBuffer<T, I, A>::MultiRingBuffer() :
+Base<T, I>(),
+_numBuffers(0)
 {
 }
 
-template <typename T, typename I>
-MultiRingBuffer<T, I>::MultiRingBuffer(
+template <typename T, typename I, typename A>
+MultiRingBuffer<T, I, A>::MultiRingBuffer(const A& allocator) :
+Base<T, I>(),
+_numBuffers(0),
+buffers(_buffers_allocator_type(allocator))
+{
+}
+
+template <typename T, typename I, typename A>
+MultiRingBuffer<T, I, A>::MultiRingBuffer(
         int_fast32_t bufferSize,
         int_fast8_t ringSize,
-        int_fast8_t numBuffers
-    )
+        int_fast8_t numBuffers,
+        const A& allocator
+    ) :
+Base<T, I>(),
+_numBuffers(0),
+buffers(_buffers_allocator_type(allocator))
 {
     set_size(bufferSize, ringSize, numBuffers);
 }
 
-template <typename T, typename I>
-MultiRingBuffer<T, I>::MultiRingBuffer(const MultiRingBuffer& obj) :
+template <typename T, typename I, typename A>
+MultiRingBuffer<T, I, A>::MultiRingBuffer(const MultiRingBuffer& obj) :
 Base<T, I>(obj),
-_numBuffers(obj._numBuffers)
+_numBuffers(obj._numBuffers),
+buffers(obj.buffers)
+{
+}
+
+template <typename T, typename I, typename A>
+MultiRingBuffer<T, I, A>::MultiRingBuffer(MultiRingBuffer&& obj) noexcept :
+Base<T, I>(std::move(obj)),
+_numBuffers(obj._numBuffers),
+buffers(std::move(obj.buffers))
+{
+    obj._numBuffers = 0;
+}
+
+template <typename T, typename I, typename A>
+MultiRingBuffer<T, I, A>::~MultiRingBuffer()
+{
+}
+
+template <typename T, typename I, typename A>
+MultiRingBuffer<T, I, A>& MultiRingBuffer<T, I, A>::operator=(
+        const MultiRingBuffer& obj
+    )
 {
-    set_size(obj.buffer_length(), obj.ring_length(), obj.num_buffers());
-    for (int i(0); i < this->_numBuffers; ++i)
+    if (this == &obj) return *this;
+
+    Base<T, I>::operator=(obj);
+    this->_numBuffers = obj._numBuffers;
+    while (this->buffers.size() > obj.buffers.size()) this->buffers.pop_back();
+    while (this->buffers.size() < obj.buffers.size())
     {
-        for (int j(0); j < obj.buffers.at(i).ring_length(); ++j)
-        {
-            std::copy(
-                    obj.buffers.at(i).ring.at(j).begin(),
-                    obj.buffers.at(i).ring.at(j).end(),
-                    this->buffers.at(i).ring.at(j).begin()
-                );
-        }
+        this->buffers.emplace_back(A(this->buffers.get_allocator()));
     }
+    for (size_t i(0); i < obj.buffers.size(); ++i)
+    {
+        this->buffers[i] = obj.buffers[i];
+    }
+    return *this;
 }
 
-template <typename T, typename I>
-MultiRingBuffer<T, I>::~MultiRingBuffer()
+template <typename T, typename I, typename A>
+MultiRingBuffer<T, I, A>& MultiRingBuffer<T, I, A>::operator=(
+        MultiRingBuffer&& obj
+    ) noexcept
 {
+    if (this == &obj) return *this;
+
+    Base<T, I>::operator=(std::move(obj));
+    this->_numBuffers = obj._numBuffers;
+    this->buffers = std::move(obj.buffers);
+    obj._numBuffers = 0;
+    obj.buffers.clear();
+    return *this;
 }
 
-template <typename T, typename I>
-bool MultiRingBuffer<T, I>::size_is_set() const
+template <typename T, typename I, typename A>
+bool MultiRingBuffer<T, I, A>::size_is_set() const
 {
-    for (const RingBuffer<T, I>& buff: this->buffers)
+    for (const RingBuffer<T, I, A>& buff: this->buffers)
     {
         if (!buff.size_is_set())
         {
-            #ifdef _DEBUG
+            #if _DEBUG
             std::cerr << "Error: sub buffer size not set\n";
             #endif
             
@@ -57,7 +104,7 @@ bool MultiRingBuffer<T, I>::size_is_set() const
         }
     }
 
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!(this->buffers.size() > 0)) std::cerr << "No sub buffers\n";
     if (!(this->_ringLength > 0)) std::cerr << "Nothing in ring\n";
     if (!(this->_bufferLength > 0)) std::cerr << "Buffers not allocated\n";
@@ -70,79 +117,100 @@ bool MultiRingBuffer<T, I>::size_is_set() const
         );
 }
 
-template <typename T, typename I>
-void MultiRingBuffer<T, I>::set_size(
+template <typename T, typename I, typename A>
+void MultiRingBuffer<T, I, A>::set_size(
         int_fast32_t bufferSize,
         int_fast8_t ringSize,
         int_fast8_t numBuffers
     )
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (numBuffers < 2) throw BUFFER_COUNT_TOO_SHORT;
     #endif
 
     Base<T, I>::set_size(bufferSize, ringSize);
     this->_numBuffers = numBuffers;
+    while (this->buffers.size() > static_cast<size_t>(numBuffers))
+    {
+        this->buffers.pop_back();
+    }
+    while (this->buffers.size() < static_cast<size_t>(numBuffers))
+    {
+        this->buffers.emplace_back(A(this->buffers.get_allocator()));
+    }
+    for (RingBuffer<T, I, A>& buff: this->buffers)
+    {
+        buff.set_size(bufferSize, ringSize);
+    }
+}
+
+template <typename T, typename I, typename A>
+void MultiRingBuffer<T, I, A>::reserve(
+        int_fast32_t bufferSize,
+        int_fast8_t ringSize,
+        int_fast8_t numBuffers
+    )
+{
     this->buffers.reserve(numBuffers);
-    for (int i(0); i < numBuffers; ++i)
+    for (RingBuffer<T, I, A>& buff: this->buffers)
     {
-        this->buffers.emplace_back(bufferSize, ringSize);
+        buff.reserve(bufferSize, ringSize);
     }
 }
 
-template <typename T, typename I>
-int_fast32_t MultiRingBuffer<T, I>::size() const
+template <typename T, typename I, typename A>
+int_fast32_t MultiRingBuffer<T, I, A>::size() const
 {
     return Base<T, I>::size() * this->_numBuffers;
 }
 
-template <typename T, typename I>
-int_fast32_t MultiRingBuffer<T, I>::total_size() const
+template <typename T, typename I, typename A>
+int_fast32_t MultiRingBuffer<T, I, A>::total_size() const
 {
     return Base<T, I>::total_size() * this->_numBuffers;
 }
 
-template <typename T, typename I>
-int_fast8_t MultiRingBuffer<T, I>::num_buffers() const
+template <typename T, typename I, typename A>
+int_fast8_t MultiRingBuffer<T, I, A>::num_buffers() const
 {
     return this->_numBuffers;
 }
 
-template <typename T, typename I>
-void MultiRingBuffer<T, I>::fill(T value)
+template <typename T, typename I, typename A>
+void MultiRingBuffer<T, I, A>::fill(T value)
 {
-    for (RingBuffer<T, I>& buff: this->buffers)
+    for (RingBuffer<T, I, A>& buff: this->buffers)
     {
         buff.fill(value);
     }
 }
 
-template <typename T, typename I>
-void MultiRingBuffer<T, I>::reset()
+template <typename T, typename I, typename A>
+void MultiRingBuffer<T, I, A>::reset()
 {
-    for (RingBuffer<T, I>& buff: this->buffers)
+    for (RingBuffer<T, I, A>& buff: this->buffers)
     {
         buff.reset();
     }
     Base<T, I>::reset();
 }
 
-template <typename T, typename I>
-auto MultiRingBuffer<T, I>::get_buffer(
+template <typename T, typename I, typename A>
+auto MultiRingBuffer<T, I, A>::get_buffer(
         int_fast8_t bufferIndex
     )
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return this->buffers.at(bufferIndex);
     #else
     return this->buffers[bufferIndex];
     #endif
 }
 
-template <typename T, typename I>
-void MultiRingBuffer<T, I>::_update_sample_counters()
+template <typename T, typename I, typename A>
+void MultiRingBuffer<T, I, A>::_update_sample_counters()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     int_fast32_t
         leastBuffered(this->buffers.at(0).buffered()),
         leastSamplesWritten(this->buffers.at(0)._samplesWritten),
@@ -157,15 +225,15 @@ void MultiRingBuffer<T, I>::_update_sample_counters()
     #endif
     for (int i(1); i < this->_numBuffers; ++i)
     {
-        #ifdef _DEBUG
-        RingBuffer<T, I>& buff = this->buffers.at(i);
+        #if _DEBUG
+        RingBuffer<T, I, A>& buff = this->buffers.at(i);
         #else
-        RingBuffer<T, I>& buff = this->buffers[i];
+        RingBuffer<T, I, A>& buff = this->buffers[i];
         #endif
 
         leastBuffered = (
-                (buff._buffered < leastBuffered)
-                ? buff._buffered
+                (buff.buffered() < leastBuffered)
+                ? buff.buffered()
                 : leastBuffered
             );
         leastSamplesWritten = (
@@ -184,74 +252,74 @@ void MultiRingBuffer<T, I>::_update_sample_counters()
                 : leastSamplesUnread
             );
     }
-    this->_buffered = leastBuffered;
+    this->_samplesCommitted.store(
+            this->_samplesReleased.load(std::memory_order_relaxed)
+            + leastBuffered,
+            std::memory_order_release
+        );
     this->_samplesWritten = leastSamplesWritten;
     this->_samplesUnwritten = this->_bufferLength - this->_samplesWritten;
     this->_samplesProcessed = leastSamplesProcessed;
     this->_samplesUnread = leastSamplesUnread;
 }
 
-template <typename T, typename I>
-void MultiRingBuffer<T, I>::_increment_counters()
+template <typename T, typename I, typename A>
+void MultiRingBuffer<T, I, A>::_increment_counters()
 {
     if (!this->_samplesUnwritten) Base<T, I>::rotate_write_buffer();
     if (!this->_samplesUnread) Base<T, I>::rotate_read_buffer();
     if (!Base<T, I>::unprocessed()) Base<T, I>::rotate_processing_buffer();
 }
 
-template <typename T, typename I>
-void MultiRingBuffer<T, I>::update()
+template <typename T, typename I, typename A>
+void MultiRingBuffer<T, I, A>::update()
 {
     _update_sample_counters();
     _increment_counters();
 }
 
-template <typename T, typename I>
-inline int_fast32_t MultiRingBuffer<T, I>::buffered()
+template <typename T, typename I, typename A>
+inline int_fast32_t MultiRingBuffer<T, I, A>::buffered()
 {
     update();
     return Base<T, I>::buffered();
 }
 
-template <typename T, typename I>
-inline int_fast32_t MultiRingBuffer<T, I>::processed()
+template <typename T, typename I, typename A>
+inline int_fast32_t MultiRingBuffer<T, I, A>::processed()
 {
     update();
     return Base<T, I>::processed();
 }
 
-template <typename T, typename I>
-std::vector<T> MultiRingBuffer<T, I>::read_interleaved()
+template <typename T, typename I, typename A>
+std::vector<T> MultiRingBuffer<T, I, A>::read_interleaved()
 {
     std::vector<T> output(this->_bufferLength);
     read_interleaved(&output);
     return output;
 }
 
-template <typename T, typename I>
-inline void MultiRingBuffer<T, I>::read_interleaved(std::vector<T>* data)
+template <typename T, typename I, typename A>
+inline void MultiRingBuffer<T, I, A>::read_interleaved(std::vector<T>* data)
 {
-    int_fast8_t buffIndex(0);
-
-    for (int_fast32_t i(0); i < this->_bufferLength; ++i)
+    #if _DEBUG
+    if (static_cast<int_fast32_t>(data->size()) < this->_bufferLength)
     {
-        #ifdef _DEBUG
-        this->buffers.at(buffIndex).read_samples(&(data->at(i)), 1);
-        #else
-        this->buffers[buffIndex].read_samples(&((*data)[i]), 1);
-        #endif
-        ++buffIndex %= this->_numBuffers;
+        throw std::out_of_range("Data must be >= buffer length");
     }
-    update();
+    #endif
+
+    read_samples_interleaved(data->data(), this->_bufferLength);
 }
 
-template <typename T, typename I>
-inline void MultiRingBuffer<T, I>::read_samples_interleaved(
+template <typename T, typename I, typename A>
+void MultiRingBuffer<T, I, A>::read_samples_interleaved(
         T* data,
         int_fast32_t length
     )
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (length > (this->_bufferLength * this->_numBuffers))
     {
         throw std::out_of_range(
@@ -260,22 +328,61 @@ inline void MultiRingBuffer<T, I>::read_samples_interleaved(
     }
     #endif
 
-    int_fast8_t buffIndex(0);
+    const int_fast8_t numChannels(this->_numBuffers);
+    int_fast32_t remaining(length / numChannels);
+    const T* inputs[8];
 
-    for (int_fast32_t i(0); i < length; ++i)
+    for (RingBuffer<T, I, A>& buff: this->buffers) buff.catch_up();
+
+    while (remaining > 0)
     {
-        #ifdef _DEBUG
-        this->buffers.at(buffIndex).read_samples(data + i, 1);
-        #else
-        this->buffers[buffIndex].read_samples(data + i, 1);
-        #endif
-        ++buffIndex %= this->_numBuffers;
+        /* Largest block every sub buffer holds contiguously */
+        int_fast32_t block(remaining);
+        for (const RingBuffer<T, I, A>& buff: this->buffers)
+        {
+            block = std::min(block, buff._samplesUnread);
+        }
+        if (!block) break;
+
+        if (numChannels <= 8)
+        {
+            for (int_fast8_t c(0); c < numChannels; ++c)
+            {
+                inputs[c] = this->buffers[c].get_read_sample();
+            }
+            interleave<T>(data, inputs, numChannels, block);
+        }
+        else
+        {
+            for (int_fast8_t c(0); c < numChannels; ++c)
+            {
+                interleave_channel<T>(
+                        data + c,
+                        this->buffers[c].get_read_sample(),
+                        numChannels,
+                        block
+                    );
+            }
+        }
+
+        for (RingBuffer<T, I, A>& buff: this->buffers)
+        {
+            buff.report_read_samples(block);
+        }
+        data += block * numChannels;
+        remaining -= block;
+    }
+
+    /* Samples short of a whole frame go to the first buffers */
+    for (int_fast8_t c(0); c < (length % numChannels); ++c)
+    {
+        this->buffers[c].read_samples(data + c, 1);
     }
     update();
 }
 
-template <typename T, typename I>
-inline void MultiRingBuffer<T, I>::read_bytes_interleaved(
+template <typename T, typename I, typename A>
+inline void MultiRingBuffer<T, I, A>::read_bytes_interleaved(
         uint8_t* data,
         int_fast32_t numBytes
     )
@@ -286,16 +393,16 @@ inline void MultiRingBuffer<T, I>::read_bytes_interleaved(
         );
 }
 
-template <typename T, typename I>
-std::vector<T> MultiRingBuffer<T, I>::read_concatenated()
+template <typename T, typename I, typename A>
+std::vector<T> MultiRingBuffer<T, I, A>::read_concatenated()
 {
     std::vector<T> output(this->_bufferLength);
     read_concatenated(&output);
     return output;
 }
 
-template <typename T, typename I>
-inline void MultiRingBuffer<T, I>::read_concatenated(std::vector<T>* data)
+template <typename T, typename I, typename A>
+inline void MultiRingBuffer<T, I, A>::read_concatenated(std::vector<T>* data)
 {
     int_fast32_t
         sampleIndex(0),
@@ -303,7 +410,7 @@ inline void MultiRingBuffer<T, I>::read_concatenated(std::vector<T>* data)
 
     for (int_fast8_t i(0); i < this->_numBuffers; ++i)
     {
-        #ifdef _DEBUG
+        #if _DEBUG
         this->buffers.at(i).read_samples(
                 &(data->at(sampleIndex)),
                 numSamples
@@ -319,13 +426,13 @@ inline void MultiRingBuffer<T, I>::read_concatenated(std::vector<T>* data)
     update();
 }
 
-template <typename T, typename I>
-inline void MultiRingBuffer<T, I>::read_samples_concatenated(
+template <typename T, typename I, typename A>
+inline void MultiRingBuffer<T, I, A>::read_samples_concatenated(
         T* data,
         int_fast32_t length
     )
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (length > (this->_bufferLength * this->_numBuffers))
     {
         throw std::out_of_range(
@@ -340,7 +447,7 @@ inline void MultiRingBuffer<T, I>::read_samples_concatenated(
 
     for (int_fast8_t i(0); i < this->_numBuffers; ++i)
     {
-        #ifdef _DEBUG
+        #if _DEBUG
         this->buffers.at(i).read_samples(data + sampleIndex, numSamples);
         #else
         this->buffers[i].read_samples(data + sampleIndex, numSamples);
@@ -350,8 +457,8 @@ inline void MultiRingBuffer<T, I>::read_samples_concatenated(
     update();
 }
 
-template <typename T, typename I>
-inline void MultiRingBuffer<T, I>::read_bytes_concatenated(
+template <typename T, typename I, typename A>
+inline void MultiRingBuffer<T, I, A>::read_bytes_concatenated(
         uint8_t* data,
         int_fast32_t numBytes
     )
@@ -362,10 +469,10 @@ inline void MultiRingBuffer<T, I>::read_bytes_concatenated(
         );
 }
 
-template <typename T, typename I>
-int_fast32_t MultiRingBuffer<T, I>::write(T data, bool force)
+template <typename T, typename I, typename A>
+int_fast32_t MultiRingBuffer<T, I, A>::write(T data, bool force)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!size_is_set())
     {
         std::cerr << "Error: size not set!\n";
@@ -373,9 +480,9 @@ int_fast32_t MultiRingBuffer<T, I>::write(T data, bool force)
     }
     #endif
 
-    for (RingBuffer<T, I>& buff: this->buffers)
+    for (RingBuffer<T, I, A>& buff: this->buffers)
     {
-        #ifdef _DEBUG
+        #if _DEBUG
         if (buff.write(data, force) > 1)
         {
             throw std::out_of_range("Must not be > 1 sample");
@@ -390,13 +497,13 @@ int_fast32_t MultiRingBuffer<T, I>::write(T data, bool force)
     return 1;
 }
 
-template <typename T, typename I>
-int_fast32_t MultiRingBuffer<T, I>::write(
+template <typename T, typename I, typename A>
+int_fast32_t MultiRingBuffer<T, I, A>::write(
         std::vector<T> data,
         bool force
     )
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!size_is_set())
     {
         std::cerr << "Error: size not set!\n";
@@ -405,7 +512,7 @@ int_fast32_t MultiRingBuffer<T, I>::write(
     #endif
 
     int_fast32_t written(Base<T, I>::buffer_length()), common(written);
-    for (RingBuffer<T, I>& buff: this->buffers)
+    for (RingBuffer<T, I, A>& buff: this->buffers)
     {
         written = buff.write(data, force);
         common = (written < common) ? written : common;
@@ -416,14 +523,14 @@ int_fast32_t MultiRingBuffer<T, I>::write(
     return common;
 }
 
-template <typename T, typename I>
-int_fast32_t MultiRingBuffer<T, I>::write_samples(
+template <typename T, typename I, typename A>
+int_fast32_t MultiRingBuffer<T, I, A>::write_samples(
         T* data,
         int_fast32_t length,
         bool force
     )
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!size_is_set())
     {
         std::cerr << "Error: size not set!\n";
@@ -433,7 +540,7 @@ int_fast32_t MultiRingBuffer<T, I>::write_samples(
 
     int_fast32_t written(Base<T, I>::buffer_length()), common(written);
 
-    for (RingBuffer<T, I>& buff: this->buffers)
+    for (RingBuffer<T, I, A>& buff: this->buffers)
     {
         written = buff.write_samples(data, length, force);
         common = (written < common) ? written : common;
@@ -444,14 +551,14 @@ int_fast32_t MultiRingBuffer<T, I>::write_samples(
     return common;
 }
 
-template <typename T, typename I>
-int_fast32_t MultiRingBuffer<T, I>::write_bytes(
+template <typename T, typename I, typename A>
+int_fast32_t MultiRingBuffer<T, I, A>::write_bytes(
         uint8_t* data,
         int_fast32_t numBytes,
         bool force
     )
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!size_is_set())
     {
         std::cerr << "Error: size not set!\n";
@@ -461,7 +568,7 @@ int_fast32_t MultiRingBuffer<T, I>::write_bytes(
 
     int_fast32_t written(numBytes), common(written);
 
-    for (RingBuffer<T, I>& buff: this->buffers)
+    for (RingBuffer<T, I, A>& buff: this->buffers)
     {
         written = buff.write_bytes(data, numBytes, force);
         common = (written < common) ? written : common;
@@ -472,6 +579,90 @@ int_fast32_t MultiRingBuffer<T, I>::write_bytes(
     return common;
 }
 
+template <typename T, typename I, typename A>
+int_fast32_t MultiRingBuffer<T, I, A>::write_samples_interleaved(
+        const T* data,
+        int_fast32_t length,
+        bool force
+    )
+{
+    #if _DEBUG
+    if (!size_is_set())
+    {
+        std::cerr << "Error: size not set!\n";
+        throw SIZE_NOT_SET;
+    }
+    #endif
+
+    const int_fast8_t numChannels(this->_numBuffers);
+    int_fast32_t written(0), remaining(length / numChannels);
+    int_fast8_t index(this->_ringLength);
+    T* outputs[8];
+
+    while ((remaining > 0) && (index-- > 0))
+    {
+        /* Largest block every sub buffer has room for contiguously */
+        int_fast32_t block(remaining);
+        for (const RingBuffer<T, I, A>& buff: this->buffers)
+        {
+            if (!(buff.is_writable() || force)) block = 0;
+            block = std::min(block, buff._samplesUnwritten);
+        }
+        if (!block) break;
+
+        if (numChannels <= 8)
+        {
+            for (int_fast8_t c(0); c < numChannels; ++c)
+            {
+                outputs[c] = this->buffers[c].get_write_sample();
+            }
+            deinterleave<T>(outputs, data, numChannels, block);
+        }
+        else
+        {
+            for (int_fast8_t c(0); c < numChannels; ++c)
+            {
+                deinterleave_channel<T>(
+                        this->buffers[c].get_write_sample(),
+                        data + c,
+                        numChannels,
+                        block
+                    );
+            }
+        }
+
+        for (RingBuffer<T, I, A>& buff: this->buffers)
+        {
+            buff.commit_written_samples(block);
+        }
+        data += block * numChannels;
+        written += block;
+        remaining -= block;
+    }
+
+    update();
+
+    return written * numChannels;
+}
+
+template <typename T, typename I, typename A>
+int_fast32_t MultiRingBuffer<T, I, A>::write_bytes_interleaved(
+        const uint8_t* data,
+        int_fast32_t numBytes,
+        bool force
+    )
+{
+    #if _DEBUG
+    if (numBytes % Base<T, I>::bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
+    #endif
+
+    return write_samples_interleaved(
+            reinterpret_cast<const T*>(data),
+            numBytes / Base<T, I>::bytesPerSample,
+            force
+        ) * Base<T, I>::bytesPerSample;
+}
+
 template <typename T>
 NonAtomicMultiRingBuffer<T>::NonAtomicMultiRingBuffer() :
 MultiRingBuffer<T, int_fast8_t>()
@@ -496,11 +687,33 @@ MultiRingBuffer<T, int_fast8_t>(obj)
 {
 }
 
+template <typename T>
+NonAtomicMultiRingBuffer<T>::NonAtomicMultiRingBuffer(
+        NonAtomicMultiRingBuffer&& obj
+    ) noexcept :
+MultiRingBuffer<T, int_fast8_t>(std::move(obj))
+{
+}
+
 template <typename T>
 NonAtomicMultiRingBuffer<T>::~NonAtomicMultiRingBuffer()
 {
 }
 
+template <typename T>
+NonAtomicMultiRingBuffer<T>& NonAtomicMultiRingBuffer<T>::operator=(const NonAtomicMultiRingBuffer& obj)
+{
+    MultiRingBuffer<T, int_fast8_t>::operator=(obj);
+    return *this;
+}
+
+template <typename T>
+NonAtomicMultiRingBuffer<T>& NonAtomicMultiRingBuffer<T>::operator=(NonAtomicMultiRingBuffer&& obj) noexcept
+{
+    MultiRingBuffer<T, int_fast8_t>::operator=(std::move(obj));
+    return *this;
+}
+
 template <typename T>
 AtomicMultiRingBuffer<T>::AtomicMultiRingBuffer() :
 MultiRingBuffer<T, std::atomic_int_fast8_t>()
@@ -529,11 +742,33 @@ MultiRingBuffer<T, std::atomic_int_fast8_t>(obj)
 {
 }
 
+template <typename T>
+AtomicMultiRingBuffer<T>::AtomicMultiRingBuffer(
+        AtomicMultiRingBuffer&& obj
+    ) noexcept :
+MultiRingBuffer<T, std::atomic_int_fast8_t>(std::move(obj))
+{
+}
+
 template <typename T>
 AtomicMultiRingBuffer<T>::~AtomicMultiRingBuffer()
 {
 }
 
+template <typename T>
+AtomicMultiRingBuffer<T>& AtomicMultiRingBuffer<T>::operator=(const AtomicMultiRingBuffer& obj)
+{
+    MultiRingBuffer<T, std::atomic_int_fast8_t>::operator=(obj);
+    return *this;
+}
+
+template <typename T>
+AtomicMultiRingBuffer<T>& AtomicMultiRingBuffer<T>::operator=(AtomicMultiRingBuffer&& obj) noexcept
+{
+    MultiRingBuffer<T, std::atomic_int_fast8_t>::operator=(std::move(obj));
+    return *this;
+}
+
 /*                           Ring Buffer                            */
 
 // template class Buffer::MultiRingBuffer<int8_t, int_fast8_t>;
@@ -545,6 +780,8 @@ template class Buffer::MultiRingBuffer<int32_t, int_fast8_t>;
 // template class Buffer::MultiRingBuffer<int64_t, int_fast8_t>;
 // template class Buffer::MultiRingBuffer<uint64_t, int_fast8_t>;
 
+template class Buffer::MultiRingBuffer<Int24, int_fast8_t>;
+
 // #if (int32_t != int)
 // template class Buffer::MultiRingBuffer<int, int_fast8_t>;
 // #endif
@@ -584,6 +821,8 @@ template class Buffer::MultiRingBuffer<int32_t, std::atomic_int_fast8_t>;
 // template class Buffer::MultiRingBuffer<int64_t, std::atomic_int_fast8_t>;
 // template class Buffer::MultiRingBuffer<uint64_t, std::atomic_int_fast8_t>;
 
+template class Buffer::MultiRingBuffer<Int24, std::atomic_int_fast8_t>;
+
 // #if (int32_t != int)
 // template class Buffer::MultiRingBuffer<int, std::atomic_int_fast8_t>;
 // #endif
@@ -612,6 +851,88 @@ template class Buffer::MultiRingBuffer<double, std::atomic_int_fast8_t>;
 // template class Buffer::MultiRingBuffer<char16_t, std::atomic_int_fast8_t>;
 // template class Buffer::MultiRingBuffer<char32_t, std::atomic_int_fast8_t>;
 
+/*                   Arena Allocated Ring Buffer                    */
+
+// template class Buffer::MultiRingBuffer<int8_t, int_fast8_t, ArenaAllocator<int8_t>>;
+template class Buffer::MultiRingBuffer<uint8_t, int_fast8_t, ArenaAllocator<uint8_t>>;
+template class Buffer::MultiRingBuffer<int16_t, int_fast8_t, ArenaAllocator<int16_t>>;
+// template class Buffer::MultiRingBuffer<uint16_t, int_fast8_t, ArenaAllocator<uint16_t>>;
+template class Buffer::MultiRingBuffer<int32_t, int_fast8_t, ArenaAllocator<int32_t>>;
+// template class Buffer::MultiRingBuffer<uint32_t, int_fast8_t, ArenaAllocator<uint32_t>>;
+// template class Buffer::MultiRingBuffer<int64_t, int_fast8_t, ArenaAllocator<int64_t>>;
+// template class Buffer::MultiRingBuffer<uint64_t, int_fast8_t, ArenaAllocator<uint64_t>>;
+
+template class Buffer::MultiRingBuffer<Int24, int_fast8_t, ArenaAllocator<Int24>>;
+
+// #if (int32_t != int)
+// template class Buffer::MultiRingBuffer<int, int_fast8_t, ArenaAllocator<int>>;
+// #endif
+
+#if (int32_t != int_fast32_t)
+template class Buffer::MultiRingBuffer<int_fast8_t, int_fast8_t, ArenaAllocator<int_fast8_t>>;
+template class Buffer::MultiRingBuffer<uint_fast8_t, int_fast8_t, ArenaAllocator<uint_fast8_t>>;
+template class Buffer::MultiRingBuffer<int_fast16_t, int_fast8_t, ArenaAllocator<int_fast16_t>>;
+template class Buffer::MultiRingBuffer<uint_fast16_t, int_fast8_t, ArenaAllocator<uint_fast16_t>>;
+template class Buffer::MultiRingBuffer<int_fast32_t, int_fast8_t, ArenaAllocator<int_fast32_t>>;
+template class Buffer::MultiRingBuffer<uint_fast32_t, int_fast8_t, ArenaAllocator<uint_fast32_t>>;
+template class Buffer::MultiRingBuffer<int_fast64_t, int_fast8_t, ArenaAllocator<int_fast64_t>>;
+template class Buffer::MultiRingBuffer<uint_fast64_t, int_fast8_t, ArenaAllocator<uint_fast64_t>>;
+#endif
+
+template class Buffer::MultiRingBuffer<float, int_fast8_t, ArenaAllocator<float>>;
+template class Buffer::MultiRingBuffer<double, int_fast8_t, ArenaAllocator<double>>;
+// template class Buffer::MultiRingBuffer<long double, int_fast8_t, ArenaAllocator<long double>>;
+
+// #if (int8_t != char)
+// template class Buffer::MultiRingBuffer<char, int_fast8_t, ArenaAllocator<char>>;
+// template class Buffer::MultiRingBuffer<unsigned char, int_fast8_t, ArenaAllocator<unsigned char>>;
+// #endif
+
+// template class Buffer::MultiRingBuffer<wchar_t, int_fast8_t, ArenaAllocator<wchar_t>>;
+// template class Buffer::MultiRingBuffer<char16_t, int_fast8_t, ArenaAllocator<char16_t>>;
+// template class Buffer::MultiRingBuffer<char32_t, int_fast8_t, ArenaAllocator<char32_t>>;
+
+/*            Arena Allocated Atomic Indices Ring Buffer            */
+
+// template class Buffer::MultiRingBuffer<int8_t, std::atomic_int_fast8_t, ArenaAllocator<int8_t>>;
+template class Buffer::MultiRingBuffer<uint8_t, std::atomic_int_fast8_t, ArenaAllocator<uint8_t>>;
+template class Buffer::MultiRingBuffer<int16_t, std::atomic_int_fast8_t, ArenaAllocator<int16_t>>;
+// template class Buffer::MultiRingBuffer<uint16_t, std::atomic_int_fast8_t, ArenaAllocator<uint16_t>>;
+template class Buffer::MultiRingBuffer<int32_t, std::atomic_int_fast8_t, ArenaAllocator<int32_t>>;
+// template class Buffer::MultiRingBuffer<uint32_t, std::atomic_int_fast8_t, ArenaAllocator<uint32_t>>;
+// template class Buffer::MultiRingBuffer<int64_t, std::atomic_int_fast8_t, ArenaAllocator<int64_t>>;
+// template class Buffer::MultiRingBuffer<uint64_t, std::atomic_int_fast8_t, ArenaAllocator<uint64_t>>;
+
+template class Buffer::MultiRingBuffer<Int24, std::atomic_int_fast8_t, ArenaAllocator<Int24>>;
+
+// #if (int32_t != int)
+// template class Buffer::MultiRingBuffer<int, std::atomic_int_fast8_t, ArenaAllocator<int>>;
+// #endif
+
+#if (int32_t != int_fast32_t)
+template class Buffer::MultiRingBuffer<int_fast8_t, std::atomic_int_fast8_t, ArenaAllocator<int_fast8_t>>;
+template class Buffer::MultiRingBuffer<uint_fast8_t, std::atomic_int_fast8_t, ArenaAllocator<uint_fast8_t>>;
+template class Buffer::MultiRingBuffer<int_fast16_t, std::atomic_int_fast8_t, ArenaAllocator<int_fast16_t>>;
+template class Buffer::MultiRingBuffer<uint_fast16_t, std::atomic_int_fast8_t, ArenaAllocator<uint_fast16_t>>;
+template class Buffer::MultiRingBuffer<int_fast32_t, std::atomic_int_fast8_t, ArenaAllocator<int_fast32_t>>;
+template class Buffer::MultiRingBuffer<uint_fast32_t, std::atomic_int_fast8_t, ArenaAllocator<uint_fast32_t>>;
+template class Buffer::MultiRingBuffer<int_fast64_t, std::atomic_int_fast8_t, ArenaAllocator<int_fast64_t>>;
+template class Buffer::MultiRingBuffer<uint_fast64_t, std::atomic_int_fast8_t, ArenaAllocator<uint_fast64_t>>;
+#endif
+
+template class Buffer::MultiRingBuffer<float, std::atomic_int_fast8_t, ArenaAllocator<float>>;
+template class Buffer::MultiRingBuffer<double, std::atomic_int_fast8_t, ArenaAllocator<double>>;
+// template class Buffer::MultiRingBuffer<long double, std::atomic_int_fast8_t, ArenaAllocator<long double>>;
+
+// #if (int8_t != char)
+// template class Buffer::MultiRingBuffer<char, std::atomic_int_fast8_t, ArenaAllocator<char>>;
+// template class Buffer::MultiRingBuffer<unsigned char, std::atomic_int_fast8_t, ArenaAllocator<unsigned char>>;
+// #endif
+
+// template class Buffer::MultiRingBuffer<wchar_t, std::atomic_int_fast8_t, ArenaAllocator<wchar_t>>;
+// template class Buffer::MultiRingBuffer<char16_t, std::atomic_int_fast8_t, ArenaAllocator<char16_t>>;
+// template class Buffer::MultiRingBuffer<char32_t, std::atomic_int_fast8_t, ArenaAllocator<char32_t>>;
+
 /*                           Ring Buffer                            */
 
 // template class Buffer::NonAtomicMultiRingBuffer<int8_t>;
@@ -623,6 +944,8 @@ template class Buffer::NonAtomicMultiRingBuffer<int32_t>;
 // template class Buffer::NonAtomicMultiRingBuffer<int64_t>;
 // template class Buffer::NonAtomicMultiRingBuffer<uint64_t>;
 
+template class Buffer::NonAtomicMultiRingBuffer<Int24>;
+
 // #if (int32_t != int)
 // template class Buffer::NonAtomicMultiRingBuffer<int>;
 // #endif
@@ -662,6 +985,8 @@ template class Buffer::AtomicMultiRingBuffer<int32_t>;
 // template class Buffer::AtomicMultiRingBuffer<int64_t>;
 // template class Buffer::AtomicMultiRingBuffer<uint64_t>;
 
+template class Buffer::AtomicMultiRingBuffer<Int24>;
+
 // #if (int32_t != int)
 // template class Buffer::AtomicMultiRingBuffer<int>;
 // #endif
@@ -0,0 +1,236 @@
+#include "resampler.h"
+
+using namespace Resample;
+
+/* One input frame in 32.32 fixed point */
+static constexpr const int64_t unitPhase = (static_cast<int64_t>(1) << 32);
+
+/*                          Cubic Resampler                         */
+
+template <typename T>
+CubicResampler<T>::CubicResampler(int_fast8_t channels) :
+_channels(channels),
+_step(unitPhase),
+_phase(0)
+{
+    this->_history.resize(
+            4 * this->_channels,
+            static_cast<float>(get_zero<T>())
+        );
+}
+
+template <typename T>
+CubicResampler<T>::~CubicResampler()
+{
+}
+
+template <typename T>
+inline T CubicResampler<T>::_to_sample(float value)
+{
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        return static_cast<T>(value);
+    }
+    else
+    {
+        return static_cast<T>(std::clamp(
+                std::nearbyint(value),
+                static_cast<float>(std::numeric_limits<T>::min()),
+                static_cast<float>(std::numeric_limits<T>::max())
+            ));
+    }
+}
+
+template <typename T>
+void CubicResampler<T>::set_ratio(double ratio)
+{
+    #if _DEBUG
+    if ((ratio < 0.5) || (ratio > 2.0)) throw RESAMPLE_RATIO_OUT_OF_RANGE;
+    #endif
+
+    this->_step = static_cast<int64_t>(std::llround(unitPhase / ratio));
+}
+
+template <typename T>
+double CubicResampler<T>::ratio() const
+{
+    return static_cast<double>(unitPhase) / static_cast<double>(this->_step);
+}
+
+template <typename T>
+int_fast32_t CubicResampler<T>::max_output_frames(int_fast32_t inFrames) const
+{
+    return static_cast<int_fast32_t>(
+            ((static_cast<int64_t>(inFrames) + 1) * unitPhase) / this->_step
+        ) + 1;
+}
+
+template <typename T>
+int_fast32_t CubicResampler<T>::process(
+        const T* in,
+        int_fast32_t inFrames,
+        T* out,
+        int_fast32_t maxOutFrames
+    )
+{
+    #if _DEBUG
+    if (maxOutFrames < max_output_frames(inFrames))
+    {
+        throw RESAMPLE_OUTPUT_TOO_SHORT;
+    }
+    #endif
+
+    const int_fast8_t channels(this->_channels);
+    float* h0 = this->_history.data();
+    float* h1 = h0 + channels;
+    float* h2 = h1 + channels;
+    float* h3 = h2 + channels;
+    int_fast32_t numOut(0);
+
+    for (int_fast32_t i(0); i < inFrames; ++i)
+    {
+        /* Shift the newest input frame into history */
+        std::copy(h1, h0 + (4 * channels), h0);
+        for (int_fast8_t c(0); c < channels; ++c)
+        {
+            h3[c] = static_cast<float>(in[(i * channels) + c]);
+        }
+
+        /* Emit every output frame that falls between h1 and h2 */
+        while ((this->_phase < unitPhase) && (numOut < maxOutFrames))
+        {
+            const float t(static_cast<float>(this->_phase) * (1.0f / unitPhase));
+            T* frame = out + (numOut * channels);
+            for (int_fast8_t c(0); c < channels; ++c)
+            {
+                const float a(
+                        (-0.5f * h0[c]) + (1.5f * h1[c])
+                        - (1.5f * h2[c]) + (0.5f * h3[c])
+                    );
+                const float b(
+                        h0[c] - (2.5f * h1[c])
+                        + (2.0f * h2[c]) - (0.5f * h3[c])
+                    );
+                const float d(0.5f * (h2[c] - h0[c]));
+                frame[c] = _to_sample((((((a * t) + b) * t) + d) * t) + h1[c]);
+            }
+            ++numOut;
+            this->_phase += this->_step;
+        }
+        this->_phase -= unitPhase;
+    }
+
+    return numOut;
+}
+
+template <typename T>
+void CubicResampler<T>::reset()
+{
+    std::fill(
+            this->_history.begin(),
+            this->_history.end(),
+            static_cast<float>(get_zero<T>())
+        );
+    this->_phase = 0;
+}
+
+/*                          Drift Estimator                         */
+
+DriftEstimator::DriftEstimator(int_fast32_t targetFill, double maxPpm) :
+_targetFill(static_cast<double>(targetFill)),
+_smoothing(1.0 / 64),
+_proportionalGain(2e-4),
+_integralGain(2e-7),
+_maxDeviation(maxPpm * 1e-6)
+{
+    reset();
+}
+
+DriftEstimator::~DriftEstimator()
+{
+}
+
+void DriftEstimator::set_target_fill(int_fast32_t targetFill)
+{
+    this->_targetFill = static_cast<double>(targetFill);
+}
+
+void DriftEstimator::set_gains(
+        double proportional,
+        double integral,
+        double smoothing
+    )
+{
+    this->_proportionalGain = proportional;
+    this->_integralGain = integral;
+    this->_smoothing = smoothing;
+}
+
+double DriftEstimator::update(int_fast32_t fill)
+{
+    if (!this->_primed)
+    {
+        this->_smoothedFill = static_cast<double>(fill);
+        this->_primed = true;
+    }
+    this->_smoothedFill += (
+            (static_cast<double>(fill) - this->_smoothedFill)
+            * this->_smoothing
+        );
+
+    /* An overfull ring means the sender runs fast,
+    so fewer samples should come out than go in */
+    const double error(
+            (this->_smoothedFill - this->_targetFill)
+            / std::max(this->_targetFill, 1.0)
+        );
+
+    /* Integral is clamped to the correction range to prevent windup */
+    this->_integral = std::clamp(
+            this->_integral + (error * this->_integralGain),
+            -this->_maxDeviation,
+            this->_maxDeviation
+        );
+    this->_ratio = 1.0 - std::clamp(
+            this->_integral + (error * this->_proportionalGain),
+            -this->_maxDeviation,
+            this->_maxDeviation
+        );
+
+    return this->_ratio;
+}
+
+double DriftEstimator::ratio() const
+{
+    return this->_ratio;
+}
+
+double DriftEstimator::ppm() const
+{
+    return (1.0 - this->_ratio) * 1e6;
+}
+
+void DriftEstimator::reset()
+{
+    this->_smoothedFill = this->_targetFill;
+    this->_integral = 0;
+    this->_ratio = 1.0;
+    this->_primed = false;
+}
+
+/*                      Template Instantiations                     */
+
+// template class Resample::CubicResampler<int8_t>;
+template class Resample::CubicResampler<uint8_t>;
+template class Resample::CubicResampler<int16_t>;
+// template class Resample::CubicResampler<uint16_t>;
+template class Resample::CubicResampler<int32_t>;
+// template class Resample::CubicResampler<uint32_t>;
+// template class Resample::CubicResampler<int64_t>;
+// template class Resample::CubicResampler<uint64_t>;
+
+template class Resample::CubicResampler<Int24>;
+
+template class Resample::CubicResampler<float>;
+template class Resample::CubicResampler<double>;
+// template class Resample::CubicResampler<long double>;
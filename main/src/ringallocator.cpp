@@ -0,0 +1,116 @@
+#include "ringallocator.h"
+
+using namespace Buffer;
+
+Arena::Arena(size_t size, uint32_t caps) :
+_region(nullptr),
+_size(size),
+_caps(caps),
+_owned(true)
+{
+    #ifdef ESP_PLATFORM
+    this->_region = static_cast<uint8_t*>(heap_caps_aligned_alloc(
+            RINGBUFF_CACHE_LINE_SIZE,
+            size,
+            caps
+        ));
+    #else
+    this->_region = static_cast<uint8_t*>(::operator new(
+            size,
+            std::align_val_t(RINGBUFF_CACHE_LINE_SIZE),
+            std::nothrow
+        ));
+    #endif
+
+    if (this->_region == nullptr) this->_size = 0;
+}
+
+Arena::Arena(void* region, size_t size) :
+_region(static_cast<uint8_t*>(region)),
+_size(size),
+_caps(0),
+_owned(false)
+{
+}
+
+Arena::~Arena()
+{
+    if (!this->_owned || (this->_region == nullptr)) return;
+
+    #ifdef ESP_PLATFORM
+    heap_caps_free(this->_region);
+    #else
+    ::operator delete(
+            this->_region,
+            std::align_val_t(RINGBUFF_CACHE_LINE_SIZE)
+        );
+    #endif
+}
+
+void* Arena::allocate(size_t numBytes, size_t alignment)
+{
+    const uintptr_t base(reinterpret_cast<uintptr_t>(this->_region));
+    size_t offset(this->_offset.load(std::memory_order_relaxed));
+    size_t start, end;
+    do
+    {
+        /* Align the address rather than the offset,
+        since a caller supplied region may be unaligned */
+        start = (
+                ((base + offset + (alignment - 1)) & ~(uintptr_t)(alignment - 1))
+                - base
+            );
+        end = start + numBytes;
+        if (end > this->_size) return nullptr;
+    }
+    while (!this->_offset.compare_exchange_weak(
+            offset,
+            end,
+            std::memory_order_relaxed
+        ));
+
+    return this->_region + start;
+}
+
+void Arena::deallocate(void* data, size_t numBytes)
+{
+    if (data == nullptr) return;
+
+    const size_t start(static_cast<uint8_t*>(data) - this->_region);
+    size_t end(start + numBytes);
+    this->_offset.compare_exchange_strong(
+            end,
+            start,
+            std::memory_order_relaxed
+        );
+}
+
+void Arena::reset()
+{
+    this->_offset.store(0, std::memory_order_relaxed);
+}
+
+bool Arena::valid() const
+{
+    return (this->_region != nullptr);
+}
+
+size_t Arena::size() const
+{
+    return this->_size;
+}
+
+size_t Arena::used() const
+{
+    return this->_offset.load(std::memory_order_relaxed);
+}
+
+size_t Arena::available() const
+{
+    return this->_size - used();
+}
+
+uint32_t Arena::caps() const
+{
+    return this->_caps;
+}
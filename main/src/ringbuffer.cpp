@@ -6,15 +6,14 @@ template <typename T, typename I>
 Base<T, I>::Base() :
 _firstWritten(false),
 _ringLength(0),
-_buffered(0),
-_samplesWritten(0),
-_samplesUnwritten(0),
-_samplesProcessed(0),
-_samplesUnread(0),
 _bufferLength(0),
 _bytesPerBuffer(0),
 _totalWritableLength(0),
-_totalRingSampleLength(0)
+_totalRingSampleLength(0),
+_samplesWritten(0),
+_samplesUnwritten(0),
+_samplesUnread(0),
+_samplesProcessed(0)
 {
 }
 
@@ -27,14 +26,45 @@ Base<T, I>::Base(int_fast32_t bufferSize, int_fast8_t ringSize)
 template <typename T, typename I>
 Base<T, I>::Base(const Base& obj)
 {
-    /* make a simple copy constructor; i.e., assign values,
-    not set_size() because running copy const when pushing
-    into a vector is triggering error checking before size
-    can be properly set.  default constructor is being used
-    to initialize but not set anything */
-    
-    set_size(obj.buffer_length(), obj.ring_length());
-    
+    /* Assign values rather than calling set_size(),
+    which would check sizes an unsized source never set */
+    _copy_state(obj);
+}
+
+template <typename T, typename I>
+Base<T, I>::Base(Base&& obj) noexcept
+{
+    _copy_state(obj);
+    obj._clear_state();
+}
+
+template <typename T, typename I>
+Base<T, I>& Base<T, I>::operator=(const Base& obj)
+{
+    if (this != &obj) _copy_state(obj);
+    return *this;
+}
+
+template <typename T, typename I>
+Base<T, I>& Base<T, I>::operator=(Base&& obj) noexcept
+{
+    if (this != &obj)
+    {
+        _copy_state(obj);
+        obj._clear_state();
+    }
+    return *this;
+}
+
+template <typename T, typename I>
+void Base<T, I>::_copy_state(const Base& obj)
+{
+    this->_ringLength = obj._ringLength;
+    this->_bufferLength = obj._bufferLength;
+    this->_bytesPerBuffer = obj._bytesPerBuffer;
+    this->_totalWritableLength = obj._totalWritableLength;
+    this->_totalRingSampleLength = obj._totalRingSampleLength;
+
     int_fast8_t readidx = obj.readIndex;
     this->readIndex = readidx;
     int_fast8_t writeidx = obj.writeIndex;
@@ -43,18 +73,136 @@ Base<T, I>::Base(const Base& obj)
     this->processingIndex = procidx;
     
     this->_firstWritten = obj._firstWritten;
-    this->_buffered = obj._buffered;
+    this->_policy.store(obj._policy.load());
+    this->_lowWatermark = obj._lowWatermark;
+    this->_highWatermark = obj._highWatermark;
+    this->_watermarkHysteresis = obj._watermarkHysteresis;
+    this->_watermarkCallback = obj._watermarkCallback;
+    this->_watermarkContext = obj._watermarkContext;
+    #ifdef ESP_PLATFORM
+    this->_watermarkEventGroup = obj._watermarkEventGroup;
+    #endif
+    this->_watermarkState.store(obj._watermarkState.load());
+    this->_watermarkEvents.store(obj._watermarkEvents.load());
+    this->_samplesDropped.store(obj._samplesDropped.load());
+    this->_buffersDropped.store(obj._buffersDropped.load());
+    this->_samplesCommitted.store(obj._samplesCommitted.load());
+    this->_samplesReleased.store(obj._samplesReleased.load());
     this->_samplesWritten = obj._samplesWritten;
     this->_samplesUnwritten = obj._samplesUnwritten;
     this->_samplesProcessed = obj._samplesProcessed;
     this->_samplesUnread = obj._samplesUnread;
 }
 
+template <typename T, typename I>
+void Base<T, I>::_clear_state()
+{
+    this->_ringLength = 0;
+    this->_bufferLength = 0;
+    this->_bytesPerBuffer = 0;
+    this->_totalWritableLength = 0;
+    this->_totalRingSampleLength = 0;
+    Base<T, I>::reset();
+    this->readIndex = 0;
+}
+
 template <typename T, typename I>
 Base<T, I>::~Base()
 {
 }
 
+template <typename T, typename I>
+inline void Base<T, I>::_commit(int_fast32_t length)
+{
+    this->_samplesCommitted.store(
+            this->_samplesCommitted.load(std::memory_order_relaxed) + length,
+            std::memory_order_release
+        );
+    _check_watermarks();
+    this->_readable.notify();
+}
+
+template <typename T, typename I>
+inline void Base<T, I>::_release(int_fast32_t length)
+{
+    this->_samplesReleased.store(
+            this->_samplesReleased.load(std::memory_order_relaxed) + length,
+            std::memory_order_release
+        );
+    _check_watermarks();
+    this->_writable.notify();
+}
+
+template <typename T, typename I>
+void Base<T, I>::_check_watermarks()
+{
+    if ((this->_lowWatermark < 0) && (this->_highWatermark < 0)) return;
+
+    const int_fast32_t level(buffered());
+    int_fast8_t state(this->_watermarkState.load(std::memory_order_relaxed));
+    int_fast8_t next(state), events(WATERMARK_NONE);
+
+    if (this->_lowWatermark >= 0)
+    {
+        if (!(state & WATERMARK_LOW) && (level <= this->_lowWatermark))
+        {
+            next |= WATERMARK_LOW;
+            events |= WATERMARK_LOW;
+        }
+        else if (
+                (state & WATERMARK_LOW)
+                && (level > (this->_lowWatermark + this->_watermarkHysteresis))
+            )
+        {
+            next &= ~WATERMARK_LOW;
+            events |= WATERMARK_LOW_CLEARED;
+        }
+    }
+
+    if (this->_highWatermark >= 0)
+    {
+        if (!(state & WATERMARK_HIGH) && (level >= this->_highWatermark))
+        {
+            next |= WATERMARK_HIGH;
+            events |= WATERMARK_HIGH;
+        }
+        else if (
+                (state & WATERMARK_HIGH)
+                && (level < (this->_highWatermark - this->_watermarkHysteresis))
+            )
+        {
+            next &= ~WATERMARK_HIGH;
+            events |= WATERMARK_HIGH_CLEARED;
+        }
+    }
+
+    /* Producer and consumer both check; only the side
+    that records the crossing raises its events */
+    if (!events) return;
+    else if (!this->_watermarkState.compare_exchange_strong(
+            state,
+            next,
+            std::memory_order_relaxed
+        ))
+    {
+        return;
+    }
+
+    this->_watermarkEvents.fetch_or(events, std::memory_order_relaxed);
+
+    #ifdef ESP_PLATFORM
+    if (this->_watermarkEventGroup != nullptr)
+    {
+        xEventGroupSetBits(this->_watermarkEventGroup, events);
+    }
+    #endif
+
+    if (this->_watermarkCallback != nullptr)
+    {
+        this->_watermarkCallback(events, level, this->_watermarkContext);
+    }
+}
+
 template <typename T, typename I>
 inline bool Base<T, I>::size_is_set() const
 {
@@ -64,7 +212,7 @@ inline bool Base<T, I>::size_is_set() const
 template <typename T, typename I>
 void Base<T, I>::set_size(int_fast32_t bufferSize, int_fast8_t ringSize)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     /* There must be multiple buffers to rotate */
     if (ringSize < 2) throw RING_SIZE_TOO_SHORT;
 
@@ -98,7 +246,12 @@ void Base<T, I>::set_size(int_fast32_t bufferSize, int_fast8_t ringSize)
     this->_samplesUnwritten = this->_bufferLength;
     this->_samplesWritten = 0;
     this->_samplesUnread = this->_bufferLength;
-    this->_buffered = 0;
+    this->_samplesCommitted.store(0);
+    this->_samplesReleased.store(0);
+    this->_samplesDropped.store(0);
+    this->_buffersDropped.store(0);
+    this->_watermarkState.store(WATERMARK_NONE);
+    this->_watermarkEvents.store(WATERMARK_NONE);
     this->readIndex = this->_ringLength - 1;
     this->writeIndex = 0;
     this->processingIndex = 0;
@@ -144,7 +297,12 @@ template <typename T, typename I>
 void Base<T, I>::reset()
 {
     this->_firstWritten = false;
-    this->_buffered = 0;
+    this->_samplesCommitted.store(0);
+    this->_samplesReleased.store(0);
+    this->_samplesDropped.store(0);
+    this->_buffersDropped.store(0);
+    this->_watermarkState.store(WATERMARK_NONE);
+    this->_watermarkEvents.store(WATERMARK_NONE);
     this->_samplesUnread = this->_bufferLength;
     this->_samplesUnwritten = this->_bufferLength;
     this->_samplesProcessed = 0;
@@ -154,22 +312,142 @@ void Base<T, I>::reset()
     this->processingIndex = 0;
 }
 
+template <typename T, typename I>
+void Base<T, I>::set_policy(overrun_policy policy)
+{
+    this->_policy.store(policy, std::memory_order_relaxed);
+}
+
+template <typename T, typename I>
+inline overrun_policy Base<T, I>::policy() const
+{
+    return static_cast<overrun_policy>(
+            this->_policy.load(std::memory_order_relaxed)
+        );
+}
+
+template <typename T, typename I>
+int_fast32_t Base<T, I>::catch_up()
+{
+    if (policy() != OVERWRITE_OLDEST) return 0;
+
+    const int_fast32_t excess(buffered() - this->_totalWritableLength);
+    if (excess <= 0) return 0;
+
+    /* Skip whole buffers to preserve chunk alignment */
+    const int_fast32_t numBuffers(
+            (excess + this->_bufferLength - 1) / this->_bufferLength
+        );
+    const int_fast32_t numSamples(
+            (numBuffers - 1) * this->_bufferLength + this->_samplesUnread
+        );
+
+    this->readIndex = (
+            (this->readIndex + numBuffers) % this->_ringLength
+        );
+    this->_samplesUnread = this->_bufferLength;
+    this->_samplesProcessed -= numBuffers * this->_bufferLength;
+    this->_samplesProcessed = (
+            (this->_samplesProcessed < 0)
+            ? 0 : this->_samplesProcessed
+        );
+    this->_samplesDropped.fetch_add(numSamples, std::memory_order_relaxed);
+    this->_buffersDropped.fetch_add(numBuffers, std::memory_order_relaxed);
+    _release(numBuffers * this->_bufferLength);
+    return numSamples;
+}
+
+template <typename T, typename I>
+inline uint_fast32_t Base<T, I>::samples_dropped() const
+{
+    return this->_samplesDropped.load(std::memory_order_relaxed);
+}
+
+template <typename T, typename I>
+inline uint_fast32_t Base<T, I>::buffers_dropped() const
+{
+    return this->_buffersDropped.load(std::memory_order_relaxed);
+}
+
+template <typename T, typename I>
+void Base<T, I>::set_watermarks(
+        int_fast32_t low,
+        int_fast32_t high,
+        int_fast32_t hysteresis
+    )
+{
+    #if _DEBUG
+    if ((low >= 0) && (high >= 0) && (low >= high))
+    {
+        throw std::out_of_range("Low watermark must be < high watermark");
+    }
+    else if (hysteresis < 0)
+    {
+        throw std::out_of_range("Hysteresis must be >= 0");
+    }
+    #endif
+
+    this->_lowWatermark = low;
+    this->_highWatermark = high;
+    this->_watermarkHysteresis = hysteresis;
+    this->_watermarkState.store(WATERMARK_NONE);
+    this->_watermarkEvents.store(WATERMARK_NONE);
+}
+
+template <typename T, typename I>
+void Base<T, I>::set_watermark_callback(
+        watermark_callback callback,
+        void* context
+    )
+{
+    this->_watermarkCallback = callback;
+    this->_watermarkContext = context;
+}
+
+#ifdef ESP_PLATFORM
+template <typename T, typename I>
+void Base<T, I>::set_watermark_event_group(EventGroupHandle_t group)
+{
+    this->_watermarkEventGroup = group;
+}
+#endif
+
+template <typename T, typename I>
+int_fast8_t Base<T, I>::watermark_events()
+{
+    return this->_watermarkEvents.exchange(
+            WATERMARK_NONE,
+            std::memory_order_relaxed
+        );
+}
+
 template <typename T, typename I>
 bool Base<T, I>::is_writable() const
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!size_is_set()) throw BUFFER_NOT_INITIALIZED;
     #endif
 
     // is (available() > 0) in this function redundant?
-    
-    return (this->readIndex != this->writeIndex) && (available() > 0);
+
+    /* A drained reader rotates onto the write buffer;
+    it holds nothing unread there until that buffer rotates */
+    if (policy() == OVERWRITE_OLDEST) return true;
+
+    return (
+            ((this->readIndex != this->writeIndex) || !buffered())
+            && (available() > 0)
+        );
 }
 
 template <typename T, typename I>
 inline int_fast32_t Base<T, I>::buffered() const
 {
-    return this->_buffered;
+    /* Running totals wrap; their difference does not */
+    return static_cast<int_fast32_t>(
+            this->_samplesCommitted.load(std::memory_order_acquire)
+            - this->_samplesReleased.load(std::memory_order_acquire)
+        );
 }
 
 template <typename T, typename I>
@@ -256,6 +534,38 @@ inline int_fast32_t Base<T, I>::buffers_processed() const
     return (processed() / this->_bufferLength);
 }
 
+template <typename T, typename I>
+bool Base<T, I>::wait_readable(int_fast32_t length, int_fast32_t timeoutMs)
+{
+    return this->_readable.wait(
+            [this, length]()
+            {
+                const int_fast32_t numBuffered(buffered());
+                return (numBuffered && ((
+                        numBuffered
+                        - this->_bufferLength
+                        + this->_samplesUnread
+                    ) >= length));
+            },
+            timeoutMs
+        );
+}
+
+template <typename T, typename I>
+bool Base<T, I>::wait_writable(int_fast32_t length, int_fast32_t timeoutMs)
+{
+    return this->_writable.wait(
+            [this, length]()
+            {
+                return (is_writable() && (
+                        (policy() == OVERWRITE_OLDEST)
+                        || (available() >= length)
+                    ));
+            },
+            timeoutMs
+        );
+}
+
 template <typename T, typename I>
 inline void Base<T, I>::rotate_read_index()
 {
@@ -267,9 +577,8 @@ void Base<T, I>::rotate_read_buffer()
 {
     rotate_read_index();
     this->_samplesUnread = this->_bufferLength;
-    this->_buffered -= this->_bufferLength;
+    _release(std::min(this->_bufferLength, buffered()));
     this->_samplesProcessed -= this->_bufferLength;
-    this->_buffered = (this->_buffered < 0) ? 0 : this->_buffered;
     this->_samplesProcessed = (
             (this->_samplesProcessed < 0)
             ? 0 : this->_samplesProcessed
@@ -279,7 +588,7 @@ void Base<T, I>::rotate_read_buffer()
 template <typename T, typename I>
 void Base<T, I>::rotate_partial_read(int_fast32_t length)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (length > this->_bufferLength)
     {
         throw std::out_of_range("Length must be <= buffer length");
@@ -287,10 +596,9 @@ void Base<T, I>::rotate_partial_read(int_fast32_t length)
     #endif
 
     rotate_read_index();
-    this->_buffered -= length;
+    _release(std::min(length, buffered()));
     this->_samplesUnread = this->_bufferLength;
     this->_samplesProcessed -= length;
-    this->_buffered = (this->_buffered < 0) ? 0 : this->_buffered;
     this->_samplesProcessed = (
             (this->_samplesProcessed < 0)
             ? 0 : this->_samplesProcessed
@@ -300,8 +608,7 @@ void Base<T, I>::rotate_partial_read(int_fast32_t length)
 template <typename T, typename I>
 inline void Base<T, I>::report_read_samples(int_fast32_t length)
 {
-    #ifdef _DEBUG
-    std::cout << "Reporting " << length << " read samples\n";
+    #if _DEBUG
     if (length > this->_samplesUnread)
     {
         std::cerr << "Length must be <= unread samples\n";
@@ -320,13 +627,37 @@ inline void Base<T, I>::report_read_samples(int_fast32_t length)
 template <typename T, typename I>
 inline void Base<T, I>::report_read_bytes(int_fast32_t numBytes)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
     #endif
 
     report_read_samples(numBytes / bytesPerSample);
 }
 
+template <typename T, typename I>
+void Base<T, I>::commit_read_samples(int_fast32_t length)
+{
+    #if _DEBUG
+    if (length <= 0) throw std::out_of_range("Length must be > 0");
+    #endif
+
+    int_fast32_t released(0);
+    while (length >= this->_samplesUnread)
+    {
+        length -= this->_samplesUnread;
+        rotate_read_index();
+        this->_samplesUnread = this->_bufferLength;
+        this->_samplesProcessed -= this->_bufferLength;
+        released += this->_bufferLength;
+    }
+    this->_samplesUnread -= length;
+    this->_samplesProcessed = (
+            (this->_samplesProcessed < 0)
+            ? 0 : this->_samplesProcessed
+        );
+    if (released) _release(std::min(released, buffered()));
+}
+
 template <typename T, typename I>
 inline void Base<T, I>::rotate_write_index()
 {
@@ -347,7 +678,7 @@ void Base<T, I>::rotate_write_buffer(bool force)
     rotate_write_index();
     this->_samplesWritten = 0;
     this->_samplesUnwritten = this->_bufferLength;
-    this->_buffered += this->_bufferLength;
+    _commit(this->_bufferLength);
     /* if (force && !is_writable())
     {
         rotate_read_index();
@@ -357,7 +688,7 @@ void Base<T, I>::rotate_write_buffer(bool force)
 template <typename T, typename I>
 void Base<T, I>::rotate_partial_write(int_fast32_t length, bool force)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (length > this->_bufferLength)
     {
         throw std::out_of_range("Length must be <= buffer length");
@@ -367,11 +698,10 @@ void Base<T, I>::rotate_partial_write(int_fast32_t length, bool force)
     rotate_write_index();
     this->_samplesWritten = 0;
     this->_samplesUnwritten = this->_bufferLength;
-    this->_buffered += length;
-    this->_buffered = (
-            (this->_buffered > this->_totalWritableLength)
-            ? this->_totalWritableLength : this->_buffered
-        );
+    _commit(std::max(
+            std::min(length, this->_totalWritableLength - buffered()),
+            static_cast<int_fast32_t>(0)
+        ));
     /* if (force && !is_writable())
     {
         rotate_read_index();
@@ -381,7 +711,7 @@ void Base<T, I>::rotate_partial_write(int_fast32_t length, bool force)
 template <typename T, typename I>
 inline void Base<T, I>::report_written_samples(int_fast32_t length)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (length > this->_samplesUnwritten)
     {
         std::cerr << "Length must be <= unwritten samples\n";
@@ -405,13 +735,34 @@ inline void Base<T, I>::report_written_samples(int_fast32_t length)
 template <typename T, typename I>
 inline void Base<T, I>::report_written_bytes(int_fast32_t numBytes)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
     #endif
 
     report_written_samples(numBytes / bytesPerSample);
 }
 
+template <typename T, typename I>
+void Base<T, I>::commit_written_samples(int_fast32_t length)
+{
+    #if _DEBUG
+    if (length <= 0) throw std::out_of_range("Length must be > 0");
+    #endif
+
+    int_fast32_t completed(0);
+    while (length >= this->_samplesUnwritten)
+    {
+        length -= this->_samplesUnwritten;
+        rotate_write_index();
+        this->_samplesWritten = 0;
+        this->_samplesUnwritten = this->_bufferLength;
+        completed += this->_bufferLength;
+    }
+    this->_samplesWritten += length;
+    this->_samplesUnwritten -= length;
+    if (completed) _commit(completed);
+}
+
 template <typename T, typename I>
 inline void Base<T, I>::rotate_processing_index()
 {
@@ -428,7 +779,7 @@ void Base<T, I>::rotate_processing_buffer()
 template <typename T, typename I>
 void Base<T, I>::rotate_partial_processing(int_fast32_t length)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (length > this->_bufferLength)
     {
         throw std::out_of_range("Length must be <= buffer length");
@@ -446,7 +797,7 @@ void Base<T, I>::rotate_partial_processing(int_fast32_t length)
 template <typename T, typename I>
 inline void Base<T, I>::report_processed_samples(int_fast32_t length)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (length > unprocessed())
     {
         throw std::out_of_range("Length must be <= unprocessed samples");
@@ -475,89 +826,148 @@ inline void Base<T, I>::report_processed_samples(int_fast32_t length)
 template <typename T, typename I>
 inline void Base<T, I>::report_processed_bytes(int_fast32_t numBytes)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (numBytes % bytesPerSample) throw NON_MULTIPLE_BYTE_COUNT;
     #endif
 
     report_processed_samples(numBytes / bytesPerSample);
 }
 
-template <typename T, typename I>
-RingBuffer<T, I>::RingBuffer() :
+template <typename T, typename I, typename A>
+RingBuffer<T, I, A>::RingBuffer() :
 Base<T, I>()
 {
 }
 
-template <typename T, typename I>
-RingBuffer<T, I>::RingBuffer(int_fast32_t bufferSize, int_fast8_t ringSize)
+template <typename T, typename I, typename A>
+RingBuffer<T, I, A>::RingBuffer(const A& allocator) :
+Base<T, I>(),
+_spare(_ring_allocator_type(allocator)),
+ring(_ring_allocator_type(allocator))
+{
+}
+
+template <typename T, typename I, typename A>
+RingBuffer<T, I, A>::RingBuffer(
+        int_fast32_t bufferSize,
+        int_fast8_t ringSize,
+        const A& allocator
+    ) :
+Base<T, I>(),
+_spare(_ring_allocator_type(allocator)),
+ring(_ring_allocator_type(allocator))
 {
     set_size(bufferSize, ringSize);
 }
 
-template <typename T, typename I>
-RingBuffer<T, I>::RingBuffer(const RingBuffer& obj) :
-Base<T, I>(obj)
+template <typename T, typename I, typename A>
+RingBuffer<T, I, A>::RingBuffer(const RingBuffer& obj) :
+Base<T, I>(obj),
+_spare(
+        std::allocator_traits<_ring_allocator_type>
+        ::select_on_container_copy_construction(obj.ring.get_allocator())
+    ),
+ring(obj.ring)
 {
-    set_size(obj.buffer_length(), obj.ring_length());
-    
-    std::copy(
-            obj.ring.begin(),
-            obj.ring.end(),
-            this->ring.begin()
-        );
+}
 
-    // for (int_fast8_t i(0); i < this->_ringLength; ++i)
-    // {
-    //     #ifdef _DEBUG
-    //     std::copy(
-    //             obj.ring.at(i).begin(),
-    //             obj.ring.at(i).end(),
-    //             this->ring.at(i).begin()
-    //         );
-    //     #else
-    //     std::copy(
-    //             obj.ring[i].begin(),
-    //             obj.ring[i].end(),
-    //             this->ring[i].begin()
-    //         );
-    //     #endif
-    // }
+template <typename T, typename I, typename A>
+RingBuffer<T, I, A>::RingBuffer(RingBuffer&& obj) noexcept :
+Base<T, I>(std::move(obj)),
+_spare(std::move(obj._spare)),
+ring(std::move(obj.ring))
+{
 }
 
-template <typename T, typename I>
-RingBuffer<T, I>::~RingBuffer()
+template <typename T, typename I, typename A>
+RingBuffer<T, I, A>::~RingBuffer()
 {
 }
 
-template <typename T, typename I>
-void RingBuffer<T, I>::set_size(int_fast32_t bufferSize, int_fast8_t ringSize)
+template <typename T, typename I, typename A>
+RingBuffer<T, I, A>& RingBuffer<T, I, A>::operator=(const RingBuffer& obj)
 {
-    Base<T, I>::set_size(bufferSize, ringSize);
-    this->ring = std::vector<std::vector<T>>(this->_ringLength);
-    for (int_fast8_t i(0); i < this->_ringLength; ++i)
+    if (this == &obj) return *this;
+
+    Base<T, I>::operator=(obj);
+    _reshape(static_cast<int_fast8_t>(obj.ring.size()));
+    for (size_t i(0); i < obj.ring.size(); ++i)
     {
-        #ifdef _DEBUG
-        this->ring.at(i).reserve(this->_bufferLength);
-        #else
-        this->ring[i].reserve(this->_bufferLength);
-        #endif
-        for (int_fast32_t j(0); j < this->_bufferLength; ++j)
+        this->ring[i].assign(obj.ring[i].begin(), obj.ring[i].end());
+    }
+    return *this;
+}
+
+template <typename T, typename I, typename A>
+RingBuffer<T, I, A>& RingBuffer<T, I, A>::operator=(RingBuffer&& obj) noexcept
+{
+    if (this == &obj) return *this;
+
+    Base<T, I>::operator=(std::move(obj));
+    this->ring = std::move(obj.ring);
+    this->_spare = std::move(obj._spare);
+    obj.ring.clear();
+    obj._spare.clear();
+    return *this;
+}
+
+template <typename T, typename I, typename A>
+void RingBuffer<T, I, A>::_reshape(int_fast8_t ringSize)
+{
+    const size_t length(ringSize);
+    while (this->ring.size() > length)
+    {
+        this->_spare.push_back(std::move(this->ring.back()));
+        this->ring.pop_back();
+    }
+    while (this->ring.size() < length)
+    {
+        if (this->_spare.empty())
         {
-            #ifdef _DEBUG
-            this->ring.at(i).emplace_back(0);
-            #else
-            this->ring[i].emplace_back(0);
-            #endif
+            /* Room for every buffer to become spare,
+            so shrinking later does not allocate */
+            this->_spare.reserve(length);
+            this->ring.emplace_back(A(this->ring.get_allocator()));
+        }
+        else
+        {
+            this->ring.push_back(std::move(this->_spare.back()));
+            this->_spare.pop_back();
         }
     }
 }
 
-template <typename T, typename I>
-void RingBuffer<T, I>::fill(T value)
+template <typename T, typename I, typename A>
+void RingBuffer<T, I, A>::set_size(int_fast32_t bufferSize, int_fast8_t ringSize)
+{
+    Base<T, I>::set_size(bufferSize, ringSize);
+    _reshape(this->_ringLength);
+    for (buffer_type& buff: this->ring)
+    {
+        buff.assign(this->_bufferLength, 0);
+    }
+}
+
+template <typename T, typename I, typename A>
+void RingBuffer<T, I, A>::reserve(int_fast32_t bufferSize, int_fast8_t ringSize)
+{
+    const size_t length(ringSize);
+    this->ring.reserve(length);
+    this->_spare.reserve(length);
+    while ((this->ring.size() + this->_spare.size()) < length)
+    {
+        this->_spare.emplace_back(A(this->ring.get_allocator()));
+    }
+    for (buffer_type& buff: this->ring) buff.reserve(bufferSize);
+    for (buffer_type& buff: this->_spare) buff.reserve(bufferSize);
+}
+
+template <typename T, typename I, typename A>
+void RingBuffer<T, I, A>::fill(T value)
 {
     for (int_fast32_t i(0); i < this->_bufferLength; ++i)
     {
-        #ifdef _DEBUG
+        #if _DEBUG
         this->ring.at(0).at(i) = value;
         #else
         this->ring[0][i] = value;
@@ -566,7 +976,7 @@ void RingBuffer<T, I>::fill(T value)
     
     for (int_fast32_t i(1); i < this->_ringLength; ++i)
     {
-        #ifdef _DEBUG
+        #if _DEBUG
         std::copy(
                 this->ring.at(0).begin(),
                 this->ring.at(0).end(),
@@ -582,16 +992,16 @@ void RingBuffer<T, I>::fill(T value)
     }
 }
 
-template <typename T, typename I>
-inline int_fast8_t RingBuffer<T, I>::get_ring_index(std::vector<T>* bufferPtr)
+template <typename T, typename I, typename A>
+inline int_fast8_t RingBuffer<T, I, A>::get_ring_index(buffer_type* bufferPtr)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!Base<T, I>::size_is_set()) throw BUFFER_NOT_INITIALIZED;
     #endif
 
     for (int_fast8_t i(0); i < this->_ringLength; ++i)
     {
-        #ifdef _DEBUG
+        #if _DEBUG
         if (&(this->ring.at(i)) == bufferPtr)
         #else
         if (&(this->ring[i]) == bufferPtr)
@@ -601,17 +1011,17 @@ inline int_fast8_t RingBuffer<T, I>::get_ring_index(std::vector<T>* bufferPtr)
         }
     }
 
-    #ifdef _DEBUG
+    #if _DEBUG
     throw std::out_of_range("Buffer not found");
     #else
     return BUFFER_ADDR_NOT_FOUND;
     #endif
 }
 
-template <typename T, typename I>
-inline int_fast8_t RingBuffer<T, I>::get_ring_index(uint8_t* bufferPtr)
+template <typename T, typename I, typename A>
+inline int_fast8_t RingBuffer<T, I, A>::get_ring_index(uint8_t* bufferPtr)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!Base<T, I>::size_is_set()) throw BUFFER_NOT_INITIALIZED;
     #endif
 
@@ -623,42 +1033,52 @@ inline int_fast8_t RingBuffer<T, I>::get_ring_index(uint8_t* bufferPtr)
         }
     }
 
-    #ifdef _DEBUG
+    #if _DEBUG
     throw std::out_of_range("Buffer not found");
     #else
     return BUFFER_ADDR_NOT_FOUND;
     #endif
 }
 
-template <typename T, typename I>
-inline std::vector<T> RingBuffer<T, I>::_read()
+template <typename T, typename I, typename A>
+inline std::vector<T, A> RingBuffer<T, I, A>::_read()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return this->ring.at(this->readIndex);
     #else
     return this->ring[this->readIndex];
     #endif
 }
 
-template <typename T, typename I>
-std::vector<T> RingBuffer<T, I>::read()
+template <typename T, typename I, typename A>
+std::vector<T, A> RingBuffer<T, I, A>::read()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!Base<T, I>::size_is_set()) throw BUFFER_NOT_INITIALIZED;
+    #endif
+
+    this->catch_up();
+
+    #if _DEBUG
     if (!Base<T, I>::buffers_buffered()) throw READ_BUFFER_UNDERRUN;
     #endif
 
-    std::vector<T> output(_read());
+    buffer_type output(_read());
     Base<T, I>::rotate_read_buffer();
     return output;
 }
 
-template <typename T, typename I>
-void RingBuffer<T, I>::read_samples(T* data, int_fast32_t length)
+template <typename T, typename I, typename A>
+void RingBuffer<T, I, A>::read_samples(T* data, int_fast32_t length)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!Base<T, I>::size_is_set()) throw BUFFER_NOT_INITIALIZED;
     if (!length) throw VALUE_MUST_BE_NONZERO;
+    #endif
+
+    this->catch_up();
+
+    #if _DEBUG
     if (length > this->_samplesUnread)
     {
         throw std::out_of_range("Must be <= samples unread");
@@ -669,10 +1089,10 @@ void RingBuffer<T, I>::read_samples(T* data, int_fast32_t length)
     Base<T, I>::report_read_samples(length);
 }
 
-template <typename T, typename I>
-void RingBuffer<T, I>::read_bytes(uint8_t* data, int_fast32_t numBytes)
+template <typename T, typename I, typename A>
+void RingBuffer<T, I, A>::read_bytes(uint8_t* data, int_fast32_t numBytes)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (numBytes % Base<T, I>::bytesPerSample)
     {
         throw NON_MULTIPLE_BYTE_COUNT;
@@ -685,30 +1105,113 @@ void RingBuffer<T, I>::read_bytes(uint8_t* data, int_fast32_t numBytes)
         );
 }
 
-template <typename T, typename I>
-inline std::vector<T>* RingBuffer<T, I>::get_read_buffer()
+template <typename T, typename I, typename A>
+int_fast32_t RingBuffer<T, I, A>::read(std::span<T> data)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
+    if (!Base<T, I>::size_is_set()) throw BUFFER_NOT_INITIALIZED;
+    #endif
+
+    this->catch_up();
+
+    int_fast32_t numRead(0), remaining(static_cast<int_fast32_t>(data.size()));
+    int_fast8_t index(this->_ringLength);
+
+    while ((remaining > 0) && Base<T, I>::buffered() && (index-- > 0))
+    {
+        const int_fast32_t length(std::min(remaining, this->_samplesUnread));
+        std::copy_n(get_read_sample(), length, data.data() + numRead);
+        numRead += length;
+        remaining -= length;
+        this->report_read_samples(length);
+    }
+    return numRead;
+}
+
+template <typename T, typename I, typename A>
+int_fast8_t RingBuffer<T, I, A>::get_read_regions(
+        int_fast32_t length,
+        T* regions[2],
+        int_fast32_t lengths[2]
+    )
+{
+    #if _DEBUG
+    if (!Base<T, I>::size_is_set()) throw BUFFER_NOT_INITIALIZED;
+    #endif
+
+    this->catch_up();
+
+    const int_fast32_t unread(Base<T, I>::unread());
+    if ((length <= 0) || !unread) return 0;
+
+    regions[0] = get_read_sample();
+    lengths[0] = std::min(length, unread);
+    if (lengths[0] == length) return 1;
+
+    /* Samples in completed buffers after the current read buffer */
+    const int_fast32_t following(std::min(
+            Base<T, I>::buffered() - this->_bufferLength,
+            this->_bufferLength
+        ));
+    if ((length - lengths[0]) > following) return 0;
+
+    regions[1] = &(this->ring[(this->readIndex + 1) % this->_ringLength][0]);
+    lengths[1] = length - lengths[0];
+    return 2;
+}
+
+template <typename T, typename I, typename A>
+int_fast8_t RingBuffer<T, I, A>::get_read_byte_regions(
+        int_fast32_t numBytes,
+        uint8_t* regions[2],
+        int_fast32_t lengths[2]
+    )
+{
+    #if _DEBUG
+    if (numBytes % Base<T, I>::bytesPerSample)
+    {
+        throw NON_MULTIPLE_BYTE_COUNT;
+    }
+    #endif
+
+    T* sampleRegions[2];
+    const int_fast8_t numRegions(get_read_regions(
+            numBytes / Base<T, I>::bytesPerSample,
+            sampleRegions,
+            lengths
+        ));
+    for (int_fast8_t i(0); i < numRegions; ++i)
+    {
+        regions[i] = reinterpret_cast<uint8_t*>(sampleRegions[i]);
+        lengths[i] *= Base<T, I>::bytesPerSample;
+    }
+    return numRegions;
+}
+
+template <typename T, typename I, typename A>
+inline std::vector<T, A>* RingBuffer<T, I, A>::get_read_buffer()
+{
+    #if _DEBUG
     return &(this->ring.at(this->readIndex));
     #else
     return &(this->ring[this->readIndex]);
     #endif
 }
 
-template <typename T, typename I>
-inline T* RingBuffer<T, I>::get_read_buffer_sample()
+template <typename T, typename I, typename A>
+inline T* RingBuffer<T, I, A>::get_read_buffer_sample()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return &(this->ring.at(this->readIndex).at(0));
     #else
     return &(this->ring[this->readIndex][0]);
     #endif
 }
 
-template <typename T, typename I>
-inline uint8_t* RingBuffer<T, I>::get_read_buffer_byte()
+template <typename T, typename I, typename A>
+inline uint8_t* RingBuffer<T, I, A>::get_read_buffer_byte()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return reinterpret_cast<uint8_t*>(
             &(this->ring.at(this->readIndex).at(0))
         );
@@ -719,10 +1222,10 @@ inline uint8_t* RingBuffer<T, I>::get_read_buffer_byte()
     #endif
 }
 
-template <typename T, typename I>
-inline T* RingBuffer<T, I>::get_read_sample()
+template <typename T, typename I, typename A>
+inline T* RingBuffer<T, I, A>::get_read_sample()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return &(this->ring.at(this->readIndex).at(
             this->_bufferLength - this->_samplesUnread
         ));
@@ -733,39 +1236,28 @@ inline T* RingBuffer<T, I>::get_read_sample()
     #endif
 }
 
-template <typename T, typename I>
-inline uint8_t* RingBuffer<T, I>::get_read_byte()
+template <typename T, typename I, typename A>
+inline uint8_t* RingBuffer<T, I, A>::get_read_byte()
 {
     return reinterpret_cast<uint8_t*>(get_read_sample());
 }
 
-template <typename T, typename I>
-int_fast32_t RingBuffer<T, I>::write(T data, bool force)
+template <typename T, typename I, typename A>
+int_fast32_t RingBuffer<T, I, A>::write(T data, bool force)
 {
-    #ifdef _DEBUG
-    if (!Base<T, I>::size_is_set()) throw BUFFER_NOT_INITIALIZED;
-    #endif
-
-    if (!Base<T, I>::is_writable() && !force) return 0;
-
-    this->ring[this->writeIndex][this->_samplesWritten] = data;
-    ++this->_samplesWritten;
-
-    #ifdef _DEBUG
-    if (--this->_samplesUnwritten <= 0)
-    {
-        Base<T, I>::rotate_write_buffer(force);
-    }
-    #endif
+    return write(std::span<const T>(&data, 1), force);
+}
 
-    ++this->_buffered;
-    return 1;
+template <typename T, typename I, typename A>
+int_fast32_t RingBuffer<T, I, A>::write(const std::vector<T>& data, bool force)
+{
+    return write(std::span<const T>(data), force);
 }
 
-template <typename T, typename I>
-int_fast32_t RingBuffer<T, I>::write(std::vector<T> data, bool force)
+template <typename T, typename I, typename A>
+int_fast32_t RingBuffer<T, I, A>::write(std::span<const T> data, bool force)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (!Base<T, I>::size_is_set()) throw BUFFER_NOT_INITIALIZED;
     #endif
     
@@ -778,102 +1270,136 @@ int_fast32_t RingBuffer<T, I>::write(std::vector<T> data, bool force)
             && (index-- > 0)
         )
     {
-        if (remaining > this->_samplesUnwritten)
-        {
-            #ifdef _DEBUG
-            std::copy(
-                    data.begin() + written,
-                    data.begin() + written + this->_samplesUnwritten,
-                    this->ring.at(this->writeIndex).begin() + this->_samplesWritten
-                );
-            #else
-            std::copy(
-                    data.begin() + written,
-                    data.begin() + written + this->_samplesUnwritten,
-                    this->ring[this->writeIndex].begin() + this->_samplesWritten
-                );
-            #endif
-            written += this->_samplesUnwritten;
-            remaining -= this->_samplesUnwritten;
-            Base<T, I>::rotate_write_buffer(force);
-        }
-        else
-        {
-            #ifdef _DEBUG
-            std::copy(
-                    data.begin() + written,
-                    data.end(),
-                    this->ring.at(this->writeIndex).begin() + this->_samplesWritten
-                );
-            #else
-            std::copy(
-                    data.begin() + written,
-                    data.end(),
-                    this->ring[this->writeIndex].begin() + this->_samplesWritten
-                );
-            #endif
-            this->_samplesWritten += remaining;
-            this->_samplesUnwritten -= remaining;
-            written += remaining;
-            remaining = 0;
-            if (this->_samplesUnwritten <= 0)
-            {
-                Base<T, I>::rotate_write_buffer(force);
-            }
-        }
+        const int_fast32_t length(std::min(remaining, this->_samplesUnwritten));
+        std::copy_n(
+                data.data() + written,
+                length,
+                this->ring[this->writeIndex].begin() + this->_samplesWritten
+            );
+        written += length;
+        remaining -= length;
+        this->commit_written_samples(length);
     }
     return written;
 }
 
-template <typename T, typename I>
-int_fast32_t RingBuffer<T, I>::write_samples(T* data, int_fast32_t length, bool force)
+template <typename T, typename I, typename A>
+int_fast32_t RingBuffer<T, I, A>::write_samples(
+        const T* data,
+        int_fast32_t length,
+        bool force
+    )
 {
-    return write(std::vector<T>(data, data + length), force);
+    return write(std::span<const T>(data, length), force);
 }
 
-template <typename T, typename I>
-int_fast32_t RingBuffer<T, I>::write_bytes(
-        uint8_t* data,
+template <typename T, typename I, typename A>
+int_fast32_t RingBuffer<T, I, A>::write_bytes(
+        const uint8_t* data,
         int_fast32_t numBytes,
         bool force
     )
 {
-    return write(std::vector<T>(
-            reinterpret_cast<T*>(data),
-            reinterpret_cast<T*>(data + numBytes)
+    return write(std::span<const T>(
+            reinterpret_cast<const T*>(data),
+            numBytes / Base<T, I>::bytesPerSample
         ), force) * Base<T, I>::bytesPerSample;
 }
 
-template <typename T, typename I>
-inline std::vector<T>* RingBuffer<T, I>::get_write_buffer()
+template <typename T, typename I, typename A>
+int_fast8_t RingBuffer<T, I, A>::get_write_regions(
+        int_fast32_t length,
+        T* regions[2],
+        int_fast32_t lengths[2]
+    )
 {
-    #ifdef _DEBUG
+    #if _DEBUG
+    if (!Base<T, I>::size_is_set()) throw BUFFER_NOT_INITIALIZED;
+    #endif
+
+    if ((length <= 0) || !Base<T, I>::is_writable()) return 0;
+
+    regions[0] = get_write_sample();
+    lengths[0] = std::min(length, this->_samplesUnwritten);
+    if (lengths[0] == length) return 1;
+
+    /* The next buffer must not be the one being read */
+    const int_fast8_t nextIndex((this->writeIndex + 1) % this->_ringLength);
+    if ((length - lengths[0]) > this->_bufferLength) return 0;
+    else if (
+            (Base<T, I>::policy() != OVERWRITE_OLDEST)
+            && (
+                (nextIndex == this->readIndex)
+                || ((Base<T, I>::available() - lengths[0]) < (length - lengths[0]))
+            )
+        )
+    {
+        return 0;
+    }
+
+    regions[1] = &(this->ring[nextIndex][0]);
+    lengths[1] = length - lengths[0];
+    return 2;
+}
+
+template <typename T, typename I, typename A>
+int_fast8_t RingBuffer<T, I, A>::get_write_byte_regions(
+        int_fast32_t numBytes,
+        uint8_t* regions[2],
+        int_fast32_t lengths[2]
+    )
+{
+    #if _DEBUG
+    if (numBytes % Base<T, I>::bytesPerSample)
+    {
+        throw NON_MULTIPLE_BYTE_COUNT;
+    }
+    #endif
+
+    T* sampleRegions[2];
+    const int_fast8_t numRegions(get_write_regions(
+            numBytes / Base<T, I>::bytesPerSample,
+            sampleRegions,
+            lengths
+        ));
+    for (int_fast8_t i(0); i < numRegions; ++i)
+    {
+        regions[i] = reinterpret_cast<uint8_t*>(sampleRegions[i]);
+        lengths[i] *= Base<T, I>::bytesPerSample;
+    }
+    return numRegions;
+}
+
+template <typename T, typename I, typename A>
+inline std::vector<T, A>* RingBuffer<T, I, A>::get_write_buffer()
+{
+    #if _DEBUG
     return &(this->ring.at(this->writeIndex));
     #else
     return &(this->ring[this->writeIndex]);
     #endif
 }
 
-template <typename T, typename I>
-inline T* RingBuffer<T, I>::get_write_buffer_sample()
+template <typename T, typename I, typename A>
+inline T* RingBuffer<T, I, A>::get_write_buffer_sample()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return &(this->ring.at(this->writeIndex).at(0));
     #else
     return &(this->ring[this->writeIndex][0]);
     #endif
 }
 
-template <typename T, typename I>
-inline uint8_t* RingBuffer<T, I>::get_write_buffer_byte()
+template <typename T, typename I, typename A>
+inline uint8_t* RingBuffer<T, I, A>::get_write_buffer_byte()
 {
     return reinterpret_cast<uint8_t*>(get_write_buffer_sample());
 }
 
-template <typename T, typename I>
-T* RingBuffer<T, I>::get_write_sample()
+template <typename T, typename I, typename A>
+T* RingBuffer<T, I, A>::get_write_sample()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return &(this->ring.at(this->writeIndex).at(
             this->_bufferLength - this->_samplesUnwritten
         ));
@@ -884,36 +1410,36 @@ T* RingBuffer<T, I>::get_write_sample()
     #endif
 }
 
-template <typename T, typename I>
-uint8_t* RingBuffer<T, I>::get_write_byte()
+template <typename T, typename I, typename A>
+uint8_t* RingBuffer<T, I, A>::get_write_byte()
 {
     return reinterpret_cast<uint8_t*>(get_write_sample());
 }
 
-template <typename T, typename I>
-std::vector<T>* RingBuffer<T, I>::get_processing_buffer()
+template <typename T, typename I, typename A>
+std::vector<T, A>* RingBuffer<T, I, A>::get_processing_buffer()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return &(this->ring.at(this->processingIndex));
     #else
     return &(this->ring[this->processingIndex]);
     #endif
 }
 
-template <typename T, typename I>
-inline T* RingBuffer<T, I>::get_processing_buffer_sample()
+template <typename T, typename I, typename A>
+inline T* RingBuffer<T, I, A>::get_processing_buffer_sample()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return &(this->ring.at(this->processingIndex).at(0));
     #else
     return &(this->ring[this->processingIndex][0]);
     #endif
 }
 
-template <typename T, typename I>
-uint8_t* RingBuffer<T, I>::get_processing_buffer_byte()
+template <typename T, typename I, typename A>
+uint8_t* RingBuffer<T, I, A>::get_processing_buffer_byte()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return reinterpret_cast<uint8_t*>(
             &(this->ring.at(this->processingIndex).at(0))
         );
@@ -924,18 +1450,18 @@ uint8_t* RingBuffer<T, I>::get_processing_buffer_byte()
     #endif
 }
 
-template <typename T, typename I>
-T* RingBuffer<T, I>::get_processing_sample()
+template <typename T, typename I, typename A>
+T* RingBuffer<T, I, A>::get_processing_sample()
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     return &(this->ring.at(this->processingIndex).at(this->_samplesProcessed));
     #else
     return &(this->ring[this->processingIndex][this->_samplesProcessed]);
     #endif
 }
 
-template <typename T, typename I>
-uint8_t* RingBuffer<T, I>::get_processing_byte()
+template <typename T, typename I, typename A>
+uint8_t* RingBuffer<T, I, A>::get_processing_byte()
 {
     return reinterpret_cast<uint8_t*>(get_processing_sample());
 }
@@ -963,11 +1489,33 @@ RingBuffer<T, int_fast8_t>(obj)
 {
 }
 
+template <typename T>
+NonAtomicRingBuffer<T>::NonAtomicRingBuffer(
+        NonAtomicRingBuffer&& obj
+    ) noexcept :
+RingBuffer<T, int_fast8_t>(std::move(obj))
+{
+}
+
 template <typename T>
 NonAtomicRingBuffer<T>::~NonAtomicRingBuffer()
 {
 }
 
+template <typename T>
+NonAtomicRingBuffer<T>& NonAtomicRingBuffer<T>::operator=(const NonAtomicRingBuffer& obj)
+{
+    RingBuffer<T, int_fast8_t>::operator=(obj);
+    return *this;
+}
+
+template <typename T>
+NonAtomicRingBuffer<T>& NonAtomicRingBuffer<T>::operator=(NonAtomicRingBuffer&& obj) noexcept
+{
+    RingBuffer<T, int_fast8_t>::operator=(std::move(obj));
+    return *this;
+}
+
 template <typename T>
 AtomicRingBuffer<T>::AtomicRingBuffer() :
 RingBuffer<T, std::atomic_int_fast8_t>()
@@ -991,11 +1539,33 @@ RingBuffer<T, std::atomic_int_fast8_t>(obj)
 {
 }
 
+template <typename T>
+AtomicRingBuffer<T>::AtomicRingBuffer(
+        AtomicRingBuffer&& obj
+    ) noexcept :
+RingBuffer<T, std::atomic_int_fast8_t>(std::move(obj))
+{
+}
+
 template <typename T>
 AtomicRingBuffer<T>::~AtomicRingBuffer()
 {
 }
 
+template <typename T>
+AtomicRingBuffer<T>& AtomicRingBuffer<T>::operator=(const AtomicRingBuffer& obj)
+{
+    RingBuffer<T, std::atomic_int_fast8_t>::operator=(obj);
+    return *this;
+}
+
+template <typename T>
+AtomicRingBuffer<T>& AtomicRingBuffer<T>::operator=(AtomicRingBuffer&& obj) noexcept
+{
+    RingBuffer<T, std::atomic_int_fast8_t>::operator=(std::move(obj));
+    return *this;
+}
+
 template <typename T>
 AtomicMultiReadRingBuffer<T>::AtomicMultiReadRingBuffer() :
 AtomicRingBuffer<T>()
@@ -1023,6 +1593,18 @@ AtomicRingBuffer<T>(obj)
     this->_readCounter = counter;
 }
 
+template <typename T>
+AtomicMultiReadRingBuffer<T>::AtomicMultiReadRingBuffer(
+        AtomicMultiReadRingBuffer&& obj
+    ) noexcept :
+AtomicRingBuffer<T>(std::move(obj))
+{
+    int_fast8_t readers = obj._numReaders;
+    this->_numReaders = readers;
+    int_fast8_t counter = obj._readCounter;
+    this->_readCounter = counter;
+}
+
 template <typename T>
 AtomicMultiReadRingBuffer<T>::~AtomicMultiReadRingBuffer()
 {
@@ -1031,16 +1613,14 @@ AtomicMultiReadRingBuffer<T>::~AtomicMultiReadRingBuffer()
 template <typename T>
 inline bool AtomicMultiReadRingBuffer<T>::_increment_read_counter()
 {
-    std::cout << "incrementing multiread counter from " << +this->_readCounter;
     this->_readCounter = ++this->_readCounter % this->_numReaders;
-    std:: cout << " to " << +this->_readCounter << " of " << +this->_numReaders << '\n';
     return !this->_readCounter;
 }
 
 template <typename T>
 inline void AtomicMultiReadRingBuffer<T>::set_num_readers(int_fast8_t numReaders)
 {
-    #ifdef _DEBUG
+    #if _DEBUG
     if (
             (numReaders <= 0)
             || (numReaders > std::numeric_limits<int_fast8_t>::max())
@@ -1071,6 +1651,7 @@ inline void AtomicMultiReadRingBuffer<T>::report_read_samples(int_fast32_t lengt
 template <typename T>
 std::vector<T> AtomicMultiReadRingBuffer<T>::read()
 {
+    this->catch_up();
     std::vector<T> output(AtomicRingBuffer<T>::_read());
     report_read_samples(this->_bufferLength);
     return output;
@@ -1089,6 +1670,8 @@ template class Buffer::Base<int32_t, int_fast8_t>;
 // template class Buffer::Base<int64_t, int_fast8_t>;
 // template class Buffer::Base<uint64_t, int_fast8_t>;
 
+template class Buffer::Base<Int24, int_fast8_t>;
+
 // #if (int32_t != int)
 // template class Buffer::Base<int, int_fast8_t>;
 // #endif
@@ -1128,6 +1711,8 @@ template class Buffer::Base<int32_t, std::atomic_int_fast8_t>;
 // template class Buffer::Base<int64_t, std::atomic_int_fast8_t>;
 // template class Buffer::Base<uint64_t, std::atomic_int_fast8_t>;
 
+template class Buffer::Base<Int24, std::atomic_int_fast8_t>;
+
 // #if (int32_t != int)
 // template class Buffer::Base<int, std::atomic_int_fast8_t>;
 // #endif
@@ -1167,6 +1752,8 @@ template class Buffer::RingBuffer<int32_t, int_fast8_t>;
 // template class Buffer::RingBuffer<int64_t, int_fast8_t>;
 // template class Buffer::RingBuffer<uint64_t, int_fast8_t>;
 
+template class Buffer::RingBuffer<Int24, int_fast8_t>;
+
 // #if (int32_t != int)
 // template class Buffer::RingBuffer<int, int_fast8_t>;
 // #endif
@@ -1206,6 +1793,8 @@ template class Buffer::RingBuffer<int32_t, std::atomic_int_fast8_t>;
 // template class Buffer::RingBuffer<int64_t, std::atomic_int_fast8_t>;
 // template class Buffer::RingBuffer<uint64_t, std::atomic_int_fast8_t>;
 
+template class Buffer::RingBuffer<Int24, std::atomic_int_fast8_t>;
+
 // #if (int32_t != int)
 // template class Buffer::RingBuffer<int, std::atomic_int_fast8_t>;
 // #endif
@@ -1234,6 +1823,88 @@ template class Buffer::RingBuffer<double, std::atomic_int_fast8_t>;
 // template class Buffer::RingBuffer<char16_t, std::atomic_int_fast8_t>;
 // template class Buffer::RingBuffer<char32_t, std::atomic_int_fast8_t>;
 
+/*                   Arena Allocated Ring Buffer                    */
+
+// template class Buffer::RingBuffer<int8_t, int_fast8_t, ArenaAllocator<int8_t>>;
+template class Buffer::RingBuffer<uint8_t, int_fast8_t, ArenaAllocator<uint8_t>>;
+template class Buffer::RingBuffer<int16_t, int_fast8_t, ArenaAllocator<int16_t>>;
+// template class Buffer::RingBuffer<uint16_t, int_fast8_t, ArenaAllocator<uint16_t>>;
+template class Buffer::RingBuffer<int32_t, int_fast8_t, ArenaAllocator<int32_t>>;
+// template class Buffer::RingBuffer<uint32_t, int_fast8_t, ArenaAllocator<uint32_t>>;
+// template class Buffer::RingBuffer<int64_t, int_fast8_t, ArenaAllocator<int64_t>>;
+// template class Buffer::RingBuffer<uint64_t, int_fast8_t, ArenaAllocator<uint64_t>>;
+
+template class Buffer::RingBuffer<Int24, int_fast8_t, ArenaAllocator<Int24>>;
+
+// #if (int32_t != int)
+// template class Buffer::RingBuffer<int, int_fast8_t, ArenaAllocator<int>>;
+// #endif
+
+#if (int32_t != int_fast32_t)
+template class Buffer::RingBuffer<int_fast8_t, int_fast8_t, ArenaAllocator<int_fast8_t>>;
+template class Buffer::RingBuffer<uint_fast8_t, int_fast8_t, ArenaAllocator<uint_fast8_t>>;
+template class Buffer::RingBuffer<int_fast16_t, int_fast8_t, ArenaAllocator<int_fast16_t>>;
+template class Buffer::RingBuffer<uint_fast16_t, int_fast8_t, ArenaAllocator<uint_fast16_t>>;
+template class Buffer::RingBuffer<int_fast32_t, int_fast8_t, ArenaAllocator<int_fast32_t>>;
+template class Buffer::RingBuffer<uint_fast32_t, int_fast8_t, ArenaAllocator<uint_fast32_t>>;
+template class Buffer::RingBuffer<int_fast64_t, int_fast8_t, ArenaAllocator<int_fast64_t>>;
+template class Buffer::RingBuffer<uint_fast64_t, int_fast8_t, ArenaAllocator<uint_fast64_t>>;
+#endif
+
+template class Buffer::RingBuffer<float, int_fast8_t, ArenaAllocator<float>>;
+template class Buffer::RingBuffer<double, int_fast8_t, ArenaAllocator<double>>;
+// template class Buffer::RingBuffer<long double, int_fast8_t, ArenaAllocator<long double>>;
+
+// #if (int8_t != char)
+// template class Buffer::RingBuffer<char, int_fast8_t, ArenaAllocator<char>>;
+// template class Buffer::RingBuffer<unsigned char, int_fast8_t, ArenaAllocator<unsigned char>>;
+// #endif
+
+// template class Buffer::RingBuffer<wchar_t, int_fast8_t, ArenaAllocator<wchar_t>>;
+// template class Buffer::RingBuffer<char16_t, int_fast8_t, ArenaAllocator<char16_t>>;
+// template class Buffer::RingBuffer<char32_t, int_fast8_t, ArenaAllocator<char32_t>>;
+
+/*            Arena Allocated Atomic Indices Ring Buffer            */
+
+// template class Buffer::RingBuffer<int8_t, std::atomic_int_fast8_t, ArenaAllocator<int8_t>>;
+template class Buffer::RingBuffer<uint8_t, std::atomic_int_fast8_t, ArenaAllocator<uint8_t>>;
+template class Buffer::RingBuffer<int16_t, std::atomic_int_fast8_t, ArenaAllocator<int16_t>>;
+// template class Buffer::RingBuffer<uint16_t, std::atomic_int_fast8_t, ArenaAllocator<uint16_t>>;
+template class Buffer::RingBuffer<int32_t, std::atomic_int_fast8_t, ArenaAllocator<int32_t>>;
+// template class Buffer::RingBuffer<uint32_t, std::atomic_int_fast8_t, ArenaAllocator<uint32_t>>;
+// template class Buffer::RingBuffer<int64_t, std::atomic_int_fast8_t, ArenaAllocator<int64_t>>;
+// template class Buffer::RingBuffer<uint64_t, std::atomic_int_fast8_t, ArenaAllocator<uint64_t>>;
+
+template class Buffer::RingBuffer<Int24, std::atomic_int_fast8_t, ArenaAllocator<Int24>>;
+
+// #if (int32_t != int)
+// template class Buffer::RingBuffer<int, std::atomic_int_fast8_t, ArenaAllocator<int>>;
+// #endif
+
+#if (int32_t != int_fast32_t)
+template class Buffer::RingBuffer<int_fast8_t, std::atomic_int_fast8_t, ArenaAllocator<int_fast8_t>>;
+template class Buffer::RingBuffer<uint_fast8_t, std::atomic_int_fast8_t, ArenaAllocator<uint_fast8_t>>;
+template class Buffer::RingBuffer<int_fast16_t, std::atomic_int_fast8_t, ArenaAllocator<int_fast16_t>>;
+template class Buffer::RingBuffer<uint_fast16_t, std::atomic_int_fast8_t, ArenaAllocator<uint_fast16_t>>;
+template class Buffer::RingBuffer<int_fast32_t, std::atomic_int_fast8_t, ArenaAllocator<int_fast32_t>>;
+template class Buffer::RingBuffer<uint_fast32_t, std::atomic_int_fast8_t, ArenaAllocator<uint_fast32_t>>;
+template class Buffer::RingBuffer<int_fast64_t, std::atomic_int_fast8_t, ArenaAllocator<int_fast64_t>>;
+template class Buffer::RingBuffer<uint_fast64_t, std::atomic_int_fast8_t, ArenaAllocator<uint_fast64_t>>;
+#endif
+
+template class Buffer::RingBuffer<float, std::atomic_int_fast8_t, ArenaAllocator<float>>;
+template class Buffer::RingBuffer<double, std::atomic_int_fast8_t, ArenaAllocator<double>>;
+// template class Buffer::RingBuffer<long double, std::atomic_int_fast8_t, ArenaAllocator<long double>>;
+
+// #if (int8_t != char)
+// template class Buffer::RingBuffer<char, std::atomic_int_fast8_t, ArenaAllocator<char>>;
+// template class Buffer::RingBuffer<unsigned char, std::atomic_int_fast8_t, ArenaAllocator<unsigned char>>;
+// #endif
+
+// template class Buffer::RingBuffer<wchar_t, std::atomic_int_fast8_t, ArenaAllocator<wchar_t>>;
+// template class Buffer::RingBuffer<char16_t, std::atomic_int_fast8_t, ArenaAllocator<char16_t>>;
+// template class Buffer::RingBuffer<char32_t, std::atomic_int_fast8_t, ArenaAllocator<char32_t>>;
+
 /*                           Ring Buffer                            */
 
 // template class Buffer::NonAtomicRingBuffer<int8_t>;
@@ -1245,6 +1916,8 @@ template class Buffer::NonAtomicRingBuffer<int32_t>;
 // template class Buffer::NonAtomicRingBuffer<int64_t>;
 // template class Buffer::NonAtomicRingBuffer<uint64_t>;
 
+template class Buffer::NonAtomicRingBuffer<Int24>;
+
 // #if (int32_t != int)
 // template class Buffer::NonAtomicRingBuffer<int>;
 // #endif
@@ -1284,6 +1957,8 @@ template class Buffer::AtomicRingBuffer<int32_t>;
 // template class Buffer::AtomicRingBuffer<int64_t>;
 // template class Buffer::AtomicRingBuffer<uint64_t>;
 
+template class Buffer::AtomicRingBuffer<Int24>;
+
 // #if (int32_t != int)
 // template class Buffer::AtomicRingBuffer<int>;
 // #endif
@@ -1323,6 +1998,8 @@ template class Buffer::AtomicMultiReadRingBuffer<int32_t>;
 // template class Buffer::AtomicMultiReadRingBuffer<int64_t>;
 // template class Buffer::AtomicMultiReadRingBuffer<uint64_t>;
 
+template class Buffer::AtomicMultiReadRingBuffer<Int24>;
+
 // #if (int32_t != int)
 // template class Buffer::AtomicMultiReadRingBuffer<int>;
 // #endif
@@ -0,0 +1,155 @@
+#include "ringnotifier.h"
+
+using namespace Buffer;
+
+Notifier::Notifier()
+{
+    #ifdef ESP_PLATFORM
+    portMUX_INITIALIZE(&this->_lock);
+    for (int_fast8_t i(0); i < RINGBUFF_MAX_WAITERS; ++i)
+    {
+        this->_waiters[i] = nullptr;
+    }
+    #endif
+}
+
+Notifier::Notifier(const Notifier& obj) :
+Notifier()
+{
+}
+
+Notifier::~Notifier()
+{
+}
+
+#ifdef ESP_PLATFORM
+
+bool Notifier::_wait(
+        bool (*ready)(const void*),
+        const void* context,
+        int_fast32_t timeoutMs
+    )
+{
+    TaskHandle_t task(xTaskGetCurrentTaskHandle());
+    int_fast8_t slot(-1);
+
+    portENTER_CRITICAL(&this->_lock);
+    for (int_fast8_t i(0); i < RINGBUFF_MAX_WAITERS; ++i)
+    {
+        if (this->_waiters[i] == nullptr)
+        {
+            this->_waiters[i] = task;
+            slot = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&this->_lock);
+
+    /* Discard notifications left over from an earlier wait */
+    ulTaskNotifyTakeIndexed((RINGBUFF_NOTIFY_INDEX), pdTRUE, 0);
+
+    /* Pairs with the fence in notify() so that either
+    the waiter sees the update or the notifier sees the waiter */
+    this->_numWaiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const TickType_t start(xTaskGetTickCount());
+    const TickType_t timeout(
+            (timeoutMs < 0) ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs)
+        );
+    bool result(ready(context));
+    while (!result)
+    {
+        const TickType_t elapsed(xTaskGetTickCount() - start);
+        if ((timeout != portMAX_DELAY) && (elapsed >= timeout)) break;
+
+        const TickType_t remaining(
+                (timeout == portMAX_DELAY) ? portMAX_DELAY : (timeout - elapsed)
+            );
+        if (slot < 0) vTaskDelay(1);
+        else ulTaskNotifyTakeIndexed((RINGBUFF_NOTIFY_INDEX), pdTRUE, remaining);
+        result = ready(context);
+    }
+
+    this->_numWaiters.fetch_sub(1);
+    if (slot >= 0)
+    {
+        portENTER_CRITICAL(&this->_lock);
+        this->_waiters[slot] = nullptr;
+        portEXIT_CRITICAL(&this->_lock);
+    }
+    return result;
+}
+
+void Notifier::notify()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!this->_numWaiters.load(std::memory_order_relaxed)) return;
+
+    portENTER_CRITICAL(&this->_lock);
+    for (int_fast8_t i(0); i < RINGBUFF_MAX_WAITERS; ++i)
+    {
+        if (this->_waiters[i] != nullptr)
+        {
+            xTaskNotifyGiveIndexed(this->_waiters[i], (RINGBUFF_NOTIFY_INDEX));
+        }
+    }
+    portEXIT_CRITICAL(&this->_lock);
+}
+
+#else
+
+bool Notifier::_wait(
+        bool (*ready)(const void*),
+        const void* context,
+        int_fast32_t timeoutMs
+    )
+{
+    const auto deadline(
+            std::chrono::steady_clock::now()
+            + std::chrono::milliseconds(timeoutMs)
+        );
+
+    std::unique_lock<std::mutex> lock(this->_mutex);
+
+    /* Pairs with the fence in notify() so that either
+    the waiter sees the update or the notifier sees the waiter */
+    this->_numWaiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool result(ready(context));
+    while (!result)
+    {
+        if (timeoutMs < 0)
+        {
+            this->_condition.wait(lock);
+        }
+        else if (
+                this->_condition.wait_until(lock, deadline)
+                == std::cv_status::timeout
+            )
+        {
+            result = ready(context);
+            break;
+        }
+        result = ready(context);
+    }
+
+    this->_numWaiters.fetch_sub(1);
+    return result;
+}
+
+void Notifier::notify()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!this->_numWaiters.load(std::memory_order_relaxed)) return;
+
+    /* Waiters hold the mutex from their last check until they
+    sleep, so taking it here cannot slip between the two */
+    {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+    }
+    this->_condition.notify_all();
+}
+
+#endif
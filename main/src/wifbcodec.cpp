@@ -0,0 +1,835 @@
+#include "wifbcodec.h"
+
+#include <algorithm>
+#include <type_traits>
+
+/* Channel header flag of a verbatim channel */
+#define LOSSLESS_VERBATIM                   (0x80)
+
+/* Most bits a Rice code may hold beyond the sample width;
+residuals of the order 4 predictor are at most 16 times
+the largest sample */
+#define LOSSLESS_RESIDUAL_HEADROOM          (5)
+
+/* Entries in the ADPCM step table */
+#define ADPCM_NUM_STEPS                     (89)
+
+/* Bytes of each channel's ADPCM header */
+#define ADPCM_CHANNEL_HEADER_SIZE           (4)
+
+/*                             Bit I/O                              */
+
+/* Writes bits msb first into a buffer known to be large enough */
+class BitWriter
+{
+
+protected:
+
+    uint8_t* _data;
+    uint64_t _cache;
+    int_fast8_t _count;
+
+public:
+
+    BitWriter(uint8_t* data) :
+    _data(data),
+    _cache(0),
+    _count(0)
+    {
+    }
+
+    /* Appends the low bits of value; at most 56 at a time */
+    inline void put(uint64_t value, int_fast8_t bits)
+    {
+        if (!bits) return;
+        this->_cache = (this->_cache << bits) | (value & ((~0ULL) >> (64 - bits)));
+        this->_count += bits;
+        while (this->_count >= 8)
+        {
+            this->_count -= 8;
+            *(this->_data++) = static_cast<uint8_t>(this->_cache >> this->_count);
+        }
+    }
+
+    /* Pads the last byte with zeros and returns the end of the data */
+    inline uint8_t* flush()
+    {
+        if (this->_count) put(0, 8 - this->_count);
+        return this->_data;
+    }
+
+};
+
+/* Reads bits msb first, failing rather than running past the end */
+class BitReader
+{
+
+protected:
+
+    const uint8_t* _data;
+    int_fast32_t _length, _position;
+    uint64_t _cache;
+    int_fast8_t _count;
+
+    inline void _refill()
+    {
+        while ((this->_count <= 56) && (this->_position < this->_length))
+        {
+            this->_cache |= (
+                    static_cast<uint64_t>(this->_data[this->_position++])
+                    << (56 - this->_count)
+                );
+            this->_count += 8;
+        }
+    }
+
+public:
+
+    BitReader(const uint8_t* data, int_fast32_t length) :
+    _data(data),
+    _length(length),
+    _position(0),
+    _cache(0),
+    _count(0)
+    {
+    }
+
+    /* Reads up to 56 bits */
+    inline bool get(int_fast8_t bits, uint64_t* value)
+    {
+        if (!bits)
+        {
+            *value = 0;
+            return true;
+        }
+        _refill();
+        if (this->_count < bits) return false;
+        *value = this->_cache >> (64 - bits);
+        this->_cache <<= bits;
+        this->_count -= bits;
+        return true;
+    }
+
+    /* Reads a run of zeros ended by a one and returns its length */
+    inline bool unary(uint64_t* value)
+    {
+        *value = 0;
+        while (true)
+        {
+            _refill();
+            if (!this->_count) return false;
+            const int_fast8_t zeros(
+                    this->_cache ? __builtin_clzll(this->_cache) : 64
+                );
+            if (zeros >= this->_count)
+            {
+                *value += this->_count;
+                this->_cache = 0;
+                this->_count = 0;
+                continue;
+            }
+            *value += zeros;
+            this->_cache = (this->_cache << zeros) << 1;
+            this->_count -= zeros + 1;
+            return true;
+        }
+    }
+
+    /* Whole bytes consumed, counting padding of the last one */
+    inline int_fast32_t consumed() const
+    {
+        return this->_position - (this->_count / 8);
+    }
+
+};
+
+/*                           Sample access                          */
+
+static inline int32_t get_sample(const uint8_t* data, int_fast8_t width)
+{
+    switch (width)
+    {
+        case 1:
+            return static_cast<int32_t>(data[0]) - 128;
+        case 2:
+            return static_cast<int16_t>(data[0] | (data[1] << 8));
+        case 3:
+            return static_cast<int32_t>(
+                    (static_cast<uint32_t>(data[0]) << 8)
+                    | (static_cast<uint32_t>(data[1]) << 16)
+                    | (static_cast<uint32_t>(data[2]) << 24)
+                ) >> 8;
+        default:
+            return static_cast<int32_t>(
+                    static_cast<uint32_t>(data[0])
+                    | (static_cast<uint32_t>(data[1]) << 8)
+                    | (static_cast<uint32_t>(data[2]) << 16)
+                    | (static_cast<uint32_t>(data[3]) << 24)
+                );
+    }
+}
+
+static inline void put_sample(uint8_t* data, int32_t value, int_fast8_t width)
+{
+    const uint32_t raw(static_cast<uint32_t>(value) + ((width == 1) ? 128 : 0));
+    for (int_fast8_t i(0); i < width; ++i) data[i] = static_cast<uint8_t>(raw >> (8 * i));
+}
+
+/* Wraps a reconstructed value to the sample width, so corrupt
+payloads cannot push later predictions out of range */
+static inline int32_t wrap_sample(int64_t value, int_fast8_t width)
+{
+    const int_fast8_t shift(32 - (8 * width));
+    return static_cast<int32_t>(static_cast<uint32_t>(value) << shift) >> shift;
+}
+
+/*                         Fixed prediction                         */
+
+/* Residual of the order Order polynomial at x */
+template <typename R, int_fast8_t Order>
+static inline R residual(const int32_t* x)
+{
+    if constexpr (Order == 0) return R(x[0]);
+    else if constexpr (Order == 1) return R(x[0]) - R(x[-1]);
+    else if constexpr (Order == 2) return R(x[0]) - (2 * R(x[-1])) + R(x[-2]);
+    else if constexpr (Order == 3)
+    {
+        return R(x[0]) - (3 * R(x[-1])) + (3 * R(x[-2])) - R(x[-3]);
+    }
+    else
+    {
+        return R(x[0]) - (4 * R(x[-1])) + (6 * R(x[-2])) - (4 * R(x[-3])) + R(x[-4]);
+    }
+}
+
+/* Prediction of x[0] from the samples before it */
+template <typename R>
+static inline R prediction(const int32_t* x, int_fast8_t order)
+{
+    switch (order)
+    {
+        case 0:
+            return 0;
+        case 1:
+            return R(x[-1]);
+        case 2:
+            return (2 * R(x[-1])) - R(x[-2]);
+        case 3:
+            return (3 * R(x[-1])) - (3 * R(x[-2])) + R(x[-3]);
+        default:
+            return (4 * R(x[-1])) - (6 * R(x[-2])) + (4 * R(x[-3])) - R(x[-4]);
+    }
+}
+
+template <typename R>
+static inline typename std::make_unsigned<R>::type zigzag(R value)
+{
+    typedef typename std::make_unsigned<R>::type U;
+    return (static_cast<U>(value) << 1) ^ static_cast<U>(value >> ((sizeof(R) * 8) - 1));
+}
+
+/* Exact sizes in bits of the residuals Rice coded
+with parameters k - 1, k and k + 1 */
+template <typename R, int_fast8_t Order>
+static void rice_sizes(
+        const int32_t* x,
+        int_fast32_t numFrames,
+        int_fast8_t k,
+        uint64_t sizes[3]
+    )
+{
+    uint64_t quotients[3] = {0, 0, 0};
+    const int_fast8_t lower((k > 0) ? (k - 1) : 0);
+    for (int_fast32_t i(Order); i < numFrames; ++i)
+    {
+        const uint64_t u(zigzag<R>(residual<R, Order>(x + i)));
+        quotients[0] += u >> lower;
+        quotients[1] += u >> k;
+        quotients[2] += u >> (k + 1);
+    }
+    const uint64_t count(numFrames - Order);
+    sizes[0] = quotients[0] + (count * (lower + 1));
+    sizes[1] = quotients[1] + (count * (k + 1));
+    sizes[2] = quotients[2] + (count * (k + 2));
+}
+
+template <typename R, int_fast8_t Order>
+static void rice_write(
+        BitWriter* writer,
+        const int32_t* x,
+        int_fast32_t numFrames,
+        int_fast8_t k
+    )
+{
+    for (int_fast32_t i(Order); i < numFrames; ++i)
+    {
+        const uint64_t u(zigzag<R>(residual<R, Order>(x + i)));
+        uint64_t quotient(u >> k);
+        const uint64_t remainder(u & ((1ULL << k) - 1));
+
+        /* A run of zeros, the terminating one, then the low bits */
+        if ((quotient + 1 + k) <= 56)
+        {
+            writer->put((1ULL << k) | remainder, quotient + 1 + k);
+            continue;
+        }
+        for (; quotient >= 56; quotient -= 56) writer->put(0, 56);
+        writer->put(1, quotient + 1);
+        writer->put(remainder, k);
+    }
+}
+
+template <typename R>
+static void rice_sizes(
+        const int32_t* x,
+        int_fast32_t numFrames,
+        int_fast8_t order,
+        int_fast8_t k,
+        uint64_t sizes[3]
+    )
+{
+    switch (order)
+    {
+        case 0: rice_sizes<R, 0>(x, numFrames, k, sizes); break;
+        case 1: rice_sizes<R, 1>(x, numFrames, k, sizes); break;
+        case 2: rice_sizes<R, 2>(x, numFrames, k, sizes); break;
+        case 3: rice_sizes<R, 3>(x, numFrames, k, sizes); break;
+        default: rice_sizes<R, 4>(x, numFrames, k, sizes);
+    }
+}
+
+template <typename R>
+static void rice_write(
+        BitWriter* writer,
+        const int32_t* x,
+        int_fast32_t numFrames,
+        int_fast8_t order,
+        int_fast8_t k
+    )
+{
+    switch (order)
+    {
+        case 0: rice_write<R, 0>(writer, x, numFrames, k); break;
+        case 1: rice_write<R, 1>(writer, x, numFrames, k); break;
+        case 2: rice_write<R, 2>(writer, x, numFrames, k); break;
+        case 3: rice_write<R, 3>(writer, x, numFrames, k); break;
+        default: rice_write<R, 4>(writer, x, numFrames, k);
+    }
+}
+
+/*                               Base                               */
+
+WIFBCodec::WIFBCodec(uint8_t bitsPerSample, uint8_t channels) :
+_bitsPerSample(bitsPerSample),
+_channels(channels)
+{
+    #if _DEBUG
+    if (
+            ((bitsPerSample != 8) && (bitsPerSample != 16)
+                && (bitsPerSample != 24) && (bitsPerSample != 32))
+            || !channels
+        ) throw CODEC_UNSUPPORTED_FORMAT;
+    #endif
+}
+
+WIFBCodec::~WIFBCodec()
+{
+}
+
+/*                             Lossless                             */
+
+WIFBLosslessCodec::WIFBLosslessCodec(uint8_t bitsPerSample, uint8_t channels) :
+WIFBCodec(bitsPerSample, channels)
+{
+}
+
+WIFBLosslessCodec::~WIFBLosslessCodec()
+{
+}
+
+uint8_t WIFBLosslessCodec::encoding() const
+{
+    return WIFB_ENCODING_LOSSLESS;
+}
+
+int_fast32_t WIFBLosslessCodec::max_encoded_size(int_fast32_t numBytes) const
+{
+    return numBytes + 2 + this->_channels;
+}
+
+template <typename R>
+int_fast32_t WIFBLosslessCodec::_encode_channel(
+        uint8_t* encoded,
+        const int32_t* samples,
+        int_fast32_t numFrames
+    )
+{
+    const int_fast8_t width(this->_bitsPerSample / 8);
+
+    /* Pick the order with the smallest total residual.  Every
+    order is measured over the same samples, past the warmup of
+    the highest, so chunks of a few frames are coded as order 0 */
+    uint64_t totals[WIFB_LOSSLESS_MAX_ORDER + 1] = {0, 0, 0, 0, 0};
+    for (int_fast32_t i(WIFB_LOSSLESS_MAX_ORDER); i < numFrames; ++i)
+    {
+        const R
+            e0(residual<R, 0>(samples + i)),
+            e1(residual<R, 1>(samples + i)),
+            e2(residual<R, 2>(samples + i)),
+            e3(residual<R, 3>(samples + i)),
+            e4(residual<R, 4>(samples + i));
+        totals[0] += (e0 < 0) ? -e0 : e0;
+        totals[1] += (e1 < 0) ? -e1 : e1;
+        totals[2] += (e2 < 0) ? -e2 : e2;
+        totals[3] += (e3 < 0) ? -e3 : e3;
+        totals[4] += (e4 < 0) ? -e4 : e4;
+    }
+    int_fast8_t order(0);
+    for (int_fast8_t o(1); o <= WIFB_LOSSLESS_MAX_ORDER; ++o)
+    {
+        if (totals[o] < totals[order]) order = o;
+    }
+
+    /* Zigzag values average about twice the absolute residual;
+    the best parameter is near log2 of their mean */
+    const int_fast8_t limit((8 * width) + LOSSLESS_RESIDUAL_HEADROOM);
+    const uint64_t count(std::max<int_fast32_t>(numFrames - WIFB_LOSSLESS_MAX_ORDER, 1));
+    const uint64_t mean((2 * totals[order]) / count);
+    int_fast8_t k(0);
+    while ((k < limit) && ((mean >> (k + 1)) != 0)) ++k;
+
+    uint64_t sizes[3];
+    rice_sizes<R>(samples, numFrames, order, k, sizes);
+    if (k >= limit) sizes[2] = ~0ULL;
+    int_fast8_t best(1);
+    if (sizes[0] < sizes[best]) best = 0;
+    if (sizes[2] < sizes[best]) best = 2;
+    k = std::max<int_fast8_t>(k + best - 1, 0);
+
+    /* Sizes are compared in bits first, as a pathological
+    chunk's code may not fit the size type in bytes */
+    const int_fast32_t verbatimSize(1 + (numFrames * width));
+    uint8_t* position(encoded);
+    if (
+            (sizes[best] >= (8ULL * verbatimSize))
+            || ((1 + (order * width) + 1 + static_cast<int_fast32_t>((sizes[best] + 7) / 8))
+                >= verbatimSize)
+        )
+    {
+        *(position++) = LOSSLESS_VERBATIM;
+        for (int_fast32_t i(0); i < numFrames; ++i, position += width)
+        {
+            put_sample(position, samples[i], width);
+        }
+        return position - encoded;
+    }
+
+    *(position++) = static_cast<uint8_t>(order);
+    for (int_fast8_t i(0); i < order; ++i, position += width)
+    {
+        put_sample(position, samples[i], width);
+    }
+    *(position++) = static_cast<uint8_t>(k);
+    BitWriter writer(position);
+    rice_write<R>(&writer, samples, numFrames, order, k);
+    return writer.flush() - encoded;
+}
+
+int_fast32_t WIFBLosslessCodec::encode(
+        uint8_t* encoded,
+        uint8_t* const regions[],
+        const int_fast32_t lengths[],
+        int_fast8_t numRegions
+    )
+{
+    const int_fast8_t width(this->_bitsPerSample / 8);
+    int_fast32_t numBytes(0);
+    for (int_fast8_t r(0); r < numRegions; ++r) numBytes += lengths[r];
+    const int_fast32_t numFrames(numBytes / (width * this->_channels));
+
+    /* Split the chunk into one run of samples per channel */
+    this->_samples.resize(numFrames * this->_channels);
+    int32_t* samples(this->_samples.data());
+    int_fast32_t frame(0);
+    uint8_t channel(0);
+    for (int_fast8_t r(0); r < numRegions; ++r)
+    {
+        for (int_fast32_t i(0); (i + width) <= lengths[r]; i += width)
+        {
+            if (frame >= numFrames) break;
+            samples[(channel * numFrames) + frame] = get_sample(regions[r] + i, width);
+            if (++channel == this->_channels)
+            {
+                channel = 0;
+                ++frame;
+            }
+        }
+    }
+
+    encoded[0] = static_cast<uint8_t>(numFrames);
+    encoded[1] = static_cast<uint8_t>(numFrames >> 8);
+    uint8_t* position(encoded + 2);
+    for (uint8_t c(0); c < this->_channels; ++c)
+    {
+        position += (
+                (width < 4)
+                ? _encode_channel<int32_t>(position, samples + (c * numFrames), numFrames)
+                : _encode_channel<int64_t>(position, samples + (c * numFrames), numFrames)
+            );
+    }
+    return position - encoded;
+}
+
+template <typename R>
+int_fast32_t WIFBLosslessCodec::_decode_channel(
+        int32_t* samples,
+        int_fast32_t numFrames,
+        const uint8_t* encoded,
+        int_fast32_t length
+    )
+{
+    const int_fast8_t width(this->_bitsPerSample / 8);
+    if (length < 1) return CODEC_MALFORMED_PAYLOAD;
+
+    if (encoded[0] == LOSSLESS_VERBATIM)
+    {
+        if ((1 + (numFrames * width)) > length) return CODEC_MALFORMED_PAYLOAD;
+        for (int_fast32_t i(0); i < numFrames; ++i)
+        {
+            samples[i] = get_sample(encoded + 1 + (i * width), width);
+        }
+        return 1 + (numFrames * width);
+    }
+
+    const uint8_t order(encoded[0]);
+    if (
+            (order > WIFB_LOSSLESS_MAX_ORDER)
+            || (order > numFrames)
+            || ((1 + (order * width) + 1) > length)
+        ) return CODEC_MALFORMED_PAYLOAD;
+
+    const uint8_t* position(encoded + 1);
+    for (int_fast8_t i(0); i < order; ++i, position += width)
+    {
+        samples[i] = get_sample(position, width);
+    }
+
+    const uint8_t k(*(position++));
+    const int_fast8_t limit((8 * width) + LOSSLESS_RESIDUAL_HEADROOM);
+    if (k > limit) return CODEC_MALFORMED_PAYLOAD;
+
+    typedef typename std::make_unsigned<R>::type U;
+    BitReader reader(position, length - (position - encoded));
+    for (int_fast32_t i(order); i < numFrames; ++i)
+    {
+        uint64_t quotient, remainder;
+        if (!reader.unary(&quotient) || !reader.get(k, &remainder))
+        {
+            return CODEC_MALFORMED_PAYLOAD;
+        }
+        const uint64_t u((quotient << k) | remainder);
+        if ((quotient >> (limit - k)) || (u >> limit)) return CODEC_MALFORMED_PAYLOAD;
+
+        const R value(static_cast<R>((static_cast<U>(u) >> 1) ^ -static_cast<U>(u & 1)));
+        samples[i] = wrap_sample(value + prediction<R>(samples + i, order), width);
+    }
+    return (position - encoded) + reader.consumed();
+}
+
+int_fast32_t WIFBLosslessCodec::decode(
+        uint8_t* pcm,
+        int_fast32_t capacity,
+        const uint8_t* encoded,
+        int_fast32_t length
+    )
+{
+    const int_fast8_t width(this->_bitsPerSample / 8);
+    if (
+            ((this->_bitsPerSample % 8) || !width || (width > 4))
+            || !this->_channels
+        ) return CODEC_UNSUPPORTED_FORMAT;
+    if (length < 2) return CODEC_MALFORMED_PAYLOAD;
+
+    const int_fast32_t
+        numFrames(encoded[0] | (encoded[1] << 8)),
+        numBytes(numFrames * width * this->_channels);
+    if (numBytes > capacity) return CODEC_OUTPUT_TOO_SHORT;
+
+    this->_samples.resize(numFrames * this->_channels);
+    int32_t* samples(this->_samples.data());
+    int_fast32_t position(2);
+    for (uint8_t c(0); c < this->_channels; ++c)
+    {
+        const int_fast32_t rc(
+                (width < 4)
+                ? _decode_channel<int32_t>(
+                        samples + (c * numFrames),
+                        numFrames,
+                        encoded + position,
+                        length - position
+                    )
+                : _decode_channel<int64_t>(
+                        samples + (c * numFrames),
+                        numFrames,
+                        encoded + position,
+                        length - position
+                    )
+            );
+        if (rc < 0) return rc;
+        position += rc;
+    }
+    if (position != length) return CODEC_MALFORMED_PAYLOAD;
+
+    for (int_fast32_t i(0); i < numFrames; ++i)
+    {
+        for (uint8_t c(0); c < this->_channels; ++c, pcm += width)
+        {
+            put_sample(pcm, samples[(c * numFrames) + i], width);
+        }
+    }
+    return numBytes;
+}
+
+/*                               ADPCM                              */
+
+/* Quantizer step sizes of IMA ADPCM */
+static constexpr const int16_t adpcmSteps[ADPCM_NUM_STEPS] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+        41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+        190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+        724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+        2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+        7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818,
+        18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+
+/* Step index change after each nibble */
+static constexpr const int8_t adpcmIndexSteps[16] = {
+        -1, -1, -1, -1, 2, 4, 6, 8,
+        -1, -1, -1, -1, 2, 4, 6, 8
+    };
+
+/* Samples are coded at 16 bits whatever their width */
+static inline int32_t to_adpcm_sample(int32_t value, int_fast8_t width)
+{
+    return (width == 1) ? (value * 256) : (value >> (8 * (width - 2)));
+}
+
+static inline int32_t from_adpcm_sample(int32_t value, int_fast8_t width)
+{
+    return (width == 1) ? (value >> 8) : (value * (1 << (8 * (width - 2))));
+}
+
+/* Difference a nibble stands for, summed from shifted
+steps exactly as by the standard decoder */
+static inline int32_t adpcm_difference(int32_t step, uint8_t nibble)
+{
+    const int32_t
+        magnitude(
+                (step >> 3)
+                + (step & -static_cast<int32_t>((nibble >> 2) & 1))
+                + ((step >> 1) & -static_cast<int32_t>((nibble >> 1) & 1))
+                + ((step >> 2) & -static_cast<int32_t>(nibble & 1))
+            ),
+        sign(-static_cast<int32_t>(nibble >> 3));
+    return (magnitude ^ sign) - sign;
+}
+
+/* Quantizes a difference with successive halvings of the step */
+static inline uint8_t adpcm_quantize(int32_t difference, int32_t step)
+{
+    const int32_t sign(difference >> 31);
+    int32_t magnitude((difference ^ sign) - sign), mask;
+    uint8_t nibble(static_cast<uint8_t>(sign & 8));
+
+    mask = -static_cast<int32_t>(magnitude >= step);
+    nibble |= 4 & mask;
+    magnitude -= step & mask;
+
+    mask = -static_cast<int32_t>(magnitude >= (step >> 1));
+    nibble |= 2 & mask;
+    magnitude -= (step >> 1) & mask;
+
+    mask = -static_cast<int32_t>(magnitude >= (step >> 2));
+    nibble |= 1 & mask;
+    return nibble;
+}
+
+/* Moves a channel's predictor and step index past a nibble */
+static inline void adpcm_update(int32_t* predictor, int_fast8_t* index, uint8_t nibble)
+{
+    *predictor = std::clamp<int32_t>(
+            *predictor + adpcm_difference(adpcmSteps[*index], nibble),
+            INT16_MIN,
+            INT16_MAX
+        );
+    *index = std::clamp<int_fast8_t>(
+            *index + adpcmIndexSteps[nibble],
+            0,
+            (ADPCM_NUM_STEPS - 1)
+        );
+}
+
+WIFBADPCMCodec::WIFBADPCMCodec(uint8_t bitsPerSample, uint8_t channels) :
+WIFBCodec(bitsPerSample, channels),
+_indices(channels, 0)
+{
+}
+
+WIFBADPCMCodec::~WIFBADPCMCodec()
+{
+}
+
+uint8_t WIFBADPCMCodec::encoding() const
+{
+    return WIFB_ENCODING_ADPCM;
+}
+
+int_fast32_t WIFBADPCMCodec::max_encoded_size(int_fast32_t numBytes) const
+{
+    const int_fast32_t numFrames(numBytes / ((this->_bitsPerSample / 8) * this->_channels));
+    return 2 + (this->_channels * (ADPCM_CHANNEL_HEADER_SIZE + (numFrames / 2)));
+}
+
+int_fast32_t WIFBADPCMCodec::encode(
+        uint8_t* encoded,
+        uint8_t* const regions[],
+        const int_fast32_t lengths[],
+        int_fast8_t numRegions
+    )
+{
+    const int_fast8_t width(this->_bitsPerSample / 8);
+    int_fast32_t numBytes(0);
+    for (int_fast8_t r(0); r < numRegions; ++r) numBytes += lengths[r];
+    const int_fast32_t numFrames(numBytes / (width * this->_channels));
+
+    /* Split the chunk into one run of samples per channel */
+    this->_samples.resize(numFrames * this->_channels);
+    int16_t* samples(this->_samples.data());
+    int_fast32_t frame(0);
+    uint8_t channel(0);
+    for (int_fast8_t r(0); r < numRegions; ++r)
+    {
+        for (int_fast32_t i(0); (i + width) <= lengths[r]; i += width)
+        {
+            if (frame >= numFrames) break;
+            samples[(channel * numFrames) + frame] = static_cast<int16_t>(
+                    to_adpcm_sample(get_sample(regions[r] + i, width), width)
+                );
+            if (++channel == this->_channels)
+            {
+                channel = 0;
+                ++frame;
+            }
+        }
+    }
+
+    encoded[0] = static_cast<uint8_t>(numFrames);
+    encoded[1] = static_cast<uint8_t>(numFrames >> 8);
+    if (!numFrames) return 2;
+
+    const int_fast32_t nibbleBytes(numFrames / 2);
+    uint8_t* header(encoded + 2);
+    uint8_t* nibbles(header + (this->_channels * ADPCM_CHANNEL_HEADER_SIZE));
+    for (uint8_t c(0); c < this->_channels; ++c, header += ADPCM_CHANNEL_HEADER_SIZE)
+    {
+        const int16_t* x(samples + (c * numFrames));
+        int32_t predictor(x[0]);
+        int_fast8_t index(this->_indices[c]);
+        header[0] = static_cast<uint8_t>(predictor);
+        header[1] = static_cast<uint8_t>(predictor >> 8);
+        header[2] = static_cast<uint8_t>(index);
+        header[3] = 0;
+
+        uint8_t* output(nibbles + (c * nibbleBytes));
+        for (int_fast32_t i(1); i < numFrames; i += 2)
+        {
+            const uint8_t low(adpcm_quantize(x[i] - predictor, adpcmSteps[index]));
+            adpcm_update(&predictor, &index, low);
+            uint8_t high(0);
+            if ((i + 1) < numFrames)
+            {
+                high = adpcm_quantize(x[i + 1] - predictor, adpcmSteps[index]);
+                adpcm_update(&predictor, &index, high);
+            }
+            *(output++) = static_cast<uint8_t>(low | (high << 4));
+        }
+        this->_indices[c] = static_cast<uint8_t>(index);
+    }
+    return (nibbles + (this->_channels * nibbleBytes)) - encoded;
+}
+
+int_fast32_t WIFBADPCMCodec::decode(
+        uint8_t* pcm,
+        int_fast32_t capacity,
+        const uint8_t* encoded,
+        int_fast32_t length
+    )
+{
+    const int_fast8_t width(this->_bitsPerSample / 8);
+    if (length < 2) return CODEC_MALFORMED_PAYLOAD;
+
+    const int_fast32_t
+        numFrames(encoded[0] | (encoded[1] << 8)),
+        numBytes(numFrames * width * this->_channels),
+        nibbleBytes(numFrames / 2);
+    if (numBytes > capacity) return CODEC_OUTPUT_TOO_SHORT;
+    if (!numFrames) return (length == 2) ? 0 : CODEC_MALFORMED_PAYLOAD;
+    if (length != (2 + (this->_channels * (ADPCM_CHANNEL_HEADER_SIZE + nibbleBytes))))
+    {
+        return CODEC_MALFORMED_PAYLOAD;
+    }
+
+    /* Channels are decoded straight into their interleaved slots */
+    const int_fast32_t stride(width * this->_channels);
+    const uint8_t* header(encoded + 2);
+    const uint8_t* nibbles(header + (this->_channels * ADPCM_CHANNEL_HEADER_SIZE));
+    for (uint8_t c(0); c < this->_channels; ++c, header += ADPCM_CHANNEL_HEADER_SIZE)
+    {
+        int32_t predictor(static_cast<int16_t>(header[0] | (header[1] << 8)));
+        if (header[2] >= ADPCM_NUM_STEPS) return CODEC_MALFORMED_PAYLOAD;
+        int_fast8_t index(header[2]);
+
+        uint8_t* output(pcm + (c * width));
+        put_sample(output, from_adpcm_sample(predictor, width), width);
+        output += stride;
+
+        const uint8_t* input(nibbles + (c * nibbleBytes));
+        for (int_fast32_t i(1); i < numFrames; i += 2, ++input)
+        {
+            adpcm_update(&predictor, &index, *input & 0x0F);
+            put_sample(output, from_adpcm_sample(predictor, width), width);
+            output += stride;
+            if ((i + 1) < numFrames)
+            {
+                adpcm_update(&predictor, &index, *input >> 4);
+                put_sample(output, from_adpcm_sample(predictor, width), width);
+                output += stride;
+            }
+        }
+    }
+    return numBytes;
+}
+
+std::unique_ptr<WIFBCodec> make_codec(
+        uint8_t encoding,
+        uint8_t bitsPerSample,
+        uint8_t channels
+    )
+{
+    if (
+            ((bitsPerSample != 8) && (bitsPerSample != 16)
+                && (bitsPerSample != 24) && (bitsPerSample != 32))
+            || !channels
+        ) return nullptr;
+
+    switch (encoding)
+    {
+        case WIFB_ENCODING_LOSSLESS:
+            return std::make_unique<WIFBLosslessCodec>(bitsPerSample, channels);
+        case WIFB_ENCODING_ADPCM:
+            return std::make_unique<WIFBADPCMCodec>(bitsPerSample, channels);
+        default:
+            return nullptr;
+    }
+}
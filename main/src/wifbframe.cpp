@@ -0,0 +1,352 @@
+#include "wifbframe.h"
+
+static inline void _put_u16(uint8_t* outgoing, uint16_t value)
+{
+    outgoing[0] = static_cast<uint8_t>(value);
+    outgoing[1] = static_cast<uint8_t>(value >> 8);
+}
+
+static inline void _put_u32(uint8_t* outgoing, uint32_t value)
+{
+    outgoing[0] = static_cast<uint8_t>(value);
+    outgoing[1] = static_cast<uint8_t>(value >> 8);
+    outgoing[2] = static_cast<uint8_t>(value >> 16);
+    outgoing[3] = static_cast<uint8_t>(value >> 24);
+}
+
+static inline uint16_t _get_u16(const uint8_t* incoming)
+{
+    return static_cast<uint16_t>(incoming[0] | (incoming[1] << 8));
+}
+
+static inline uint32_t _get_u32(const uint8_t* incoming)
+{
+    return (
+            static_cast<uint32_t>(incoming[0])
+            | (static_cast<uint32_t>(incoming[1]) << 8)
+            | (static_cast<uint32_t>(incoming[2]) << 16)
+            | (static_cast<uint32_t>(incoming[3]) << 24)
+        );
+}
+
+void encode_frame_header(const WIFBFrameHeader& header, uint8_t* outgoing)
+{
+    outgoing[0] = (WIFB_FRAME_MAGIC) | (header.version & ~(WIFB_FRAME_MAGIC_MASK));
+    outgoing[1] = header.encoding;
+    outgoing[2] = header.bitsPerSample;
+    outgoing[3] = header.channels;
+    _put_u16(&(outgoing[4]), header.payloadLength);
+    _put_u16(&(outgoing[6]), header.metadataLength);
+    _put_u32(&(outgoing[8]), header.sequence);
+    _put_u32(&(outgoing[12]), header.timestamp);
+}
+
+bool decode_frame_header(const uint8_t* incoming, WIFBFrameHeader* header)
+{
+    header->version = incoming[0] & ~(WIFB_FRAME_MAGIC_MASK);
+    header->encoding = incoming[1];
+    header->bitsPerSample = incoming[2];
+    header->channels = incoming[3];
+    header->payloadLength = _get_u16(&(incoming[4]));
+    header->metadataLength = _get_u16(&(incoming[6]));
+    header->sequence = _get_u32(&(incoming[8]));
+    header->timestamp = _get_u32(&(incoming[12]));
+
+    return (
+            ((incoming[0] & (WIFB_FRAME_MAGIC_MASK)) == (WIFB_FRAME_MAGIC))
+            && (header->version == (WIFB_FRAME_VERSION))
+        );
+}
+
+/*                              Encoder                             */
+
+WIFBFrameEncoder::WIFBFrameEncoder()
+{
+    std::memset(&(this->_header), 0, sizeof(this->_header));
+    std::memset(this->data, 0, (WIFB_FRAME_HEADER_SIZE));
+    this->_header.version = (WIFB_FRAME_VERSION);
+}
+
+WIFBFrameEncoder::WIFBFrameEncoder(
+        uint8_t encoding,
+        uint8_t bitsPerSample,
+        uint8_t channels
+    ) :
+WIFBFrameEncoder()
+{
+    set_format(encoding, bitsPerSample, channels);
+}
+
+WIFBFrameEncoder::~WIFBFrameEncoder()
+{
+}
+
+void WIFBFrameEncoder::set_format(
+        uint8_t encoding,
+        uint8_t bitsPerSample,
+        uint8_t channels
+    )
+{
+    this->_header.encoding = encoding;
+    this->_header.bitsPerSample = bitsPerSample;
+    this->_header.channels = channels;
+}
+
+void WIFBFrameEncoder::encode(
+        uint16_t payloadLength,
+        uint16_t metadataLength,
+        uint32_t numSamples
+    )
+{
+    this->_header.payloadLength = payloadLength;
+    this->_header.metadataLength = metadataLength;
+    encode_frame_header(this->_header, this->data);
+    ++this->_header.sequence;
+    this->_header.timestamp += numSamples;
+}
+
+void WIFBFrameEncoder::skip_samples(uint32_t numSamples, uint32_t numFrames)
+{
+    this->_header.sequence += numFrames;
+    this->_header.timestamp += numSamples;
+}
+
+const WIFBFrameHeader& WIFBFrameEncoder::header(void) const
+{
+    return this->_header;
+}
+
+/*                              Parser                              */
+
+WIFBFrameParser::WIFBFrameParser(
+        int_fast32_t maxPayloadLength,
+        uint8_t* metadataDestination,
+        int_fast32_t maxMetadataLength
+    ) :
+_maxPayloadLength(maxPayloadLength),
+_maxMetadataLength(maxMetadataLength),
+_metadataDestination(metadataDestination)
+{
+    reset();
+}
+
+WIFBFrameParser::~WIFBFrameParser()
+{
+}
+
+bool WIFBFrameParser::_accept_header(void)
+{
+    if (!decode_frame_header(this->_headerData, &(this->_header)))
+    {
+        return false;
+    }
+    if (
+            (this->_header.payloadLength > this->_maxPayloadLength)
+            || (this->_header.metadataLength > this->_maxMetadataLength)
+        )
+    {
+        return false;
+    }
+
+    /* Only count forward gaps; a sender restart is not a loss */
+    const uint32_t gap(this->_header.sequence - this->_nextSequence);
+    if (this->_sequenceKnown && (gap < 0x80000000))
+    {
+        this->_lostFrames += gap;
+    }
+    this->_nextSequence = this->_header.sequence + 1;
+    this->_sequenceKnown = true;
+
+    return true;
+}
+
+void WIFBFrameParser::_resync(void)
+{
+    int_fast32_t offset(1);
+    while (
+            (offset < (WIFB_FRAME_HEADER_SIZE))
+            && ((this->_headerData[offset] & (WIFB_FRAME_MAGIC_MASK)) != (WIFB_FRAME_MAGIC))
+        )
+    {
+        ++offset;
+    }
+
+    std::memmove(
+            this->_headerData,
+            &(this->_headerData[offset]),
+            (WIFB_FRAME_HEADER_SIZE) - offset
+        );
+    this->_headerFilled = (WIFB_FRAME_HEADER_SIZE) - offset;
+    this->_discardedBytes += offset;
+}
+
+wifb_frame_state WIFBFrameParser::state(void) const
+{
+    return this->_state;
+}
+
+const WIFBFrameHeader& WIFBFrameParser::header(void) const
+{
+    return this->_header;
+}
+
+int_fast8_t WIFBFrameParser::next_regions(
+        uint8_t* regions[3],
+        int_fast32_t lengths[3]
+    )
+{
+    if (this->_state == FRAME_HEADER)
+    {
+        regions[0] = &(this->_headerData[this->_headerFilled]);
+        lengths[0] = (WIFB_FRAME_HEADER_SIZE) - this->_headerFilled;
+        return 1;
+    }
+    else if (this->_state != FRAME_BODY)
+    {
+        return 0;
+    }
+
+    int_fast8_t numRegions(0);
+    for (int_fast8_t i(this->_currentRegion); i < this->_numRegions; ++i)
+    {
+        const int_fast32_t filled((i == this->_currentRegion) ? this->_regionFilled : 0);
+        regions[numRegions] = this->_regions[i] + filled;
+        lengths[numRegions] = this->_lengths[i] - filled;
+        ++numRegions;
+    }
+    return numRegions;
+}
+
+wifb_frame_state WIFBFrameParser::advance(int_fast32_t numBytes)
+{
+    if (this->_state == FRAME_HEADER)
+    {
+        this->_headerFilled += numBytes;
+        if (this->_headerFilled < (WIFB_FRAME_HEADER_SIZE))
+        {
+            return this->_state;
+        }
+        if (_accept_header())
+        {
+            this->_state = FRAME_HEADER_COMPLETE;
+        }
+        else
+        {
+            _resync();
+        }
+        return this->_state;
+    }
+    else if (this->_state != FRAME_BODY)
+    {
+        return this->_state;
+    }
+
+    while (numBytes && (this->_currentRegion < this->_numRegions))
+    {
+        const int_fast32_t step(std::min(
+                numBytes,
+                this->_lengths[this->_currentRegion] - this->_regionFilled
+            ));
+        this->_regionFilled += step;
+        numBytes -= step;
+        if (this->_regionFilled == this->_lengths[this->_currentRegion])
+        {
+            ++this->_currentRegion;
+            this->_regionFilled = 0;
+        }
+    }
+    if (this->_currentRegion == this->_numRegions)
+    {
+        this->_state = FRAME_COMPLETE;
+    }
+    return this->_state;
+}
+
+void WIFBFrameParser::set_payload_regions(
+        uint8_t* const regions[],
+        const int_fast32_t lengths[],
+        int_fast8_t numRegions
+    )
+{
+    #if _DEBUG
+    if (this->_state != FRAME_HEADER_COMPLETE)
+    {
+        throw FRAME_NOT_AWAITING_PAYLOAD;
+    }
+    int_fast32_t total(0);
+    for (int_fast8_t i(0); i < numRegions; ++i) total += lengths[i];
+    if (total != this->_header.payloadLength)
+    {
+        throw FRAME_PAYLOAD_LENGTH_MISMATCH;
+    }
+    #endif
+
+    this->_numRegions = 0;
+    for (int_fast8_t i(0); (i < numRegions) && (i < 2); ++i)
+    {
+        if (!lengths[i]) continue;
+        this->_regions[this->_numRegions] = regions[i];
+        this->_lengths[this->_numRegions] = lengths[i];
+        ++this->_numRegions;
+    }
+    if (this->_header.metadataLength)
+    {
+        this->_regions[this->_numRegions] = this->_metadataDestination;
+        this->_lengths[this->_numRegions] = this->_header.metadataLength;
+        ++this->_numRegions;
+    }
+
+    this->_currentRegion = 0;
+    this->_regionFilled = 0;
+    this->_state = (this->_numRegions ? FRAME_BODY : FRAME_COMPLETE);
+}
+
+int_fast32_t WIFBFrameParser::parse(const uint8_t* data, int_fast32_t length)
+{
+    uint8_t* regions[3];
+    int_fast32_t lengths[3];
+    int_fast32_t consumed(0);
+
+    while ((consumed < length) && next_regions(regions, lengths))
+    {
+        const int_fast32_t numBytes(std::min(lengths[0], length - consumed));
+        std::memcpy(regions[0], &(data[consumed]), numBytes);
+        consumed += numBytes;
+        advance(numBytes);
+    }
+
+    return consumed;
+}
+
+void WIFBFrameParser::next_frame(void)
+{
+    this->_state = FRAME_HEADER;
+    this->_headerFilled = 0;
+    this->_numRegions = 0;
+    this->_currentRegion = 0;
+    this->_regionFilled = 0;
+}
+
+uint_fast32_t WIFBFrameParser::discarded(void)
+{
+    const uint_fast32_t numBytes(this->_discardedBytes);
+    this->_discardedBytes = 0;
+    return numBytes;
+}
+
+uint_fast32_t WIFBFrameParser::lost(void)
+{
+    const uint_fast32_t numFrames(this->_lostFrames);
+    this->_lostFrames = 0;
+    return numFrames;
+}
+
+void WIFBFrameParser::reset(void)
+{
+    next_frame();
+    std::memset(&(this->_header), 0, sizeof(this->_header));
+    this->_nextSequence = 0;
+    this->_sequenceKnown = false;
+    this->_discardedBytes = 0;
+    this->_lostFrames = 0;
+}
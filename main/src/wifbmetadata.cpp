@@ -59,6 +59,11 @@ void WIFBMetadata::set_data(const uint8_t* incoming)
     _set_timecode_from_data();
 }
 
+void WIFBMetadata::parse_data(void)
+{
+    _set_timecode_from_data();
+}
+
 void WIFBMetadata::get_data(uint8_t* outgoing) const
 {
     std::memcpy(outgoing, this->data, (METADATA_SIZE));
@@ -27,10 +27,12 @@ std::string ip_addr_string(int addr)
     return ip_addr_string(reinterpret_cast<uint8_t*>(&addr));
 }
 
+#ifdef ESP_PLATFORM
 std::string ip_addr_string(esp_ip4_addr_t addr)
 {
     return ip_addr_string(reinterpret_cast<uint8_t*>(&addr));
 }
+#endif
 
 bool match_mac_addr(const uint8_t addr1[6], const uint8_t addr2[6])
 {
@@ -41,3 +43,207 @@ bool match_mac_addr(const uint8_t addr1[6], const uint8_t addr2[6])
     return true;
 }
 
+int advance_iov(struct iovec* iov, int iovcnt, size_t numBytes)
+{
+    int index(0);
+    while ((index < iovcnt) && (numBytes >= iov[index].iov_len))
+    {
+        numBytes -= iov[index].iov_len;
+        iov[index].iov_len = 0;
+        ++index;
+    }
+    if (index < iovcnt)
+    {
+        iov[index].iov_base = static_cast<uint8_t*>(iov[index].iov_base) + numBytes;
+        iov[index].iov_len -= numBytes;
+    }
+    return index;
+}
+
+int send_iov(int sock, struct iovec* iov, int iovcnt)
+{
+    size_t remaining(0);
+    for (int i(0); i < iovcnt; ++i) remaining += iov[i].iov_len;
+
+    int sent(0), index(0);
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+
+    while (remaining)
+    {
+        msg.msg_iov = iov + index;
+        msg.msg_iovlen = iovcnt - index;
+        const int rc = sendmsg(sock, &msg, (WIFB_SEND_FLAGS));
+        if (rc < 0)
+        {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        sent += rc;
+        remaining -= rc;
+        index += advance_iov(iov + index, iovcnt - index, rc);
+    }
+    return sent;
+}
+
+int recv_iov(int sock, struct iovec* iov, int iovcnt)
+{
+    size_t remaining(0);
+    for (int i(0); i < iovcnt; ++i) remaining += iov[i].iov_len;
+
+    int received(0), index(0);
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+
+    while (remaining)
+    {
+        msg.msg_iov = iov + index;
+        msg.msg_iovlen = iovcnt - index;
+        const int rc = recvmsg(sock, &msg, 0);
+        if (rc < 0)
+        {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (!rc) return 0;
+        received += rc;
+        remaining -= rc;
+        index += advance_iov(iov + index, iovcnt - index, rc);
+    }
+    return received;
+}
+
+int open_udp_socket(uint16_t* port)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) return -1;
+
+    struct sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(*port);
+
+    socklen_t addressLength = sizeof(address);
+    if (
+            (bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+            || (getsockname(
+                    sock,
+                    reinterpret_cast<sockaddr*>(&address),
+                    &addressLength
+                ) < 0)
+        )
+    {
+        close(sock);
+        return -1;
+    }
+
+    *port = ntohs(address.sin_port);
+    return sock;
+}
+
+bool peer_closed(int sock)
+{
+    uint8_t peeked;
+    const int rc = recv(sock, &peeked, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (rc > 0) return false;
+    else if (!rc) return true;
+    return !((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR));
+}
+
+bool is_multicast_addr(const uint8_t addr[4])
+{
+    return (addr[0] & 0xF0) == 0xE0;
+}
+
+int open_group_sender(
+        const uint8_t group[4],
+        uint16_t port,
+        const uint8_t interfaceAddr[4]
+    )
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) return -1;
+
+    struct sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    std::memcpy(&address.sin_addr.s_addr, group, 4);
+    address.sin_port = htons(port);
+
+    int rc(0);
+    if (is_multicast_addr(group))
+    {
+        /* Keep the group on the local network, and loop it back
+        so receivers on this host hear it too */
+        struct in_addr interface;
+        std::memcpy(&interface.s_addr, interfaceAddr, 4);
+        const uint8_t ttl(1), loop(1);
+        rc |= setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        rc |= setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        if (interface.s_addr != htonl(INADDR_ANY))
+        {
+            rc |= setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &interface, sizeof(interface));
+        }
+    }
+    else
+    {
+        const int broadcast(1);
+        rc |= setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast));
+    }
+
+    if (
+            (rc < 0)
+            || (connect(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+        )
+    {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+int open_group_receiver(
+        const uint8_t group[4],
+        uint16_t port,
+        const uint8_t interfaceAddr[4]
+    )
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) return -1;
+
+    /* Every receiver on a host binds the same port */
+    const int reuse(1);
+    int rc = setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    #ifdef SO_REUSEPORT
+    rc |= setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse));
+    #endif
+
+    struct sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    rc |= bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+    if (is_multicast_addr(group))
+    {
+        struct ip_mreq membership;
+        std::memcpy(&membership.imr_multiaddr.s_addr, group, 4);
+        std::memcpy(&membership.imr_interface.s_addr, interfaceAddr, 4);
+        rc |= setsockopt(
+                sock,
+                IPPROTO_IP,
+                IP_ADD_MEMBERSHIP,
+                &membership,
+                sizeof(membership)
+            );
+    }
+
+    if (rc < 0)
+    {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
@@ -0,0 +1,88 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/* Replaces the global allocation functions with ones that count
+every call, so a test can check that a path never reaches the
+heap.  Include it in one translation unit of a test only. */
+
+static std::atomic_long wifbAllocations(0);
+
+/* Number of allocations made since the program started */
+inline long allocations()
+{
+    return wifbAllocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+    ++wifbAllocations;
+    if (void* data = std::malloc(size ? size : 1)) return data;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++wifbAllocations;
+    const std::size_t align(static_cast<std::size_t>(alignment));
+    if (void* data = std::aligned_alloc(align, ((size + align - 1) / align) * align))
+    {
+        return data;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* data) noexcept
+{
+    std::free(data);
+}
+
+void operator delete[](void* data) noexcept
+{
+    std::free(data);
+}
+
+void operator delete(void* data, std::size_t) noexcept
+{
+    std::free(data);
+}
+
+void operator delete[](void* data, std::size_t) noexcept
+{
+    std::free(data);
+}
+
+void operator delete(void* data, std::align_val_t) noexcept
+{
+    std::free(data);
+}
+
+void operator delete[](void* data, std::align_val_t) noexcept
+{
+    std::free(data);
+}
+
+void operator delete(void* data, std::size_t, std::align_val_t) noexcept
+{
+    std::free(data);
+}
+
+void operator delete[](void* data, std::size_t, std::align_val_t) noexcept
+{
+    std::free(data);
+}
+
+#endif
@@ -0,0 +1,245 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "batchconversions.h"
+#include "oscillator.h"
+#include "wifbcodec.h"
+#include "wifbtest.h"
+
+/* Tones from Osc::OscillatorBase go through the ADPCM codec in
+chunks, as they do between the ring and the socket, and the SNR
+of what comes back is measured and bounded, along with the size
+of the payloads and the codec's throughput.  Each chunk carries
+its own decoder state, so chunks decode the same in any order.
+Payloads come off the network, so the decoder is also fed every
+truncation and bit flip of valid payloads and random bytes. */
+
+static constexpr const uint8_t numChannels = 2;
+static constexpr const int_fast32_t chunkFrames = 256;
+static constexpr const int_fast32_t numChunks = 200;
+
+static uint32_t seed(1);
+
+static uint8_t random_byte()
+{
+    seed = (seed * 1664525) + 1013904223;
+    return static_cast<uint8_t>(seed >> 24);
+}
+
+/* Interleaved pcm of a tone, the same in every channel */
+template <typename I>
+static std::vector<uint8_t> make_pcm(float frequency, float scale, int_fast32_t numFrames)
+{
+    Osc::OscillatorBase<float> osc;
+    osc.set_sample_rate(48000);
+    osc.set_frequency(frequency);
+    osc.scale = scale;
+
+    std::vector<float> values(numFrames * numChannels);
+    for (int_fast32_t i(0); i < numFrames; ++i)
+    {
+        float tone;
+        osc.get(&tone, 1);
+        for (uint8_t c(0); c < numChannels; ++c) values[(i * numChannels) + c] = tone;
+    }
+
+    std::vector<uint8_t> pcm(values.size() * sizeof(I));
+    float_to_int_batch<I>(reinterpret_cast<I*>(pcm.data()), values.data(), values.size());
+    return pcm;
+}
+
+/* Encodes pcm chunk by chunk and returns the payloads */
+static std::vector<std::vector<uint8_t>> encode_chunks(WIFBCodec& codec, std::vector<uint8_t>& pcm, int_fast32_t chunkBytes)
+{
+    std::vector<std::vector<uint8_t>> payloads;
+    for (size_t start(0); start < pcm.size(); start += chunkBytes)
+    {
+        std::vector<uint8_t> encoded(codec.max_encoded_size(chunkBytes));
+        uint8_t* regions[1] = {pcm.data() + start};
+        const int_fast32_t lengths[1] = {chunkBytes};
+        const int_fast32_t length(codec.encode(encoded.data(), regions, lengths, 1));
+        WIFB_CHECK(length <= static_cast<int_fast32_t>(encoded.size()));
+        encoded.resize(length);
+        payloads.push_back(encoded);
+    }
+    return payloads;
+}
+
+template <typename I>
+static double snr(const std::vector<uint8_t>& pcm, const std::vector<uint8_t>& decoded, size_t from)
+{
+    const I* x(reinterpret_cast<const I*>(pcm.data()));
+    const I* y(reinterpret_cast<const I*>(decoded.data()));
+    double signal(0), error(0);
+    for (size_t i(from / sizeof(I)); i < (pcm.size() / sizeof(I)); ++i)
+    {
+        const double difference(static_cast<double>(x[i]) - static_cast<double>(y[i]));
+        signal += static_cast<double>(x[i]) * static_cast<double>(x[i]);
+        error += difference * difference;
+    }
+    return 10.0 * std::log10(signal / std::max(error, 1.0));
+}
+
+template <typename I>
+static void check_snr(float frequency, float scale, double least)
+{
+    constexpr int_fast32_t chunkBytes = chunkFrames * numChannels * sizeof(I);
+    WIFBADPCMCodec encoder(sizeof(I) * 8, numChannels), decoder(sizeof(I) * 8, numChannels);
+    std::vector<uint8_t> pcm(make_pcm<I>(frequency, scale, chunkFrames * numChunks));
+    std::vector<uint8_t> decoded(pcm.size());
+
+    const auto start(std::chrono::steady_clock::now());
+    const std::vector<std::vector<uint8_t>> payloads(encode_chunks(encoder, pcm, chunkBytes));
+    const auto encoded(std::chrono::steady_clock::now());
+
+    /* Chunks decode the same in reverse, as they carry their own state */
+    size_t payloadBytes(0);
+    for (size_t chunk(payloads.size()); chunk-- > 0;)
+    {
+        const int_fast32_t rc(decoder.decode(
+                decoded.data() + (chunk * chunkBytes),
+                chunkBytes,
+                payloads[chunk].data(),
+                payloads[chunk].size()
+            ));
+        WIFB_CHECK_EQUAL(rc, chunkBytes);
+        payloadBytes += payloads[chunk].size();
+    }
+    const auto finished(std::chrono::steady_clock::now());
+
+    /* The first chunk is left out while the step size adapts */
+    const double measured(snr<I>(pcm, decoded, chunkBytes));
+    const double ratio(static_cast<double>(payloadBytes) / static_cast<double>(pcm.size()));
+    const double numSamples(static_cast<double>(pcm.size() / sizeof(I)));
+    std::cout << (sizeof(I) * 8) << " bit, " << frequency << " Hz at " << (20.0 * std::log10(scale));
+    std::cout << " dBFS: snr " << measured << " dB, ratio " << ratio << ", encode ";
+    std::cout << (numSamples / std::chrono::duration<double>(encoded - start).count() / 1e6);
+    std::cout << " M samples/s, decode ";
+    std::cout << (numSamples / std::chrono::duration<double>(finished - encoded).count() / 1e6);
+    std::cout << " M samples/s\n";
+
+    WIFB_CHECK(measured >= least);
+    WIFB_CHECK(ratio < ((sizeof(I) == 2) ? 0.26 : (sizeof(I) == 3) ? 0.18 : 0.14));
+}
+
+static void check_lengths()
+{
+    /* Chunks of every length up to a few frames, including none */
+    for (uint8_t bitsPerSample: {8, 16, 24, 32})
+    {
+        const int_fast32_t frameBytes((bitsPerSample / 8) * numChannels);
+        WIFBADPCMCodec codec(bitsPerSample, numChannels);
+        for (int_fast32_t numFrames(0); numFrames <= 9; ++numFrames)
+        {
+            std::vector<uint8_t> pcm(numFrames * frameBytes, 0x10);
+            const std::vector<std::vector<uint8_t>> payloads(
+                    encode_chunks(codec, pcm, pcm.size())
+                );
+            if (!numFrames) continue;
+            std::vector<uint8_t> decoded(pcm.size());
+            WIFB_CHECK_EQUAL(
+                    codec.decode(decoded.data(), decoded.size(), payloads[0].data(), payloads[0].size()),
+                    static_cast<int_fast32_t>(pcm.size())
+                );
+        }
+        std::vector<uint8_t> empty(2, 0), decoded(frameBytes);
+        WIFB_CHECK_EQUAL(codec.decode(decoded.data(), decoded.size(), empty.data(), 2), 0);
+        empty.push_back(0);
+        WIFB_CHECK_EQUAL(codec.decode(decoded.data(), decoded.size(), empty.data(), 3), CODEC_MALFORMED_PAYLOAD);
+    }
+}
+
+static int_fast32_t decode(WIFBCodec& codec, const std::vector<uint8_t>& encoded, int_fast32_t capacity)
+{
+    /* Exactly sized, so the sanitizers catch any write past it */
+    std::vector<uint8_t> payload(encoded), pcm(capacity);
+    const int_fast32_t rc(codec.decode(pcm.data(), capacity, payload.data(), payload.size()));
+    WIFB_CHECK(rc <= capacity);
+    return rc;
+}
+
+static void check_malformed()
+{
+    for (uint8_t bitsPerSample: {8, 16, 24, 32})
+    {
+        const int_fast32_t width(bitsPerSample / 8);
+        WIFBADPCMCodec codec(bitsPerSample, numChannels);
+        std::vector<uint8_t> pcm(make_pcm<int16_t>(1000, 0.5f, 63));
+        if (width != 2) pcm.resize(63 * numChannels * width, 0x55);
+        const std::vector<uint8_t> valid(encode_chunks(codec, pcm, pcm.size())[0]);
+        const int_fast32_t capacity(pcm.size());
+
+        /* A payload must be exactly as long as its frame count calls for */
+        for (size_t length(0); length < valid.size(); ++length)
+        {
+            std::vector<uint8_t> truncated(valid.begin(), valid.begin() + length);
+            WIFB_CHECK(decode(codec, truncated, capacity) < 0);
+        }
+        std::vector<uint8_t> extended(valid);
+        extended.push_back(0);
+        WIFB_CHECK_EQUAL(decode(codec, extended, capacity), CODEC_MALFORMED_PAYLOAD);
+        WIFB_CHECK_EQUAL(decode(codec, valid, capacity - 1), CODEC_OUTPUT_TOO_SHORT);
+
+        /* Step indices past the table */
+        std::vector<uint8_t> header(valid);
+        header[4] = 89;
+        WIFB_CHECK_EQUAL(decode(codec, header, capacity), CODEC_MALFORMED_PAYLOAD);
+        header[4] = 0xFF;
+        WIFB_CHECK_EQUAL(decode(codec, header, capacity), CODEC_MALFORMED_PAYLOAD);
+
+        /* Flipped bits either fail or decode to a whole chunk */
+        for (size_t bit(0); bit < (valid.size() * 8); ++bit)
+        {
+            std::vector<uint8_t> flipped(valid);
+            flipped[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+            const int_fast32_t declared(width * numChannels * (flipped[0] | (flipped[1] << 8)));
+            const int_fast32_t rc(decode(codec, flipped, capacity));
+            WIFB_CHECK((rc < 0) || (rc == declared));
+        }
+
+        /* Nibbles that drive the predictor and step index to their limits */
+        for (uint8_t fill: {0x77, 0xFF, 0x70, 0x07})
+        {
+            std::vector<uint8_t> saturating(valid);
+            saturating[4] = saturating[8] = 88;
+            for (size_t i(2 + (numChannels * 4)); i < saturating.size(); ++i) saturating[i] = fill;
+            WIFB_CHECK_EQUAL(decode(codec, saturating, capacity), capacity);
+        }
+
+        /* Random payloads, with and without a consistent length */
+        for (int_fast32_t trial(0); trial < 2000; ++trial)
+        {
+            const int_fast32_t numFrames(random_byte() % 40);
+            std::vector<uint8_t> payload(
+                    (trial & 1)
+                    ? (2 + (numChannels * (4 + (numFrames / 2))))
+                    : (random_byte() % 64)
+                );
+            for (uint8_t& byte: payload) byte = random_byte();
+            if ((trial & 1) && (payload.size() >= 2))
+            {
+                payload[0] = static_cast<uint8_t>(numFrames);
+                payload[1] = 0;
+            }
+            decode(codec, payload, 40 * width * numChannels);
+        }
+    }
+}
+
+int main()
+{
+    /* Speech band tones at moderate and low levels */
+    check_snr<int16_t>(200, 0.5f, 48);
+    check_snr<int16_t>(1000, 0.5f, 35);
+    check_snr<int16_t>(3000, 0.5f, 25);
+    check_snr<int16_t>(1000, 0.05f, 35);
+    check_snr<Int24>(1000, 0.5f, 35);
+    check_snr<int32_t>(1000, 0.5f, 35);
+
+    check_lengths();
+    check_malformed();
+    return WIFB_TEST_RESULT();
+}
@@ -0,0 +1,166 @@
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <span>
+
+#include "broadcastringbuffer.h"
+#include "multibuffer.h"
+#include "ringallocator.h"
+#include "ringbuffer.h"
+#include "allocationcounter.h"
+#include "wifbtest.h"
+
+/* Every ring of a transmit and receive pipeline is carved from
+one static region, as firmware does at boot.  Neither building
+the rings nor running audio through them may touch the heap,
+and resizing within the arena must not leak its space. */
+
+static constexpr const int_fast32_t bufferLength = 64;
+static constexpr const int_fast8_t ringLength = 4;
+static constexpr const int_fast8_t numChannels = 2;
+static constexpr const int_fast8_t numClients = 3;
+static constexpr const int_fast32_t numSteps = 500;
+
+typedef Buffer::ArenaAllocator<int16_t> Allocator;
+typedef Buffer::RingBuffer<int16_t, std::atomic_int_fast8_t, Allocator> Ring;
+typedef Buffer::MultiRingBuffer<int16_t, std::atomic_int_fast8_t, Allocator> MultiRing;
+
+alignas(RINGBUFF_CACHE_LINE_SIZE) static uint8_t region[1 << 16];
+
+struct Pipeline
+{
+    /* Captured frames, split one channel per sub buffer */
+    MultiRing capture;
+
+    /* Interleaved frames sent to every client */
+    Buffer::BroadcastRingBuffer<int16_t> transmit;
+
+    /* What one client receives */
+    Ring receive;
+
+    int_fast8_t clients[numClients];
+    int16_t next{0}, expected{0};
+    uint32_t errors{0};
+
+    Pipeline(Buffer::Arena& arena) :
+    capture(bufferLength, ringLength, numChannels, Allocator(arena)),
+    transmit(),
+    receive(bufferLength * numChannels, ringLength, Allocator(arena))
+    {
+        transmit.set_arena(&arena);
+        transmit.set_size(bufferLength * numChannels, ringLength);
+        for (int_fast8_t c(0); c < numClients; ++c) clients[c] = transmit.add_reader();
+    }
+
+    void step()
+    {
+        int16_t frames[bufferLength * numChannels];
+
+        /* Capture one buffer of frames */
+        for (int_fast32_t i(0); i < bufferLength; ++i)
+        {
+            for (int_fast8_t c(0); c < numChannels; ++c) frames[(i * numChannels) + c] = next;
+            ++next;
+        }
+        capture.write_samples_interleaved(frames, bufferLength * numChannels);
+
+        /* Interleave it again for the clients */
+        capture.read_samples_interleaved(frames, bufferLength * numChannels);
+        transmit.write_samples(frames, bufferLength * numChannels);
+
+        /* Every client takes the chunk; one of them plays it */
+        for (int_fast8_t c(0); c < numClients; ++c)
+        {
+            transmit.read_samples(clients[c], frames, bufferLength * numChannels);
+        }
+        receive.write(std::span<const int16_t>(frames, bufferLength * numChannels));
+        const int_fast32_t numRead(receive.read(std::span<int16_t>(frames, bufferLength * numChannels)));
+        for (int_fast32_t i(0); i < numRead; i += numChannels)
+        {
+            for (int_fast8_t c(0); c < numChannels; ++c) errors += (frames[i + c] != expected);
+            ++expected;
+        }
+    }
+};
+
+static void check_pipeline()
+{
+    long before(allocations());
+    Buffer::Arena arena(region, sizeof(region));
+    Pipeline pipeline(arena);
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK(arena.used() > 0);
+
+    before = allocations();
+    for (int_fast32_t step(0); step < numSteps; ++step) pipeline.step();
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK_EQUAL(pipeline.errors, 0u);
+    WIFB_CHECK_EQUAL(pipeline.expected, numSteps * bufferLength);
+}
+
+static void check_resizes()
+{
+    /* The ring sits at the top of the arena, so shrinking and
+    growing it back reuses the same space */
+    Buffer::Arena arena(region, sizeof(region));
+    Ring ring(bufferLength, ringLength, Allocator(arena));
+    const size_t used(arena.used());
+
+    long before(allocations());
+    for (int_fast8_t pass(0); pass < 4; ++pass)
+    {
+        ring.set_size(bufferLength / 2, ringLength / 2);
+        ring.set_size(bufferLength, ringLength);
+    }
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK_EQUAL(arena.used(), used);
+
+    /* So does the broadcast ring moving in and out of the arena */
+    Buffer::BroadcastRingBuffer<int16_t> transmit(bufferLength, ringLength);
+    transmit.set_arena(&arena);
+    transmit.set_arena(nullptr);
+    WIFB_CHECK_EQUAL(arena.used(), used);
+}
+
+static void check_exhaustion()
+{
+    /* Running out of arena throws instead of falling back to the heap */
+    Buffer::Arena arena(region, 4 * RINGBUFF_CACHE_LINE_SIZE);
+    bool threw(false);
+    long before(allocations());
+    try
+    {
+        Ring ring(bufferLength, ringLength, Allocator(arena));
+    }
+    catch (const std::bad_alloc&)
+    {
+        threw = true;
+    }
+    WIFB_CHECK(threw);
+    WIFB_CHECK(arena.used() <= arena.size());
+
+    /* As does an allocator without an arena */
+    threw = false;
+    try
+    {
+        Ring ring(bufferLength, ringLength);
+    }
+    catch (const std::bad_alloc&)
+    {
+        threw = true;
+    }
+    WIFB_CHECK(threw);
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+
+    /* Releasing the arena makes all of it available again */
+    arena.reset();
+    WIFB_CHECK_EQUAL(arena.available(), arena.size());
+}
+
+int main()
+{
+    check_pipeline();
+    check_resizes();
+    check_exhaustion();
+    return WIFB_TEST_RESULT();
+}
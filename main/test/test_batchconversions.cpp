@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "batchconversions.h"
+#include "wifbtest.h"
+
+/* Every format is checked bit for bit against a double precision
+reference that clamps and rounds with nearbyint, over edge values,
+ties, infinities and NaN at lengths that leave tails after whole
+blocks.  The reference redraws the dither from the documented
+generators, so dithered output must match exactly too, and the
+dither itself must be unbiased with the variance of +-1 LSB
+triangular noise. */
+
+static constexpr const float infinity = std::numeric_limits<float>::infinity();
+
+/* Xorshift32 with its 16 bit halves differenced, as TPDFDither documents */
+static float reference_dither(uint32_t* state)
+{
+    uint32_t x(*state);
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return static_cast<float>(
+            static_cast<int32_t>(x & 0xFFFF) - static_cast<int32_t>(x >> 16)
+        ) / 65536.0f;
+}
+
+template <typename I, int_fast8_t Bits>
+static I reference_to_int(float value, float dither)
+{
+    const double scale(std::ldexp(1.0, Bits - 1));
+    const float scaled((value * static_cast<float>(scale)) + dither);
+    double result(std::isnan(scaled) ? -scale : static_cast<double>(scaled));
+    result = std::nearbyint(std::min(std::max(result, -scale), scale - 1.0));
+    if (std::is_unsigned<I>::value) result += scale;
+    return static_cast<I>(static_cast<int64_t>(result));
+}
+
+template <typename I, int_fast8_t Bits>
+static float reference_to_float(I value)
+{
+    const double scale(std::ldexp(1.0, Bits - 1));
+    const double offset(std::is_unsigned<I>::value ? scale : 0.0);
+    return static_cast<float>((static_cast<double>(value) - offset) / scale);
+}
+
+/* Values every format must get right, in units of full scale */
+template <int_fast8_t Bits>
+static std::vector<float> edge_values()
+{
+    const float lsb(std::ldexp(1.0f, 1 - Bits));
+    std::vector<float> values = {
+            0.0f, -0.0f, 1.0f, -1.0f, 1.0f - lsb, -1.0f + lsb,
+            1.5f, -1.5f, 1e30f, -1e30f, infinity, -infinity,
+            std::numeric_limits<float>::quiet_NaN(),
+            std::numeric_limits<float>::denorm_min(),
+            -std::numeric_limits<float>::denorm_min(),
+        };
+
+    /* Ties either side of zero and of full scale round to even */
+    for (int_fast8_t k(0); k < 4; ++k)
+    {
+        values.push_back((k + 0.5f) * lsb);
+        values.push_back(-(k + 0.5f) * lsb);
+        values.push_back(1.0f - ((k + 0.5f) * lsb));
+        values.push_back(-1.0f + ((k + 0.5f) * lsb));
+    }
+    return values;
+}
+
+/* Edge values, then a seeded spread over and past full scale */
+template <int_fast8_t Bits>
+static std::vector<float> test_values(int_fast32_t length)
+{
+    std::vector<float> values(edge_values<Bits>());
+    uint32_t seed(Bits);
+    while (static_cast<int_fast32_t>(values.size()) < length)
+    {
+        seed = (seed * 1664525) + 1013904223;
+        values.push_back((static_cast<float>(seed >> 8) / 8388608.0f) * 3.0f - 1.5f);
+    }
+    values.resize(length);
+    return values;
+}
+
+template <typename I, int_fast8_t Bits>
+static void check_to_int(bool dithered)
+{
+    TPDFDither dither(12345);
+    uint32_t mismatches(0);
+
+    /* Lengths leave every size of tail after whole blocks,
+    and calls continue the dither where the last left off */
+    for (int_fast32_t length(1); length <= 67; ++length)
+    {
+        const std::vector<float> values(test_values<Bits>(length));
+        std::vector<I> converted(length);
+
+        uint32_t state[TPDF_DITHER_LANES];
+        std::memcpy(state, dither.state, sizeof(state));
+        float_to_int_batch<I, Bits>(
+                converted.data(),
+                values.data(),
+                length,
+                dithered ? &dither : nullptr
+            );
+
+        for (int_fast32_t i(0); i < length; ++i)
+        {
+            const float d(
+                    dithered
+                    ? reference_dither(&state[i % TPDF_DITHER_LANES])
+                    : 0.0f
+                );
+            mismatches += (converted[i] != reference_to_int<I, Bits>(values[i], d));
+        }
+        WIFB_CHECK(std::memcmp(state, dither.state, sizeof(state)) == 0);
+    }
+    WIFB_CHECK_EQUAL(mismatches, 0u);
+}
+
+template <typename I, int_fast8_t Bits>
+static void check_to_float(const std::vector<I>& values)
+{
+    std::vector<float> converted(values.size());
+    int_to_float_batch<I, Bits>(converted.data(), values.data(), values.size());
+
+    uint32_t mismatches(0);
+    for (size_t i(0); i < values.size(); ++i)
+    {
+        mismatches += (converted[i] != reference_to_float<I, Bits>(values[i]));
+    }
+    WIFB_CHECK_EQUAL(mismatches, 0u);
+
+    /* Formats up to 24 bits are exact in float, so they come back unchanged */
+    if constexpr (Bits <= 24)
+    {
+        std::vector<I> restored(values.size());
+        float_to_int_batch<I, Bits>(restored.data(), converted.data(), values.size());
+        WIFB_CHECK(restored == values);
+    }
+}
+
+static void check_to_float()
+{
+    /* Every 8 and 16 bit sample */
+    std::vector<uint8_t> bytes;
+    for (int32_t v(0); v <= 0xFF; ++v) bytes.push_back(v);
+    check_to_float<uint8_t, 8>(bytes);
+
+    std::vector<int16_t> shorts;
+    for (int32_t v(INT16_MIN); v <= INT16_MAX; ++v) shorts.push_back(v);
+    check_to_float<int16_t, 16>(shorts);
+
+    /* Ends of the range and a seeded spread for wider samples */
+    std::vector<int32_t> int24 = {-8388608, -8388607, -1, 0, 1, 8388606, 8388607};
+    std::vector<int32_t> int32 = {INT32_MIN, INT32_MIN + 1, -1, 0, 1, INT32_MAX - 1, INT32_MAX};
+    uint32_t seed(24);
+    for (int_fast32_t i(0); i < 100003; ++i)
+    {
+        seed = (seed * 1664525) + 1013904223;
+        int24.push_back(static_cast<int32_t>(seed) >> 8);
+        int32.push_back(static_cast<int32_t>(seed));
+    }
+    check_to_float<int32_t, 24>(int24);
+    check_to_float<int32_t, 32>(int32);
+}
+
+static void check_dither_statistics()
+{
+    /* A constant a quarter of an LSB above a step: undithered it
+    always rounds down, dithered it must average out to the value */
+    constexpr int_fast32_t length = (1 << 18);
+    const float value(static_cast<float>(100.25 / 32768.0));
+    std::vector<float> values(length, value);
+    std::vector<int16_t> converted(length);
+
+    float_to_int_batch<int16_t>(converted.data(), values.data(), length);
+    WIFB_CHECK_EQUAL(converted[0], 100);
+    WIFB_CHECK_EQUAL(converted[length - 1], 100);
+
+    TPDFDither dither;
+    float_to_int_batch<int16_t>(converted.data(), values.data(), length, &dither);
+
+    double sum(0.0), sumSquares(0.0);
+    int16_t lowest(INT16_MAX), highest(INT16_MIN);
+    for (int16_t sample: converted)
+    {
+        const double error(sample - 100.25);
+        sum += error;
+        sumSquares += error * error;
+        lowest = std::min(lowest, sample);
+        highest = std::max(highest, sample);
+    }
+    const double mean(sum / length), variance((sumSquares / length) - (mean * mean));
+
+    /* Triangular dither of +-1 LSB has variance 1/6; rounding adds 1/12 */
+    WIFB_CHECK(std::fabs(mean) < 0.01);
+    WIFB_CHECK(std::fabs(variance - 0.25) < 0.01);
+    WIFB_CHECK_EQUAL(lowest, 99);
+    WIFB_CHECK_EQUAL(highest, 101);
+}
+
+int main()
+{
+    for (bool dithered: {false, true})
+    {
+        check_to_int<uint8_t, 8>(dithered);
+        check_to_int<int16_t, 16>(dithered);
+        check_to_int<int32_t, 24>(dithered);
+        check_to_int<int32_t, 32>(dithered);
+    }
+    check_to_float();
+    check_dither_statistics();
+    return WIFB_TEST_RESULT();
+}
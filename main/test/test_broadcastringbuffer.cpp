@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "broadcastringbuffer.h"
+#include "wifbtest.h"
+
+/* Readers that fall behind an overwriting writer have their
+cursors snapped forward, which is counted as skipped; a chunk
+the writer reaches while it is being read still reaches the
+reader, and is counted as overrun instead.  A blocking writer
+instead stalls on the slowest reader until it reads or is
+removed.  Readers run at their own pace in either policy, and
+every sample is either read intact or accounted for. */
+
+static constexpr const int_fast32_t bufferLength = 8;
+static constexpr const int_fast8_t ringLength = 4;
+
+static constexpr const int_fast32_t threadedBufferLength = 64;
+static constexpr const int32_t numSamples = (1 << 18);
+
+static void write(Buffer::BroadcastRingBuffer<int16_t>& ring, int16_t* next, int_fast32_t length)
+{
+    for (int_fast32_t i(0); i < length; ++i, ++*next)
+    {
+        WIFB_CHECK_EQUAL(ring.write_samples(next, 1), 1);
+    }
+}
+
+static void check_overwrite()
+{
+    Buffer::BroadcastRingBuffer<int16_t> ring(
+            bufferLength,
+            ringLength,
+            Buffer::OVERWRITE_SLOWEST_READER
+        );
+    const int_fast8_t slow(ring.add_reader()), fast(ring.add_reader());
+    WIFB_CHECK(slow >= 0);
+    WIFB_CHECK(fast >= 0);
+
+    int16_t next(0);
+    int16_t* regions[2];
+    int_fast32_t lengths[2];
+    int16_t chunk[bufferLength];
+
+    /* The slow reader holds a chunk while the writer laps it */
+    write(ring, &next, bufferLength * 2);
+    WIFB_CHECK_EQUAL(+ring.get_read_regions(slow, bufferLength, regions, lengths), 1);
+    WIFB_CHECK_EQUAL(regions[0][0], 0);
+    write(ring, &next, bufferLength * 2);
+    ring.report_read_samples(slow, bufferLength);
+    WIFB_CHECK_EQUAL(ring.overrun(slow), bufferLength);
+    WIFB_CHECK_EQUAL(ring.skipped(slow), 0);
+    WIFB_CHECK_EQUAL(ring.overrun(slow), 0);
+
+    /* Falling further behind moves its cursor past unread buffers */
+    write(ring, &next, bufferLength * 2);
+    WIFB_CHECK_EQUAL(ring.buffered(slow), (bufferLength * (ringLength - 1)));
+    WIFB_CHECK_EQUAL(ring.skipped(slow), bufferLength * 2);
+    WIFB_CHECK_EQUAL(ring.overrun(slow), 0);
+    WIFB_CHECK_EQUAL(ring.read_samples(slow, chunk, bufferLength), bufferLength);
+    WIFB_CHECK_EQUAL(chunk[0], bufferLength * 3);
+
+    /* Once caught up, a reader that keeps up sees neither */
+    while (ring.buffered(fast)) ring.read_samples(fast, chunk, bufferLength);
+    ring.skipped(fast);
+    ring.overrun(fast);
+    write(ring, &next, bufferLength);
+    WIFB_CHECK_EQUAL(ring.read_samples(fast, chunk, bufferLength), bufferLength);
+    WIFB_CHECK_EQUAL(chunk[bufferLength - 1], next - 1);
+    WIFB_CHECK_EQUAL(ring.skipped(fast), 0);
+    WIFB_CHECK_EQUAL(ring.overrun(fast), 0);
+}
+
+static void check_reader_limit()
+{
+    Buffer::BroadcastRingBuffer<int16_t> ring(bufferLength, ringLength);
+    std::vector<int_fast8_t> readers;
+    for (int_fast8_t i(0); i < RINGBUFF_MAX_READERS; ++i) readers.push_back(ring.add_reader());
+    for (int_fast8_t i(0); i < RINGBUFF_MAX_READERS; ++i) WIFB_CHECK_EQUAL(+readers[i], +i);
+    WIFB_CHECK_EQUAL(+ring.num_readers(), RINGBUFF_MAX_READERS);
+    WIFB_CHECK_EQUAL(+ring.add_reader(), +Buffer::READER_LIMIT_REACHED);
+
+    /* Every reader sees every sample */
+    int16_t chunk[bufferLength];
+    for (int_fast32_t i(0); i < bufferLength; ++i) chunk[i] = static_cast<int16_t>(i + 100);
+    WIFB_CHECK_EQUAL(ring.write_samples(chunk, bufferLength), bufferLength);
+    uint32_t mismatches(0);
+    for (const int_fast8_t reader: readers)
+    {
+        int16_t read[bufferLength];
+        mismatches += (ring.read_samples(reader, read, bufferLength) != bufferLength);
+        for (int_fast32_t i(0); i < bufferLength; ++i) mismatches += (read[i] != (i + 100));
+    }
+    WIFB_CHECK_EQUAL(mismatches, 0u);
+
+    /* A freed slot is reused, and its reader starts at the live edge */
+    ring.remove_reader(readers[3]);
+    WIFB_CHECK_EQUAL(+ring.num_readers(), RINGBUFF_MAX_READERS - 1);
+    WIFB_CHECK_EQUAL(+ring.add_reader(), 3);
+    WIFB_CHECK_EQUAL(ring.buffered(3), 0);
+    WIFB_CHECK_EQUAL(+ring.add_reader(), +Buffer::READER_LIMIT_REACHED);
+}
+
+static std::atomic_bool woken(false);
+static std::chrono::steady_clock::duration wokenAfter;
+
+/* Waits well past any test's patience, so a writer
+that is never notified shows up in wokenAfter */
+static void wait_writable(Buffer::BroadcastRingBuffer<int16_t>& ring, int_fast32_t length)
+{
+    woken.store(false);
+    const auto start(std::chrono::steady_clock::now());
+    const bool writable(ring.wait_writable(length, 3000));
+    wokenAfter = std::chrono::steady_clock::now() - start;
+    woken.store(writable);
+}
+
+static void check_block()
+{
+    Buffer::BroadcastRingBuffer<int16_t> ring(bufferLength, ringLength);
+    const int_fast8_t slow(ring.add_reader()), fast(ring.add_reader());
+    const int_fast32_t ringSize(bufferLength * ringLength);
+    int16_t next(0);
+    int16_t chunk[bufferLength];
+
+    /* The fast reader keeps up, the slow one holds the writer */
+    while (ring.available())
+    {
+        write(ring, &next, bufferLength);
+        WIFB_CHECK_EQUAL(ring.read_samples(fast, chunk, bufferLength), bufferLength);
+    }
+    WIFB_CHECK_EQUAL(next, ringSize);
+    WIFB_CHECK_EQUAL(ring.write_samples(chunk, bufferLength), 0);
+    WIFB_CHECK(!ring.wait_writable(bufferLength, 0));
+    WIFB_CHECK_EQUAL(ring.read_samples(slow, chunk, bufferLength), bufferLength);
+    WIFB_CHECK_EQUAL(ring.available(), bufferLength);
+    WIFB_CHECK_EQUAL(ring.skipped(slow), 0);
+
+    /* A stalled writer wakes when the slowest reader reads */
+    write(ring, &next, bufferLength);
+    std::thread writer(wait_writable, std::ref(ring), bufferLength);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    WIFB_CHECK(!woken.load());
+    WIFB_CHECK_EQUAL(ring.read_samples(slow, chunk, bufferLength), bufferLength);
+    writer.join();
+    WIFB_CHECK(woken.load());
+    WIFB_CHECK(wokenAfter < std::chrono::milliseconds(1000));
+    WIFB_CHECK_EQUAL(chunk[0], bufferLength);
+
+    /* Removing the slowest reader releases a stalled writer */
+    write(ring, &next, bufferLength);
+    writer = std::thread(wait_writable, std::ref(ring), bufferLength * 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    WIFB_CHECK(!woken.load());
+    ring.remove_reader(slow);
+    writer.join();
+    WIFB_CHECK(woken.load());
+    WIFB_CHECK(wokenAfter < std::chrono::milliseconds(1000));
+    WIFB_CHECK_EQUAL(ring.available(), ringSize - ring.buffered(fast));
+}
+
+struct ReaderResult
+{
+    int32_t read{0};
+    int32_t skipped{0};
+    int32_t overrun{0};
+    uint32_t mismatches{0};
+};
+
+/* Reads counting samples in whole buffers, pausing for delayUs
+between them, until the writer's last sample is accounted for */
+static void read_counting(
+        Buffer::BroadcastRingBuffer<int32_t>& ring,
+        int_fast8_t reader,
+        int_fast32_t delayUs,
+        ReaderResult* result
+    )
+{
+    std::vector<int32_t> chunk(threadedBufferLength);
+    int32_t expected(0);
+    while (expected < numSamples)
+    {
+        if (!ring.wait_readable(reader, threadedBufferLength, 5000)) break;
+        const int_fast32_t length(ring.read_samples(reader, chunk.data(), threadedBufferLength));
+        const int_fast32_t skipped(ring.skipped(reader)), overrun(ring.overrun(reader));
+        expected += skipped;
+        result->skipped += skipped;
+        result->overrun += overrun;
+        result->read += length;
+
+        /* An overrun chunk may be torn, but everything else is in order */
+        if (!overrun)
+        {
+            for (int_fast32_t i(0); i < length; ++i) result->mismatches += (chunk[i] != (expected + i));
+        }
+        expected += length;
+        if (delayUs) std::this_thread::sleep_for(std::chrono::microseconds(delayUs));
+    }
+}
+
+static void check_threaded(Buffer::broadcast_policy policy)
+{
+    Buffer::BroadcastRingBuffer<int32_t> ring(threadedBufferLength, ringLength, policy);
+    const int_fast32_t delays[] = {0, 1, 20};
+    constexpr int_fast8_t numReaders = sizeof(delays) / sizeof(delays[0]);
+    ReaderResult results[numReaders];
+    std::vector<std::thread> threads;
+    for (int_fast8_t r(0); r < numReaders; ++r)
+    {
+        const int_fast8_t reader(ring.add_reader());
+        threads.emplace_back(read_counting, std::ref(ring), reader, delays[r], &results[r]);
+    }
+
+    /* Chunks straddle buffer boundaries */
+    std::vector<int32_t> chunk(threadedBufferLength);
+    const int_fast32_t chunkLength((threadedBufferLength * 3) / 4);
+    int32_t next(0);
+    while (next < numSamples)
+    {
+        const int_fast32_t length(std::min<int_fast32_t>(chunkLength, numSamples - next));
+        if (!ring.wait_writable(length, 5000)) break;
+        for (int_fast32_t i(0); i < length; ++i) chunk[i] = next + i;
+        next += ring.write_samples(chunk.data(), length);
+    }
+    WIFB_CHECK_EQUAL(next, numSamples);
+    for (std::thread& thread: threads) thread.join();
+
+    for (const ReaderResult& result: results)
+    {
+        WIFB_CHECK_EQUAL(result.mismatches, 0u);
+        WIFB_CHECK_EQUAL(result.read + result.skipped, numSamples);
+        WIFB_CHECK(result.overrun <= result.read);
+        if (policy == Buffer::BLOCK_ON_SLOWEST_READER)
+        {
+            WIFB_CHECK_EQUAL(result.skipped, 0);
+            WIFB_CHECK_EQUAL(result.overrun, 0);
+        }
+    }
+
+    /* The slowest reader cannot keep up with an overwriting writer */
+    if (policy == Buffer::OVERWRITE_SLOWEST_READER) WIFB_CHECK(results[numReaders - 1].skipped > 0);
+}
+
+int main()
+{
+    check_overwrite();
+    check_reader_limit();
+    check_block();
+    check_threaded(Buffer::BLOCK_ON_SLOWEST_READER);
+    check_threaded(Buffer::OVERWRITE_SLOWEST_READER);
+    return WIFB_TEST_RESULT();
+}
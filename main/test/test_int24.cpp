@@ -0,0 +1,169 @@
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "batchconversions.h"
+#include "broadcastringbuffer.h"
+#include "int24.h"
+#include "ringbuffer.h"
+#include "wifbtest.h"
+
+/* Packed 24 bit samples must survive every leg of the path: the
+sample type itself over its whole range, the pack and unpack
+kernels for right justified and i2s slot layouts at every tail
+length, float conversion, and the transmit and receive rings,
+whose bytes are the wire format at three bytes per sample. */
+
+static constexpr const int32_t numValues = (1 << 24);
+
+/* Every 24 bit value in a seeded order, so neighbours differ in every byte */
+static int32_t value_at(int32_t index)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(index * 0x9E3779B1) << 8) >> 8;
+}
+
+static void check_sample_type()
+{
+    uint32_t mismatches(0);
+    for (int32_t value(Int24::minimum); value <= Int24::maximum; ++value)
+    {
+        const Int24 sample(value);
+        uint8_t bytes[3];
+        std::memcpy(bytes, &sample, sizeof(bytes));
+        mismatches += (static_cast<int32_t>(sample) != value);
+        mismatches += (bytes[0] != static_cast<uint8_t>(value));
+        mismatches += (bytes[1] != static_cast<uint8_t>(value >> 8));
+        mismatches += (bytes[2] != static_cast<uint8_t>(value >> 16));
+    }
+    WIFB_CHECK_EQUAL(mismatches, 0u);
+
+    /* Values past 24 bits wrap */
+    WIFB_CHECK_EQUAL(static_cast<int32_t>(Int24(Int24::maximum + 1)), Int24::minimum);
+    WIFB_CHECK_EQUAL(static_cast<int32_t>(Int24(0x12345678)), 0x345678);
+    WIFB_CHECK_EQUAL(static_cast<int32_t>(std::numeric_limits<Int24>::max()), Int24::maximum);
+    WIFB_CHECK_EQUAL(static_cast<int32_t>(std::numeric_limits<Int24>::min()), Int24::minimum);
+}
+
+static void check_kernels()
+{
+    /* Every value passes through in chunks of every tail
+    length, packed at every offset from a word boundary */
+    std::vector<int32_t> values(64), slots(64), restored(64);
+    std::vector<Int24> packed(64 + 3), reference(64);
+    uint32_t mismatches(0);
+    int32_t index(0);
+    for (int_fast32_t length(1); index < numValues; length = 1 + (length % 63))
+    {
+        const int_fast32_t offset(index % 4);
+        for (int_fast32_t i(0); i < length; ++i)
+        {
+            values[i] = value_at(index + i);
+            slots[i] = static_cast<int32_t>(static_cast<uint32_t>(values[i]) << 8) | (i & 0xFF);
+            reference[i] = values[i];
+        }
+        index += length;
+
+        pack_int24(packed.data() + offset, values.data(), length);
+        mismatches += (std::memcmp(packed.data() + offset, reference.data(), length * 3) != 0);
+        unpack_int24(restored.data(), packed.data() + offset, length);
+        mismatches += (std::memcmp(restored.data(), values.data(), length * 4) != 0);
+
+        /* The low byte of an i2s slot is padding and is dropped */
+        pack_int24_slots(packed.data() + offset, slots.data(), length);
+        mismatches += (std::memcmp(packed.data() + offset, reference.data(), length * 3) != 0);
+        unpack_int24_slots(restored.data(), packed.data() + offset, length);
+        for (int_fast32_t i(0); i < length; ++i)
+        {
+            mismatches += (restored[i] != (slots[i] & ~0xFF));
+        }
+    }
+    WIFB_CHECK_EQUAL(mismatches, 0u);
+}
+
+static void check_conversions()
+{
+    /* Packed conversion matches 32 bit containers, including dither
+    carried across the staging passes of a long batch */
+    constexpr int_fast32_t length = 5000;
+    std::vector<float> values(length), floats(length), expected(length);
+    std::vector<int32_t> wide(length);
+    std::vector<Int24> packed(length);
+    uint32_t seed(22);
+    for (float& value: values)
+    {
+        seed = (seed * 1664525) + 1013904223;
+        value = (static_cast<float>(seed >> 8) / 8388608.0f) * 2.5f - 1.25f;
+    }
+
+    for (bool dithered: {false, true})
+    {
+        TPDFDither packedDither(7), wideDither(7);
+        float_to_int_batch<Int24, 24>(packed.data(), values.data(), length, dithered ? &packedDither : nullptr);
+        float_to_int_batch<int32_t, 24>(wide.data(), values.data(), length, dithered ? &wideDither : nullptr);
+        uint32_t mismatches(0);
+        for (int_fast32_t i(0); i < length; ++i) mismatches += (packed[i] != wide[i]);
+        WIFB_CHECK_EQUAL(mismatches, 0u);
+    }
+
+    int_to_float_batch<Int24, 24>(floats.data(), packed.data(), length);
+    int_to_float_batch<int32_t, 24>(expected.data(), wide.data(), length);
+    WIFB_CHECK(floats == expected);
+
+    /* 24 bits are exact in float, so samples round trip */
+    std::vector<Int24> restored(length);
+    float_to_int_batch<Int24, 24>(restored.data(), floats.data(), length);
+    WIFB_CHECK(std::memcmp(restored.data(), packed.data(), length * 3) == 0);
+}
+
+static void check_wire()
+{
+    /* A transmit ring's bytes are sent as is and written
+    into a receive ring at the other end */
+    constexpr int_fast32_t bufferLength = 96;
+    constexpr int_fast8_t ringLength = 4;
+    Buffer::BroadcastRingBuffer<Int24> transmit(bufferLength, ringLength);
+    Buffer::AtomicRingBuffer<Int24> receive(bufferLength, ringLength);
+    const int_fast8_t client(transmit.add_reader());
+
+    WIFB_CHECK_EQUAL(transmit.bytes_per_sample(), 3);
+    WIFB_CHECK_EQUAL(transmit.bytes_per_buffer(), bufferLength * 3);
+    WIFB_CHECK_EQUAL(receive.bytes_per_sample(), 3);
+    WIFB_CHECK_EQUAL(receive.total_size(), bufferLength * ringLength * 3);
+
+    Int24 chunk[bufferLength];
+    uint8_t wire[bufferLength * 3];
+    int32_t next(0), expected(0);
+    uint32_t mismatches(0);
+    for (int_fast32_t step(0); step < 1000; ++step)
+    {
+        for (Int24& sample: chunk) sample = value_at(next++);
+        WIFB_CHECK_EQUAL(transmit.write_samples(chunk, bufferLength), bufferLength);
+
+        const int_fast32_t numBytes(transmit.read_bytes(client, wire, sizeof(wire)));
+        WIFB_CHECK_EQUAL(numBytes, bufferLength * 3);
+        for (int_fast32_t i(0); i < bufferLength; ++i)
+        {
+            /* Little endian, three bytes per sample, no padding */
+            const int32_t value(value_at(expected + i));
+            mismatches += (wire[i * 3] != static_cast<uint8_t>(value));
+            mismatches += (wire[(i * 3) + 2] != static_cast<uint8_t>(value >> 16));
+        }
+
+        WIFB_CHECK_EQUAL(receive.write_bytes(wire, numBytes), numBytes);
+        const int_fast32_t numRead(receive.read(std::span<Int24>(chunk, bufferLength)));
+        WIFB_CHECK_EQUAL(numRead, bufferLength);
+        for (int_fast32_t i(0); i < numRead; ++i) mismatches += (chunk[i] != value_at(expected++));
+    }
+    WIFB_CHECK_EQUAL(mismatches, 0u);
+}
+
+int main()
+{
+    check_sample_type();
+    check_kernels();
+    check_conversions();
+    check_wire();
+    return WIFB_TEST_RESULT();
+}
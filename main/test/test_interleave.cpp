@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "interleave.h"
+#include "multibuffer.h"
+#include "wifbtest.h"
+
+/* The block kernels must agree bit for bit with a plain strided
+copy for every type, channel count and length, including lengths
+short of a register and pointers off any alignment, and frames
+moved through a MultiRingBuffer must come back in order whether
+or not a block crosses the end of a sub buffer. */
+
+static constexpr const int_fast32_t lengths[] = {0, 1, 2, 3, 7, 8, 15, 16, 17, 31, 33, 64, 100};
+
+template <typename T>
+static T pattern(uint32_t seed)
+{
+    /* Every byte varies, so misplaced lanes show */
+    const uint64_t bits(static_cast<uint64_t>(seed) * 0x9E3779B97F4A7C15ull);
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+template <typename T>
+static bool same_bits(const T* a, const T* b, int_fast32_t length)
+{
+    return (std::memcmp(a, b, length * sizeof(T)) == 0);
+}
+
+template <typename T>
+static void check_kernels(int_fast8_t numChannels, int_fast32_t length, int_fast8_t offset)
+{
+    /* One spare sample in front of each array for misalignment */
+    std::vector<std::vector<T>> channels(numChannels, std::vector<T>(length + 1));
+    std::vector<std::vector<T>> split(numChannels, std::vector<T>(length + 1));
+    std::vector<T> reference(numChannels * length), interleaved((numChannels * length) + 1);
+    const T* inputs[16];
+    T* outputs[16];
+
+    uint32_t seed(1 + (numChannels * 1000) + length);
+    for (int_fast8_t c(0); c < numChannels; ++c)
+    {
+        for (T& sample: channels[c]) sample = pattern<T>(seed++);
+        inputs[c] = channels[c].data() + offset;
+        outputs[c] = split[c].data() + offset;
+        for (int_fast32_t i(0); i < length; ++i)
+        {
+            reference[(i * numChannels) + c] = inputs[c][i];
+        }
+    }
+
+    Buffer::interleave<T>(interleaved.data() + offset, inputs, numChannels, length);
+    WIFB_CHECK(same_bits(interleaved.data() + offset, reference.data(), numChannels * length));
+
+    Buffer::deinterleave<T>(outputs, reference.data(), numChannels, length);
+    for (int_fast8_t c(0); c < numChannels; ++c)
+    {
+        WIFB_CHECK(same_bits(outputs[c], inputs[c], length));
+    }
+}
+
+template <typename T>
+static void check_kernels()
+{
+    for (int_fast8_t numChannels(1); numChannels <= 9; ++numChannels)
+    {
+        for (int_fast32_t length: lengths)
+        {
+            check_kernels<T>(numChannels, length, 0);
+            check_kernels<T>(numChannels, length, 1);
+        }
+    }
+}
+
+template <typename T>
+static void check_ring(int_fast8_t numChannels)
+{
+    constexpr int_fast32_t bufferLength = 16;
+    Buffer::AtomicMultiRingBuffer<T> ring(bufferLength, 4, numChannels);
+
+    std::vector<T> staged(bufferLength * 3 * numChannels), read(bufferLength * numChannels);
+    uint32_t next(0), expected(0), errors(0), step(0);
+    while (expected < 2000)
+    {
+        /* Chunks of 1 to 40 frames, so blocks keep
+        straddling the ends of sub buffers */
+        const int_fast32_t frames(1 + ((++step * 13) % 40));
+        for (int_fast32_t i(0); i < frames; ++i)
+        {
+            for (int_fast8_t c(0); c < numChannels; ++c)
+            {
+                staged[(i * numChannels) + c] = pattern<T>(((next + i) * 16) + c);
+            }
+        }
+        const int_fast32_t written(ring.write_samples_interleaved(
+                staged.data(),
+                frames * numChannels
+            ));
+        WIFB_CHECK_EQUAL(written % numChannels, 0);
+        next += written / numChannels;
+
+        const int_fast32_t numRead(std::min(ring.buffered(), bufferLength));
+        ring.read_samples_interleaved(read.data(), numRead * numChannels);
+        for (int_fast32_t i(0); i < numRead; ++i, ++expected)
+        {
+            for (int_fast8_t c(0); c < numChannels; ++c)
+            {
+                const T value(pattern<T>((expected * 16) + c));
+                errors += !same_bits(&read[(i * numChannels) + c], &value, 1);
+            }
+        }
+    }
+    WIFB_CHECK_EQUAL(errors, 0u);
+}
+
+int main()
+{
+    check_kernels<uint8_t>();
+    check_kernels<int16_t>();
+    check_kernels<int32_t>();
+    check_kernels<float>();
+    check_kernels<int_fast64_t>();
+    check_kernels<double>();
+
+    for (int_fast8_t numChannels: {2, 3, 4, 8})
+    {
+        check_ring<int16_t>(numChannels);
+        check_ring<int32_t>(numChannels);
+        check_ring<float>(numChannels);
+    }
+
+    return WIFB_TEST_RESULT();
+}
@@ -0,0 +1,261 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "jitterbuffer.h"
+#include "wifbtest.h"
+
+/* Arrival traces are replayed against the jitter buffer on a
+simulated clock.  The buffer takes time only from its caller,
+so a trace always produces the same output and statistics. */
+
+static constexpr const int_fast32_t frameLength = 4;
+static constexpr const int_fast32_t sampleRate = 8000;
+static constexpr const int64_t framePeriodUs = (
+        (frameLength * 1000000) / sampleRate
+    );
+static constexpr const uint8_t silence = 0x80;
+
+struct Arrival
+{
+    int64_t timeUs;
+    uint32_t sequence;
+};
+
+struct Replay
+{
+    /* Every frame pulled, one after another */
+    std::vector<uint8_t> output;
+
+    /* When each frame was pulled */
+    std::vector<int64_t> pullTimesUs;
+
+    Buffer::JitterStats stats;
+};
+
+/* Audio of a frame identifies its sequence and is never silence */
+static void make_frame(uint8_t* frame, uint32_t sequence)
+{
+    for (int_fast32_t i(0); i < frameLength; ++i)
+    {
+        frame[i] = static_cast<uint8_t>(1 + (((sequence * frameLength) + i) % 97));
+    }
+}
+
+static bool is_frame(const uint8_t* frame, uint32_t sequence)
+{
+    uint8_t expected[frameLength];
+    make_frame(expected, sequence);
+    return std::equal(frame, frame + frameLength, expected);
+}
+
+static bool is_silence(const uint8_t* frame)
+{
+    return std::all_of(frame, frame + frameLength, [](uint8_t sample) {
+            return (sample == silence);
+        });
+}
+
+/* Steps the clock in stepUs increments up to endUs, inserting
+every arrival that is due and then pulling every frame that is */
+static Replay replay(
+        Buffer::JitterBuffer<uint8_t>& buffer,
+        const std::vector<Arrival>& trace,
+        int64_t endUs,
+        int64_t stepUs = 50
+    )
+{
+    Replay result;
+    uint8_t frame[frameLength];
+    size_t next(0);
+    for (int64_t now(0); now <= endUs; now += stepUs)
+    {
+        for (; (next < trace.size()) && (trace[next].timeUs <= now); ++next)
+        {
+            make_frame(frame, trace[next].sequence);
+            buffer.insert(
+                    trace[next].sequence,
+                    trace[next].sequence * frameLength,
+                    frame,
+                    frameLength,
+                    now
+                );
+        }
+        const uint8_t* pulled;
+        while ((pulled = buffer.pull(now)))
+        {
+            result.output.insert(result.output.end(), pulled, pulled + frameLength);
+            result.pullTimesUs.push_back(now);
+        }
+    }
+    result.stats = buffer.stats();
+    return result;
+}
+
+static Buffer::JitterBuffer<uint8_t> make_fixed_buffer()
+{
+    Buffer::JitterBuffer<uint8_t> buffer(frameLength, 8, sampleRate);
+    buffer.set_adaptive(false);
+    buffer.set_target_depth_ms(1);
+    return buffer;
+}
+
+static void check_reorder_duplicate_late_and_loss()
+{
+    /* Frame 1 arrives after 2 and twice, 3 arrives after
+    its playout time and everything else is on time */
+    const std::vector<Arrival> trace = {
+            {0, 0},
+            {1000, 2},
+            {1100, 1},
+            {1150, 1},
+            {2000, 4},
+            {2600, 3},
+        };
+    Buffer::JitterBuffer<uint8_t> buffer(make_fixed_buffer());
+    const Replay result(replay(buffer, trace, 3000));
+
+    WIFB_CHECK_EQUAL(result.pullTimesUs.size(), 5u);
+    if (result.pullTimesUs.size() != 5) return;
+
+    /* Each frame plays a fixed delay after its nominal arrival */
+    for (size_t i(0); i < result.pullTimesUs.size(); ++i)
+    {
+        WIFB_CHECK_EQUAL(
+                result.pullTimesUs[i],
+                1000 + (static_cast<int64_t>(i) * framePeriodUs)
+            );
+    }
+    const uint8_t* frames(result.output.data());
+    WIFB_CHECK(is_frame(frames, 0));
+    WIFB_CHECK(is_frame(frames + frameLength, 1));
+    WIFB_CHECK(is_frame(frames + (2 * frameLength), 2));
+    WIFB_CHECK(is_silence(frames + (3 * frameLength)));
+    WIFB_CHECK(is_frame(frames + (4 * frameLength), 4));
+
+    WIFB_CHECK_EQUAL(result.stats.received, 4u);
+    WIFB_CHECK_EQUAL(result.stats.played, 4u);
+    WIFB_CHECK_EQUAL(result.stats.concealed, 1u);
+    WIFB_CHECK_EQUAL(result.stats.late, 1u);
+    WIFB_CHECK_EQUAL(result.stats.duplicated, 1u);
+    WIFB_CHECK_EQUAL(result.stats.lost, 0u);
+    WIFB_CHECK_EQUAL(result.stats.depth, 0);
+}
+
+static void check_repeat_then_silence()
+{
+    /* Two frames go missing; the first repeats the last
+    frame played and the second falls back to silence */
+    const std::vector<Arrival> trace = {{0, 0}, {1500, 3}};
+    Buffer::JitterBuffer<uint8_t> buffer(make_fixed_buffer());
+    buffer.set_concealment(Buffer::CONCEAL_REPEAT_LAST, 1);
+    const Replay result(replay(buffer, trace, 2500));
+
+    WIFB_CHECK_EQUAL(result.pullTimesUs.size(), 4u);
+    if (result.pullTimesUs.size() != 4) return;
+
+    const uint8_t* frames(result.output.data());
+    WIFB_CHECK(is_frame(frames, 0));
+    WIFB_CHECK(is_frame(frames + frameLength, 0));
+    WIFB_CHECK(is_silence(frames + (2 * frameLength)));
+    WIFB_CHECK(is_frame(frames + (3 * frameLength), 3));
+    WIFB_CHECK_EQUAL(result.stats.lost, 2u);
+}
+
+static void check_silence_is_the_midpoint()
+{
+    /* Unsigned samples are silent at half their range */
+    Buffer::JitterBuffer<uint8_t> buffer(make_fixed_buffer());
+    const Replay result(replay(buffer, {{0, 0}}, 2000));
+    WIFB_CHECK_EQUAL(result.pullTimesUs.size(), 3u);
+    for (size_t i(1); i < result.pullTimesUs.size(); ++i)
+    {
+        WIFB_CHECK(is_silence(result.output.data() + (i * frameLength)));
+    }
+
+    Buffer::JitterBuffer<int16_t> signedBuffer(frameLength, 8, sampleRate);
+    signedBuffer.set_adaptive(false);
+    const int16_t audio[frameLength] = {1, 2, 3, 4};
+    signedBuffer.insert(0, 0, audio, frameLength, 0);
+    WIFB_CHECK(signedBuffer.pull(framePeriodUs) != nullptr);
+    const int16_t* concealed(signedBuffer.pull(2 * framePeriodUs));
+    WIFB_CHECK(concealed != nullptr);
+    if (concealed) WIFB_CHECK(std::all_of(concealed, concealed + frameLength, [](int16_t sample) {
+            return !sample;
+        }));
+}
+
+/* Trace of a sender on a jittery, lossy network; frames are sent
+every period and arrive after a random delay, so some arrive out
+of order, some twice and some not at all */
+static std::vector<Arrival> make_network_trace(uint32_t seed, uint32_t numFrames)
+{
+    std::vector<Arrival> trace;
+    for (uint32_t sequence(0); sequence < numFrames; ++sequence)
+    {
+        seed = (seed * 1664525) + 1013904223;
+        if ((seed >> 28) == 0) continue;
+        const int64_t sentUs(sequence * framePeriodUs);
+        trace.push_back({sentUs + 2000 + ((seed >> 8) % 1500), sequence});
+        if ((seed >> 24) == 0x11)
+        {
+            trace.push_back({sentUs + 2500 + ((seed >> 4) % 1500), sequence});
+        }
+    }
+    std::stable_sort(trace.begin(), trace.end(), [](const Arrival& a, const Arrival& b) {
+            return (a.timeUs < b.timeUs);
+        });
+    return trace;
+}
+
+static void check_network_trace_replays_exactly()
+{
+    const uint32_t numFrames(4000);
+    const std::vector<Arrival> trace(make_network_trace(12345, numFrames));
+    const int64_t endUs(trace.back().timeUs + 1000);
+
+    Buffer::JitterBuffer<uint8_t> first(frameLength, 16, sampleRate);
+    Buffer::JitterBuffer<uint8_t> second(frameLength, 16, sampleRate);
+    const Replay a(replay(first, trace, endUs)), b(replay(second, trace, endUs));
+
+    WIFB_CHECK(a.output == b.output);
+    WIFB_CHECK(a.pullTimesUs == b.pullTimesUs);
+    WIFB_CHECK_EQUAL(a.stats.received, b.stats.received);
+    WIFB_CHECK_EQUAL(a.stats.played, b.stats.played);
+    WIFB_CHECK_EQUAL(a.stats.concealed, b.stats.concealed);
+    WIFB_CHECK_EQUAL(a.stats.late, b.stats.late);
+    WIFB_CHECK_EQUAL(a.stats.duplicated, b.stats.duplicated);
+    WIFB_CHECK_EQUAL(a.stats.targetDepthUs, b.stats.targetDepthUs);
+    WIFB_CHECK_EQUAL(a.stats.jitterUs, b.stats.jitterUs);
+
+    /* Every pulled frame is either the next frame in sequence,
+    counting from the first to arrive, or silence in its place */
+    const uint32_t firstSequence(trace.front().sequence);
+    const size_t numPulled(a.pullTimesUs.size());
+    WIFB_CHECK_EQUAL(numPulled, a.stats.played + a.stats.concealed);
+    uint_fast32_t played(0), outOfOrder(0);
+    for (size_t i(0); i < numPulled; ++i)
+    {
+        const uint8_t* frame(a.output.data() + (i * frameLength));
+        if (is_frame(frame, firstSequence + i)) ++played;
+        else if (!is_silence(frame)) ++outOfOrder;
+    }
+    WIFB_CHECK_EQUAL(played, a.stats.played);
+    WIFB_CHECK_EQUAL(outOfOrder, 0u);
+    WIFB_CHECK_EQUAL(a.stats.resynced, 0u);
+
+    /* The delay adapted to the jitter, so few frames missed playout */
+    WIFB_CHECK(a.stats.jitterUs > 0);
+    WIFB_CHECK(a.stats.targetDepthUs > framePeriodUs);
+    WIFB_CHECK(a.stats.played > ((numFrames * 9) / 10));
+    WIFB_CHECK(a.stats.duplicated > 0);
+}
+
+int main()
+{
+    check_reorder_duplicate_late_and_loss();
+    check_repeat_then_silence();
+    check_silence_is_the_midpoint();
+    check_network_trace_replays_exactly();
+    return WIFB_TEST_RESULT();
+}
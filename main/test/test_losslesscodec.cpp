@@ -0,0 +1,250 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "batchconversions.h"
+#include "oscillator.h"
+#include "wifbcodec.h"
+#include "wifbtest.h"
+
+/* Every chunk must decode to exactly the pcm it was encoded from,
+at every sample width and channel count, from one ring region or
+two, and never grow past max_encoded_size.  Tones must shrink.
+Payloads come off the network, so the decoder is also fed every
+truncation and bit flip of valid payloads and random bytes.  It
+must reject them, or decode them to at most the pcm its header
+declares, and never write past its output. */
+
+enum signal
+{
+    SILENCE,
+    TONE,
+    NOISY_TONE,
+    WHITE,
+    EXTREMES,
+};
+
+static uint32_t seed(1);
+
+static float noise()
+{
+    seed = (seed * 1664525) + 1013904223;
+    return (static_cast<float>(seed >> 8) / 8388608.0f) - 1.0f;
+}
+
+/* Interleaved little endian pcm of numFrames frames */
+template <typename I>
+static std::vector<uint8_t> make_pcm(signal kind, int_fast32_t numFrames, uint8_t channels)
+{
+    const int_fast32_t numSamples(numFrames * channels);
+    std::vector<float> values(numSamples);
+    Osc::OscillatorBase<float> osc;
+    osc.set_sample_rate(48000);
+    osc.set_frequency(1000);
+    osc.scale = 0.5f;
+    for (int_fast32_t i(0); i < numSamples; i += channels)
+    {
+        float tone;
+        osc.get(&tone, 1);
+        for (uint8_t c(0); c < channels; ++c)
+        {
+            switch (kind)
+            {
+                case SILENCE: values[i + c] = 0.0f; break;
+                case TONE: values[i + c] = tone; break;
+                case NOISY_TONE: values[i + c] = tone + (noise() * 0.001f); break;
+                case WHITE: values[i + c] = noise(); break;
+                default: values[i + c] = ((i / channels) & 1) ? 1.0f : -1.0f;
+            }
+        }
+    }
+
+    std::vector<uint8_t> pcm(numSamples * sizeof(I));
+    float_to_int_batch<I>(reinterpret_cast<I*>(pcm.data()), values.data(), numSamples);
+    return pcm;
+}
+
+static std::vector<uint8_t> make_pcm(
+        signal kind,
+        int_fast32_t numFrames,
+        uint8_t bitsPerSample,
+        uint8_t channels
+    )
+{
+    switch (bitsPerSample)
+    {
+        case 8: return make_pcm<uint8_t>(kind, numFrames, channels);
+        case 16: return make_pcm<int16_t>(kind, numFrames, channels);
+        case 24: return make_pcm<Int24>(kind, numFrames, channels);
+        default: return make_pcm<int32_t>(kind, numFrames, channels);
+    }
+}
+
+/* Encodes pcm, split in two regions at split bytes if nonzero */
+static std::vector<uint8_t> encode(WIFBCodec& codec, std::vector<uint8_t>& pcm, int_fast32_t split)
+{
+    std::vector<uint8_t> encoded(codec.max_encoded_size(pcm.size()));
+    uint8_t* regions[2] = {pcm.data(), pcm.data() + split};
+    const int_fast32_t lengths[2] = {split, static_cast<int_fast32_t>(pcm.size()) - split};
+    const int_fast32_t length(
+            split
+            ? codec.encode(encoded.data(), regions, lengths, 2)
+            : codec.encode(encoded.data(), regions + 1, lengths + 1, 1)
+        );
+    WIFB_CHECK(length <= static_cast<int_fast32_t>(encoded.size()));
+    encoded.resize(length);
+    return encoded;
+}
+
+/* Decodes into output of exactly capacity bytes and checks the result
+is an error or a whole chunk within it */
+static int_fast32_t decode(WIFBCodec& codec, const std::vector<uint8_t>& encoded, int_fast32_t capacity)
+{
+    std::vector<uint8_t> payload(encoded), pcm(capacity);
+    const int_fast32_t rc(codec.decode(pcm.data(), capacity, payload.data(), payload.size()));
+    WIFB_CHECK(rc <= capacity);
+    return rc;
+}
+
+static void check_round_trips()
+{
+    uint32_t mismatches(0);
+    for (uint8_t bitsPerSample: {8, 16, 24, 32})
+    {
+        const int_fast32_t width(bitsPerSample / 8);
+        for (uint8_t channels: {1, 2, 3})
+        {
+            WIFBLosslessCodec codec(bitsPerSample, channels);
+            for (signal kind: {SILENCE, TONE, NOISY_TONE, WHITE, EXTREMES})
+            {
+                for (int_fast32_t numFrames: {0, 1, 2, 3, 4, 5, 17, 256, 1000})
+                {
+                    std::vector<uint8_t> pcm(make_pcm(kind, numFrames, bitsPerSample, channels));
+                    const int_fast32_t split(width * ((numFrames * channels) / 3));
+                    for (int_fast32_t at: {static_cast<int_fast32_t>(0), split})
+                    {
+                        const std::vector<uint8_t> encoded(encode(codec, pcm, at));
+                        WIFB_CHECK(
+                                static_cast<int_fast32_t>(encoded.size())
+                                <= static_cast<int_fast32_t>(pcm.size() + WIFB_CODEC_OVERHEAD(channels))
+                            );
+
+                        std::vector<uint8_t> decoded(pcm.size());
+                        const int_fast32_t rc(codec.decode(
+                                decoded.data(),
+                                decoded.size(),
+                                encoded.data(),
+                                encoded.size()
+                            ));
+                        mismatches += (rc != static_cast<int_fast32_t>(pcm.size()));
+                        mismatches += (decoded != pcm);
+                    }
+                }
+            }
+        }
+    }
+    WIFB_CHECK_EQUAL(mismatches, 0u);
+}
+
+static void check_ratios()
+{
+    /* Chunks of 256 stereo frames, as payload over pcm */
+    for (uint8_t bitsPerSample: {16, 24})
+    {
+        WIFBLosslessCodec codec(bitsPerSample, 2);
+        double ratios[EXTREMES + 1];
+        for (signal kind: {SILENCE, TONE, NOISY_TONE, WHITE, EXTREMES})
+        {
+            std::vector<uint8_t> pcm(make_pcm(kind, 256, bitsPerSample, 2));
+            ratios[kind] = static_cast<double>(encode(codec, pcm, 0).size()) / pcm.size();
+        }
+        std::cout << +bitsPerSample << " bit stereo compression ratios: silence " << ratios[SILENCE];
+        std::cout << ", tone " << ratios[TONE] << ", noisy tone " << ratios[NOISY_TONE];
+        std::cout << ", white " << ratios[WHITE] << ", extremes " << ratios[EXTREMES] << '\n';
+
+        WIFB_CHECK(ratios[SILENCE] < 0.1);
+        WIFB_CHECK(ratios[TONE] < ((bitsPerSample == 16) ? 0.4 : 0.6));
+        WIFB_CHECK(ratios[NOISY_TONE] < ((bitsPerSample == 16) ? 0.7 : 0.8));
+        WIFB_CHECK(ratios[WHITE] < 1.01);
+        WIFB_CHECK(ratios[EXTREMES] < 1.01);
+    }
+}
+
+static void check_malformed()
+{
+    for (uint8_t bitsPerSample: {8, 16, 24, 32})
+    {
+        const int_fast32_t width(bitsPerSample / 8);
+        WIFBLosslessCodec codec(bitsPerSample, 2);
+        for (signal kind: {TONE, NOISY_TONE, WHITE})
+        {
+            std::vector<uint8_t> pcm(make_pcm(kind, 64, bitsPerSample, 2));
+            const std::vector<uint8_t> valid(encode(codec, pcm, 0));
+            const int_fast32_t capacity(pcm.size());
+
+            /* Every truncation leaves part of a channel missing */
+            for (size_t length(0); length < valid.size(); ++length)
+            {
+                std::vector<uint8_t> truncated(valid.begin(), valid.begin() + length);
+                WIFB_CHECK(decode(codec, truncated, capacity) < 0);
+            }
+
+            /* Anything after the last channel is rejected */
+            std::vector<uint8_t> extended(valid);
+            extended.push_back(0);
+            WIFB_CHECK_EQUAL(decode(codec, extended, capacity), CODEC_MALFORMED_PAYLOAD);
+
+            /* Flipped bits either fail or decode to a whole chunk */
+            for (size_t bit(0); bit < (valid.size() * 8); ++bit)
+            {
+                std::vector<uint8_t> flipped(valid);
+                flipped[bit / 8] ^= static_cast<uint8_t>(1 << (bit % 8));
+                const int_fast32_t declared(width * 2 * (flipped[0] | (flipped[1] << 8)));
+                const int_fast32_t rc(decode(codec, flipped, capacity));
+                WIFB_CHECK((rc < 0) || (rc == declared));
+            }
+        }
+
+        /* More frames than the output holds */
+        std::vector<uint8_t> pcm(make_pcm(TONE, 64, bitsPerSample, 2));
+        const std::vector<uint8_t> valid(encode(codec, pcm, 0));
+        WIFB_CHECK_EQUAL(decode(codec, valid, pcm.size() - 1), CODEC_OUTPUT_TOO_SHORT);
+
+        /* Predictor orders and Rice parameters out of range */
+        std::vector<uint8_t> header = {4, 0, WIFB_LOSSLESS_MAX_ORDER + 1};
+        header.resize(64, 0);
+        WIFB_CHECK_EQUAL(decode(codec, header, 1024), CODEC_MALFORMED_PAYLOAD);
+        header = {4, 0, 0, 64, 0xFF, 0xFF};
+        WIFB_CHECK_EQUAL(decode(codec, header, 1024), CODEC_MALFORMED_PAYLOAD);
+
+        /* A residual that never ends, and one too long for the sample width */
+        header = {4, 0, 0, 0};
+        header.resize(4096, 0);
+        WIFB_CHECK_EQUAL(decode(codec, header, 1024), CODEC_MALFORMED_PAYLOAD);
+        header = {1, 0, 0, static_cast<uint8_t>((8 * width) + 5), 0x40};
+        header.resize(32, 0);
+        WIFB_CHECK_EQUAL(decode(codec, header, 1024), CODEC_MALFORMED_PAYLOAD);
+
+        /* Random payloads, with and without a plausible frame count */
+        for (int_fast32_t trial(0); trial < 2000; ++trial)
+        {
+            std::vector<uint8_t> payload(1 + (static_cast<uint32_t>(noise() * 100.0f + 100.0f)));
+            for (uint8_t& byte: payload) byte = static_cast<uint8_t>(noise() * 128.0f + 128.0f);
+            if (trial & 1)
+            {
+                payload[0] = static_cast<uint8_t>(trial % 40);
+                if (payload.size() > 1) payload[1] = 0;
+            }
+            decode(codec, payload, 40 * width * 2);
+        }
+    }
+}
+
+int main()
+{
+    check_round_trips();
+    check_ratios();
+    check_malformed();
+    return WIFB_TEST_RESULT();
+}
@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <span>
+
+#include "ringbuffer.h"
+#include "wifbtest.h"
+
+/* A producer that writes several times faster than its consumer
+reads, in bursts, through a ring that overwrites the oldest
+buffers.  The schedule comes from a seeded generator, so every
+run replays the same overruns.  Values are a counting sequence,
+so the gaps the reader sees are exactly what was dropped. */
+
+static constexpr const int_fast32_t bufferLength = 8;
+static constexpr const int_fast8_t ringLength = 4;
+static constexpr const int_fast32_t numSteps = 50000;
+
+struct Reader
+{
+    Buffer::AtomicRingBuffer<int32_t>& ring;
+    int32_t expected{0};
+    uint_fast32_t numRead{0}, gapSamples{0}, gapBuffers{0}, misaligned{0}, backwards{0};
+
+    void receive(const int32_t* samples, int_fast32_t length)
+    {
+        for (int_fast32_t i(0); i < length; ++i)
+        {
+            const int32_t value(samples[i]);
+            if (value < expected)
+            {
+                ++backwards;
+            }
+            else if (value > expected)
+            {
+                /* Readers skip to the start of a buffer, and every
+                buffer from the one being read up to it is dropped */
+                gapSamples += value - expected;
+                gapBuffers += (value / bufferLength) - (expected / bufferLength);
+                misaligned += ((value % bufferLength) != 0);
+            }
+            expected = value + 1;
+            ++numRead;
+        }
+    }
+
+    void read(uint32_t choice, int_fast32_t length)
+    {
+        int32_t staged[bufferLength * 2];
+        int32_t* regions[2];
+        int_fast32_t lengths[2];
+        switch (choice % 3)
+        {
+            case 0:
+            {
+                receive(staged, ring.read(std::span<int32_t>(staged, length)));
+                break;
+            }
+            case 1:
+            {
+                /* Catch up first, as consumers reading in place do */
+                ring.catch_up();
+                length = std::min(length, ring.unread());
+                if (!length) break;
+                ring.read_samples(staged, length);
+                receive(staged, length);
+                break;
+            }
+            default:
+            {
+                const int_fast8_t numRegions(ring.get_read_regions(length, regions, lengths));
+                if (!numRegions) break;
+                for (int_fast8_t r(0); r < numRegions; ++r) receive(regions[r], lengths[r]);
+                ring.commit_read_samples(length);
+            }
+        }
+    }
+};
+
+int main()
+{
+    Buffer::AtomicRingBuffer<int32_t> ring(bufferLength, ringLength);
+    ring.set_policy(Buffer::OVERWRITE_OLDEST);
+    Reader reader{ring};
+
+    int32_t next(0), staged[bufferLength * 3];
+    uint_fast32_t shortWrites(0);
+    uint32_t seed(2024);
+    for (int_fast32_t step(0); step < numSteps; ++step)
+    {
+        seed = (seed * 1664525) + 1013904223;
+
+        /* Bursts of up to three buffers; the writer never stalls */
+        const int_fast32_t length(1 + ((seed >> 8) % (bufferLength * 3)));
+        for (int_fast32_t i(0); i < length; ++i) staged[i] = next + i;
+        const int_fast32_t written(ring.write(std::span<const int32_t>(staged, length)));
+        shortWrites += (written != length);
+        next += written;
+
+        /* Reads about a fifth as often, and a little less each time */
+        if (((seed >> 20) % 5) == 0)
+        {
+            reader.read(seed >> 24, 1 + ((seed >> 4) % (bufferLength + 3)));
+        }
+    }
+
+    /* Drain what survived; only completed buffers are readable */
+    while (ring.buffered()) reader.read(0, bufferLength);
+    const int32_t committed((next / bufferLength) * bufferLength);
+
+    WIFB_CHECK_EQUAL(shortWrites, 0u);
+    WIFB_CHECK_EQUAL(reader.backwards, 0u);
+    WIFB_CHECK_EQUAL(reader.misaligned, 0u);
+    WIFB_CHECK_EQUAL(reader.expected, committed);
+
+    /* Everything committed was either read or counted as dropped */
+    WIFB_CHECK_EQUAL(reader.numRead + ring.samples_dropped(), static_cast<uint_fast32_t>(committed));
+    WIFB_CHECK_EQUAL(ring.samples_dropped(), reader.gapSamples);
+    WIFB_CHECK_EQUAL(ring.buffers_dropped(), reader.gapBuffers);
+    WIFB_CHECK(ring.samples_dropped() > (static_cast<uint_fast32_t>(committed) / 2));
+
+    /* Reset clears the accounting */
+    ring.reset();
+    WIFB_CHECK_EQUAL(ring.samples_dropped(), 0u);
+    WIFB_CHECK_EQUAL(ring.buffers_dropped(), 0u);
+
+    return WIFB_TEST_RESULT();
+}
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "jitterbuffer.h"
+#include "resampler.h"
+#include "staticringbuffer.h"
+#include "wifbtest.h"
+
+/* Before its first input the resampler interpolates from silence,
+which for unsigned samples is the midpoint rather than zero.
+
+Over hours of virtual time, a sender whose clock runs fast or slow
+of the receiver's sends frames through a jittery network into the
+receiver's jitter buffer, resampler and ring, as receive_udp_audio
+does, while playback takes whole buffers from the ring on the
+receiver's clock.  The drift estimate settles on the clock offset,
+and the ring neither runs dry nor fills past the next frame. */
+
+static constexpr const int_fast32_t sampleRate = 48000;
+static constexpr const int_fast8_t numChannels = 2;
+
+/* 32 sample frames into a ring of four 256 sample buffers, each
+handed to playback whole.  The default ring of two 128 sample
+buffers leaves less room between a buffer short and full than
+the release schedule of the jitter buffer wanders. */
+static constexpr const int_fast32_t frameFrames = 16;
+static constexpr const int_fast32_t maxResampledFrames = frameFrames + 4;
+static constexpr const int_fast32_t playbackLength = 256;
+static constexpr const int_fast8_t playbackBuffers = 4;
+
+static constexpr const int64_t pollUs = 1000;
+static constexpr const int64_t simulatedUs = 2LL * 3600 * 1000000;
+
+/* The estimate is judged once the controller has had this long,
+by its mean over each minute, which stays within 10 ppm, as its
+proportional term follows every step of the fill between buffers */
+static constexpr const int64_t settleUs = 20LL * 60 * 1000000;
+static constexpr const int64_t windowUs = 60LL * 1000000;
+
+template <typename T>
+static void check_starts_from_silence(T value)
+{
+    constexpr const int_fast32_t numFrames = 8;
+    Resample::CubicResampler<T> resampler(2);
+    T in[numFrames * 2], out[(numFrames + 2) * 2];
+    for (T& sample: in) sample = value;
+
+    /* At unity ratio every output is a history frame, two behind */
+    WIFB_CHECK_EQUAL(resampler.process(in, numFrames, out, numFrames + 2), numFrames);
+    for (int_fast32_t i(0); i < (numFrames * 2); ++i)
+    {
+        WIFB_CHECK_EQUAL(out[i], ((i < 4) ? get_zero<T>() : value));
+    }
+
+    /* As it does again after a reset */
+    resampler.reset();
+    resampler.process(in, numFrames, out, numFrames + 2);
+    WIFB_CHECK_EQUAL(out[0], get_zero<T>());
+}
+
+static void check_drift(double senderPpm)
+{
+    Buffer::JitterBuffer<int16_t> jitterBuffer(frameFrames * numChannels, 64, sampleRate, numChannels);
+    jitterBuffer.set_depth_limits_ms(2, 60);
+    jitterBuffer.set_target_depth_ms(10);
+    Buffer::StaticRingBuffer<int16_t, playbackLength, playbackBuffers> ring;
+    Resample::CubicResampler<int16_t> resampler(numChannels);
+    Resample::DriftEstimator driftEstimator(ring.size() / 2, 500);
+
+    std::vector<int16_t> frame(frameFrames * numChannels, 1000);
+    int16_t resampled[maxResampledFrames * numChannels];
+    uint32_t seed(1);
+
+    /* Frames in flight by arrival time, and their sequence */
+    std::priority_queue<
+            std::pair<int64_t, uint32_t>,
+            std::vector<std::pair<int64_t, uint32_t>>,
+            std::greater<std::pair<int64_t, uint32_t>>
+        > inFlight;
+    const double sendPeriodUs(frameFrames * 1e6 / sampleRate / (1.0 + (senderPpm * 1e-6)));
+    uint32_t nextSend(0);
+
+    int64_t nextPollUs(0), playbacks(0);
+    bool playing(false);
+    uint32_t underruns(0), overruns(0), unsettled(0);
+
+    /* The ratio that matches the clocks, in the estimator's terms */
+    const double expectedPpm(senderPpm / (1.0 + (senderPpm * 1e-6)));
+    double windowPpm(0), settledPpm(0), worstPpm(0);
+    int64_t windowEndUs(settleUs + windowUs), windowUpdates(0), settledUpdates(0);
+    int_fast32_t leastFill(ring.size()), mostFill(0);
+
+    while (true)
+    {
+        /* Send every frame due by the next event, 1 to 3 ms from wire to socket */
+        const int64_t nextPlaybackUs((playbacks * playbackLength / numChannels * 1000000) / sampleRate);
+        int64_t now(std::min(nextPollUs, nextPlaybackUs));
+        while (std::llround(nextSend * sendPeriodUs) <= now)
+        {
+            seed = (seed * 1664525) + 1013904223;
+            inFlight.emplace(std::llround(nextSend * sendPeriodUs) + 1000 + (seed >> 21), nextSend);
+            ++nextSend;
+        }
+        if (!inFlight.empty() && (inFlight.top().first < now)) now = inFlight.top().first;
+        if (now >= simulatedUs) break;
+
+        if (now == nextPlaybackUs)
+        {
+            /* Playback takes a whole buffer on the receiver's clock */
+            if (ring.buffers_buffered())
+            {
+                playing = true;
+                ring.report_read_samples(ring.unread());
+            }
+            else if (playing)
+            {
+                ++underruns;
+            }
+            ++playbacks;
+            continue;
+        }
+
+        if (now == nextPollUs) nextPollUs += pollUs;
+        while (!inFlight.empty() && (inFlight.top().first == now))
+        {
+            const uint32_t sequence(inFlight.top().second);
+            inFlight.pop();
+            jitterBuffer.insert(sequence, sequence * frameFrames, frame.data(), frame.size(), now);
+        }
+
+        /* Release due frames as receive_udp_audio does */
+        const int16_t* released;
+        while (
+                (ring.available() >= (maxResampledFrames * numChannels))
+                && ((released = jitterBuffer.pull(now)) != nullptr)
+            )
+        {
+            const int_fast32_t fill(ring.size() - ring.available());
+            resampler.set_ratio(driftEstimator.update(fill));
+            const int_fast32_t numResampled(resampler.process(released, frameFrames, resampled, maxResampledFrames));
+            ring.write_samples(resampled, numResampled * numChannels);
+
+            if (now < settleUs) continue;
+            leastFill = std::min(leastFill, fill);
+            mostFill = std::max(mostFill, fill);
+            windowPpm += driftEstimator.ppm();
+            ++windowUpdates;
+            if (now >= windowEndUs)
+            {
+                const double deviation(std::fabs((windowPpm / windowUpdates) - expectedPpm));
+                worstPpm = std::max(worstPpm, deviation);
+                unsettled += (deviation > 10);
+                settledPpm += windowPpm;
+                settledUpdates += windowUpdates;
+                windowPpm = 0;
+                windowUpdates = 0;
+                windowEndUs += windowUs;
+            }
+        }
+
+        /* A ring too full for the next frame holds back the stream */
+        overruns += (ring.available() < (maxResampledFrames * numChannels));
+    }
+
+    const Buffer::JitterStats stats(jitterBuffer.stats());
+    settledPpm /= static_cast<double>(std::max(settledUpdates, int64_t(1)));
+    std::cout << senderPpm << " ppm sender: estimate " << settledPpm << " ppm, worst minute off by ";
+    std::cout << worstPpm << " ppm, settled ring fill " << leastFill << " to " << mostFill << " of ";
+    std::cout << ring.size() << ", " << underruns << " underruns, " << overruns << " overruns\n";
+
+    WIFB_CHECK(std::fabs(settledPpm - expectedPpm) < 0.5);
+    WIFB_CHECK_EQUAL(unsettled, 0u);
+    WIFB_CHECK_EQUAL(underruns, 0u);
+    WIFB_CHECK_EQUAL(overruns, 0u);
+    WIFB_CHECK(settledUpdates > 0);
+    WIFB_CHECK_EQUAL(stats.late, 0u);
+    WIFB_CHECK_EQUAL(stats.resynced, 0u);
+}
+
+int main()
+{
+    check_starts_from_silence<uint8_t>(200);
+    check_starts_from_silence<int16_t>(-1000);
+    check_starts_from_silence<float>(0.5f);
+    check_drift(100);
+    check_drift(-100);
+    return WIFB_TEST_RESULT();
+}
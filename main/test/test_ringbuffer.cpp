@@ -0,0 +1,134 @@
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ringbuffer.h"
+#include "allocationcounter.h"
+#include "wifbtest.h"
+
+/* A counting sequence is moved through a small ring by spans,
+vectors and two-region reservations of lengths that do not
+divide the buffer, so transfers keep straddling buffer ends.
+Every value must arrive once and in order, and once the ring
+is sized none of it may touch the heap. */
+
+static constexpr const int_fast32_t bufferLength = 8;
+static constexpr const int_fast8_t ringLength = 4;
+static constexpr const int_fast32_t numSteps = 20000;
+
+struct Traffic
+{
+    Buffer::AtomicRingBuffer<int32_t> ring{bufferLength, ringLength};
+    std::vector<int32_t> staged = std::vector<int32_t>(bufferLength * ringLength);
+    std::vector<int32_t> vector = std::vector<int32_t>(5);
+    int32_t next{0}, expected{0};
+    uint32_t errors{0}, regionWrites{0}, regionReads{0};
+
+    void write(int_fast32_t step)
+    {
+        const int_fast32_t length(1 + ((step * 7) % 13));
+        int32_t* regions[2];
+        int_fast32_t lengths[2];
+        switch (step % 3)
+        {
+            case 0:
+            {
+                for (int_fast32_t i(0); i < length; ++i) staged[i] = next + i;
+                next += ring.write(std::span<const int32_t>(staged.data(), length));
+                break;
+            }
+            case 1:
+            {
+                for (int32_t& sample: vector) sample = next++;
+                const int_fast32_t written(ring.write(vector));
+                next -= static_cast<int32_t>(vector.size()) - written;
+                break;
+            }
+            default:
+            {
+                const int_fast8_t numRegions(ring.get_write_regions(length, regions, lengths));
+                if (!numRegions) break;
+                check_regions(regions, lengths, numRegions, length, ring.writeIndex);
+                for (int_fast8_t r(0); r < numRegions; ++r)
+                {
+                    for (int_fast32_t i(0); i < lengths[r]; ++i) regions[r][i] = next++;
+                }
+                ring.commit_written_samples(length);
+                ++regionWrites;
+            }
+        }
+    }
+
+    void read(int_fast32_t step)
+    {
+        const int_fast32_t length(1 + ((step * 5) % 11));
+        int32_t* regions[2];
+        int_fast32_t lengths[2];
+        if (step & 1)
+        {
+            const int_fast32_t numRead(ring.read(std::span<int32_t>(staged.data(), length)));
+            for (int_fast32_t i(0); i < numRead; ++i) errors += (staged[i] != expected++);
+            return;
+        }
+        const int_fast8_t numRegions(ring.get_read_regions(length, regions, lengths));
+        if (!numRegions) return;
+        check_regions(regions, lengths, numRegions, length, ring.readIndex);
+        for (int_fast8_t r(0); r < numRegions; ++r)
+        {
+            for (int_fast32_t i(0); i < lengths[r]; ++i) errors += (regions[r][i] != expected++);
+        }
+        ring.commit_read_samples(length);
+        ++regionReads;
+    }
+
+    /* A transfer is split only at the end of a buffer,
+    and continues from the start of the next one */
+    void check_regions(
+            int32_t* regions[2],
+            const int_fast32_t lengths[2],
+            int_fast8_t numRegions,
+            int_fast32_t length,
+            int_fast8_t index
+        )
+    {
+        WIFB_CHECK((numRegions == 1) || (numRegions == 2));
+        if (numRegions == 1)
+        {
+            WIFB_CHECK_EQUAL(lengths[0], length);
+            return;
+        }
+        WIFB_CHECK_EQUAL(lengths[0] + lengths[1], length);
+        WIFB_CHECK(regions[0] + lengths[0] == ring.ring[index].data() + bufferLength);
+        WIFB_CHECK(regions[1] == ring.ring[(index + 1) % ringLength].data());
+    }
+};
+
+int main()
+{
+    Traffic traffic;
+    for (int_fast32_t step(0); step < 64; ++step)
+    {
+        traffic.write(step);
+        traffic.read(step);
+    }
+
+    const long before(allocations());
+    for (int_fast32_t step(0); step < numSteps; ++step)
+    {
+        /* Let either end run ahead now and then */
+        traffic.write(step);
+        if ((step % 17) < 12) traffic.write(step + 1);
+        traffic.read(step);
+        if ((step % 23) < 14) traffic.read(step + 1);
+    }
+    const long used(allocations() - before);
+
+    WIFB_CHECK_EQUAL(used, 0);
+    WIFB_CHECK_EQUAL(traffic.errors, 0u);
+    WIFB_CHECK(traffic.next > (numSteps * 4));
+    WIFB_CHECK((traffic.next - traffic.expected) <= (bufferLength * ringLength));
+    WIFB_CHECK(traffic.regionWrites > 0);
+    WIFB_CHECK(traffic.regionReads > 0);
+
+    return WIFB_TEST_RESULT();
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "multibuffer.h"
+#include "ringbuffer.h"
+#include "allocationcounter.h"
+#include "wifbtest.h"
+
+/* Moves hand storage over, copies into rings at least as large
+reuse theirs, and resizing within reserved or earlier sizes
+reuses buffers, so none of them may allocate */
+
+typedef Buffer::AtomicRingBuffer<int16_t> Ring;
+typedef Buffer::AtomicMultiRingBuffer<int16_t> MultiRing;
+
+static_assert(std::is_nothrow_move_constructible_v<Ring>, "Rings must move without throwing");
+static_assert(std::is_nothrow_move_assignable_v<Ring>, "Rings must move without throwing");
+static_assert(std::is_nothrow_move_constructible_v<MultiRing>, "Rings must move without throwing");
+static_assert(std::is_nothrow_move_assignable_v<MultiRing>, "Rings must move without throwing");
+
+/* Writes a counting sequence until the ring is full */
+static void fill(Ring& ring)
+{
+    int16_t next(0);
+    while (ring.write(std::span<const int16_t>(&next, 1))) ++next;
+}
+
+static bool same_contents(const Ring& a, const Ring& b)
+{
+    return (
+            (a.ring_length() == b.ring_length())
+            && (a.buffer_length() == b.buffer_length())
+            && (a.buffered() == b.buffered())
+            && std::equal(a.ring.begin(), a.ring.end(), b.ring.begin())
+        );
+}
+
+static void check_ring_moves()
+{
+    Ring source(64, 4), reference(64, 4);
+    fill(source);
+    fill(reference);
+    const int16_t* storage(source.ring[0].data());
+
+    long before(allocations());
+    Ring moved(std::move(source));
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK(moved.ring[0].data() == storage);
+    WIFB_CHECK(same_contents(moved, reference));
+
+    before = allocations();
+    Ring assigned;
+    assigned = std::move(moved);
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK(assigned.ring[0].data() == storage);
+    WIFB_CHECK(same_contents(assigned, reference));
+
+    /* Copies into rings of the same or greater size */
+    Ring same(64, 4), larger(96, 6);
+    before = allocations();
+    same = assigned;
+    larger = assigned;
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK(same_contents(same, reference));
+    WIFB_CHECK(same_contents(larger, reference));
+}
+
+static void check_ring_resizes()
+{
+    /* Resizing within a reservation */
+    Ring reserved;
+    reserved.reserve(256, 8);
+    long before(allocations());
+    for (int_fast8_t pass(0); pass < 2; ++pass)
+    {
+        reserved.set_size(64, 4);
+        reserved.set_size(256, 8);
+        reserved.set_size(32, 2);
+        reserved.set_size(96, 6);
+    }
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+
+    /* Growing back to a size the ring has had before */
+    Ring grown(256, 8);
+    grown.set_size(32, 2);
+    grown.set_size(256, 8);
+    before = allocations();
+    grown.set_size(64, 4);
+    grown.set_size(256, 8);
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK_EQUAL(grown.size(), 256 * 8);
+}
+
+static void check_multiring_moves_and_resizes()
+{
+    MultiRing source(64, 4, 2);
+    source.buffers[1].ring[2][5] = 7;
+    const int16_t* storage(source.buffers[0].ring[0].data());
+
+    long before(allocations());
+    MultiRing moved(std::move(source));
+    MultiRing assigned;
+    assigned = std::move(moved);
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK_EQUAL(+assigned.num_buffers(), 2);
+    WIFB_CHECK(assigned.buffers[0].ring[0].data() == storage);
+    WIFB_CHECK_EQUAL(assigned.buffers[1].ring[2][5], 7);
+
+    MultiRing same(64, 4, 2);
+    before = allocations();
+    same = assigned;
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK_EQUAL(same.buffers[1].ring[2][5], 7);
+
+    /* Buffer and ring sizes change within a reservation;
+    the number of channels stays */
+    same.reserve(256, 8, 2);
+    before = allocations();
+    same.set_size(256, 8, 2);
+    same.set_size(32, 2, 2);
+    same.set_size(96, 6, 2);
+    WIFB_CHECK_EQUAL(allocations() - before, 0);
+    WIFB_CHECK_EQUAL(same.size(), 96 * 6 * 2);
+}
+
+int main()
+{
+    check_ring_moves();
+    check_ring_resizes();
+    check_multiring_moves_and_resizes();
+    return WIFB_TEST_RESULT();
+}
@@ -0,0 +1,151 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+#include "ringbuffer.h"
+#include "wifbtest.h"
+
+/* A producer and a consumer thread move a counting sequence
+through the ring, reserving regions and publishing each with
+one commit, then again by copying spans.  The consumer checks
+that each value arrives once and in order, and the throughput
+of both is printed to compare hosts and layouts. */
+
+static constexpr const int_fast32_t bufferLength = 256;
+static constexpr const int_fast8_t ringLength = 8;
+static constexpr const uint32_t numSamples = (1 << 23);
+
+/* Only whole buffers are readable, so the last must be filled */
+static_assert(!(numSamples % bufferLength), "Samples must fill whole buffers");
+
+/* Largest transfer, which straddles at most two buffers */
+static constexpr const int_fast32_t chunkLength = (bufferLength * 3) / 4;
+
+static void check_layout(Buffer::AtomicRingBuffer<int32_t>& ring)
+{
+    /* Producer and consumer indices sit on separate cache lines */
+    const intptr_t distance(
+            reinterpret_cast<intptr_t>(&ring.readIndex)
+            - reinterpret_cast<intptr_t>(&ring.writeIndex)
+        );
+    WIFB_CHECK(distance >= (RINGBUFF_CACHE_LINE_SIZE));
+    WIFB_CHECK_EQUAL(reinterpret_cast<intptr_t>(&ring.writeIndex) % (RINGBUFF_CACHE_LINE_SIZE), 0);
+    WIFB_CHECK_EQUAL(reinterpret_cast<intptr_t>(&ring.readIndex) % (RINGBUFF_CACHE_LINE_SIZE), 0);
+}
+
+static void produce_regions(Buffer::AtomicRingBuffer<int32_t>& ring)
+{
+    int32_t* regions[2];
+    int_fast32_t lengths[2];
+    uint32_t next(0), step(0);
+    while (next < numSamples)
+    {
+        const int_fast32_t length(std::min<uint32_t>(
+                1 + ((++step * 37) % chunkLength),
+                numSamples - next
+            ));
+        const int_fast8_t numRegions(ring.get_write_regions(length, regions, lengths));
+        if (!numRegions)
+        {
+            ring.wait_writable(length, 1);
+            continue;
+        }
+        for (int_fast8_t r(0); r < numRegions; ++r)
+        {
+            for (int_fast32_t i(0); i < lengths[r]; ++i) regions[r][i] = next++;
+        }
+        ring.commit_written_samples(length);
+    }
+}
+
+static uint32_t consume_regions(Buffer::AtomicRingBuffer<int32_t>& ring)
+{
+    int32_t* regions[2];
+    int_fast32_t lengths[2];
+    uint32_t expected(0), step(0), errors(0);
+    while (expected < numSamples)
+    {
+        const int_fast32_t length(std::min<uint32_t>(
+                1 + ((++step * 53) % chunkLength),
+                numSamples - expected
+            ));
+        const int_fast8_t numRegions(ring.get_read_regions(length, regions, lengths));
+        if (!numRegions)
+        {
+            ring.wait_readable(length, 1);
+            continue;
+        }
+        for (int_fast8_t r(0); r < numRegions; ++r)
+        {
+            for (int_fast32_t i(0); i < lengths[r]; ++i)
+            {
+                errors += (static_cast<uint32_t>(regions[r][i]) != expected++);
+            }
+        }
+        ring.commit_read_samples(length);
+    }
+    return errors;
+}
+
+static void produce_spans(Buffer::AtomicRingBuffer<int32_t>& ring)
+{
+    int32_t staged[chunkLength];
+    uint32_t next(0), step(0);
+    while (next < numSamples)
+    {
+        const int_fast32_t length(std::min<uint32_t>(
+                1 + ((++step * 37) % chunkLength),
+                numSamples - next
+            ));
+        for (int_fast32_t i(0); i < length; ++i) staged[i] = next + i;
+        const int_fast32_t written(ring.write(std::span<const int32_t>(staged, length)));
+        next += written;
+        if (written < length) ring.wait_writable(length - written, 1);
+    }
+}
+
+static uint32_t consume_spans(Buffer::AtomicRingBuffer<int32_t>& ring)
+{
+    int32_t staged[chunkLength];
+    uint32_t expected(0), step(0), errors(0);
+    while (expected < numSamples)
+    {
+        const int_fast32_t length(1 + ((++step * 53) % chunkLength));
+        const int_fast32_t numRead(ring.read(std::span<int32_t>(staged, length)));
+        for (int_fast32_t i(0); i < numRead; ++i)
+        {
+            errors += (static_cast<uint32_t>(staged[i]) != expected++);
+        }
+        if (!numRead) ring.wait_readable(1, 1);
+    }
+    return errors;
+}
+
+template <typename Producer, typename Consumer>
+static void run(const char* name, Producer produce, Consumer consume)
+{
+    Buffer::AtomicRingBuffer<int32_t> ring(bufferLength, ringLength);
+    check_layout(ring);
+
+    const auto start(std::chrono::steady_clock::now());
+    std::thread producer([&ring, produce]() { produce(ring); });
+    const uint32_t errors(consume(ring));
+    producer.join();
+    const double seconds(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count());
+
+    WIFB_CHECK_EQUAL(errors, 0u);
+    WIFB_CHECK_EQUAL(ring.buffered(), 0);
+    std::cout << name << ": " << numSamples << " samples in " << seconds << " s, ";
+    std::cout << (numSamples / seconds / 1e6) << " M samples/s on ";
+    std::cout << std::thread::hardware_concurrency() << " cpu(s)\n";
+}
+
+int main()
+{
+    run("reserve and commit", produce_regions, consume_regions);
+    run("span copies", produce_spans, consume_spans);
+    return WIFB_TEST_RESULT();
+}
@@ -0,0 +1,158 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+#include "staticringbuffer.h"
+#include "wifbtest.h"
+
+/* A producer and a consumer thread move a counting sequence
+through the ring with every write and read path, and the
+consumer checks that each value arrives exactly once, in order */
+
+static constexpr const uint32_t stressSamples = (1 << 24);
+
+template <typename Ring>
+static void check_full_and_empty(Ring& ring)
+{
+    WIFB_CHECK_EQUAL(ring.buffered(), 0);
+    WIFB_CHECK_EQUAL(ring.available(), ring.size());
+
+    uint32_t value(0);
+    while (ring.available())
+    {
+        WIFB_CHECK_EQUAL(ring.write_samples(&value, 1), 1);
+        ++value;
+    }
+    WIFB_CHECK_EQUAL(ring.buffered(), ring.size());
+    WIFB_CHECK_EQUAL(ring.write_samples(&value, 1), 0);
+
+    uint32_t* regions[2];
+    int_fast32_t lengths[2];
+    WIFB_CHECK_EQUAL(+ring.get_write_regions(1, regions, lengths), 0);
+
+    /* Free half a buffer past the end so the next write wraps */
+    uint32_t discard[Ring::totalRingSampleLength];
+    WIFB_CHECK_EQUAL(ring.read_samples(discard, ring.size()), ring.size());
+    WIFB_CHECK_EQUAL(discard[ring.size() - 1], value - 1);
+    WIFB_CHECK_EQUAL(ring.buffered(), 0);
+
+    const int_fast32_t half(ring.buffer_length() / 2);
+    for (int_fast32_t i(0); i < (ring.size() - half); ++i)
+    {
+        ring.write_samples(&value, 1);
+        ring.read_samples(discard, 1);
+    }
+    WIFB_CHECK_EQUAL(
+            +ring.get_write_regions(ring.buffer_length(), regions, lengths),
+            2
+        );
+    WIFB_CHECK_EQUAL(lengths[0], half);
+    WIFB_CHECK_EQUAL(lengths[1], ring.buffer_length() - half);
+    WIFB_CHECK((regions[1] + ring.size()) == (regions[0] + lengths[0]));
+}
+
+template <typename Ring>
+static void stress(Ring& ring)
+{
+    const auto start(std::chrono::steady_clock::now());
+
+    std::thread producer([&ring]() {
+            uint32_t next(0), step(0);
+            uint32_t staged[Ring::totalRingSampleLength];
+            uint32_t* regions[2];
+            int_fast32_t lengths[2];
+            while (next < stressSamples)
+            {
+                /* Alternate copies and writes into ring memory
+                of lengths that do not divide the ring */
+                const int_fast32_t length(std::min<uint32_t>(
+                        (1 + ((++step * 37) % (ring.buffer_length() + 3))),
+                        (stressSamples - next)
+                    ));
+                if (step & 1)
+                {
+                    for (int_fast32_t i(0); i < length; ++i) staged[i] = next + i;
+                    const int_fast32_t written(ring.write_samples(staged, length));
+                    next += written;
+                    if (!written) std::this_thread::yield();
+                }
+                else if (ring.get_write_regions(length, regions, lengths))
+                {
+                    for (int_fast32_t i(0); i < lengths[0]; ++i) regions[0][i] = next++;
+                    if (lengths[0] < length)
+                    {
+                        for (int_fast32_t i(0); i < lengths[1]; ++i) regions[1][i] = next++;
+                    }
+                    ring.report_written_samples(length);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+    uint32_t expected(0), step(0), errors(0);
+    uint32_t staged[Ring::totalRingSampleLength];
+    while (expected < stressSamples)
+    {
+        if (++step & 1)
+        {
+            const int_fast32_t length(ring.read_samples(
+                    staged,
+                    (1 + ((step * 53) % (ring.buffer_length() * 2)))
+                ));
+            for (int_fast32_t i(0); i < length; ++i)
+            {
+                errors += (staged[i] != expected++);
+            }
+            if (!length) std::this_thread::yield();
+        }
+        else
+        {
+            /* Read in place from the current buffer */
+            const int_fast32_t length(ring.unread());
+            if (!length)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            const uint32_t* samples(ring.get_read_sample());
+            for (int_fast32_t i(0); i < length; ++i)
+            {
+                errors += (samples[i] != expected++);
+            }
+            ring.report_read_samples(length);
+        }
+    }
+
+    producer.join();
+    const double seconds(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count());
+
+    WIFB_CHECK_EQUAL(errors, 0u);
+    WIFB_CHECK_EQUAL(expected, stressSamples);
+    WIFB_CHECK_EQUAL(ring.buffered(), 0);
+    std::cout << ring.size() << " sample ring: " << stressSamples;
+    std::cout << " samples in " << seconds << " s, ";
+    std::cout << (stressSamples / seconds / 1e6) << " M samples/s\n";
+}
+
+int main()
+{
+    /* Power of two rings wrap with masks, others with compares */
+    static Buffer::StaticRingBuffer<uint32_t, 256, 8> masked;
+    static Buffer::StaticRingBuffer<uint32_t, 250, 3> compared;
+
+    check_full_and_empty(masked);
+    check_full_and_empty(compared);
+
+    masked.reset();
+    compared.reset();
+    stress(masked);
+    stress(compared);
+
+    return WIFB_TEST_RESULT();
+}
@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <vector>
+
+#include "ringbuffer.h"
+#include "wifbtest.h"
+
+/* The fill level is walked a buffer at a time through a list of
+levels, and the events each step raises are checked against the
+ones the watermarks and their hysteresis call for.  Dithering
+within the hysteresis band must not raise anything. */
+
+static constexpr const int_fast32_t bufferLength = 8;
+static constexpr const int_fast8_t ringLength = 8;
+
+struct Event
+{
+    int_fast8_t events;
+    int_fast32_t buffered;
+};
+
+struct Step
+{
+    /* Fill level in buffers after the step */
+    int_fast32_t level;
+
+    /* Events the step raises */
+    int_fast8_t events;
+};
+
+static void record(int_fast8_t events, int_fast32_t buffered, void* context)
+{
+    static_cast<std::vector<Event>*>(context)->push_back({events, buffered});
+}
+
+static void walk(
+        Buffer::AtomicRingBuffer<int16_t>& ring,
+        std::vector<Event>& raised,
+        const std::vector<Step>& steps
+    )
+{
+    for (const Step& step: steps)
+    {
+        raised.clear();
+        const int_fast32_t target(step.level * bufferLength);
+        if (target > ring.buffered()) ring.report_written_samples(bufferLength);
+        else ring.report_read_samples(bufferLength);
+        WIFB_CHECK_EQUAL(ring.buffered(), target);
+
+        /* Each crossing calls back once with the level it
+        happened at, and is kept until events are queried */
+        const int_fast8_t queried(ring.watermark_events());
+        WIFB_CHECK_EQUAL(queried, step.events);
+        if (step.events)
+        {
+            WIFB_CHECK_EQUAL(raised.size(), 1u);
+            if (raised.size() == 1)
+            {
+                WIFB_CHECK_EQUAL(raised[0].events, step.events);
+                WIFB_CHECK_EQUAL(raised[0].buffered, target);
+            }
+        }
+        else
+        {
+            WIFB_CHECK_EQUAL(raised.size(), 0u);
+        }
+        WIFB_CHECK_EQUAL(ring.watermark_events(), Buffer::WATERMARK_NONE);
+    }
+}
+
+int main()
+{
+    using namespace Buffer;
+
+    Buffer::AtomicRingBuffer<int16_t> ring(bufferLength, ringLength);
+    std::vector<Event> raised;
+    raised.reserve(8);
+    ring.set_watermark_callback(record, &raised);
+
+    /* Low at two buffers, high at five, one buffer of hysteresis */
+    ring.set_watermarks(2 * bufferLength, 5 * bufferLength, bufferLength);
+    walk(ring, raised, {
+            {1, WATERMARK_LOW},
+            {2, WATERMARK_NONE},
+            {3, WATERMARK_NONE},
+            {2, WATERMARK_NONE},
+            {3, WATERMARK_NONE},
+            {4, WATERMARK_LOW_CLEARED},
+            {5, WATERMARK_HIGH},
+            {4, WATERMARK_NONE},
+            {5, WATERMARK_NONE},
+            {4, WATERMARK_NONE},
+            {5, WATERMARK_NONE},
+            {6, WATERMARK_NONE},
+            {5, WATERMARK_NONE},
+            {4, WATERMARK_NONE},
+            {3, WATERMARK_HIGH_CLEARED},
+            {2, WATERMARK_LOW},
+            {1, WATERMARK_NONE},
+            {2, WATERMARK_NONE},
+            {3, WATERMARK_NONE},
+            {4, WATERMARK_LOW_CLEARED},
+        });
+
+    /* Without hysteresis every crossing is an event */
+    ring.reset();
+    ring.set_watermarks(2 * bufferLength, 5 * bufferLength, 0);
+    walk(ring, raised, {
+            {1, WATERMARK_LOW},
+            {2, WATERMARK_NONE},
+            {3, WATERMARK_LOW_CLEARED},
+            {2, WATERMARK_LOW},
+            {3, WATERMARK_LOW_CLEARED},
+            {4, WATERMARK_NONE},
+            {5, WATERMARK_HIGH},
+            {4, WATERMARK_HIGH_CLEARED},
+            {5, WATERMARK_HIGH},
+            {4, WATERMARK_HIGH_CLEARED},
+        });
+
+    /* A negative level disables its watermark */
+    ring.reset();
+    ring.set_watermarks(-1, 3 * bufferLength, bufferLength);
+    walk(ring, raised, {
+            {1, WATERMARK_NONE},
+            {2, WATERMARK_NONE},
+            {3, WATERMARK_HIGH},
+            {2, WATERMARK_NONE},
+            {1, WATERMARK_HIGH_CLEARED},
+            {0, WATERMARK_NONE},
+        });
+
+    return WIFB_TEST_RESULT();
+}
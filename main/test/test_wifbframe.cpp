@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "wifbframe.h"
+#include "wifbtest.h"
+
+/* Streams of frames are fed to WIFBFrameParser both through its
+regions, as recvmsg fills them, and through parse, in reads of
+every length from a byte to the whole stream, so headers and
+bodies split anywhere and several frames arrive in one read.
+Garbage, foreign versions and oversized headers are discarded
+byte for byte until the parser is back on a frame boundary, and
+gaps in the sequence are counted as lost frames. */
+
+static constexpr const int_fast32_t maxPayloadLength = 96;
+static constexpr const int_fast32_t maxMetadataLength = 24;
+
+static uint8_t payload_byte(uint32_t sequence, int_fast32_t i)
+{
+    return static_cast<uint8_t>((sequence * 31) + i);
+}
+
+static uint8_t metadata_byte(uint32_t sequence, int_fast32_t i)
+{
+    return static_cast<uint8_t>(~payload_byte(sequence, i));
+}
+
+/* Appends the next frame from encoder to stream */
+static void append_frame(
+        std::vector<uint8_t>* stream,
+        WIFBFrameEncoder* encoder,
+        int_fast32_t payloadLength,
+        int_fast32_t metadataLength
+    )
+{
+    const uint32_t sequence(encoder->header().sequence);
+    encoder->encode(payloadLength, metadataLength, payloadLength / 4);
+    stream->insert(stream->end(), encoder->data, encoder->data + (WIFB_FRAME_HEADER_SIZE));
+    for (int_fast32_t i(0); i < payloadLength; ++i) stream->push_back(payload_byte(sequence, i));
+    for (int_fast32_t i(0); i < metadataLength; ++i) stream->push_back(metadata_byte(sequence, i));
+}
+
+/* Garbage that never looks like the start of a header */
+static void append_garbage(std::vector<uint8_t>* stream, int_fast32_t length)
+{
+    for (int_fast32_t i(0); i < length; ++i)
+    {
+        const uint8_t byte(static_cast<uint8_t>((i * 37) + 5));
+        stream->push_back(((byte & (WIFB_FRAME_MAGIC_MASK)) == (WIFB_FRAME_MAGIC)) ? 0x5A : byte);
+    }
+}
+
+struct Received
+{
+    WIFBFrameHeader header;
+    uint32_t mismatches;
+};
+
+/* Takes frames off the parser, putting each payload in two
+regions as a receiver does when a chunk wraps its ring */
+class Receiver
+{
+
+public:
+
+    uint8_t payload[maxPayloadLength];
+    uint8_t metadata[maxMetadataLength];
+    WIFBFrameParser parser;
+    std::vector<Received> frames;
+
+    Receiver() :
+    parser(maxPayloadLength, metadata, maxMetadataLength)
+    {
+    }
+
+    /* Handles a parser that is waiting on the caller,
+    and returns whether it was */
+    bool step()
+    {
+        if (parser.state() == FRAME_HEADER_COMPLETE)
+        {
+            const int_fast32_t length(parser.header().payloadLength);
+            uint8_t* regions[2] = {&(payload[maxPayloadLength - (length / 2)]), payload};
+            const int_fast32_t lengths[2] = {length / 2, length - (length / 2)};
+            parser.set_payload_regions(regions, lengths, 2);
+            return true;
+        }
+        if (parser.state() == FRAME_COMPLETE)
+        {
+            const WIFBFrameHeader& header(parser.header());
+            const int_fast32_t half(header.payloadLength / 2);
+            Received frame{header, 0};
+            for (int_fast32_t i(0); i < header.payloadLength; ++i)
+            {
+                const uint8_t byte((i < half) ? payload[maxPayloadLength - half + i] : payload[i - half]);
+                frame.mismatches += (byte != payload_byte(header.sequence, i));
+            }
+            for (int_fast32_t i(0); i < header.metadataLength; ++i)
+            {
+                frame.mismatches += (metadata[i] != metadata_byte(header.sequence, i));
+            }
+            frames.push_back(frame);
+            parser.next_frame();
+            return true;
+        }
+        return false;
+    }
+
+    /* Feeds stream through next_regions and advance, as recvmsg
+    fills the regions, at most readLength bytes per read */
+    void receive(const std::vector<uint8_t>& stream, size_t readLength)
+    {
+        uint8_t* regions[3];
+        int_fast32_t lengths[3];
+        size_t position(0);
+        while (step() || (position < stream.size()))
+        {
+            const int_fast8_t numRegions(parser.next_regions(regions, lengths));
+            size_t read(0);
+            for (int_fast8_t i(0); (i < numRegions) && (position < stream.size()) && (read < readLength); ++i)
+            {
+                const size_t length(std::min({
+                        static_cast<size_t>(lengths[i]),
+                        readLength - read,
+                        stream.size() - position
+                    }));
+                std::memcpy(regions[i], &(stream[position]), length);
+                position += length;
+                read += length;
+            }
+            parser.advance(read);
+        }
+    }
+
+    /* Feeds stream through parse, readLength bytes per read */
+    void parse(const std::vector<uint8_t>& stream, size_t readLength)
+    {
+        for (size_t position(0); position < stream.size(); position += readLength)
+        {
+            const int_fast32_t length(std::min(readLength, stream.size() - position));
+            int_fast32_t consumed(0);
+            while (consumed < length)
+            {
+                consumed += parser.parse(&(stream[position + consumed]), length - consumed);
+                step();
+            }
+        }
+        while (step());
+    }
+
+};
+
+/* Checks that every read length brings back the
+expected frames, and discards the expected bytes */
+static void check_stream(
+        const std::vector<uint8_t>& stream,
+        const std::vector<uint32_t>& sequences,
+        uint_fast32_t discarded,
+        uint_fast32_t lost
+    )
+{
+    /* Small reads cover every split; past that, a few suffice */
+    uint32_t mismatches(0);
+    for (size_t readLength(1); readLength <= stream.size(); readLength += ((readLength < 64) ? 1 : 37))
+    {
+        for (const bool regions: {true, false})
+        {
+            Receiver receiver;
+            if (regions) receiver.receive(stream, readLength);
+            else receiver.parse(stream, readLength);
+
+            mismatches += (receiver.frames.size() != sequences.size());
+            for (size_t i(0); i < std::min(receiver.frames.size(), sequences.size()); ++i)
+            {
+                mismatches += receiver.frames[i].mismatches;
+                mismatches += (receiver.frames[i].header.sequence != sequences[i]);
+            }
+            mismatches += (receiver.parser.discarded() != discarded);
+            mismatches += (receiver.parser.lost() != lost);
+            mismatches += (receiver.parser.state() != FRAME_HEADER);
+        }
+    }
+    WIFB_CHECK_EQUAL(mismatches, 0u);
+}
+
+static void check_header()
+{
+    WIFBFrameHeader header{WIFB_FRAME_VERSION, WIFB_ENCODING_ADPCM, 24, 2, 0x1234, 0x56, 0x89ABCDEF, 0xFEDCBA98};
+    uint8_t data[WIFB_FRAME_HEADER_SIZE];
+    encode_frame_header(header, data);
+    WIFB_CHECK_EQUAL(+data[0], 0xA1);
+    WIFB_CHECK_EQUAL(+data[4], 0x34);
+    WIFB_CHECK_EQUAL(+data[8], 0xEF);
+
+    WIFBFrameHeader decoded;
+    WIFB_CHECK(decode_frame_header(data, &decoded));
+    WIFB_CHECK_EQUAL(+decoded.encoding, +header.encoding);
+    WIFB_CHECK_EQUAL(+decoded.bitsPerSample, 24);
+    WIFB_CHECK_EQUAL(+decoded.channels, 2);
+    WIFB_CHECK_EQUAL(decoded.payloadLength, header.payloadLength);
+    WIFB_CHECK_EQUAL(decoded.metadataLength, header.metadataLength);
+    WIFB_CHECK_EQUAL(decoded.sequence, header.sequence);
+    WIFB_CHECK_EQUAL(decoded.timestamp, header.timestamp);
+
+    data[0] = 0xB1;
+    WIFB_CHECK(!decode_frame_header(data, &decoded));
+    data[0] = 0xA2;
+    WIFB_CHECK(!decode_frame_header(data, &decoded));
+}
+
+static void check_frames()
+{
+    /* Frames of every shape, several to a read once reads are long */
+    WIFBFrameEncoder encoder(WIFB_ENCODING_PCM, 16, 2);
+    std::vector<uint8_t> stream;
+    append_frame(&stream, &encoder, 64, 24);
+    append_frame(&stream, &encoder, 0, 24);
+    append_frame(&stream, &encoder, 96, 0);
+    append_frame(&stream, &encoder, 0, 0);
+    append_frame(&stream, &encoder, 1, 1);
+    append_frame(&stream, &encoder, 32, 8);
+    check_stream(stream, {0, 1, 2, 3, 4, 5}, 0, 0);
+}
+
+static void check_resync()
+{
+    WIFBFrameEncoder encoder(WIFB_ENCODING_PCM, 16, 2);
+    std::vector<uint8_t> stream;
+    append_garbage(&stream, 5);
+    append_frame(&stream, &encoder, 32, 8);
+    append_garbage(&stream, 40);
+    append_frame(&stream, &encoder, 16, 0);
+
+    /* Magic bytes in the garbage are tried as headers and given up */
+    stream.insert(stream.end(), {0xA1, 0xAF, 0xA1, 0xA0, 0x03});
+    append_garbage(&stream, 11);
+    append_frame(&stream, &encoder, 8, 8);
+    check_stream(stream, {0, 1, 2}, 5 + 40 + 16, 0);
+
+    /* A whole frame of another version is discarded, though
+    its own magic byte starts the search for the next header */
+    encoder.encode(8, 0, 0);
+    std::vector<uint8_t> foreign(encoder.data, encoder.data + (WIFB_FRAME_HEADER_SIZE));
+    foreign[0] = (WIFB_FRAME_MAGIC) | ((WIFB_FRAME_VERSION) + 1);
+    append_garbage(&foreign, 8);
+    append_frame(&foreign, &encoder, 8, 0);
+    check_stream(foreign, {4}, (WIFB_FRAME_HEADER_SIZE) + 8, 0);
+}
+
+static void check_oversized()
+{
+    /* Lengths past the parser's limits would overrun its regions */
+    for (const int_fast32_t payloadLength: {maxPayloadLength + 1, int_fast32_t(0)})
+    {
+        WIFBFrameEncoder encoder(WIFB_ENCODING_PCM, 16, 2);
+        std::vector<uint8_t> stream;
+        encoder.encode(payloadLength, payloadLength ? 0 : (maxMetadataLength + 1), 0);
+        stream.insert(stream.end(), encoder.data, encoder.data + (WIFB_FRAME_HEADER_SIZE));
+        append_frame(&stream, &encoder, maxPayloadLength, maxMetadataLength);
+        check_stream(stream, {1}, (WIFB_FRAME_HEADER_SIZE), 0);
+    }
+}
+
+static void check_sequence()
+{
+    WIFBFrameEncoder encoder(WIFB_ENCODING_PCM, 16, 2);
+    std::vector<uint8_t> stream;
+    append_frame(&stream, &encoder, 8, 0);
+    encoder.skip_samples(40, 3);
+    append_frame(&stream, &encoder, 8, 0);
+    encoder.skip_samples(0, 1);
+    append_frame(&stream, &encoder, 8, 0);
+    check_stream(stream, {0, 4, 6}, 0, 4);
+
+    /* A sender that restarts its sequence loses nothing */
+    WIFBFrameEncoder restarted(WIFB_ENCODING_PCM, 16, 2);
+    append_frame(&stream, &restarted, 8, 0);
+    append_frame(&stream, &restarted, 8, 0);
+    check_stream(stream, {0, 4, 6, 0, 1}, 0, 4);
+
+    /* Counts clear once read, and reset forgets the sequence */
+    Receiver receiver;
+    receiver.receive(stream, stream.size());
+    WIFB_CHECK_EQUAL(receiver.parser.lost(), 4u);
+    WIFB_CHECK_EQUAL(receiver.parser.lost(), 0u);
+    receiver.parser.reset();
+    std::vector<uint8_t> later;
+    encoder.skip_samples(0, 100);
+    append_frame(&later, &encoder, 8, 0);
+    receiver.receive(later, later.size());
+    WIFB_CHECK_EQUAL(receiver.parser.lost(), 0u);
+    WIFB_CHECK_EQUAL(receiver.frames.back().header.sequence, 107u);
+}
+
+int main()
+{
+    check_header();
+    check_frames();
+    check_resync();
+    check_oversized();
+    check_sequence();
+    return WIFB_TEST_RESULT();
+}
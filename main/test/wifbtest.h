@@ -0,0 +1,40 @@
+#ifndef WIFBTEST_H
+#define WIFBTEST_H
+
+#include <iostream>
+
+/* Minimal checks for the host tests.  A failing check prints
+where and what failed and the test carries on, so one run
+reports every failure; main returns WIFB_TEST_RESULT(). */
+
+static int wifbTestFailures(0);
+
+#define WIFB_CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            ++wifbTestFailures; \
+            std::cerr << __FILE__ << ':' << __LINE__; \
+            std::cerr << ": check failed: " << #condition << '\n'; \
+        } \
+    } while (0)
+
+#define WIFB_CHECK_EQUAL(actual, expected) \
+    do \
+    { \
+        const auto wifbActual(actual); \
+        const auto wifbExpected(expected); \
+        if (!(wifbActual == wifbExpected)) \
+        { \
+            ++wifbTestFailures; \
+            std::cerr << __FILE__ << ':' << __LINE__; \
+            std::cerr << ": " << #actual << " is " << +wifbActual; \
+            std::cerr << ", expected " << +wifbExpected << '\n'; \
+        } \
+    } while (0)
+
+#define WIFB_TEST_RESULT() \
+    (wifbTestFailures ? (std::cerr << wifbTestFailures << " check(s) failed\n", 1) : 0)
+
+#endif